@@ -0,0 +1,520 @@
+#include "AssetCache.h"
+#include "ContentDeduplicator.h"
+#include "CookedTexture.h"
+#include "JobSystem.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "PngLoader.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <Windows.h>
+
+namespace{
+
+// マップしたファイルのページを先に読み込ませる (メインスレッドでのページフォルトを避ける)
+template<class T>
+void TouchPages(std::span<const T> data){
+	const volatile std::byte* bytes = reinterpret_cast<const volatile std::byte*>(data.data());
+	size_t size = data.size_bytes();
+	for(size_t offset = 0; offset < size; offset += 4096){
+		(void)bytes[offset];
+	}
+}
+
+} // namespace
+
+// =================================================================
+// ハンドル
+// =================================================================
+
+AssetRef::AssetRef(AssetEntry* entry) : entry_(entry){
+	if(entry_){
+		++entry_->refCount;
+	}
+}
+
+AssetRef::AssetRef(const AssetRef& other) : AssetRef(other.entry_){}
+
+AssetRef::AssetRef(AssetRef&& other) noexcept : entry_(other.entry_){
+	other.entry_ = nullptr;
+}
+
+AssetRef& AssetRef::operator=(const AssetRef& other){
+	if(this != &other){
+		// (先に参照を増やしてから手放す)
+		AssetEntry* entry = other.entry_;
+		if(entry){
+			++entry->refCount;
+		}
+		Reset();
+		entry_ = entry;
+	}
+	return *this;
+}
+
+AssetRef& AssetRef::operator=(AssetRef&& other) noexcept{
+	if(this != &other){
+		Reset();
+		entry_ = other.entry_;
+		other.entry_ = nullptr;
+	}
+	return *this;
+}
+
+AssetRef::~AssetRef(){
+	Reset();
+}
+
+void AssetRef::Reset(){
+	if(!entry_){
+		return;
+	}
+	assert(entry_->refCount > 0);
+	if(--entry_->refCount == 0){
+		// 誰も使わなくなったので、予算を超えていれば捨てる候補になる
+		AssetCache::GetInstance()->Trim();
+	}
+	entry_ = nullptr;
+}
+
+MeshModel* ModelHandle::Get() const{
+	if(!entry_){
+		return nullptr;
+	}
+	AssetCache::GetInstance()->Touch(entry_);
+	return entry_->model;
+}
+
+uint32_t TextureHandle::Get() const{
+	if(!entry_){
+		return 0;
+	}
+	AssetCache::GetInstance()->Touch(entry_);
+	return entry_->textureHandle;
+}
+
+uint32_t SoundHandle::Get() const{
+	if(!entry_){
+		return 0;
+	}
+	AssetCache::GetInstance()->Touch(entry_);
+	return entry_->soundHandle;
+}
+
+// =================================================================
+// キャッシュ本体
+// =================================================================
+
+AssetCache* AssetCache::GetInstance(){
+	static AssetCache instance;
+	return &instance;
+}
+
+void AssetCache::SetMemoryBudget(size_t bytes){
+	memoryBudget_ = bytes;
+	Trim();
+}
+
+ModelHandle AssetCache::LoadModel(const std::string& name,bool smoothing){
+	AssetEntry* entry = FindOrAdd(AssetEntry::Kind::kModel,name,smoothing);
+	if(entry->isLoaded){
+		++hitCount_;
+	}
+	Touch(entry);
+	return ModelHandle(entry);
+}
+
+TextureHandle AssetCache::LoadTexture(const std::string& fileName){
+	AssetEntry* entry = FindOrAdd(AssetEntry::Kind::kTexture,ContentDeduplicator::GetInstance()->GetCanonicalTexture(fileName),false);
+	if(entry->isLoaded){
+		++hitCount_;
+	}
+	Touch(entry);
+	return TextureHandle(entry);
+}
+
+SoundHandle AssetCache::LoadSound(const std::string& fileName){
+	AssetEntry* entry = FindOrAdd(AssetEntry::Kind::kSound,fileName,false);
+	if(entry->isLoaded){
+		++hitCount_;
+	}
+	Touch(entry);
+	return SoundHandle(entry);
+}
+
+ModelHandle AssetCache::RequestModel(const std::string& name,bool smoothing){
+	return ModelHandle(FindOrAdd(AssetEntry::Kind::kModel,name,smoothing));
+}
+
+ModelHandle AssetCache::LoadModelAsync(const std::string& name,bool smoothing){
+	AssetEntry* entry = FindOrAdd(AssetEntry::Kind::kModel,name,smoothing);
+	if(entry->isLoaded){
+		++hitCount_;
+	}
+	entry->lastUseTick = ++useTick_;
+	StartAsyncLoad(entry);
+	return ModelHandle(entry);
+}
+
+TextureHandle AssetCache::LoadTextureAsync(const std::string& fileName){
+	AssetEntry* entry = FindOrAdd(AssetEntry::Kind::kTexture,ContentDeduplicator::GetInstance()->GetCanonicalTexture(fileName),false);
+	if(entry->isLoaded){
+		++hitCount_;
+	}
+	entry->lastUseTick = ++useTick_;
+	StartAsyncLoad(entry);
+	return TextureHandle(entry);
+}
+
+SoundHandle AssetCache::LoadSoundAsync(const std::string& fileName){
+	AssetEntry* entry = FindOrAdd(AssetEntry::Kind::kSound,fileName,false);
+	if(entry->isLoaded){
+		++hitCount_;
+	}
+	entry->lastUseTick = ++useTick_;
+	StartAsyncLoad(entry);
+	return SoundHandle(entry);
+}
+
+void AssetCache::Update(float timeBudgetMs){
+	auto start = std::chrono::steady_clock::now();
+	for(;;){
+		AssetEntry* entry = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if(prepared_.empty()){
+				return;
+			}
+			entry = prepared_.front();
+			prepared_.pop_front();
+		}
+		Finalize(entry);
+
+		std::chrono::duration<float,std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		if(elapsed.count() >= timeBudgetMs){
+			return; // 残りは次のフレーム
+		}
+	}
+}
+
+float AssetCache::GetLoadProgress() const{
+	if(asyncRequested_ == 0){
+		return 1.0f;
+	}
+	return static_cast<float>(asyncFinished_) / static_cast<float>(asyncRequested_);
+}
+
+void AssetCache::Shutdown(){
+	// ワーカーが触っているエントリを消さないよう、先に全部終わらせる
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		condition_.wait(lock,[this](){ return jobsInFlight_ == 0; });
+		prepared_.clear();
+	}
+	asyncRequested_ = 0;
+	asyncFinished_ = 0;
+
+	// (ハンドルが残っていてもエントリ自体は消さない。中身だけ解放する)
+	for(auto& [key,entry] : entries_){
+		entry->isLoading = false;
+		entry->isPrepared = false;
+		entry->meshData.reset();
+		entry->cookedMesh.reset();
+		entry->textureFileName.clear();
+		Unload(entry.get());
+	}
+}
+
+void AssetCache::Report(const std::string& label) const{
+	uint32_t loadedCount = 0;
+	uint32_t referencedCount = 0;
+	for(const auto& [key,entry] : entries_){
+		if(entry->isLoaded){
+			++loadedCount;
+			if(entry->refCount > 0){
+				++referencedCount;
+			}
+		}
+	}
+	std::string message = "[AssetCache] " + label +
+	                      ": loads " + std::to_string(loadCount_) +
+	                      ", hits " + std::to_string(hitCount_) +
+	                      ", evicts " + std::to_string(evictCount_) +
+	                      ", loaded " + std::to_string(loadedCount) + " (in use " + std::to_string(referencedCount) + ")" +
+	                      ", memory " + std::to_string(memoryUsage_ / 1024) + " KB / " + std::to_string(memoryBudget_ / 1024) + " KB\n";
+	OutputDebugStringA(message.c_str());
+}
+
+AssetEntry* AssetCache::FindOrAdd(AssetEntry::Kind kind,const std::string& name,bool smoothing){
+	// 種類と平滑化の有無も含めて1つの名前にする
+	static const char* const kPrefixes[] = {"model:", "texture:", "sound:"};
+	std::string key = kPrefixes[static_cast<size_t>(kind)] + name;
+	if(smoothing){
+		key += "#smooth";
+	}
+
+	auto it = entries_.find(key);
+	if(it != entries_.end()){
+		return it->second.get();
+	}
+
+	auto entry = std::make_unique<AssetEntry>();
+	entry->kind = kind;
+	entry->name = name;
+	entry->smoothing = smoothing;
+	AssetEntry* result = entry.get();
+	entries_.emplace(std::move(key),std::move(entry));
+	return result;
+}
+
+void AssetCache::Touch(AssetEntry* entry){
+	entry->lastUseTick = ++useTick_;
+	if(entry->isLoaded){
+		return;
+	}
+	if(entry->isLoading){
+		WaitFor(entry);
+		return;
+	}
+	Load(entry);
+	Trim();
+}
+
+void AssetCache::Load(AssetEntry* entry){
+	switch(entry->kind){
+	case AssetEntry::Kind::kModel:
+		entry->model = MeshModel::CreateFromOBJ(entry->name,entry->smoothing);
+		entry->memorySize = entry->model->GetMemorySize();
+		break;
+	case AssetEntry::Kind::kTexture:{
+		std::string fileName = GetTextureFileName(entry->name);
+		entry->textureHandle = TextureManager::Load(fileName);
+		entry->memorySize = EstimateTextureSize(fileName);
+		break;
+	}
+	case AssetEntry::Kind::kSound:{
+		std::lock_guard<std::mutex> lock(audioMutex_);
+		entry->soundHandle = Audio::GetInstance()->LoadWave(entry->name);
+		break;
+	}
+	}
+	entry->isLoaded = true;
+	memoryUsage_ += entry->memorySize;
+	++loadCount_;
+}
+
+void AssetCache::StartAsyncLoad(AssetEntry* entry){
+	if(entry->isLoaded || entry->isLoading){
+		return;
+	}
+	entry->isLoading = true;
+
+	// 前の読み込みが全部終わっていれば、進み具合を数え直す
+	if(asyncFinished_ == asyncRequested_){
+		asyncRequested_ = 0;
+		asyncFinished_ = 0;
+	}
+	++asyncRequested_;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		++jobsInFlight_;
+	}
+	JobSystem::GetInstance()->Submit([this,entry](){ Prepare(entry); });
+}
+
+void AssetCache::Prepare(AssetEntry* entry){
+	// (ワーカースレッド。エントリの種類と名前は読み込み中に変わらない)
+	std::unique_ptr<MeshData> meshData;
+	std::unique_ptr<CookedMesh> cookedMesh;
+	std::string textureFileName;
+	uint32_t soundHandle = 0;
+	size_t fileSize = 0;
+
+	switch(entry->kind){
+	case AssetEntry::Kind::kModel:
+		// クック済みがあればマップするだけ
+		if(CookedMesh::IsUpToDate(entry->name,entry->smoothing)){
+			cookedMesh = std::make_unique<CookedMesh>();
+			if(cookedMesh->Open(CookedMesh::GetPath(entry->name,entry->smoothing))){
+				TouchPages(cookedMesh->GetVertices());
+				TouchPages(cookedMesh->GetIndices());
+				break;
+			}
+			cookedMesh.reset();
+		}
+		// (すでにワーカースレッドなので、1モデルの中では並列にしない)
+		meshData = std::make_unique<MeshData>();
+		if(ObjParser::Load(entry->name,entry->smoothing,*meshData)){
+			MeshOptimizer::Optimize(*meshData);
+			MeshSimplifier::GenerateLods(*meshData);
+		}
+		else{
+			meshData.reset();
+		}
+		break;
+	case AssetEntry::Kind::kTexture:{
+		// エンジンの TextureManager はファイル名からしか作れないので、
+		// PNG はここでデコード・ミップマップ作成・圧縮まで済ませてクック済みの DDS に書き、
+		// メインスレッドの Load はそれを読んで送るだけにする
+		// (書いた DDS は OS のキャッシュに載せておく)
+		textureFileName = CookTexture(entry->name);
+		std::ifstream file("Resources/" + textureFileName,std::ios::binary);
+		if(file.is_open()){
+			std::vector<char> buffer(64 * 1024);
+			while(file.read(buffer.data(),static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0){
+				fileSize += static_cast<size_t>(file.gcount());
+			}
+		}
+		break;
+	}
+	case AssetEntry::Kind::kSound:{
+		// WAV の読み込みは GPU を使わないので、Audio に入れるところまでここで済ませる
+		std::lock_guard<std::mutex> lock(audioMutex_);
+		soundHandle = Audio::GetInstance()->LoadWave(entry->name);
+		break;
+	}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		entry->meshData = std::move(meshData);
+		entry->cookedMesh = std::move(cookedMesh);
+		entry->textureFileName = std::move(textureFileName);
+		entry->soundHandle = soundHandle;
+		entry->fileSize = fileSize;
+		entry->isPrepared = true;
+		prepared_.push_back(entry);
+		--jobsInFlight_;
+	}
+	condition_.notify_all();
+}
+
+void AssetCache::Finalize(AssetEntry* entry){
+	if(!entry->isLoading){
+		return;
+	}
+	entry->isLoading = false;
+	entry->isPrepared = false;
+	++asyncFinished_;
+
+	switch(entry->kind){
+	case AssetEntry::Kind::kModel:
+		if(entry->cookedMesh){
+			entry->model = MeshModel::Create(*entry->cookedMesh);
+		}
+		else if(entry->meshData){
+			entry->model = MeshModel::Create(*entry->meshData);
+		}
+		else{
+			// 読めなかった時は同期版と同じ場所で止める
+			entry->model = MeshModel::CreateFromOBJ(entry->name,entry->smoothing);
+		}
+		entry->memorySize = entry->model->GetMemorySize();
+		entry->meshData.reset();
+		entry->cookedMesh.reset();
+		break;
+	case AssetEntry::Kind::kTexture:
+		entry->textureHandle = TextureManager::Load(entry->textureFileName);
+		entry->memorySize = entry->fileSize;
+		entry->textureFileName.clear();
+		break;
+	case AssetEntry::Kind::kSound:
+		// (ワーカーで読み終えている)
+		break;
+	}
+	entry->isLoaded = true;
+	memoryUsage_ += entry->memorySize;
+	++loadCount_;
+	Trim();
+}
+
+void AssetCache::WaitFor(AssetEntry* entry){
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		condition_.wait(lock,[entry](){ return entry->isPrepared; });
+		// Update で二重に仕上げないよう、待ち行列から外す
+		prepared_.erase(std::find(prepared_.begin(),prepared_.end(),entry));
+	}
+	Finalize(entry);
+}
+
+void AssetCache::Unload(AssetEntry* entry){
+	if(!entry->isLoaded){
+		return;
+	}
+	switch(entry->kind){
+	case AssetEntry::Kind::kModel:
+		delete entry->model;
+		entry->model = nullptr;
+		break;
+	case AssetEntry::Kind::kTexture:
+		TextureManager::Unload(entry->textureHandle);
+		entry->textureHandle = 0;
+		break;
+	case AssetEntry::Kind::kSound:
+		// (Audio には番号で解放する手段がない。Audio::Finalize でまとめて消える)
+		entry->soundHandle = 0;
+		break;
+	}
+	entry->isLoaded = false;
+	memoryUsage_ -= entry->memorySize;
+	entry->memorySize = 0;
+}
+
+void AssetCache::Trim(){
+	while(memoryUsage_ > memoryBudget_){
+		// 参照されていない読み込み済みのもののうち、一番古く使ったもの
+		AssetEntry* oldest = nullptr;
+		for(auto& [key,entry] : entries_){
+			if(entry->isLoaded && entry->refCount == 0 && entry->kind != AssetEntry::Kind::kSound && (!oldest || entry->lastUseTick < oldest->lastUseTick)){
+				oldest = entry.get();
+			}
+		}
+		if(!oldest){
+			return; // 全部使用中
+		}
+		Unload(oldest);
+		++evictCount_;
+	}
+}
+
+size_t AssetCache::EstimateTextureSize(const std::string& fileName){
+	// 画像ファイルの大きさで代用する (クック済みの DDS ならほぼ VRAM の大きさ)
+	std::error_code errorCode;
+	uintmax_t size = std::filesystem::file_size("Resources/" + fileName,errorCode);
+	return errorCode ? 0 : static_cast<size_t>(size);
+}
+
+std::string AssetCache::CookTexture(const std::string& fileName){
+	// クック済みが新しければそのまま使う
+	if(CookedTexture::IsUpToDate(fileName)){
+		return CookedTexture::GetCookedName(fileName);
+	}
+	ImageData image;
+	if(!PngLoader::Load("Resources/" + fileName,image)){
+		return fileName; // PNG 以外はエンジンに任せる
+	}
+	// (書きかけのファイルを読まないよう、別の名前で書き終えてから置き換える)
+	std::string cookedName = CookedTexture::GetCookedName(fileName);
+	std::string path = "Resources/" + cookedName;
+	std::string temporaryPath = path + ".tmp";
+	if(!CookedTexture::Write(image,CookedTexture::ChooseFormat(image),temporaryPath,1)){
+		return fileName;
+	}
+	std::error_code errorCode;
+	std::filesystem::rename(temporaryPath,path,errorCode);
+	if(errorCode){
+		std::filesystem::remove(temporaryPath,errorCode);
+		return fileName;
+	}
+	return cookedName;
+}
+
+std::string AssetCache::GetTextureFileName(const std::string& fileName){
+	return CookedTexture::IsUpToDate(fileName) ? CookedTexture::GetCookedName(fileName) : fileName;
+}
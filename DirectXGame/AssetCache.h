@@ -0,0 +1,213 @@
+#pragma once
+#include "KamataEngine.h"
+#include "CookedMesh.h"
+#include "MeshData.h"
+#include "MeshModel.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace KamataEngine;
+
+class AssetCache;
+
+// ==========================================
+// キャッシュ内の1アセット分の情報
+// (名前は登録時に1度だけ保存し、以降は番号とポインタで扱う)
+// ==========================================
+struct AssetEntry{
+	enum class Kind{
+		kModel,
+		kTexture,
+		kSound,
+	};
+
+	Kind kind = Kind::kModel;
+	std::string name;
+	bool smoothing = false;
+
+	// 読み込み済みのデータ
+	MeshModel* model = nullptr;
+	uint32_t textureHandle = 0;
+	uint32_t soundHandle = 0;
+	bool isLoaded = false;
+
+	// 非同期読み込み中 (ワーカーで CPU 側の処理をしている)
+	bool isLoading = false;
+	// ワーカーが作ったデータ (AssetCache::mutex_ で守る)
+	bool isPrepared = false;
+	std::unique_ptr<MeshData> meshData;
+	std::unique_ptr<CookedMesh> cookedMesh; // クック済みがあればこちら
+	std::string textureFileName; // テクスチャは、ワーカーがデコードして書いたクック済みの名前 (書けなければ元の名前)
+	size_t fileSize = 0;
+
+	uint32_t refCount = 0;
+	size_t memorySize = 0;   // 見積もったメモリ量 (バイト)
+	uint64_t lastUseTick = 0; // LRU 用
+};
+
+// 参照カウント付きハンドルの共通部分
+// コピーで参照が増え、破棄で減る。0 になってもすぐには捨てず、予算を超えた時に古いものから捨てる
+class AssetRef{
+public:
+	AssetRef() = default;
+	explicit AssetRef(AssetEntry* entry);
+	AssetRef(const AssetRef& other);
+	AssetRef(AssetRef&& other) noexcept;
+	AssetRef& operator=(const AssetRef& other);
+	AssetRef& operator=(AssetRef&& other) noexcept;
+	~AssetRef();
+
+	// 参照を手放す
+	void Reset();
+
+	bool IsValid() const{ return entry_ != nullptr; }
+	bool IsLoaded() const{ return entry_ && entry_->isLoaded; }
+
+protected:
+	AssetEntry* entry_ = nullptr;
+};
+
+// モデルのハンドル (Get した時点で未読み込みなら読み込む)
+class ModelHandle : public AssetRef{
+public:
+	using AssetRef::AssetRef;
+
+	MeshModel* Get() const;
+	MeshModel* operator->() const{ return Get(); }
+};
+
+// テクスチャのハンドル
+class TextureHandle : public AssetRef{
+public:
+	using AssetRef::AssetRef;
+
+	uint32_t Get() const;
+};
+
+// 音声のハンドル (Audio::LoadWave の番号を返す)
+class SoundHandle : public AssetRef{
+public:
+	using AssetRef::AssetRef;
+
+	uint32_t Get() const;
+};
+
+// ==========================================
+// モデル・テクスチャ・音声の共有キャッシュ
+// ・同じ名前のアセットは1度だけ読み込み、参照カウント付きのハンドルで配る
+// ・LoadModel / LoadTexture はすぐ読み込む。RequestModel は初めて Get した時に読み込む
+// ・Load～Async はファイルの読み込みと解析を JobSystem のワーカーで行い、
+//   GPU へのアップロードだけを毎フレームの Update でメインスレッドから行う
+//   (PNG はワーカーでデコードしてクック済みの DDS にするので、メインスレッドは圧縮済みのデータを送るだけ。
+//    WAV は Audio::LoadWave ごとワーカーで読む)
+//   (読み込み中に Get すると、その場で完了を待つ)
+// ・どこからも参照されていないアセットは残しておき (シーンをまたいで再利用)、
+//   メモリ予算を超えたら最後に使ったのが古いものから捨てる
+// テクスチャは AssetCooker でクックした圧縮済みの DDS (.cooked.dds) が新しければそちらを読む
+// 別の名前でも中身が同じテクスチャは、最初に読んだ名前のエントリを共有する
+// 音声は Audio 側で解放できないので、一度読んだら捨てない
+// ==========================================
+class AssetCache{
+public:
+	// Update 1回で GPU へのアップロードに使う時間の目安 (ミリ秒)
+	static inline const float kDefaultUpdateBudgetMs = 4.0f;
+
+	static AssetCache* GetInstance();
+
+	// 予算 (バイト)。参照中のアセットは予算を超えても捨てない
+	void SetMemoryBudget(size_t bytes);
+
+	// すぐ読み込む
+	ModelHandle LoadModel(const std::string& name,bool smoothing = false);
+	TextureHandle LoadTexture(const std::string& fileName);
+	SoundHandle LoadSound(const std::string& fileName);
+	// 読み込みは初めて使う時まで遅らせる (めったに描かないもの用)
+	ModelHandle RequestModel(const std::string& name,bool smoothing = false);
+
+	// ワーカーで読み込みを始める (完了は IsLoaded か GetLoadProgress で確認する)
+	ModelHandle LoadModelAsync(const std::string& name,bool smoothing = false);
+	TextureHandle LoadTextureAsync(const std::string& fileName);
+	SoundHandle LoadSoundAsync(const std::string& fileName);
+
+	// 毎フレーム呼ぶ。ワーカーが終えたものを GPU に送る
+	// (1フレームに使う時間の目安。最低1つは処理する)
+	void Update(float timeBudgetMs = kDefaultUpdateBudgetMs);
+
+	// 非同期読み込みの進み具合 (0～1)。読み込み中のものがなければ 1
+	float GetLoadProgress() const;
+	bool IsLoading() const{ return asyncFinished_ < asyncRequested_; }
+
+	// 全て破棄 (エンジンの終了前に呼ぶ。読み込み中のジョブは終わるまで待つ)
+	void Shutdown();
+
+	// --- 統計 ---
+	uint32_t GetLoadCount() const{ return loadCount_; }     // 実際に読み込んだ回数
+	uint32_t GetHitCount() const{ return hitCount_; }       // キャッシュから返した回数
+	uint32_t GetEvictCount() const{ return evictCount_; }   // 予算超過で捨てた回数
+	size_t GetMemoryUsage() const{ return memoryUsage_; }   // 読み込み済みアセットの見積もり合計
+	// 上の統計と読み込み済みの数をデバッグ出力に書く (シーンを切り替えるたびに呼び、タイトル→ゲーム→エンドの読み込み回数とメモリ量を確かめる)
+	void Report(const std::string& label) const;
+
+private:
+	friend class AssetRef;
+	friend class ModelHandle;
+	friend class TextureHandle;
+	friend class SoundHandle;
+
+	AssetCache() = default;
+	~AssetCache() = default;
+	AssetCache(const AssetCache&) = delete;
+	AssetCache& operator=(const AssetCache&) = delete;
+
+	AssetEntry* FindOrAdd(AssetEntry::Kind kind,const std::string& name,bool smoothing);
+	// 未読み込みなら読み込み、使用時刻を更新する
+	void Touch(AssetEntry* entry);
+	void Load(AssetEntry* entry);
+	// ワーカーで CPU 側の処理を始める
+	void StartAsyncLoad(AssetEntry* entry);
+	// ワーカー側の処理 (エントリのファイルを読み、解析する)
+	void Prepare(AssetEntry* entry);
+	// 非同期読み込みの残り (GPU へのアップロード) を行う
+	void Finalize(AssetEntry* entry);
+	// 非同期読み込み中なら、ワーカーの完了を待って仕上げる
+	void WaitFor(AssetEntry* entry);
+	void Unload(AssetEntry* entry);
+	// 予算に収まるまで、参照されていないものを古い順に捨てる
+	void Trim();
+
+	static size_t EstimateTextureSize(const std::string& fileName);
+	// クック済み (.cooked.dds) が元の画像より新しければその名前、なければそのままの名前
+	static std::string GetTextureFileName(const std::string& fileName);
+	// GetTextureFileName と同じだが、クック済みが古ければ PNG をデコードして書き直す (ワーカーで呼ぶ)
+	static std::string CookTexture(const std::string& fileName);
+
+	// 名前 → エントリ
+	std::unordered_map<std::string,std::unique_ptr<AssetEntry>> entries_;
+
+	size_t memoryBudget_ = 64 * 1024 * 1024;
+	size_t memoryUsage_ = 0;
+	uint64_t useTick_ = 0;
+
+	uint32_t loadCount_ = 0;
+	uint32_t hitCount_ = 0;
+	uint32_t evictCount_ = 0;
+
+	// --- 非同期読み込み ---
+	// ワーカーとの受け渡し
+	mutable std::mutex mutex_;
+	std::condition_variable condition_;
+	std::deque<AssetEntry*> prepared_; // ワーカーが終えて仕上げ待ちのもの
+	uint32_t jobsInFlight_ = 0;
+	// Audio::LoadWave はスレッドセーフでないので、メインスレッドとワーカーの呼び出しをこれで1つずつにする
+	// (LoadWave を呼ぶのはこのキャッシュだけ)
+	std::mutex audioMutex_;
+	// 進み具合 (全部終わったら次の要求で 0 に戻す)
+	uint32_t asyncRequested_ = 0;
+	uint32_t asyncFinished_ = 0;
+};
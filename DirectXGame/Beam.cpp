@@ -1,37 +1,37 @@
 #include "Beam.h"
+#include "MapChipField.h"
+#include <cmath>
 
 // ==========================================
 // Beamクラスの実装
 // ==========================================
 
-void Beam::Initialize(Model* model,const Vector3& position,const Vector3& velocity){
-	model_ = model;
-	worldTransform_.Initialize();
-	worldTransform_.translation_ = position;
-	worldTransform_.scale_ = {0.5f, 0.5f, 0.5f}; // サイズ調整
+void Beam::Initialize(const Vector3& position,const Vector3& velocity,uint32_t spawnTick,const MapChipField* mapChipField){
+	startPosition_ = position;
 	velocity_ = velocity;
-
-	objectColor_.Initialize();
-	objectColor_.SetColor({1.0f, 1.0f, 0.0f, 1.0f}); // 黄色	
-}
-
-void Beam::Update(){
-	// 移動
-	worldTransform_.translation_ += velocity_;
-
-	// 行列更新
-	WorldTransformUpdate(worldTransform_);
-
-	// 寿命処理
-	if(--lifeTimer_ <= 0){
-		isDead_ = true;
+	spawnTick_ = spawnTick;
+	isDead_ = false;
+	isEnemy_ = false;
+
+	// 寿命切れのティック
+	eventTick_ = spawnTick_ + kLifeTime;
+	isWallHitEvent_ = false;
+
+	// 直線上で最初に入るブロックを調べ、寿命より先なら着弾を予定する
+	// (位置は発射したティックで1回分進んでいるので、経過 age の位置は spawnTick + age - 1 ティック目)
+	float hitT = 0.0f;
+	if(mapChipField && mapChipField->RaycastBlock(startPosition_,velocity_,static_cast<float>(kLifeTime),hitT)){
+		uint32_t hitAge = static_cast<uint32_t>(std::ceil(hitT));
+		if(hitAge == 0){
+			hitAge = 1; // 発射位置が壁の中なら最初のティックで着弾
+		}
+		if(hitAge <= kLifeTime){
+			eventTick_ = spawnTick_ + hitAge - 1;
+			isWallHitEvent_ = true;
+		}
 	}
 }
 
-void Beam::Draw(const Camera& camera){
-	model_->Draw(worldTransform_,camera,&objectColor_);
-}
-
 void Beam::OnCollision(){
 	isDead_ = true;
 }
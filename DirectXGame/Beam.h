@@ -1,29 +1,49 @@
 #pragma once
-#include "KamataEngine.h"
-#include "Math.h"
+#include "ConstexprMath.h"
+#include <cstdint>
 
+class MapChipField;
+
+// ==========================================
+// ビーム (直線運動する弾)
+// 位置は発射時の状態から解析的に求めるので、毎ティックの移動・行列更新・壁判定はしない
+// 壁への着弾と寿命切れは発射時に「何ティック目に起きるか」を計算しておく
+// 描画用のリソースは持たず、このまま EntityWorld のコンポーネントとして使う
+// (D3D を使わないので AssetCooker の計測でも同じ型を使う)
+// ==========================================
 class Beam{
 public:
-	void Initialize(Model* model,const Vector3& position,const Vector3& velocity);
-	void Update();
-	void Draw(const Camera& camera);
+	// 寿命(ティック数)
+	static inline const uint32_t kLifeTime = 120;
+
+	// spawnTick: 発射したティック / mapChipField: 着弾予定の計算用
+	void Initialize(const Vector3& position,const Vector3& velocity,uint32_t spawnTick,const MapChipField* mapChipField);
 	bool IsDead() const{ return isDead_; }
 	void OnCollision(); // 何かに当たった時
 
 	void SetIsEnemy(bool isEnemy){ isEnemy_ = isEnemy; }
 	bool IsEnemy() const{ return isEnemy_; }
 
-	// 当たり判定用
-	Vector3 GetWorldPosition() const{ return worldTransform_.translation_; }
+	// 当たり判定用 (指定したティックでの位置)
+	Vector3 GetWorldPosition(uint32_t tick) const{ return GetPositionAt(static_cast<float>(tick - spawnTick_ + 1)); }
+	// 描画用 (前ティックと今ティックの間を alpha で補間した位置)
+	Vector3 GetRenderPosition(uint32_t tick,float alpha) const{ return GetPositionAt(static_cast<float>(tick - spawnTick_) + alpha); }
 	float GetRadius() const{ return 0.5f; } // 判定半径
 
+	// 予定イベント (壁への着弾 or 寿命切れ) が起きるティック
+	uint32_t GetEventTick() const{ return eventTick_; }
+	// 予定イベントが壁への着弾か
+	bool IsWallHitEvent() const{ return isWallHitEvent_; }
+
 private:
-	WorldTransform worldTransform_;
-	Model* model_ = nullptr;
-	ObjectColor objectColor_; // 色変更用
+	// 発射してから age ティック経過した位置
+	Vector3 GetPositionAt(float age) const{ return startPosition_ + velocity_ * age; }
 
+	Vector3 startPosition_;
 	Vector3 velocity_;
-	int lifeTimer_ = 120; // 寿命(フレーム数)
+	uint32_t spawnTick_ = 0;
+	uint32_t eventTick_ = 0;
+	bool isWallHitEvent_ = false;
 	bool isDead_ = false;
 
 	bool isEnemy_ = false;
@@ -3,7 +3,7 @@
 
 using namespace KamataEngine;
 
-void BossEffectSystem::Initialize(Model* model){
+void BossEffectSystem::Initialize(const ModelHandle& model){
 	model_ = model;
 
 	// 全て非アクティブにしておく
@@ -16,6 +16,18 @@ void BossEffectSystem::Initialize(Model* model){
 	nextIndex_ = 0;
 }
 
+void BossEffectSystem::Clear(){
+	for(auto& p : particles_){
+		p.isActive = false;
+	}
+	nextIndex_ = 0;
+}
+
+void BossEffectSystem::ReleaseModel(){
+	Clear();
+	model_.Reset();
+}
+
 void BossEffectSystem::Spawn(const Vector3& centerPos){
 	// ★検索せず、強制的に「次の場所」を使う（古いものは上書きされる）
 	BossParticle& p = particles_[nextIndex_];
@@ -59,13 +71,27 @@ void BossEffectSystem::Update(float deltaTime){
 		}
 	}
 }
-void BossEffectSystem::Draw(Camera* camera){
-	if(!model_) return;
+void BossEffectSystem::Draw(Camera* camera,VisibilityCuller& culler){
+	MeshModel* model = model_.Get();
+	if(!model) return;
 
+	// 生きている粒を囲む球を積んで、画面の外のものを除く
+	uint32_t first = culler.GetTestedCount();
 	for(auto& p : particles_){
 		if(p.isActive){
+			Vector3 center;
+			float radius;
+			model->GetWorldBoundingSphere(p.worldTransform.matWorld_,center,radius);
+			culler.AddSphere(center,radius);
+		}
+	}
+	culler.Cull();
+
+	uint32_t index = first;
+	for(auto& p : particles_){
+		if(p.isActive && culler.IsVisible(index++)){
 
-			model_->Draw(p.worldTransform,*camera,&p.color);
+			model->Draw(p.worldTransform,*camera,&p.color);
 		}
 	}
 }
\ No newline at end of file
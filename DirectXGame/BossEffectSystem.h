@@ -1,5 +1,6 @@
 #pragma once
 #include "ParticleManager.h"
+#include "AssetCache.h"
 #include "Math.h"
 #include <vector>
 
@@ -18,23 +19,28 @@ struct BossParticle{
 };
 class BossEffectSystem : public EffectSystemBase{
 public:
-	// 初期化 (モデルを受け取る)
-	void Initialize(Model* model);
+	// 初期化 (モデルを受け取る。ハンドルを持つので、このシステムが使っている間はキャッシュに捨てられない)
+	void Initialize(const ModelHandle& model);
 
 	// 更新 (EffectSystemBaseのオーバーライド)
 	void Update(float deltaTime) override;
 
 	// 描画 (EffectSystemBaseのオーバーライド)
-	void Draw(Camera* camera) override;
+	void Draw(Camera* camera,VisibilityCuller& culler) override;
 
 	// エフェクト発生 (GameSceneからこれを呼ぶ)
 	void Spawn(const Vector3& centerPos);
 
+	// 全て消す (リトライ用。定数バッファは作り直さない)
+	void Clear();
+	// 粒を消してモデルの参照を外す (シーンの終わりに呼ぶ)
+	void ReleaseModel();
+
 private:
 	// パーティクルの最大数
 	static const int kMaxParticles = 50;
 	std::array<BossParticle,kMaxParticles> particles_;
 	// 描画用モデル
-	Model* model_ = nullptr;
+	ModelHandle model_;
 	int nextIndex_ = 0;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "KamataEngine.h"
+#include "ViewSettings.h"
 
 // 前方宣言
 class Player;
@@ -37,7 +38,7 @@ private:
 	Player* target_ = nullptr;
 
 	// 追従対象とカメラの座標の差（オフセット）
-	Vector3 targetOffset_ = {0, 0, -15.0f};
+	Vector3 targetOffset_ = ViewSettings::kCameraTargetOffset;
 
 	// カメラ移動範囲
 	Rect movableArea_ = {0, 100, 0, 100};
@@ -0,0 +1,121 @@
+#include "CollisionGrid.h"
+#include <algorithm>
+
+void CollisionGrid::Clear(){
+	centers_.clear();
+	radii_.clear();
+	maxRadius_ = 0.0f;
+	columns_ = 0;
+	rows_ = 0;
+}
+
+uint32_t CollisionGrid::Add(const Vector3& center,float radius){
+	centers_.push_back(center);
+	radii_.push_back(radius);
+	maxRadius_ = std::max(maxRadius_,radius);
+	return static_cast<uint32_t>(centers_.size() - 1);
+}
+
+void CollisionGrid::Build(float cellSize){
+	const uint32_t count = GetCount();
+	if(count == 0){
+		columns_ = 0;
+		rows_ = 0;
+		return;
+	}
+
+	// 積んだものの中心を囲む範囲
+	float minX = centers_[0].x;
+	float minY = centers_[0].y;
+	float maxX = minX;
+	float maxY = minY;
+	for(const Vector3& center : centers_){
+		minX = std::min(minX,center.x);
+		minY = std::min(minY,center.y);
+		maxX = std::max(maxX,center.x);
+		maxY = std::max(maxY,center.y);
+	}
+	minX_ = minX;
+	minY_ = minY;
+
+	// マスが多すぎる時は大きくする
+	cellSize_ = cellSize;
+	for(;;){
+		columns_ = static_cast<uint32_t>((maxX - minX) / cellSize_) + 1;
+		rows_ = static_cast<uint32_t>((maxY - minY) / cellSize_) + 1;
+		if(static_cast<uint64_t>(columns_) * rows_ <= kMaxCells){
+			break;
+		}
+		cellSize_ *= 2.0f;
+	}
+
+	// 数えてから詰める (同じマスの中は番号の小さい順に並ぶ)
+	const uint32_t cellCount = columns_ * rows_;
+	cellStart_.assign(cellCount + 1,0);
+	itemCells_.resize(count);
+	for(uint32_t i = 0; i < count; ++i){
+		itemCells_[i] = GetCell(centers_[i]);
+		++cellStart_[itemCells_[i] + 1];
+	}
+	for(uint32_t c = 0; c < cellCount; ++c){
+		cellStart_[c + 1] += cellStart_[c];
+	}
+	cellItems_.resize(count);
+	for(uint32_t i = 0; i < count; ++i){
+		// (cellStart_[c] を書き込み位置に使い、最後に1つずらして戻す)
+		cellItems_[cellStart_[itemCells_[i]]++] = i;
+	}
+	for(uint32_t c = cellCount; c > 0; --c){
+		cellStart_[c] = cellStart_[c - 1];
+	}
+	cellStart_[0] = 0;
+}
+
+uint32_t CollisionGrid::FindFirst(const Vector3& center,float radius) const{
+	lastTested_ = 0;
+	if(columns_ == 0){
+		return kNone;
+	}
+
+	// 中心がこの範囲に無いものとは重ならない
+	const float reach = radius + maxRadius_;
+	const float left = (center.x - reach - minX_) / cellSize_;
+	const float right = (center.x + reach - minX_) / cellSize_;
+	const float bottom = (center.y - reach - minY_) / cellSize_;
+	const float top = (center.y + reach - minY_) / cellSize_;
+	if(right < 0.0f || top < 0.0f || left >= static_cast<float>(columns_) || bottom >= static_cast<float>(rows_)){
+		return kNone;
+	}
+	const uint32_t x0 = static_cast<uint32_t>(std::max(left,0.0f));
+	const uint32_t y0 = static_cast<uint32_t>(std::max(bottom,0.0f));
+	const uint32_t x1 = std::min(static_cast<uint32_t>(right),columns_ - 1);
+	const uint32_t y1 = std::min(static_cast<uint32_t>(top),rows_ - 1);
+
+	uint32_t first = kNone;
+	for(uint32_t y = y0; y <= y1; ++y){
+		for(uint32_t x = x0; x <= x1; ++x){
+			const uint32_t cell = y * columns_ + x;
+			for(uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k){
+				const uint32_t index = cellItems_[k];
+				if(index >= first){
+					break; // マスの中は小さい順なので、これより後は見なくてよい
+				}
+				++lastTested_;
+				Vector3 diff = center - centers_[index];
+				float distSq = diff.x * diff.x + diff.y * diff.y + diff.z * diff.z;
+				float r = radius + radii_[index];
+				if(distSq <= r * r){
+					first = index;
+					break;
+				}
+			}
+		}
+	}
+	return first;
+}
+
+uint32_t CollisionGrid::GetCell(const Vector3& center) const{
+	uint32_t x = std::min(static_cast<uint32_t>((center.x - minX_) / cellSize_),columns_ - 1);
+	uint32_t y = std::min(static_cast<uint32_t>((center.y - minY_) / cellSize_),rows_ - 1);
+	return y * columns_ + x;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "ConstexprMath.h"
+#include <cstdint>
+#include <vector>
+
+// ==========================================
+// 当たり判定の広域判定 (一様グリッド)
+// ・Clear で空にし、Add で球 (中心と半径) を積み、Build でマス目に振り分ける
+// ・FindFirst は周りのマスに入っているものだけを調べ、重なるもののうち一番小さい番号を返す
+//   (積んだ順に総当たりして最初に当たったものと同じ結果になる)
+// ・マスは xy 平面 (マップのブロックと同じ大きさ)。z は詳細判定でだけ見る
+// ・球は中心のあるマスにだけ入れ、調べる範囲を一番大きい半径の分だけ広げるので、同じものを2度調べない
+// ・配列は Clear でも大きさを残すので、数が増えない限り確保しない
+// ・D3D を使わないので AssetCooker でも動く
+// ==========================================
+class CollisionGrid{
+public:
+	static inline const uint32_t kNone = UINT32_MAX;
+
+	// 積んだものを捨てる
+	void Clear();
+
+	// 球を積んで番号を返す (Clear からの通し番号)
+	uint32_t Add(const Vector3& center,float radius);
+
+	// 積んだものを cellSize 四方のマスに振り分ける (Add の後、FindFirst の前に1度呼ぶ)
+	// (積んだものの広がりに対してマスが多すぎる時はマスを大きくする)
+	void Build(float cellSize);
+
+	// center から radius の球と重なるもののうち、一番小さい番号 (無ければ kNone)
+	uint32_t FindFirst(const Vector3& center,float radius) const;
+
+	uint32_t GetCount() const{ return static_cast<uint32_t>(centers_.size()); }
+	// 直前の FindFirst で詳細判定した数
+	uint32_t GetLastTestedCount() const{ return lastTested_; }
+
+private:
+	// マスの数の上限 (これを超える時はマスを大きくする)
+	static inline const uint32_t kMaxCells = 1u << 16;
+
+	uint32_t GetCell(const Vector3& center) const;
+
+	std::vector<Vector3> centers_;
+	std::vector<float> radii_;
+	float maxRadius_ = 0.0f;
+
+	// マス目 (積んだものの中心を囲む範囲)
+	float minX_ = 0.0f;
+	float minY_ = 0.0f;
+	float cellSize_ = 1.0f;
+	uint32_t columns_ = 0;
+	uint32_t rows_ = 0;
+
+	// マスごとの番号 (cellStart_[c] から cellStart_[c + 1] まで。マスの中は小さい順)
+	std::vector<uint32_t> cellStart_;
+	std::vector<uint32_t> cellItems_;
+	std::vector<uint32_t> itemCells_;
+
+	mutable uint32_t lastTested_ = 0;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include "MathKernels.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+#include <numbers>
+
+using namespace KamataEngine;
+
+// ==========================================
+// ベクトルの演算子・簡単な行列・Lerp・イージング (constexpr でヘッダーに書く)
+// ・別の cpp からも展開されて関数呼び出しにならず、定数だけの式はコンパイル時に計算される
+// ・決まった値の表 (パーティクルの方向など) もコンパイル時に作る (cos は MathKernels.h の CosConstexpr)
+// ・D3D を使わないので AssetCooker でも使える (AssetCooker tables で確かめる)
+// ==========================================
+
+// 単項演算子
+constexpr Vector3 operator+(const Vector3& v) { return v; }
+constexpr Vector3 operator-(const Vector3& v) { return {-v.x, -v.y, -v.z}; }
+
+// 代入演算子オーバーロード
+constexpr Vector3& operator+=(Vector3& lhv, const Vector3& rhv) {
+	lhv.x += rhv.x;
+	lhv.y += rhv.y;
+	lhv.z += rhv.z;
+	return lhv;
+}
+constexpr Vector3& operator-=(Vector3& lhv, const Vector3& rhv) {
+	lhv.x -= rhv.x;
+	lhv.y -= rhv.y;
+	lhv.z -= rhv.z;
+	return lhv;
+}
+constexpr Vector3& operator*=(Vector3& v, float s) {
+	v.x *= s;
+	v.y *= s;
+	v.z *= s;
+	return v;
+}
+constexpr Vector3& operator/=(Vector3& v, float s) {
+	v.x /= s;
+	v.y /= s;
+	v.z /= s;
+	return v;
+}
+
+// 2項演算子オーバーロード (引き算は KamataEngine の Vector3 のメンバーにある)
+constexpr Vector3 operator+(const Vector3& lhv, const Vector3& rhv) { return {lhv.x + rhv.x, lhv.y + rhv.y, lhv.z + rhv.z}; }
+constexpr Vector3 operator*(const Vector3& v1, const float f) { return {v1.x * f, v1.y * f, v1.z * f}; }
+constexpr Vector3 operator/(const Vector3& v, float scalar) { return {v.x / scalar, v.y / scalar, v.z / scalar}; }
+
+constexpr float Lerp(float x1, float x2, float t) {
+	// 同じ値同士は丸めでずれないようにそのまま返す (止まっている物の補間結果が毎フレーム同じになり、転送を省ける)
+	if (x1 == x2) {
+		return x1;
+	}
+	return (1.0f - t) * x1 + t * x2;
+}
+constexpr Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t) { return {Lerp(v1.x, v2.x, t), Lerp(v1.y, v2.y, t), Lerp(v1.z, v2.z, t)}; }
+
+// 単位行列の作成
+constexpr Matrix4x4 MakeIdentityMatrix() {
+	return {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+}
+// スケーリング行列の作成
+constexpr Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
+	return {scale.x, 0.0f, 0.0f, 0.0f, 0.0f, scale.y, 0.0f, 0.0f, 0.0f, 0.0f, scale.z, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+}
+// 平行移動行列の作成
+constexpr Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
+	return {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, translate.x, translate.y, translate.z, 1.0f};
+}
+
+// XY 平面で {length, 0, 0} を Z 軸まわりに 2π / N ずつ回した N 個の方向 (MakeRotateZMatrix で回した時と同じ向き)
+// 放射状に飛ぶパーティクルの速度など、決まった方向の表をコンパイル時に作る
+template <size_t N> constexpr std::array<Vector3, N> MakeCircleDirections(float length) {
+	std::array<Vector3, N> directions{};
+	for (size_t i = 0; i < N; ++i) {
+		double angle = 2.0 * 3.14159265358979323846 * static_cast<double>(i) / N;
+		directions[i] = {static_cast<float>(length * CosConstexpr(angle)), static_cast<float>(length * SinConstexpr(angle)), 0.0f};
+	}
+	return directions;
+}
+
+// --- イージング ---
+// EaseIn は t^2、EaseOut は 1 - (1 - t)^3 (掛け算だけなのでヘッダーで展開する)
+constexpr float EaseIn(float x1, float x2, float t) { return Lerp(x1, x2, t * t); }
+constexpr float EaseOut(float x1, float x2, float t) {
+	float inverseT = 1.0f - t;
+	return Lerp(x1, x2, 1.0f - inverseT * inverseT * inverseT);
+}
+
+// EaseInOut は (1 - cos(πt)) / 2
+// (表の線形補間や MathKernels の Cos より std::cos の方が速いので、これだけは constexpr にしない。AssetCooker tables で測る)
+inline float EaseInOutCurve(float t) { return (1.0f - std::cos(std::numbers::pi_v<float> * t)) / 2.0f; }
+inline float EaseInOut(float x1, float x2, float t) { return Lerp(x1, x2, EaseInOutCurve(t)); }
@@ -0,0 +1,112 @@
+#include "ContentDeduplicator.h"
+#include "MappedFile.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+namespace{
+
+bool IsSameContents(const std::string& a,const std::string& b){
+	MappedFile fileA;
+	MappedFile fileB;
+	if(!fileA.Open("Resources/" + a) || !fileB.Open("Resources/" + b)){
+		return false;
+	}
+	return fileA.GetSize() == fileB.GetSize() && std::memcmp(fileA.GetData(),fileB.GetData(),fileA.GetSize()) == 0;
+}
+
+int32_t Quantize(float value){
+	return static_cast<int32_t>(std::lround(value * 4096.0f));
+}
+
+} // namespace
+
+uint64_t ContentDeduplicator::HashBytes(const std::byte* data,size_t size){
+	// FNV-1a (8バイトずつ)
+	uint64_t hash = 14695981039346656037ull;
+	size_t i = 0;
+	for(; i + 8 <= size; i += 8){
+		uint64_t word;
+		std::memcpy(&word,data + i,sizeof(word));
+		hash ^= word;
+		hash *= 1099511628211ull;
+	}
+	for(; i < size; ++i){
+		hash ^= static_cast<uint64_t>(data[i]);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+uint64_t ContentDeduplicator::HashFile(const std::string& path){
+	MappedFile file;
+	return file.Open(path) ? HashBytes(file.GetData(),file.GetSize()) : 0;
+}
+
+size_t ContentDeduplicator::MaterialKeyHash::operator()(const MaterialKey& key) const{
+	uint64_t hash = HashBytes(reinterpret_cast<const std::byte*>(key.values.data()),sizeof(key.values));
+	return static_cast<size_t>(hash ^ std::hash<std::string>()(key.texture));
+}
+
+ContentDeduplicator* ContentDeduplicator::GetInstance(){
+	static ContentDeduplicator instance;
+	return &instance;
+}
+
+std::string ContentDeduplicator::GetCanonicalTexture(const std::string& fileName){
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = canonicalNames_.find(fileName);
+	if(it != canonicalNames_.end()){
+		return it->second;
+	}
+	++textureCount_;
+
+	std::error_code errorCode;
+	uint64_t size = std::filesystem::file_size("Resources/" + fileName,errorCode);
+	if(errorCode){
+		canonicalNames_.emplace(fileName,fileName);
+		return fileName;
+	}
+
+	// 大きさが同じものがある時だけ中身を見る
+	FileInfo file{fileName, size};
+	std::vector<size_t>& sameSize = filesBySize_[size];
+	for(size_t index : sameSize){
+		if(GetHash(files_[index]) == GetHash(file) && IsSameContents(files_[index].fileName,fileName)){
+			++duplicateCount_;
+			duplicateBytes_ += size;
+			canonicalNames_.emplace(fileName,files_[index].fileName);
+			return files_[index].fileName;
+		}
+	}
+	sameSize.push_back(files_.size());
+	files_.push_back(std::move(file));
+	canonicalNames_.emplace(fileName,fileName);
+	return fileName;
+}
+
+uint64_t ContentDeduplicator::GetHash(FileInfo& file){
+	if(!file.hasHash){
+		file.hash = HashFile("Resources/" + file.fileName);
+		file.hasHash = true;
+		++hashedCount_;
+	}
+	return file.hash;
+}
+
+ContentDeduplicator::MaterialKey ContentDeduplicator::MakeMaterialKey(const MeshData::MaterialData& data,const std::string& texture,const float uvScale[2],const float uvOffset[2]){
+	MaterialKey key;
+	const float colors[] = {data.ambient.x, data.ambient.y, data.ambient.z, data.diffuse.x, data.diffuse.y, data.diffuse.z,
+	                        data.specular.x, data.specular.y, data.specular.z, data.alpha};
+	for(size_t i = 0; i < std::size(colors); ++i){
+		key.values[i] = Quantize(colors[i]);
+	}
+	// UV はアトラスの位置なので丸めない
+	key.values[10] = std::bit_cast<int32_t>(uvScale[0]);
+	key.values[11] = std::bit_cast<int32_t>(uvScale[1]);
+	key.values[12] = std::bit_cast<int32_t>(uvOffset[0]);
+	key.values[13] = std::bit_cast<int32_t>(uvOffset[1]);
+	key.texture = texture;
+	return key;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "MeshData.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ==========================================
+// 中身が同じファイル・値が同じマテリアルを1つにまとめる
+// ・テクスチャは名前ごとに1度だけ調べ、中身が同じなら最初に見た名前を返す
+//   (大きさが同じファイルがある時だけハッシュを取り、ハッシュが合えば中身も比べる)
+// ・マテリアルは色を丸めた値とテクスチャ名をキーにする (名前は見ない)
+// テクスチャ名は Resources/ からの相対。複数スレッドから呼んでよい
+// ==========================================
+class ContentDeduplicator{
+public:
+	// マテリアルを比べるためのキー
+	struct MaterialKey{
+		std::array<int32_t,14> values = {}; // ambient, diffuse, specular, alpha (丸めた値)、UV のスケールとオフセット (ビット列)
+		std::string texture;                // 読むテクスチャ (読まないなら空)
+		bool operator==(const MaterialKey& other) const = default;
+	};
+
+	struct MaterialKeyHash{
+		size_t operator()(const MaterialKey& key) const;
+	};
+
+	static ContentDeduplicator* GetInstance();
+
+	// 中身のハッシュ (FNV-1a。ファイルが読めなければ 0)
+	static uint64_t HashBytes(const std::byte* data,size_t size);
+	static uint64_t HashFile(const std::string& path);
+
+	// 同じ中身で最初に見たテクスチャ名 (ファイルが無ければそのまま返す)
+	std::string GetCanonicalTexture(const std::string& fileName);
+
+	// 色は 1/4096 に丸める (.mtl の小数6桁の違い程度は同じとみなす)
+	static MaterialKey MakeMaterialKey(const MeshData::MaterialData& data,const std::string& texture,const float uvScale[2],const float uvOffset[2]);
+
+	// --- 統計 ---
+	uint32_t GetTextureCount() const{ return textureCount_; }         // 調べた名前の数
+	uint32_t GetDuplicateCount() const{ return duplicateCount_; }     // 他の名前にまとめた数
+	uint64_t GetDuplicateBytes() const{ return duplicateBytes_; }     // まとめたファイルの合計 (読まずに済んだバイト数)
+	uint32_t GetHashedCount() const{ return hashedCount_; }           // ハッシュを取ったファイルの数
+
+private:
+	struct FileInfo{
+		std::string fileName;
+		uint64_t size = 0;
+		bool hasHash = false;
+		uint64_t hash = 0;
+	};
+
+	ContentDeduplicator() = default;
+	~ContentDeduplicator() = default;
+	ContentDeduplicator(const ContentDeduplicator&) = delete;
+	ContentDeduplicator& operator=(const ContentDeduplicator&) = delete;
+
+	uint64_t GetHash(FileInfo& file);
+
+	std::mutex mutex_;
+	std::unordered_map<std::string,std::string> canonicalNames_;
+	std::vector<FileInfo> files_;                                    // まとめ先になるファイル
+	std::unordered_map<uint64_t,std::vector<size_t>> filesBySize_; // 大きさ → files_ の番号
+
+	uint32_t textureCount_ = 0;
+	uint32_t duplicateCount_ = 0;
+	uint64_t duplicateBytes_ = 0;
+	uint32_t hashedCount_ = 0;
+};
@@ -0,0 +1,103 @@
+#include "CookedLevel.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+std::string CookedLevel::GetPath(const std::string& csvPath){
+	std::filesystem::path path(csvPath);
+	path.replace_extension(".kmap");
+	return path.generic_string();
+}
+
+bool CookedLevel::IsUpToDate(const std::string& csvPath){
+	// パックは AssetCooker がクックし終えてから作るので、入っていれば新しい
+	if(VirtualFileSystem::GetInstance()->IsPacked(GetPath(csvPath))){
+		return true;
+	}
+	std::error_code errorCode;
+	auto cookedTime = std::filesystem::last_write_time(GetPath(csvPath),errorCode);
+	if(errorCode){
+		return false;
+	}
+	auto sourceTime = std::filesystem::last_write_time(csvPath,errorCode);
+	if(errorCode){
+		return true; // 元がなければクック済みのものを使う
+	}
+	return cookedTime >= sourceTime;
+}
+
+bool CookedLevel::ParseCsv(const std::string& csvPath,Level& level){
+	FileView file;
+	if(!VirtualFileSystem::GetInstance()->Open(csvPath,file)){
+		return false;
+	}
+
+	std::vector<std::vector<uint8_t>> rows;
+	std::string_view text(reinterpret_cast<const char*>(file.GetData()),file.GetSize());
+	while(!text.empty()){
+		size_t lineEnd = text.find('\n');
+		std::string_view line = text.substr(0,lineEnd);
+		text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+		if(!line.empty() && line.back() == '\r'){
+			line.remove_suffix(1);
+		}
+		std::vector<uint8_t>& row = rows.emplace_back();
+		// (getline と同じく、最後の , の後ろが空ならセルにしない)
+		while(!line.empty()){
+			size_t wordEnd = line.find(',');
+			std::string_view word = line.substr(0,wordEnd);
+			line = wordEnd == std::string_view::npos ? std::string_view() : line.substr(wordEnd + 1);
+			uint32_t value = 0;
+			auto [end,errorCode] = std::from_chars(word.data(),word.data() + word.size(),value);
+			row.push_back(errorCode == std::errc() && end == word.data() + word.size() && value <= 255 ? static_cast<uint8_t>(value) : 0);
+		}
+	}
+	// 末尾の空行は除く
+	while(!rows.empty() && rows.back().empty()){
+		rows.pop_back();
+	}
+
+	level.height = static_cast<uint32_t>(rows.size());
+	level.width = 0;
+	for(const std::vector<uint8_t>& row : rows){
+		level.width = std::max(level.width,static_cast<uint32_t>(row.size()));
+	}
+	level.cells.assign(static_cast<size_t>(level.width) * level.height,0);
+	for(uint32_t y = 0; y < level.height; ++y){
+		std::copy(rows[y].begin(),rows[y].end(),level.cells.begin() + static_cast<size_t>(y) * level.width);
+	}
+	return true;
+}
+
+bool CookedLevel::Write(const Level& level,const std::string& path){
+	FileHeader header = {kMagic, kVersion, level.width, level.height};
+	std::ofstream file(path,std::ios::binary | std::ios::trunc);
+	if(!file.is_open()){
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+	file.write(reinterpret_cast<const char*>(level.cells.data()),static_cast<std::streamsize>(level.cells.size()));
+	return file.good();
+}
+
+bool CookedLevel::Read(const std::string& path,Level& level){
+	FileView file;
+	if(!VirtualFileSystem::GetInstance()->Open(path,file) || file.GetSize() < sizeof(FileHeader)){
+		return false;
+	}
+	FileHeader header;
+	std::memcpy(&header,file.GetData(),sizeof(header));
+	size_t cellCount = static_cast<size_t>(header.width) * header.height;
+	if(header.magic != kMagic || header.version != kVersion || file.GetSize() < sizeof(header) + cellCount){
+		return false;
+	}
+	level.width = header.width;
+	level.height = header.height;
+	const uint8_t* cells = reinterpret_cast<const uint8_t*>(file.GetData() + sizeof(header));
+	level.cells.assign(cells,cells + cellCount);
+	return true;
+}
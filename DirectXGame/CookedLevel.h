@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ==========================================
+// クック済みのマップチップ (.kmap)
+// CSV の各セルを数にして、[ヘッダ][セル (uint8、上の行から)] で書き出す
+// 数として読めないセルは 0 (空白) にする
+// ==========================================
+class CookedLevel{
+public:
+	static inline const uint32_t kMagic = 0x50414D4B; // "KMAP"
+	// 形式を変えたら上げる (古いファイルは読まずに CSV から読み直す)
+	static inline const uint32_t kVersion = 1;
+
+	struct Level{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> cells; // width * height
+	};
+
+	// Resources/MapChip.csv → Resources/MapChip.kmap
+	static std::string GetPath(const std::string& csvPath);
+	// クック済みファイルが元の CSV より新しい (かパックに入っている) なら true
+	static bool IsUpToDate(const std::string& csvPath);
+
+	static bool ParseCsv(const std::string& csvPath,Level& level);
+	static bool Write(const Level& level,const std::string& path);
+	static bool Read(const std::string& path,Level& level);
+
+private:
+	struct FileHeader{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+	};
+};
@@ -0,0 +1,275 @@
+#include "CookedMesh.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace{
+
+// 区画の境界
+const uint64_t kSectionAlignment = 16;
+
+uint64_t AlignUp(uint64_t value){
+	return (value + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+}
+
+// 頂点をビット列のまま比べるためのキー
+using VertexKey = std::array<uint32_t,sizeof(MeshData::Vertex) / sizeof(uint32_t)>;
+
+struct VertexKeyHash{
+	size_t operator()(const VertexKey& key) const{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for(uint32_t word : key){
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+		return static_cast<size_t>(hash);
+	}
+};
+
+// 文字列区画に追加して位置を返す
+uint32_t AddString(std::vector<char>& strings,const std::string& text){
+	uint32_t offset = static_cast<uint32_t>(strings.size());
+	strings.insert(strings.end(),text.begin(),text.end());
+	return offset;
+}
+
+} // namespace
+
+std::string CookedMesh::GetPath(const std::string& name,bool smoothing){
+	return "Resources/" + name + "/" + name + (smoothing ? ".smooth.kmesh" : ".kmesh");
+}
+
+bool CookedMesh::IsUpToDate(const std::string& name,bool smoothing){
+	// パックは AssetCooker がクックし終えてから作るので、入っていれば新しい
+	if(VirtualFileSystem::GetInstance()->IsPacked(GetPath(name,smoothing))){
+		return true;
+	}
+	std::error_code errorCode;
+	auto cookedTime = std::filesystem::last_write_time(GetPath(name,smoothing),errorCode);
+	if(errorCode){
+		return false;
+	}
+	auto sourceTime = std::filesystem::last_write_time("Resources/" + name + "/" + name + ".obj",errorCode);
+	if(errorCode){
+		return true; // 元がなければクック済みのものを使う
+	}
+	return cookedTime >= sourceTime;
+}
+
+void CookedMesh::WeldVertices(MeshData& meshData){
+	assert(meshData.lods.empty());
+	std::vector<MeshData::Vertex> vertices;
+	vertices.reserve(meshData.vertices.size());
+	std::unordered_map<VertexKey,uint32_t,VertexKeyHash> lookup;
+
+	for(MeshData::SubMesh& subMesh : meshData.subMeshes){
+		// メッシュをまたいだ共有はしない (メッシュごとに範囲を持つため)
+		lookup.clear();
+		uint32_t newOffset = static_cast<uint32_t>(vertices.size());
+		for(uint32_t i = 0; i < subMesh.indexCount; ++i){
+			uint32_t& index = meshData.indices[subMesh.indexOffset + i];
+			const MeshData::Vertex& vertex = meshData.vertices[subMesh.vertexOffset + index];
+			VertexKey key;
+			std::memcpy(key.data(),&vertex,sizeof(vertex));
+			auto [it,isInserted] = lookup.try_emplace(key,static_cast<uint32_t>(vertices.size()) - newOffset);
+			if(isInserted){
+				vertices.push_back(vertex);
+			}
+			index = it->second;
+		}
+		subMesh.vertexOffset = newOffset;
+		subMesh.vertexCount = static_cast<uint32_t>(vertices.size()) - newOffset;
+	}
+	meshData.vertices = std::move(vertices);
+}
+
+bool CookedMesh::Write(const MeshData& source,const std::string& path){
+	MeshData meshData = source;
+	// LOD は並べ替えた後の頂点で作り直す (古い段のインデックスは GenerateLods が捨てる)
+	meshData.lods.clear();
+	WeldVertices(meshData);
+	MeshOptimizer::Optimize(meshData);
+	MeshSimplifier::GenerateLods(meshData);
+
+	// 文字列
+	std::vector<char> strings;
+	std::vector<FileMaterial> materials;
+	for(const MeshData::MaterialData& data : meshData.materials){
+		FileMaterial material{};
+		std::memcpy(material.ambient,&data.ambient,sizeof(material.ambient));
+		std::memcpy(material.diffuse,&data.diffuse,sizeof(material.diffuse));
+		std::memcpy(material.specular,&data.specular,sizeof(material.specular));
+		material.alpha = data.alpha;
+		material.nameOffset = AddString(strings,data.name);
+		material.nameLength = static_cast<uint32_t>(data.name.size());
+		material.textureOffset = AddString(strings,data.textureFilename);
+		material.textureLength = static_cast<uint32_t>(data.textureFilename.size());
+		materials.push_back(material);
+	}
+	std::vector<FileSubMesh> subMeshes;
+	for(const MeshData::SubMesh& data : meshData.subMeshes){
+		FileSubMesh subMesh{};
+		subMesh.materialIndex = data.materialIndex;
+		subMesh.nameOffset = AddString(strings,data.name);
+		subMesh.nameLength = static_cast<uint32_t>(data.name.size());
+		subMesh.vertexOffset = data.vertexOffset;
+		subMesh.vertexCount = data.vertexCount;
+		subMesh.indexOffset = data.indexOffset;
+		subMesh.indexCount = data.indexCount;
+		subMeshes.push_back(subMesh);
+	}
+	std::vector<FileLod> lods;
+	std::vector<FileIndexRange> lodRanges;
+	for(const MeshData::Lod& data : meshData.lods){
+		lods.push_back({data.error, 0});
+		for(const MeshData::IndexRange& range : data.subMeshes){
+			lodRanges.push_back({range.offset, range.count});
+		}
+	}
+
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.numMaterials = static_cast<uint32_t>(materials.size());
+	header.numSubMeshes = static_cast<uint32_t>(subMeshes.size());
+	header.numVertices = static_cast<uint32_t>(meshData.vertices.size());
+	header.numIndices = static_cast<uint32_t>(meshData.indices.size());
+	header.nameOffset = AddString(strings,meshData.name);
+	header.nameLength = static_cast<uint32_t>(meshData.name.size());
+	header.numLods = static_cast<uint32_t>(lods.size());
+	header.stringBytes = static_cast<uint32_t>(strings.size());
+	header.materialsOffset = AlignUp(sizeof(FileHeader));
+	header.subMeshesOffset = AlignUp(header.materialsOffset + materials.size() * sizeof(FileMaterial));
+	header.verticesOffset = AlignUp(header.subMeshesOffset + subMeshes.size() * sizeof(FileSubMesh));
+	header.indicesOffset = AlignUp(header.verticesOffset + meshData.vertices.size() * sizeof(MeshData::Vertex));
+	header.stringsOffset = AlignUp(header.indicesOffset + meshData.indices.size() * sizeof(uint32_t));
+	header.lodsOffset = AlignUp(header.stringsOffset + strings.size());
+	header.lodRangesOffset = AlignUp(header.lodsOffset + lods.size() * sizeof(FileLod));
+
+	// 一度メモリ上に組み立ててから書く
+	std::vector<std::byte> image(header.lodRangesOffset + lodRanges.size() * sizeof(FileIndexRange));
+	std::memcpy(image.data(),&header,sizeof(header));
+	std::memcpy(image.data() + header.materialsOffset,materials.data(),materials.size() * sizeof(FileMaterial));
+	std::memcpy(image.data() + header.subMeshesOffset,subMeshes.data(),subMeshes.size() * sizeof(FileSubMesh));
+	std::memcpy(image.data() + header.verticesOffset,meshData.vertices.data(),meshData.vertices.size() * sizeof(MeshData::Vertex));
+	std::memcpy(image.data() + header.indicesOffset,meshData.indices.data(),meshData.indices.size() * sizeof(uint32_t));
+	std::memcpy(image.data() + header.stringsOffset,strings.data(),strings.size());
+	std::memcpy(image.data() + header.lodsOffset,lods.data(),lods.size() * sizeof(FileLod));
+	std::memcpy(image.data() + header.lodRangesOffset,lodRanges.data(),lodRanges.size() * sizeof(FileIndexRange));
+
+	std::ofstream file(path,std::ios::binary | std::ios::trunc);
+	if(!file.is_open()){
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(image.data()),static_cast<std::streamsize>(image.size()));
+	return file.good();
+}
+
+bool CookedMesh::Open(const std::string& path){
+	Close();
+	if(!VirtualFileSystem::GetInstance()->Open(path,file_)){
+		return false;
+	}
+
+	const std::byte* data = file_.GetData();
+	size_t size = file_.GetSize();
+	if(size < sizeof(FileHeader)){
+		Close();
+		return false;
+	}
+	FileHeader header;
+	std::memcpy(&header,data,sizeof(header));
+	if(header.magic != kMagic || header.version != kVersion){
+		Close();
+		return false;
+	}
+	// 区画がファイルに収まっているか
+	if(header.materialsOffset + uint64_t{header.numMaterials} * sizeof(FileMaterial) > size ||
+	   header.subMeshesOffset + uint64_t{header.numSubMeshes} * sizeof(FileSubMesh) > size ||
+	   header.verticesOffset + uint64_t{header.numVertices} * sizeof(MeshData::Vertex) > size ||
+	   header.indicesOffset + uint64_t{header.numIndices} * sizeof(uint32_t) > size ||
+	   header.stringsOffset + header.stringBytes > size ||
+	   header.lodsOffset + uint64_t{header.numLods} * sizeof(FileLod) > size ||
+	   header.lodRangesOffset + uint64_t{header.numLods} * header.numSubMeshes * sizeof(FileIndexRange) > size){
+		Close();
+		return false;
+	}
+
+	const char* strings = reinterpret_cast<const char*>(data + header.stringsOffset);
+	auto getString = [&](uint32_t offset,uint32_t length){
+		if(uint64_t{offset} + length > header.stringBytes){
+			return std::string();
+		}
+		return std::string(strings + offset,length);
+	};
+
+	name_ = getString(header.nameOffset,header.nameLength);
+
+	// マテリアルとメッシュの情報は小さいので写す
+	materials_.resize(header.numMaterials);
+	for(uint32_t i = 0; i < header.numMaterials; ++i){
+		FileMaterial material;
+		std::memcpy(&material,data + header.materialsOffset + i * sizeof(FileMaterial),sizeof(material));
+		MeshData::MaterialData& result = materials_[i];
+		std::memcpy(&result.ambient,material.ambient,sizeof(material.ambient));
+		std::memcpy(&result.diffuse,material.diffuse,sizeof(material.diffuse));
+		std::memcpy(&result.specular,material.specular,sizeof(material.specular));
+		result.alpha = material.alpha;
+		result.name = getString(material.nameOffset,material.nameLength);
+		result.textureFilename = getString(material.textureOffset,material.textureLength);
+	}
+	subMeshes_.resize(header.numSubMeshes);
+	for(uint32_t i = 0; i < header.numSubMeshes; ++i){
+		FileSubMesh subMesh;
+		std::memcpy(&subMesh,data + header.subMeshesOffset + i * sizeof(FileSubMesh),sizeof(subMesh));
+		MeshData::SubMesh& result = subMeshes_[i];
+		result.name = getString(subMesh.nameOffset,subMesh.nameLength);
+		result.materialIndex = subMesh.materialIndex < static_cast<int32_t>(header.numMaterials) ? subMesh.materialIndex : -1;
+		result.vertexOffset = subMesh.vertexOffset;
+		result.vertexCount = subMesh.vertexCount;
+		result.indexOffset = subMesh.indexOffset;
+		result.indexCount = subMesh.indexCount;
+		if(uint64_t{result.vertexOffset} + result.vertexCount > header.numVertices || uint64_t{result.indexOffset} + result.indexCount > header.numIndices){
+			Close();
+			return false;
+		}
+	}
+
+	lods_.resize(header.numLods);
+	for(uint32_t i = 0; i < header.numLods; ++i){
+		FileLod lod;
+		std::memcpy(&lod,data + header.lodsOffset + i * sizeof(FileLod),sizeof(lod));
+		lods_[i].error = lod.error;
+		lods_[i].subMeshes.resize(header.numSubMeshes);
+		for(uint32_t j = 0; j < header.numSubMeshes; ++j){
+			FileIndexRange range;
+			std::memcpy(&range,data + header.lodRangesOffset + (uint64_t{i} * header.numSubMeshes + j) * sizeof(FileIndexRange),sizeof(range));
+			if(uint64_t{range.offset} + range.count > header.numIndices){
+				Close();
+				return false;
+			}
+			lods_[i].subMeshes[j] = {range.offset, range.count};
+		}
+	}
+
+	// 頂点とインデックスはファイルの中を直接指す
+	vertices_ = {reinterpret_cast<const MeshData::Vertex*>(data + header.verticesOffset),header.numVertices};
+	indices_ = {reinterpret_cast<const uint32_t*>(data + header.indicesOffset),header.numIndices};
+	return true;
+}
+
+void CookedMesh::Close(){
+	file_.Close();
+	name_.clear();
+	materials_.clear();
+	subMeshes_.clear();
+	lods_.clear();
+	vertices_ = {};
+	indices_ = {};
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "MeshData.h"
+#include "VirtualFileSystem.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// ==========================================
+// クック済みメッシュ (.kmesh)
+// OBJ を読んで重複頂点を除き、平滑化した法線まで計算し終えたものをそのまま書き出す
+// 読む時はファイルをマップするだけで、頂点とインデックスはファイルの中身を直接指す (パックに入っていればパックの中)
+//
+// [ヘッダ][マテリアル][メッシュ][頂点 (VertexPosNormalUv)][インデックス (uint32)][文字列][LOD][LOD ごとのメッシュの範囲]
+// 各区画は16バイト境界に置く
+// ==========================================
+class CookedMesh{
+public:
+	static inline const uint32_t kMagic = 0x48534D4B; // "KMSH"
+	// 形式を変えたら上げる (古いファイルは読まずに OBJ から読み直す)
+	static inline const uint32_t kVersion = 2;
+
+	// Resources/<name>/<name>.kmesh (平滑化ありは .smooth.kmesh)
+	static std::string GetPath(const std::string& name,bool smoothing);
+	// クック済みファイルが元の OBJ より新しい (かパックに入っている) なら true
+	static bool IsUpToDate(const std::string& name,bool smoothing);
+
+	// 重複頂点を除き、GPU 向けに並べ替え、LOD を作ってから書き出す
+	static bool Write(const MeshData& meshData,const std::string& path);
+
+	// 重複する頂点をまとめてインデックスを付け直す (メッシュごと)
+	static void WeldVertices(MeshData& meshData);
+
+	bool Open(const std::string& path);
+	void Close();
+
+	const std::string& GetName() const{ return name_; }
+	const std::vector<MeshData::MaterialData>& GetMaterials() const{ return materials_; }
+	const std::vector<MeshData::SubMesh>& GetSubMeshes() const{ return subMeshes_; }
+	const std::vector<MeshData::Lod>& GetLods() const{ return lods_; }
+	std::span<const MeshData::Vertex> GetVertices() const{ return vertices_; }
+	std::span<const uint32_t> GetIndices() const{ return indices_; }
+
+private:
+	struct FileHeader{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t numMaterials;
+		uint32_t numSubMeshes;
+		uint32_t numVertices;
+		uint32_t numIndices;
+		uint32_t stringBytes;
+		uint32_t nameOffset; // 文字列区画内の位置
+		uint32_t nameLength;
+		uint32_t numLods;
+		uint32_t reserved[2];
+		uint64_t materialsOffset;
+		uint64_t subMeshesOffset;
+		uint64_t verticesOffset;
+		uint64_t indicesOffset;
+		uint64_t stringsOffset;
+		uint64_t lodsOffset;      // FileLod が numLods 個
+		uint64_t lodRangesOffset; // FileIndexRange が numLods * numSubMeshes 個
+	};
+
+	struct FileMaterial{
+		float ambient[3];
+		float diffuse[3];
+		float specular[3];
+		float alpha;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+		uint32_t textureOffset;
+		uint32_t textureLength;
+	};
+
+	struct FileSubMesh{
+		int32_t materialIndex;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+		uint32_t vertexOffset;
+		uint32_t vertexCount;
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		uint32_t reserved;
+	};
+
+	struct FileLod{
+		float error;
+		uint32_t reserved;
+	};
+
+	struct FileIndexRange{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	FileView file_;
+	std::string name_;
+	std::vector<MeshData::MaterialData> materials_;
+	std::vector<MeshData::SubMesh> subMeshes_;
+	std::vector<MeshData::Lod> lods_;
+	std::span<const MeshData::Vertex> vertices_;
+	std::span<const uint32_t> indices_;
+};
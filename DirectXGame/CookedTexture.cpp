@@ -0,0 +1,251 @@
+#include "CookedTexture.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#include <dxgiformat.h>
+#else
+// Windows 以外 (ツールを試す時) は使う値だけ用意する
+enum DXGI_FORMAT : uint32_t{
+	DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+	DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+	DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+};
+#endif
+#include <DDS.h>
+
+namespace{
+
+DXGI_FORMAT ToDxgiFormat(TextureCompressor::Format format){
+	switch(format){
+	case TextureCompressor::Format::kBC1:
+		return DXGI_FORMAT_BC1_UNORM_SRGB;
+	case TextureCompressor::Format::kBC3:
+		return DXGI_FORMAT_BC3_UNORM_SRGB;
+	default:
+		return DXGI_FORMAT_BC7_UNORM_SRGB;
+	}
+}
+
+// sRGB (8ビット) → 線形 (0 ～ 1)
+const float* GetSrgbToLinearTable(){
+	static const std::vector<float> table = [](){
+		std::vector<float> result(256);
+		for(int i = 0; i < 256; ++i){
+			float value = static_cast<float>(i) / 255.0f;
+			result[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f,2.4f);
+		}
+		return result;
+	}();
+	return table.data();
+}
+
+uint8_t LinearToSrgb(float value){
+	value = std::clamp(value,0.0f,1.0f);
+	float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value,1.0f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(srgb * 255.0f + 0.5f);
+}
+
+// 縮めた (伸ばした) 先の1画素に、元のどの画素がどれだけ重なるか
+struct Tap{
+	uint32_t index;
+	float weight;
+};
+
+std::vector<std::vector<Tap>> ComputeTaps(uint32_t sourceSize,uint32_t size){
+	std::vector<std::vector<Tap>> taps(size);
+	double scale = static_cast<double>(sourceSize) / size;
+	for(uint32_t i = 0; i < size; ++i){
+		double begin = i * scale;
+		double end = (i + 1) * scale;
+		if(scale < 1.0){
+			// 伸ばす時は画素の中心どうしで線形補間する
+			double center = (i + 0.5) * scale - 0.5;
+			double base = std::floor(center);
+			double t = center - base;
+			uint32_t index0 = static_cast<uint32_t>(std::clamp(base,0.0,sourceSize - 1.0));
+			uint32_t index1 = static_cast<uint32_t>(std::clamp(base + 1.0,0.0,sourceSize - 1.0));
+			taps[i].push_back({index0, static_cast<float>(1.0 - t)});
+			taps[i].push_back({index1, static_cast<float>(t)});
+			continue;
+		}
+		for(uint32_t j = static_cast<uint32_t>(begin); j < sourceSize && j < end; ++j){
+			double overlap = std::min(end,j + 1.0) - std::max(begin,static_cast<double>(j));
+			if(overlap > 1e-6){
+				taps[i].push_back({j, static_cast<float>(overlap / scale)});
+			}
+		}
+	}
+	return taps;
+}
+
+} // namespace
+
+std::string CookedTexture::GetCookedName(const std::string& fileName){
+	std::filesystem::path path(fileName);
+	path.replace_extension(".cooked.dds");
+	return path.generic_string();
+}
+
+bool CookedTexture::IsUpToDate(const std::string& fileName){
+	std::error_code errorCode;
+	auto cookedTime = std::filesystem::last_write_time("Resources/" + GetCookedName(fileName),errorCode);
+	if(errorCode){
+		return false;
+	}
+	auto sourceTime = std::filesystem::last_write_time("Resources/" + fileName,errorCode);
+	if(errorCode){
+		return true; // 元がなければクック済みのものを使う
+	}
+	return cookedTime >= sourceTime;
+}
+
+TextureCompressor::Format CookedTexture::ChooseFormat(const ImageData& image){
+	return image.IsOpaque() ? TextureCompressor::Format::kBC1 : TextureCompressor::Format::kBC7;
+}
+
+ImageData CookedTexture::Resize(const ImageData& image,uint32_t width,uint32_t height,uint32_t numThreads){
+	ImageData result;
+	result.width = width;
+	result.height = height;
+	result.pixels.resize(static_cast<size_t>(width) * height * 4);
+	const float* toLinear = GetSrgbToLinearTable();
+	std::vector<std::vector<Tap>> tapsX = ComputeTaps(image.width,width);
+	std::vector<std::vector<Tap>> tapsY = ComputeTaps(image.height,height);
+
+	ParallelFor(height,numThreads,[&](size_t y){
+		for(uint32_t x = 0; x < width; ++x){
+			// α を掛けた色と、掛けない色 (全部透明だった時に使う) を足し合わせる
+			float weighted[3] = {};
+			float plain[3] = {};
+			float alpha = 0.0f;
+			for(const Tap& tapY : tapsY[y]){
+				for(const Tap& tapX : tapsX[x]){
+					const uint8_t* pixel = image.GetPixel(tapX.index,tapY.index);
+					float weight = tapX.weight * tapY.weight;
+					float coverage = weight * (pixel[3] / 255.0f);
+					for(int c = 0; c < 3; ++c){
+						float linear = toLinear[pixel[c]];
+						weighted[c] += coverage * linear;
+						plain[c] += weight * linear;
+					}
+					alpha += coverage;
+				}
+			}
+			uint8_t* output = result.GetPixel(x,static_cast<uint32_t>(y));
+			for(int c = 0; c < 3; ++c){
+				output[c] = LinearToSrgb(alpha > 1e-6f ? weighted[c] / alpha : plain[c]);
+			}
+			output[3] = static_cast<uint8_t>(std::clamp(alpha,0.0f,1.0f) * 255.0f + 0.5f);
+		}
+	});
+	return result;
+}
+
+std::vector<ImageData> CookedTexture::GenerateMips(const ImageData& image,uint32_t numThreads,uint32_t maxLevels){
+	std::vector<ImageData> mips;
+	mips.push_back(image);
+	while((mips.back().width > 1 || mips.back().height > 1) && (maxLevels == 0 || mips.size() < maxLevels)){
+		const ImageData& source = mips.back();
+		mips.push_back(Resize(source,std::max(1u,source.width / 2),std::max(1u,source.height / 2),numThreads));
+	}
+	return mips;
+}
+
+bool CookedTexture::Write(const ImageData& image,TextureCompressor::Format format,const std::string& path,uint32_t numThreads,uint32_t maxMipLevels){
+	if(image.width == 0 || image.height == 0){
+		return false;
+	}
+
+	// 一番上の段は4の倍数にする
+	uint32_t width = (image.width + 3) / 4 * 4;
+	uint32_t height = (image.height + 3) / 4 * 4;
+	std::vector<ImageData> mips = GenerateMips(width == image.width && height == image.height ? image : Resize(image,width,height,numThreads),numThreads,maxMipLevels);
+
+	DirectX::DDS_HEADER header = {};
+	header.size = sizeof(DirectX::DDS_HEADER);
+	header.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_LINEARSIZE | DDS_HEADER_FLAGS_MIPMAP;
+	header.width = width;
+	header.height = height;
+	header.pitchOrLinearSize = static_cast<uint32_t>(TextureCompressor::GetCompressedSize(width,height,format));
+	header.mipMapCount = static_cast<uint32_t>(mips.size());
+	header.ddspf = DirectX::DDSPF_DX10;
+	header.caps = DDS_SURFACE_FLAGS_TEXTURE | (mips.size() > 1 ? DDS_SURFACE_FLAGS_MIPMAP : 0);
+
+	DirectX::DDS_HEADER_DXT10 extension = {};
+	extension.dxgiFormat = ToDxgiFormat(format);
+	extension.resourceDimension = DirectX::DDS_DIMENSION_TEXTURE2D;
+	extension.arraySize = 1;
+	extension.miscFlags2 = format == TextureCompressor::Format::kBC1 ? DirectX::DDS_ALPHA_MODE_OPAQUE : DirectX::DDS_ALPHA_MODE_STRAIGHT;
+
+	std::ofstream file(path,std::ios::binary);
+	if(!file.is_open()){
+		return false;
+	}
+	uint32_t magic = DirectX::DDS_MAGIC;
+	file.write(reinterpret_cast<const char*>(&magic),sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+	file.write(reinterpret_cast<const char*>(&extension),sizeof(extension));
+	for(const ImageData& mip : mips){
+		std::vector<uint8_t> blocks = TextureCompressor::Compress(mip,format,numThreads);
+		file.write(reinterpret_cast<const char*>(blocks.data()),static_cast<std::streamsize>(blocks.size()));
+	}
+	return file.good();
+}
+
+bool CookedTexture::Read(const std::string& path,TextureCompressor::Format& format,std::vector<ImageData>& mips){
+	mips.clear();
+	MappedFile file;
+	if(!file.Open(path)){
+		return false;
+	}
+	const size_t headerSize = sizeof(uint32_t) + sizeof(DirectX::DDS_HEADER) + sizeof(DirectX::DDS_HEADER_DXT10);
+	if(file.GetSize() < headerSize){
+		return false;
+	}
+	uint32_t magic;
+	DirectX::DDS_HEADER header;
+	DirectX::DDS_HEADER_DXT10 extension;
+	const std::byte* data = file.GetData();
+	std::memcpy(&magic,data,sizeof(magic));
+	std::memcpy(&header,data + sizeof(magic),sizeof(header));
+	std::memcpy(&extension,data + sizeof(magic) + sizeof(header),sizeof(extension));
+	if(magic != DirectX::DDS_MAGIC || header.ddspf.fourCC != DirectX::DDSPF_DX10.fourCC){
+		return false;
+	}
+	switch(extension.dxgiFormat){
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+		format = TextureCompressor::Format::kBC1;
+		break;
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+		format = TextureCompressor::Format::kBC3;
+		break;
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		format = TextureCompressor::Format::kBC7;
+		break;
+	default:
+		return false;
+	}
+
+	const uint8_t* current = reinterpret_cast<const uint8_t*>(data) + headerSize;
+	const uint8_t* end = reinterpret_cast<const uint8_t*>(data) + file.GetSize();
+	uint32_t width = header.width;
+	uint32_t height = header.height;
+	for(uint32_t level = 0; level < std::max(1u,header.mipMapCount); ++level){
+		size_t size = TextureCompressor::GetCompressedSize(width,height,format);
+		if(static_cast<size_t>(end - current) < size){
+			mips.clear();
+			return false;
+		}
+		mips.push_back(TextureCompressor::Decompress(std::span<const uint8_t>(current,size),width,height,format));
+		current += size;
+		width = std::max(1u,width / 2);
+		height = std::max(1u,height / 2);
+	}
+	return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "ImageData.h"
+#include "TextureCompressor.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ==========================================
+// クック済みテクスチャ (.cooked.dds)
+// PNG を読んでミップマップを全段作り、ブロック圧縮した DDS (DX10 ヘッダ、*_UNORM_SRGB) を書き出す
+// 不透明なら BC1 (1/8)、α があれば BC7 (1/4) にする
+// 一番上の段は4の倍数でないと GPU に作れないので、合わない時は近い大きさに伸ばす
+// ==========================================
+class CookedTexture{
+public:
+	// Resources/ からの相対のテクスチャ名 → クック済みの名前 (sample.png → sample.cooked.dds)
+	static std::string GetCookedName(const std::string& fileName);
+	// クック済みファイルが元の画像より新しければ true
+	static bool IsUpToDate(const std::string& fileName);
+
+	// 不透明なら BC1、そうでなければ BC7
+	static TextureCompressor::Format ChooseFormat(const ImageData& image);
+
+	// [0] が元の画像で、1x1 まで (maxLevels が 0 でなければその段数まで) 半分ずつ縮める
+	// sRGB を線形に戻し、α で重み付けして平均する (透明な所の色がにじまないように)
+	static std::vector<ImageData> GenerateMips(const ImageData& image,uint32_t numThreads = 0,uint32_t maxLevels = 0);
+	// 大きさを変える (面積の重なりで平均する。伸ばす時は近い2画素の補間になる)
+	static ImageData Resize(const ImageData& image,uint32_t width,uint32_t height,uint32_t numThreads = 0);
+
+	// maxMipLevels が 0 なら全段 (アトラスのように隣の画像がにじむものは段数を抑える)
+	static bool Write(const ImageData& image,TextureCompressor::Format format,const std::string& path,uint32_t numThreads = 0,uint32_t maxMipLevels = 0);
+	// 書いた DDS を読んで全段を展開する (ツールでの確認用)
+	static bool Read(const std::string& path,TextureCompressor::Format& format,std::vector<ImageData>& mips);
+};
@@ -1,6 +1,7 @@
 #include "DeathParticles.h"
+#include "FixedTimestep.h"
 
-void DeathParticles::Initialize(Model* model, Camera* camera, const Vector3& position) {
+void DeathParticles::Initialize(MeshModel* model, Camera* camera, const Vector3& position) {
 
 	// 02_11_13枚目 モデルとカメラを退避
 	model_ = model;
@@ -9,14 +10,26 @@ void DeathParticles::Initialize(Model* model, Camera* camera, const Vector3& pos
 	// 02_11_11枚目 ワールド変換の初期化
 	for (auto& worldTransform : worldTransforms_) {
 		worldTransform.Initialize();
-		worldTransform.translation_ = position;
 	}
 
 	// 02_11_31枚目
 	objectColor_.Initialize();
 
+	Reset(position);
+}
+
+void DeathParticles::Reset(const Vector3& position) {
+
+	for (auto& worldTransform : worldTransforms_) {
+		worldTransform.translation_ = position;
+	}
+
 	// 02_11_31枚目
 	color_ = {1, 1, 1, 1};
+	objectColor_.SetColor(color_);
+
+	counter_ = 0.0f;
+	isFinished_ = false;
 }
 
 void DeathParticles::Update() {
@@ -27,7 +40,7 @@ void DeathParticles::Update() {
 	}
 
 	// 02_11_26枚目  カウンターを1フレーム分の秒数進める
-	counter_ += 1.0f / 60.0f;
+	counter_ += FixedTimestep::kDeltaTime;
 
 	// 02_11_26枚目  存続時間の上限に達したら
 	if (counter_ >= kDuration_) {
@@ -36,23 +49,9 @@ void DeathParticles::Update() {
 		isFinished_ = true;
 	}
 
-	// 02_11_23枚目
+	// 02_11_23枚目 速度ベクトル (回転させた結果は kVelocities_ の表にある) で移動する
 	for (uint32_t i = 0; i < kNumParticles; ++i) {
-		// 基本となる速度ベクトル
-		Vector3 velocity = {kSpeed_, 0, 0};
-
-		// 回転角を計算する
-		float angle = kAngleUnit_ * i;
-
-		// Z軸まわり回転行列
-		Matrix4x4 matrixRotation = MakeRotateZMatrix(angle);
-
-		// 基本ベクトルを回転させて速度ベクトルを得る
-		// オリジナル数学関数ファイルにTransform関数追加
-		velocity = Transform(velocity, matrixRotation);
-
-		// 移動処理
-		worldTransforms_[i].translation_ += velocity;
+		worldTransforms_[i].translation_ += kVelocities_[i];
 	}
 
 	// 02_11_32枚目
@@ -1,6 +1,7 @@
 #pragma once
 #include "KamataEngine.h"
 #include "Math.h"
+#include "MeshModel.h"
 #include <algorithm>
 #include <array>
 #include <numbers>
@@ -9,7 +10,9 @@
 class DeathParticles {
 public:
 	// 02_11_8枚目 Initialize,Update,Draw関数追加
-	void Initialize(Model* model, Camera* camera, const Vector3& position);
+	void Initialize(MeshModel* model, Camera* camera, const Vector3& position);
+	// 2回目からの死亡用。定数バッファは作り直さず、位置・色・経過時間だけを最初に戻す
+	void Reset(const Vector3& position);
 	void Update();
 	void Draw();
 
@@ -18,13 +21,13 @@ public:
 
 private:
 	// 02_11_10枚目パーティクルの個数
-	static inline const uint32_t kNumParticles = 8;
+	static inline constexpr uint32_t kNumParticles = 8;
 
 	// 02_11_10枚目パーティクル座標配列
 	std::array<WorldTransform, kNumParticles> worldTransforms_;
 
 	// 02_11_13枚目 モデル
-	Model* model_ = nullptr;
+	MeshModel* model_ = nullptr;
 
 	// 02_11_13枚目 カメラ
 	Camera* camera_ = nullptr;
@@ -33,10 +36,14 @@ private:
 	static inline const float kDuration_ = 2.0f;
 
 	// 02_11_22枚目 移動の速さ
-	static inline const float kSpeed_ = 0.05f;
+	static inline constexpr float kSpeed_ = 0.05f;
 
 	// 02_11_22枚目 分割した1個分の角度(#include <numbers>)
-	static inline const float kAngleUnit_ = 2.0f * std::numbers::pi_v<float> / kNumParticles;
+	static inline constexpr float kAngleUnit_ = 2.0f * std::numbers::pi_v<float> / kNumParticles;
+
+	// 各パーティクルの速度 ({kSpeed_, 0, 0} を Z 軸まわりに kAngleUnit_ * i 回したもの)
+	// 方向は決まっているので、毎フレーム回転行列を作らずにコンパイル時に表にしておく
+	static inline constexpr std::array<Vector3, kNumParticles> kVelocities_ = MakeCircleDirections<kNumParticles>(kSpeed_);
 
 	// 02_11_25枚目 終了フラグ
 	bool isFinished_ = false;
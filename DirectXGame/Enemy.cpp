@@ -1,127 +1,138 @@
 #include "Enemy.h"
-#include "GameScene.h"
+#include "FixedTimestep.h"
 #include "Math.h"
-#include "Player.h"
-#include <cassert>
+#include "RenderResourcePool.h"
+#include "VisibilityCuller.h"
 #include <numbers>
 
-void Enemy::Initialize(Model* model,Camera* camera,const Vector3& position,Type type){
-	assert(model);
-	model_ = model;
-	camera_ = camera;
+Entity Enemy::Create(EntityWorld& world,const Vector3& position,Type type){
+	TransformComponent transform;
+	transform.translation = position;
+	transform.rotation.y = std::numbers::pi_v<float> *3.0f / 2.0f;
 
+	State state;
 	// タイプを保存
-	type_ = type;
-
-	worldTransform_.Initialize();
-	worldTransform_.translation_ = position;
-	worldTransform_.rotation_.y = std::numbers::pi_v<float> *3.0f / 2.0f;
-
-	fireTimer_ = 120 + (rand() % 180);
+	state.type = type;
+	state.fireTimer = 120 + (rand() % 180);
 
 	// ★追加: タイプごとの設定
-	objectColor_.Initialize(); // 色用
+	ColorComponent color;
 
-	if(type_ == Type::kScarecrow){
+	if(type == Type::kScarecrow){
 		// --- カカシの設定 ---
-		hp_ = 9999; // 死なないように
-		velocity_ = {0, 0, 0}; // 動かない
-		objectColor_.SetColor({0.5f, 1.0f, 0.5f, 1.0f}); // 緑色
-		worldTransform_.scale_ = {1.5f, 1.5f, 1.5f}; // 普通サイズ
-	} // Enemy.cpp Initialize内 (ボスの設定部分)
+		state.hp = 9999; // 死なないように
+		color.color = {0.5f, 1.0f, 0.5f, 1.0f}; // 緑色
+		transform.scale = {1.5f, 1.5f, 1.5f}; // 普通サイズ
+	}
 
-	else if(type_ == Type::kBoss){
-		hp_ = 10;
-		objectColor_.SetColor({1.0f, 0.0f, 0.0f, 1.0f}); // 赤色で威圧感
+	else if(type == Type::kBoss){
+		state.hp = 10;
+		color.color = {1.0f, 0.0f, 0.0f, 1.0f}; // 赤色で威圧感
 
 		// Blenderで作ったモデルサイズに合わせて倍率を調整
 		// もしBlenderですでに大きく作っていたら 1.0f でもOK
-		worldTransform_.scale_ = {2.0f, 2.0f, 2.0f};
-
-		// ボスはゆっくり回転させると巨大感が出る
-		velocity_ = {-0.01f, 0, 0}; // 移動はゆっくり
+		transform.scale = {2.0f, 2.0f, 2.0f};
 	}
 
-	walkTimer = 0.0f;
+	PrevTransformComponent prevTransform{transform.rotation, transform.translation};
+
+	return world.Create(transform,prevTransform,color,state);
 }
 
 // 02_09 スライド5枚目
-void Enemy::Update(){
-
-	// 変更リクエストがあったら
-	if(behaviorRequest_ != Behavior::kUnknown){
-		// 振るまいを変更する
-		behavior_ = behaviorRequest_;
-
-		// 各振るまいごとの初期化を実行
-		switch(behavior_){
-		case Behavior::kDefeated:
-		default:
-			counter_ = 0;
-			break;
+void Enemy::UpdateAll(EntityWorld& world){
+	world.ForEach<TransformComponent,PrevTransformComponent,State>([](Entity,TransformComponent& transform,PrevTransformComponent& prevTransform,State& state){
+		// 描画補間用に前ティックの姿勢を残す
+		prevTransform.rotation = transform.rotation;
+		prevTransform.translation = transform.translation;
+
+		// 変更リクエストがあったら
+		if(state.behaviorRequest != Behavior::kUnknown){
+			// 振るまいを変更する
+			state.behavior = state.behaviorRequest;
+
+			// 各振るまいごとの初期化を実行
+			switch(state.behavior){
+			case Behavior::kDefeated:
+			default:
+				state.counter = 0;
+				break;
+			}
+
+			// 振るまいリクエストをリセット
+			state.behaviorRequest = Behavior::kUnknown;
 		}
 
-		// 振るまいリクエストをリセット
-		behaviorRequest_ = Behavior::kUnknown;
-	}
-
-	// 02_15 13枚目
-	switch(behavior_){
-		// 歩行
-	case Behavior::kWalk:
-		// 02_09 16枚目 移動
-		//worldTransform_.translation_ += velocity_;
-
-		//// 02_09 20枚目
-		//walkTimer += 1.0f / 60.0f;
-
-		//// 02_09 23枚目 回転アニメーション
-		//worldTransform_.rotation_.x = std::sin(std::numbers::pi_v<float> *2.0f * walkTimer / kWalkMotionTime);
-
-		// 02_09 スライド8枚目 ワールド行列更新
-		WorldTransformUpdate(worldTransform_);
-		break;
-		// やられ
-	case Behavior::kDefeated:
-		// 02_15 15枚目
-		counter_ += 1.0f / 60.0f;
-
-		worldTransform_.rotation_.y += 0.3f;
-		worldTransform_.rotation_.x = EaseOut(ToRadians(kDefeatedMotionAngleStart),ToRadians(kDefeatedMotionAngleEnd),counter_ / kDefeatedTime);
+		// 02_15 13枚目
+		switch(state.behavior){
+			// 歩行
+		case Behavior::kWalk:
+			// (今は動かない。行列は描画時に作る)
+			break;
+			// やられ
+		case Behavior::kDefeated:
+			// 02_15 15枚目
+			state.counter += FixedTimestep::kDeltaTime;
 
-		WorldTransformUpdate(worldTransform_);
+			transform.rotation.y += 0.3f;
+			transform.rotation.x = EaseOut(ToRadians(kDefeatedMotionAngleStart),ToRadians(kDefeatedMotionAngleEnd),state.counter / kDefeatedTime);
 
-		if(counter_ >= kDefeatedTime){
-			isDead_ = true;
+			if(state.counter >= kDefeatedTime){
+				state.isDead = true;
+			}
+			break;
+		default:
+			break;
 		}
-		break;
-	}
+	});
 }
 
-void Enemy::Draw(){
-	// ★変更: 色を渡して描画
-	model_->Draw(worldTransform_,*camera_,&objectColor_);
+void Enemy::DrawAll(EntityWorld& world,MeshModel* model,const Camera& camera,RenderResourcePool& renderResourcePool,VisibilityCuller& culler,float alpha){
+	// 1. 補間した位置でモデルを囲む箱を積み、画面の外の敵を除く
+	uint32_t first = culler.GetTestedCount();
+	world.ForEach<TransformComponent,PrevTransformComponent,ColorComponent>([&](Entity,TransformComponent& transform,PrevTransformComponent& prevTransform,ColorComponent&){
+		Vector3 center;
+		Vector3 extent;
+		model->GetWorldBoundingBox(MakeAffineMatrix(transform.scale,Lerp(prevTransform.rotation,transform.rotation,alpha),Lerp(prevTransform.translation,transform.translation,alpha)),
+		                           center,extent);
+		culler.AddBox(center,extent);
+	});
+	culler.Cull();
+
+	// 2. 見える敵だけ描く (ForEach の順は 1. と同じ)
+	uint32_t index = first;
+	world.ForEach<TransformComponent,PrevTransformComponent,ColorComponent>([&](Entity,TransformComponent& transform,PrevTransformComponent& prevTransform,ColorComponent& color){
+		if(!culler.IsVisible(index++)){
+			return;
+		}
+		// 前ティックと今ティックの間を補間して描く (止まっている敵は転送されない)
+		const WorldTransform& worldTransform = renderResourcePool.AcquireTransform(
+		    transform.scale,Lerp(prevTransform.rotation,transform.rotation,alpha),Lerp(prevTransform.translation,transform.translation,alpha));
+
+		// ★変更: 色を渡して描画
+		ObjectColor& objectColor = renderResourcePool.AcquireColor();
+		objectColor.SetColor(color.color);
+		model->Draw(worldTransform,camera,&objectColor);
+	});
 }
 
-void Enemy::OnCollision(const Player* player){
+void Enemy::OnCollision(State& state){
 	// 既に死んでるなら何もしない
-	if(behavior_ == Behavior::kDefeated){
+	if(state.behavior == Behavior::kDefeated){
 		return;
 	}
 
-	(void)player; // 警告消し
-
-	hp_ = 0; // HPを0にする
-	behaviorRequest_ = Behavior::kDefeated; // 即座に死亡状態へ遷移
+	state.hp = 0; // HPを0にする
+	state.behaviorRequest = Behavior::kDefeated; // 即座に死亡状態へ遷移
 
 	// 当たり判定を無効化（死体に当たらないようにする）
-	isCollisionDisabled_ = true;
+	state.isCollisionDisabled = true;
 }
 
 // 02_10 スライド14枚目
-AABB Enemy::GetAABB(){
+AABB Enemy::GetAABB(const TransformComponent& transform){
 
-	Vector3 worldPos = GetWorldPosition();
+	Vector3 worldPos = GetWorldPosition(transform);
 
 	AABB aabb;
 
@@ -131,36 +142,23 @@ AABB Enemy::GetAABB(){
 	return aabb;
 }
 
-// 02_10 スライド14枚目
-Vector3 Enemy::GetWorldPosition(){
-
-	Vector3 worldPos;
-
-	// ワールド行列の平行移動成分を取得（ワールド座標）
-	worldPos.x = worldTransform_.matWorld_.m[3][0];
-	worldPos.y = worldTransform_.matWorld_.m[3][1];
-	worldPos.z = worldTransform_.matWorld_.m[3][2];
-
-	return worldPos;
-}
-
-bool Enemy::IsTimeToFire() {
+bool Enemy::IsTimeToFire(State& state) {
 	// 既に死んでいたら撃たない
-	if (behavior_ == Behavior::kDefeated) {
+	if (state.behavior == Behavior::kDefeated) {
 		return false;
 	}
 
 	// タイマーを減らす
-	fireTimer_--;
+	state.fireTimer--;
 
 	// タイマーが0になったら発射！
-	if (fireTimer_ <= 0) {
+	if (state.fireTimer <= 0) {
 		// 次の発射までの時間をセット (ここも少しランダムにするとさらに良い)
 		// 例: 120フレーム(2秒) + ランダム60フレーム(1秒)
-		fireTimer_ = 120 + (rand() % 60);
-		
+		state.fireTimer = 120 + (rand() % 60);
+
 		return true; // 「撃ってよし！」と返す
 	}
 
 	return false; // まだ待ち
-}
\ No newline at end of file
+}
@@ -1,77 +1,59 @@
 #pragma once
 
 #include "KamataEngine.h"
+#include "EnemyState.h"
+#include "EntityWorld.h"
+#include "GameComponents.h"
 #include "Math.h"
-#include "Player.h"
+#include "MeshModel.h"
 
 using namespace KamataEngine;
 
-// 02_10 20枚目
-// class Player;
-class GameScene;
+class RenderResourcePool;
+class VisibilityCuller;
 
 // 02_09 スライド4枚目
+// 敵は EntityWorld のエンティティとして持つ
+// (TransformComponent + PrevTransformComponent + ColorComponent + Enemy::State)
+// このクラスは敵エンティティの生成・更新・描画をまとめたもの
 class Enemy{
 
 public:
 	// ★追加: 敵の種類
-	enum class Type{
-		kScarecrow, // カカシ (練習用・無敵)
-		kBoss,      // ボス (倒すとクリア)
-	};
+	using Type = EnemyType;
 
 	// 02_15 13枚目 振るまい
-	enum class Behavior{
-		kUnknown = -1, // 無効な状態
-		kWalk,         // 歩行状態
-		kDefeated,     // やられ状態
-	};
+	using Behavior = EnemyBehavior;
+
+	// 敵ごとの状態 (コンポーネント。中身は EnemyState.h)
+	using State = EnemyState;
 
 	// 02_09 スライド5枚目
-	// ★変更: 引数に type を追加
-	void Initialize(Model* model,Camera* camera,const Vector3& position,Type type);
+	// 敵エンティティを生成する
+	static Entity Create(EntityWorld& world,const Vector3& position,Type type);
 
 	// 02_09 スライド5枚目
-	void Update();
+	// 全ての敵を更新
+	static void UpdateAll(EntityWorld& world);
 	// 02_09 スライド5枚目
-	void Draw();
+	// 画面に入る敵を描画 (alpha: 前ティックとの補間率。囲む形は culler に積んで判定する)
+	static void DrawAll(EntityWorld& world,MeshModel* model,const Camera& camera,RenderResourcePool& renderResourcePool,VisibilityCuller& culler,float alpha);
+
 	// 02_10 スライド14枚目
-	AABB GetAABB();
+	static AABB GetAABB(const TransformComponent& transform);
 	// 02_10 スライド14枚目 ワールド座標を取得
-	Vector3 GetWorldPosition();
-	// 02_10 スライド20枚目 衝突応答
-	void OnCollision(const Player* player);
-	// 02_15 6枚目
-	bool IsDead() const{ return isDead_; }
-	// 02_15 20枚目
-	bool IsCollisionDisabled() const{ return isCollisionDisabled_; }
-	// 02_16 19
-	void SetGameScene(GameScene* gameScene){ gameScene_ = gameScene; }
-
-	// ★追加: 外部からタイプを確認する用 (クリア判定などで使用)
-	Type GetType() const{ return type_; }
-
-	bool IsTimeToFire();
-
-
-	void SetScale(const Vector3& scale){ worldTransform_.scale_ = scale; }
-
+	static Vector3 GetWorldPosition(const TransformComponent& transform){ return transform.translation; }
 	// 今のサイズ（半径として使う用）を取得する関数
-	float GetRadius() const{ return worldTransform_.scale_.x; }
+	static float GetRadius(const TransformComponent& transform){ return transform.scale.x; }
+
+	// 02_10 スライド20枚目 衝突応答
+	static void OnCollision(State& state);
 
+	static bool IsTimeToFire(State& state);
 
 private:
-	// 02_09 6枚目 ザ・ワールド
-	WorldTransform worldTransform_;
-	// 02_09 6枚目 モデル
-	Model* model_ = nullptr;
-	// 02_09 6枚目 カメラ
-	Camera* camera_ = nullptr;
-
 	// 02_09 15枚目
 	static inline const float kWalkSpeed = 0.02f;
-	// 02_09 15枚目
-	Vector3 velocity_ = {};
 
 	// 02_09 19枚目
 	static inline const float kWalkMotionAngleStart = 0.0f;
@@ -79,37 +61,13 @@ private:
 	static inline const float kWalkMotionAngleEnd = 30.0f;
 	// 02_09 19枚目
 	static inline const float kWalkMotionTime = 1.0f;
-	// 02_09 20枚目
-	float walkTimer = 0.0f;
 
 	// 02_10 14枚目 当たり判定サイズ
 	static inline const float kWidth = 0.8f;
 	static inline const float kHeight = 0.8f;
 
-	// 02_15 6枚目
-	bool isDead_ = false;
-
-	// 02_15 13枚目
-	Behavior behavior_ = Behavior::kWalk;
-	Behavior behaviorRequest_ = Behavior::kUnknown;
-
 	// 02_15 15枚目
 	static inline const float kDefeatedTime = 0.6f;
 	static inline const float kDefeatedMotionAngleStart = 0.0f;
 	static inline const float kDefeatedMotionAngleEnd = -60.0f;
-	float counter_ = 0.0f; // カウンター
-
-	// 02_15 20枚目
-	bool isCollisionDisabled_ = false;
-	// 02_16 19
-	GameScene* gameScene_ = nullptr;
-
-	// ★追加: 敵パラメータ
-	int hp_ = 0;
-	Type type_ = Type::kScarecrow;
-
-	// ★追加: 色変え用の変数 (カカシとボスを見分けるため)
-	KamataEngine::ObjectColor objectColor_;
-
-	int fireTimer_ = 0;
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+// ==========================================
+// 敵エンティティのコンポーネント (Enemy::State)
+// Enemy.h は描画のためにエンジンを読むので、コンポーネントだけここに分ける
+// (D3D を使わないので AssetCooker の計測でも同じ型を使う)
+// ==========================================
+
+// 敵の種類 (Enemy::Type)
+enum class EnemyType{
+	kScarecrow, // カカシ (練習用・無敵)
+	kBoss,      // ボス (倒すとクリア)
+};
+
+// 02_15 13枚目 振るまい (Enemy::Behavior)
+enum class EnemyBehavior{
+	kUnknown = -1, // 無効な状態
+	kWalk,         // 歩行状態
+	kDefeated,     // やられ状態
+};
+
+// 敵ごとの状態 (Enemy::State)
+struct EnemyState{
+	EnemyType type = EnemyType::kScarecrow;
+	EnemyBehavior behavior = EnemyBehavior::kWalk;
+	EnemyBehavior behaviorRequest = EnemyBehavior::kUnknown;
+	float counter = 0.0f; // カウンター
+	int hp = 0;
+	int fireTimer = 0;
+	bool isCollisionDisabled = false;
+	bool isDead = false;
+};
@@ -0,0 +1,287 @@
+#include "EntityWorld.h"
+
+std::vector<EntityWorld::ComponentInfo>& EntityWorld::ComponentInfos(){
+	static std::vector<ComponentInfo> infos;
+	return infos;
+}
+
+uint32_t EntityWorld::RegisterComponent(size_t size,size_t align){
+	std::vector<ComponentInfo>& infos = ComponentInfos();
+	assert(infos.size() < kMaxComponentTypes);
+	infos.push_back({size,align});
+	return static_cast<uint32_t>(infos.size() - 1);
+}
+
+Entity EntityWorld::AllocateEntity(){
+	uint32_t index;
+	if(!freeIndices_.empty()){
+		index = freeIndices_.back();
+		freeIndices_.pop_back();
+	}
+	else{
+		index = static_cast<uint32_t>(records_.size());
+		records_.emplace_back();
+	}
+	Record& record = records_[index];
+	record.archetype = nullptr;
+	record.isReserved = false;
+	return {index,record.generation};
+}
+
+void EntityWorld::FreeEntity(Entity entity){
+	Record& record = records_[entity.index];
+	record.archetype = nullptr;
+	record.isReserved = false;
+	// 世代を進めて古いエンティティを無効にする (0 は無効値なので飛ばす)
+	if(++record.generation == 0){
+		record.generation = 1;
+	}
+	freeIndices_.push_back(entity.index);
+}
+
+bool EntityWorld::IsAlive(Entity entity) const{
+	if(entity.generation == 0 || entity.index >= records_.size()){
+		return false;
+	}
+	const Record& record = records_[entity.index];
+	return record.generation == entity.generation && record.archetype != nullptr;
+}
+
+EntityWorld::Archetype& EntityWorld::GetOrCreateArchetype(ComponentMask mask){
+	auto it = archetypes_.find(mask);
+	if(it != archetypes_.end()){
+		return *it->second;
+	}
+
+	auto archetype = std::make_unique<Archetype>();
+	archetype->mask = mask;
+
+	// チャンク内に [A A A ...][B B B ...] の順で配列を並べる
+	const std::vector<ComponentInfo>& infos = ComponentInfos();
+	size_t offset = 0;
+	for(uint32_t id = 0; id < kMaxComponentTypes; ++id){
+		if((mask & (ComponentMask{1} << id)) == 0){
+			continue;
+		}
+		const ComponentInfo& info = infos[id];
+		offset = (offset + info.align - 1) / info.align * info.align;
+		archetype->componentIds.push_back(id);
+		archetype->offsets[id] = offset;
+		offset += info.size * kChunkCapacity;
+	}
+	archetype->chunkBytes = offset;
+
+	// 既存のクエリのうち、条件を満たすものに追加
+	for(auto& [queryMask,list] : queries_){
+		if((mask & queryMask) == queryMask){
+			list.push_back(archetype.get());
+		}
+	}
+
+	Archetype& result = *archetype;
+	archetypes_.emplace(mask,std::move(archetype));
+	return result;
+}
+
+const std::vector<EntityWorld::Archetype*>& EntityWorld::GetQuery(ComponentMask mask){
+	auto it = queries_.find(mask);
+	if(it != queries_.end()){
+		return it->second;
+	}
+
+	std::vector<Archetype*>& list = queries_[mask];
+	for(auto& [archetypeMask,archetype] : archetypes_){
+		if((archetypeMask & mask) == mask){
+			list.push_back(archetype.get());
+		}
+	}
+	return list;
+}
+
+uint32_t EntityWorld::AllocateRow(Archetype& archetype,Entity entity){
+	uint32_t row = archetype.count;
+	uint32_t chunkIndex = row / kChunkCapacity;
+	// チャンクは解放せずに取っておくので、足りない時だけ確保する
+	if(chunkIndex == archetype.chunks.size()){
+		auto chunk = std::make_unique<Chunk>();
+		chunk->data = std::make_unique<std::byte[]>(archetype.chunkBytes == 0 ? 1 : archetype.chunkBytes);
+		archetype.chunks.push_back(std::move(chunk));
+	}
+	archetype.chunks[chunkIndex]->entities[row % kChunkCapacity] = entity;
+	++archetype.count;
+	return row;
+}
+
+void EntityWorld::RemoveRow(Archetype& archetype,uint32_t row){
+	uint32_t last = archetype.count - 1;
+	if(row != last){
+		// 末尾の行で穴を埋める
+		for(uint32_t id : archetype.componentIds){
+			std::memcpy(GetComponentPtr(archetype,id,row),GetComponentPtr(archetype,id,last),ComponentInfos()[id].size);
+		}
+		Entity moved = archetype.chunks[last / kChunkCapacity]->entities[last % kChunkCapacity];
+		archetype.chunks[row / kChunkCapacity]->entities[row % kChunkCapacity] = moved;
+		records_[moved.index].row = row;
+	}
+	--archetype.count;
+}
+
+void EntityWorld::MoveEntity(Entity entity,Archetype& to){
+	Record& record = records_[entity.index];
+	Archetype& from = *record.archetype;
+	uint32_t fromRow = record.row;
+	uint32_t toRow = AllocateRow(to,entity);
+
+	// 両方にあるコンポーネントだけ写す
+	for(uint32_t id : from.componentIds){
+		if((to.mask & (ComponentMask{1} << id)) != 0){
+			std::memcpy(GetComponentPtr(to,id,toRow),GetComponentPtr(from,id,fromRow),ComponentInfos()[id].size);
+		}
+	}
+	RemoveRow(from,fromRow);
+
+	record.archetype = &to;
+	record.row = toRow;
+}
+
+void EntityWorld::Destroy(Entity entity){
+	assert(iterationDepth_ == 0);
+	if(entity.generation == 0 || entity.index >= records_.size()){
+		return;
+	}
+	Record& record = records_[entity.index];
+	if(record.generation != entity.generation){
+		return;
+	}
+	if(record.archetype){
+		RemoveRow(*record.archetype,record.row);
+	}
+	else if(!record.isReserved){
+		return;
+	}
+	FreeEntity(entity);
+}
+
+void EntityWorld::DeferDestroy(Entity entity){
+	auto apply = [](EntityWorld& world,Entity target,const std::byte*){ world.Destroy(target); };
+	commands_.push_back({apply, entity, commandData_.size()});
+}
+
+void EntityWorld::Flush(){
+	assert(iterationDepth_ == 0);
+	// コマンドの実行中に積まれたものも続けて処理する
+	// (積まれると配列が動くので、コマンドは写してから、引数は実行の直前に位置から引く)
+	for(size_t i = 0; i < commands_.size(); ++i){
+		Command command = commands_[i];
+		command.apply(*this,command.entity,commandData_.data() + command.dataOffset);
+	}
+	commands_.clear();
+	commandData_.clear();
+}
+
+void EntityWorld::Clear(){
+	assert(iterationDepth_ == 0);
+	commands_.clear();
+	commandData_.clear();
+	for(Record& record : records_){
+		if(record.archetype || record.isReserved){
+			record.archetype = nullptr;
+			record.isReserved = false;
+			if(++record.generation == 0){
+				record.generation = 1;
+			}
+		}
+	}
+	freeIndices_.clear();
+	for(uint32_t index = static_cast<uint32_t>(records_.size()); index > 0; --index){
+		freeIndices_.push_back(index - 1);
+	}
+	for(auto& [mask,archetype] : archetypes_){
+		archetype->count = 0;
+	}
+}
+
+void EntityWorld::SaveSnapshot(){
+	assert(iterationDepth_ == 0 && commands_.empty());
+
+	snapshot_.records = records_;
+	snapshot_.archetypes.clear();
+	for(auto& [mask,archetype] : archetypes_){
+		if(archetype->count == 0){
+			continue;
+		}
+		ArchetypeSnapshot& saved = snapshot_.archetypes.emplace_back();
+		saved.archetype = archetype.get();
+		saved.count = archetype->count;
+
+		uint32_t numChunks = (archetype->count + kChunkCapacity - 1) / kChunkCapacity;
+		saved.data.resize(archetype->chunkBytes * numChunks);
+		saved.entities.resize(archetype->count);
+		for(uint32_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex){
+			const Chunk& chunk = *archetype->chunks[chunkIndex];
+			std::memcpy(saved.data.data() + archetype->chunkBytes * chunkIndex,chunk.data.get(),archetype->chunkBytes);
+		}
+		for(uint32_t row = 0; row < archetype->count; ++row){
+			saved.entities[row] = archetype->chunks[row / kChunkCapacity]->entities[row % kChunkCapacity];
+		}
+	}
+	hasSnapshot_ = true;
+}
+
+void EntityWorld::RestoreSnapshot(){
+	assert(iterationDepth_ == 0);
+	assert(hasSnapshot_);
+
+	commands_.clear();
+	commandData_.clear();
+	for(auto& [mask,archetype] : archetypes_){
+		archetype->count = 0;
+	}
+
+	// 全エンティティの世代を進める (保存後に取ったエンティティを無効にするため)
+	// 保存時に生きていたものは、チャンク側のエンティティも新しい世代に書き換える
+	size_t numRecords = records_.size();
+	for(size_t index = 0; index < numRecords; ++index){
+		Record& record = records_[index];
+		uint32_t generation = record.generation + 1;
+		if(generation == 0){
+			generation = 1;
+		}
+		if(index < snapshot_.records.size()){
+			record = snapshot_.records[index];
+			record.isReserved = false;
+		}
+		else{
+			record.archetype = nullptr;
+			record.isReserved = false;
+		}
+		record.generation = generation;
+	}
+
+	freeIndices_.clear();
+	for(size_t index = numRecords; index > 0; --index){
+		if(!records_[index - 1].archetype){
+			freeIndices_.push_back(static_cast<uint32_t>(index - 1));
+		}
+	}
+
+	for(const ArchetypeSnapshot& saved : snapshot_.archetypes){
+		Archetype& archetype = *saved.archetype;
+		uint32_t numChunks = (saved.count + kChunkCapacity - 1) / kChunkCapacity;
+		for(uint32_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex){
+			// (チャンクは解放しないので通常は残っている)
+			if(chunkIndex == archetype.chunks.size()){
+				auto chunk = std::make_unique<Chunk>();
+				chunk->data = std::make_unique<std::byte[]>(archetype.chunkBytes == 0 ? 1 : archetype.chunkBytes);
+				archetype.chunks.push_back(std::move(chunk));
+			}
+			std::memcpy(archetype.chunks[chunkIndex]->data.get(),saved.data.data() + archetype.chunkBytes * chunkIndex,archetype.chunkBytes);
+		}
+		for(uint32_t row = 0; row < saved.count; ++row){
+			Entity entity = saved.entities[row];
+			entity.generation = records_[entity.index].generation;
+			archetype.chunks[row / kChunkCapacity]->entities[row % kChunkCapacity] = entity;
+		}
+		archetype.count = saved.count;
+	}
+}
@@ -0,0 +1,342 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// エンティティ (番号 + 世代)
+// 破棄されると世代が進むので、古いエンティティを指したままでも検出できる
+struct Entity{
+	uint32_t index = 0;
+	uint32_t generation = 0; // 0 は無効
+
+	bool operator==(const Entity& other) const = default;
+};
+
+// コンポーネントの組み合わせ (1ビット = 1種類)
+using ComponentMask = uint64_t;
+
+// ==========================================
+// アーキタイプ型のエンティティ・コンポーネント管理
+// ・同じコンポーネントの組み合わせを持つエンティティを1つのアーキタイプにまとめる
+// ・アーキタイプはチャンク単位で、コンポーネントごとに連続した配列(SoA)で持つ
+// ・ForEach の対象アーキタイプはマスクごとにキャッシュする
+// ・ForEach 中の生成・破棄・追加・削除は Defer～ で積んで Flush で反映する
+// コンポーネントは memcpy で移動するので、トリビアルにコピーできる型に限る
+// ==========================================
+class EntityWorld{
+public:
+	// コンポーネントの種類の上限
+	static inline const uint32_t kMaxComponentTypes = 64;
+	// 1チャンクに入るエンティティ数
+	static inline const uint32_t kChunkCapacity = 128;
+
+	EntityWorld() = default;
+	~EntityWorld() = default;
+	EntityWorld(const EntityWorld&) = delete;
+	EntityWorld& operator=(const EntityWorld&) = delete;
+
+	// コンポーネントの種類番号 (型ごとに初回呼び出し時に採番)
+	template<class T>
+	static uint32_t ComponentId();
+
+	template<class... Ts>
+	static ComponentMask MaskOf(){ return (ComponentMask{0} | ... | (ComponentMask{1} << ComponentId<Ts>())); }
+
+	// --- 即時の構造変更 (ForEach の外でのみ) ---
+	template<class... Ts>
+	Entity Create(const Ts&... components);
+	void Destroy(Entity entity);
+	template<class T>
+	void Add(Entity entity,const T& component);
+	template<class T>
+	void Remove(Entity entity);
+
+	// --- 遅延した構造変更 (Flush で反映) ---
+	// 生成はエンティティ番号だけ先に予約して返す (Flush までは IsAlive が false)
+	template<class... Ts>
+	Entity DeferCreate(const Ts&... components);
+	void DeferDestroy(Entity entity);
+	template<class T>
+	void DeferAdd(Entity entity,const T& component);
+	template<class T>
+	void DeferRemove(Entity entity);
+	void Flush();
+
+	// 全エンティティを破棄 (確保済みのチャンクは再利用のため残す)
+	void Clear();
+
+	// 今の状態を丸ごと保存する (Flush 済みであること)
+	void SaveSnapshot();
+	// 保存した状態に戻す (チャンクの memcpy だけで済む)
+	// 保存後に取ったエンティティは世代が進むので全て無効になる
+	void RestoreSnapshot();
+	bool HasSnapshot() const{ return hasSnapshot_; }
+
+	// --- 参照 ---
+	bool IsAlive(Entity entity) const;
+	template<class T>
+	bool Has(Entity entity) const;
+	template<class T>
+	T* Get(Entity entity);
+
+	// Ts をすべて持つエンティティに f(Entity, Ts&...) を呼ぶ
+	template<class... Ts,class F>
+	void ForEach(F&& f);
+
+	// Ts をすべて持つエンティティの数
+	template<class... Ts>
+	uint32_t Count();
+
+private:
+	struct ComponentInfo{
+		size_t size;
+		size_t align;
+	};
+
+	struct Chunk{
+		std::unique_ptr<std::byte[]> data;
+		std::array<Entity,kChunkCapacity> entities;
+	};
+
+	struct Archetype{
+		ComponentMask mask = 0;
+		std::vector<uint32_t> componentIds;
+		// チャンク内での各コンポーネント配列の先頭位置
+		std::array<size_t,kMaxComponentTypes> offsets = {};
+		size_t chunkBytes = 0;
+		std::vector<std::unique_ptr<Chunk>> chunks;
+		// 生きているエンティティ数 (先頭から詰めて並ぶ)
+		uint32_t count = 0;
+	};
+
+	struct Record{
+		uint32_t generation = 1;
+		Archetype* archetype = nullptr;
+		uint32_t row = 0;
+		bool isReserved = false; // DeferCreate で予約中
+	};
+
+	static std::vector<ComponentInfo>& ComponentInfos();
+	static uint32_t RegisterComponent(size_t size,size_t align);
+
+	// エンティティ番号の確保・解放
+	Entity AllocateEntity();
+	void FreeEntity(Entity entity);
+
+	Archetype& GetOrCreateArchetype(ComponentMask mask);
+	const std::vector<Archetype*>& GetQuery(ComponentMask mask);
+
+	// アーキタイプの末尾に行を確保
+	uint32_t AllocateRow(Archetype& archetype,Entity entity);
+	// 行を削除 (末尾の行を詰める)
+	void RemoveRow(Archetype& archetype,uint32_t row);
+	// 共通するコンポーネントを別アーキタイプへ移す
+	void MoveEntity(Entity entity,Archetype& to);
+
+	std::byte* GetComponentPtr(Archetype& archetype,uint32_t componentId,uint32_t row){
+		Chunk& chunk = *archetype.chunks[row / kChunkCapacity];
+		return chunk.data.get() + archetype.offsets[componentId] + (row % kChunkCapacity) * ComponentInfos()[componentId].size;
+	}
+
+	template<class T>
+	void WriteComponent(Entity entity,const T& component){
+		Record& record = records_[entity.index];
+		std::memcpy(GetComponentPtr(*record.archetype,ComponentId<T>(),record.row),&component,sizeof(T));
+	}
+
+	// 遅延した構造変更
+	// std::function だとコンポーネントを抱えるたびにヒープを確保するので、関数ポインタと
+	// commandData_ に詰めた引数で持つ (どちらも clear で容量を残すので、一度広がった後は確保しない)
+	struct Command{
+		void (*apply)(EntityWorld& world,Entity entity,const std::byte* data);
+		Entity entity;
+		size_t dataOffset; // commandData_ の中の引数の位置
+	};
+
+	template<class T>
+	void PushCommandData(const T& component){
+		const std::byte* bytes = reinterpret_cast<const std::byte*>(&component);
+		commandData_.insert(commandData_.end(),bytes,bytes + sizeof(T));
+	}
+
+	// 詰めた引数を1つ読んでコンポーネントに写し、次の引数へ進む
+	template<class T>
+	void ReadComponent(Entity entity,const std::byte*& data){
+		Record& record = records_[entity.index];
+		std::memcpy(GetComponentPtr(*record.archetype,ComponentId<T>(),record.row),data,sizeof(T));
+		data += sizeof(T);
+	}
+
+	std::vector<Record> records_;
+	std::vector<uint32_t> freeIndices_;
+	std::unordered_map<ComponentMask,std::unique_ptr<Archetype>> archetypes_;
+	std::unordered_map<ComponentMask,std::vector<Archetype*>> queries_;
+	std::vector<Command> commands_;
+	std::vector<std::byte> commandData_;
+
+	// SaveSnapshot で保存した状態
+	struct ArchetypeSnapshot{
+		Archetype* archetype;
+		uint32_t count;
+		std::vector<std::byte> data; // 使用中のチャンクを順につなげたもの
+		std::vector<Entity> entities;
+	};
+	struct Snapshot{
+		std::vector<Record> records;
+		std::vector<ArchetypeSnapshot> archetypes;
+	};
+	Snapshot snapshot_;
+	bool hasSnapshot_ = false;
+
+	// ForEach の入れ子の深さ (0 以外の時は即時の構造変更を禁止)
+	uint32_t iterationDepth_ = 0;
+};
+
+// =================================================================
+// テンプレートの実装
+// =================================================================
+
+template<class T>
+uint32_t EntityWorld::ComponentId(){
+	static_assert(std::is_trivially_copyable_v<T>,"コンポーネントはトリビアルにコピーできる型にすること");
+	static_assert(alignof(T) <= alignof(std::max_align_t));
+	static const uint32_t id = RegisterComponent(sizeof(T),alignof(T));
+	return id;
+}
+
+template<class... Ts>
+Entity EntityWorld::Create(const Ts&... components){
+	assert(iterationDepth_ == 0);
+	Entity entity = AllocateEntity();
+	Archetype& archetype = GetOrCreateArchetype(MaskOf<Ts...>());
+	Record& record = records_[entity.index];
+	record.archetype = &archetype;
+	record.row = AllocateRow(archetype,entity);
+	(WriteComponent(entity,components),...);
+	return entity;
+}
+
+template<class T>
+void EntityWorld::Add(Entity entity,const T& component){
+	assert(iterationDepth_ == 0);
+	if(!IsAlive(entity)){
+		return;
+	}
+	Record& record = records_[entity.index];
+	ComponentMask mask = record.archetype->mask | MaskOf<T>();
+	if(mask != record.archetype->mask){
+		MoveEntity(entity,GetOrCreateArchetype(mask));
+	}
+	WriteComponent(entity,component);
+}
+
+template<class T>
+void EntityWorld::Remove(Entity entity){
+	assert(iterationDepth_ == 0);
+	if(!IsAlive(entity)){
+		return;
+	}
+	Record& record = records_[entity.index];
+	ComponentMask mask = record.archetype->mask & ~MaskOf<T>();
+	if(mask != record.archetype->mask){
+		MoveEntity(entity,GetOrCreateArchetype(mask));
+	}
+}
+
+template<class... Ts>
+Entity EntityWorld::DeferCreate(const Ts&... components){
+	Entity entity = AllocateEntity();
+	records_[entity.index].isReserved = true;
+	size_t dataOffset = commandData_.size();
+	(PushCommandData(components),...);
+	auto apply = [](EntityWorld& world,Entity target,const std::byte* data){
+		Record& record = world.records_[target.index];
+		if(record.generation != target.generation || !record.isReserved){
+			return; // 生成前に破棄された
+		}
+		record.isReserved = false;
+		Archetype& archetype = world.GetOrCreateArchetype(MaskOf<Ts...>());
+		record.archetype = &archetype;
+		record.row = world.AllocateRow(archetype,target);
+		(world.ReadComponent<Ts>(target,data),...);
+	};
+	commands_.push_back({apply, entity, dataOffset});
+	return entity;
+}
+
+template<class T>
+void EntityWorld::DeferAdd(Entity entity,const T& component){
+	size_t dataOffset = commandData_.size();
+	PushCommandData(component);
+	auto apply = [](EntityWorld& world,Entity target,const std::byte* data){
+		T value;
+		std::memcpy(&value,data,sizeof(T));
+		world.Add(target,value);
+	};
+	commands_.push_back({apply, entity, dataOffset});
+}
+
+template<class T>
+void EntityWorld::DeferRemove(Entity entity){
+	auto apply = [](EntityWorld& world,Entity target,const std::byte*){ world.Remove<T>(target); };
+	commands_.push_back({apply, entity, commandData_.size()});
+}
+
+template<class T>
+bool EntityWorld::Has(Entity entity) const{
+	if(!IsAlive(entity)){
+		return false;
+	}
+	return (records_[entity.index].archetype->mask & MaskOf<T>()) != 0;
+}
+
+template<class T>
+T* EntityWorld::Get(Entity entity){
+	if(!Has<T>(entity)){
+		return nullptr;
+	}
+	Record& record = records_[entity.index];
+	return reinterpret_cast<T*>(GetComponentPtr(*record.archetype,ComponentId<T>(),record.row));
+}
+
+template<class... Ts,class F>
+void EntityWorld::ForEach(F&& f){
+	const std::vector<Archetype*>& archetypes = GetQuery(MaskOf<Ts...>());
+
+	++iterationDepth_;
+	// (ループ中にアーキタイプが増えても参照が壊れないよう、数を先に固定する)
+	size_t numArchetypes = archetypes.size();
+	for(size_t a = 0; a < numArchetypes; ++a){
+		Archetype& archetype = *archetypes[a];
+		for(uint32_t chunkIndex = 0; chunkIndex * kChunkCapacity < archetype.count; ++chunkIndex){
+			Chunk& chunk = *archetype.chunks[chunkIndex];
+			uint32_t rows = archetype.count - chunkIndex * kChunkCapacity;
+			if(rows > kChunkCapacity){
+				rows = kChunkCapacity;
+			}
+
+			// コンポーネントごとの配列の先頭
+			std::tuple<Ts*...> columns{reinterpret_cast<Ts*>(chunk.data.get() + archetype.offsets[ComponentId<Ts>()])...};
+			for(uint32_t row = 0; row < rows; ++row){
+				f(chunk.entities[row],std::get<Ts*>(columns)[row]...);
+			}
+		}
+	}
+	--iterationDepth_;
+}
+
+template<class... Ts>
+uint32_t EntityWorld::Count(){
+	uint32_t count = 0;
+	for(Archetype* archetype : GetQuery(MaskOf<Ts...>())){
+		count += archetype->count;
+	}
+	return count;
+}
@@ -1,4 +1,5 @@
 #include "Fade.h"
+#include "FixedTimestep.h"
 #include <algorithm>
 
 void Fade::Initialize() {
@@ -21,7 +22,7 @@ void Fade::Update() {
 		// 02_13 21枚目
 
 		// 1フレーム分の秒数をカウントアップ
-		counter_ += 1.0f / 60.0f;
+		counter_ += FixedTimestep::kDeltaTime;
 		// フェード継続時間に達したら打ち止め
 		if (counter_ >= duration_) {
 			counter_ = duration_;
@@ -34,7 +35,7 @@ void Fade::Update() {
 		// 02_13 20枚目
 
 		// 1フレーム分の秒数をカウントアップ
-		counter_ += 1.0f / 60.0f;
+		counter_ += FixedTimestep::kDeltaTime;
 		// フェード継続時間に達したら打ち止め
 		if (counter_ >= duration_) {
 			counter_ = duration_;
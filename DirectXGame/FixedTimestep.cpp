@@ -0,0 +1,34 @@
+#include "FixedTimestep.h"
+
+void FixedTimestep::Initialize(){
+	prevTime_ = std::chrono::steady_clock::now();
+	accumulator_ = 0.0;
+	stepsThisFrame_ = 0;
+	tickCount_ = 0;
+}
+
+void FixedTimestep::BeginFrame(){
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	double elapsed = std::chrono::duration<double>(now - prevTime_).count();
+	prevTime_ = now;
+
+	accumulator_ += elapsed * timeScale_;
+	stepsThisFrame_ = 0;
+}
+
+bool FixedTimestep::Step(){
+	if(accumulator_ < kDeltaTime){
+		return false;
+	}
+
+	// 上限に達したら残りは捨てる (遅れを取り戻そうとしてさらに遅れるのを防ぐ)
+	if(stepsThisFrame_ >= maxStepsPerFrame_){
+		accumulator_ = 0.0;
+		return false;
+	}
+
+	accumulator_ -= kDeltaTime;
+	++stepsThisFrame_;
+	++tickCount_;
+	return true;
+}
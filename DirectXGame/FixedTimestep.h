@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// ==========================================
+// 固定タイムステップ
+// シミュレーションの更新レートを描画レートから切り離す
+// ==========================================
+class FixedTimestep{
+public:
+	// 1ティックあたりの秒数 (60Hz固定)
+	static inline const float kDeltaTime = 1.0f / 60.0f;
+	// 1フレームで進める最大ティック数 (処理落ち時の暴走防止)
+	static inline const uint32_t kDefaultMaxStepsPerFrame = 8;
+
+	void Initialize();
+
+	// フレーム開始時に実時間の経過分を蓄積する
+	void BeginFrame();
+
+	// ティックを1つ消費できればtrue (while で回す)
+	bool Step();
+
+	// 描画用の補間係数 (前回ティック=0.0 ～ 今回ティック=1.0)
+	float GetAlpha() const{ return static_cast<float>(accumulator_ / kDeltaTime); }
+
+	// 時間倍率 (描画しながらの早送り用。1フレームに進めるのは maxStepsPerFrame までなので、60fps なら 8 倍が上限)
+	// (描画しないで速く進める時は、実時間を見ない AdvanceTick を使う)
+	void SetTimeScale(float timeScale){ timeScale_ = timeScale; }
+	void SetMaxStepsPerFrame(uint32_t maxSteps){ maxStepsPerFrame_ = maxSteps; }
+
+	// ヘッドレス実行用: 実時間を待たずに1ティック進める (描画しないので蓄積と補間係数は使わない)
+	void AdvanceTick(){ ++tickCount_; }
+
+	// 起動してからの累計ティック数
+	uint64_t GetTickCount() const{ return tickCount_; }
+
+private:
+	std::chrono::steady_clock::time_point prevTime_;
+	// 未消化の時間 <秒>
+	double accumulator_ = 0.0;
+	float timeScale_ = 1.0f;
+	uint32_t maxStepsPerFrame_ = kDefaultMaxStepsPerFrame;
+	uint32_t stepsThisFrame_ = 0;
+	uint64_t tickCount_ = 0;
+};
@@ -0,0 +1,138 @@
+#include "Frustum.h"
+#include <algorithm>
+#include <cmath>
+
+namespace{
+
+float Dot(const Vector3& a,const Vector3& b){
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+Vector3 Cross(const Vector3& a,const Vector3& b){
+	return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+float Distance(const Frustum::Plane& plane,const Vector3& point){
+	return Dot(plane.normal,point) + plane.distance;
+}
+
+// 3枚の面が交わる点。平行な面があれば false
+bool Intersect(const Frustum::Plane& a,const Frustum::Plane& b,const Frustum::Plane& c,Vector3& point){
+	Vector3 bc = Cross(b.normal,c.normal);
+	float determinant = Dot(a.normal,bc);
+	if(std::abs(determinant) < 1.0e-6f){
+		return false;
+	}
+	Vector3 ca = Cross(c.normal,a.normal);
+	Vector3 ab = Cross(a.normal,b.normal);
+	float scale = -1.0f / determinant;
+	point = {
+	    (a.distance * bc.x + b.distance * ca.x + c.distance * ab.x) * scale,
+	    (a.distance * bc.y + b.distance * ca.y + c.distance * ab.y) * scale,
+	    (a.distance * bc.z + b.distance * ca.z + c.distance * ab.z) * scale,
+	};
+	return true;
+}
+
+} // namespace
+
+Frustum Frustum::Create(const Matrix4x4& view,const Matrix4x4& projection){
+	Matrix4x4 viewProjection;
+	for(int row = 0; row < 4; ++row){
+		for(int column = 0; column < 4; ++column){
+			viewProjection.m[row][column] = view.m[row][0] * projection.m[0][column] + view.m[row][1] * projection.m[1][column] +
+			                                view.m[row][2] * projection.m[2][column] + view.m[row][3] * projection.m[3][column];
+		}
+	}
+	return Create(viewProjection);
+}
+
+Frustum Frustum::Create(const Matrix4x4& viewProjection){
+	// クリップ座標 c = v * M で、-w <= x <= w, -w <= y <= w, 0 <= z <= w が内側
+	// 列 j を (m[0][j], m[1][j], m[2][j], m[3][j]) とすると、面は列の足し引きになる
+	const float (&m)[4][4] = viewProjection.m;
+	auto column = [&](int j){ return std::array<float,4>{m[0][j], m[1][j], m[2][j], m[3][j]}; };
+	std::array<float,4> x = column(0);
+	std::array<float,4> y = column(1);
+	std::array<float,4> z = column(2);
+	std::array<float,4> w = column(3);
+
+	Frustum frustum;
+	auto setPlane = [&](PlaneIndex index,float sign,const std::array<float,4>& axis,float wScale){
+		Plane& plane = frustum.planes_[index];
+		plane.normal = {w[0] * wScale + axis[0] * sign, w[1] * wScale + axis[1] * sign, w[2] * wScale + axis[2] * sign};
+		plane.distance = w[3] * wScale + axis[3] * sign;
+		float length = std::sqrt(Dot(plane.normal,plane.normal));
+		if(length > 0.0f){
+			plane.normal = {plane.normal.x / length, plane.normal.y / length, plane.normal.z / length};
+			plane.distance /= length;
+		}
+	};
+	setPlane(kLeft,1.0f,x,1.0f);
+	setPlane(kRight,-1.0f,x,1.0f);
+	setPlane(kBottom,1.0f,y,1.0f);
+	setPlane(kTop,-1.0f,y,1.0f);
+	setPlane(kNear,1.0f,z,0.0f);
+	setPlane(kFar,-1.0f,z,1.0f);
+	return frustum;
+}
+
+bool Frustum::IsBoxVisible(const Vector3& center,const Vector3& extent) const{
+	for(const Plane& plane : planes_){
+		// 面に一番近い角までの距離 (箱の半径を面の向きに投影したもの)
+		float radius = std::abs(plane.normal.x) * extent.x + std::abs(plane.normal.y) * extent.y + std::abs(plane.normal.z) * extent.z;
+		if(Distance(plane,center) < -radius){
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::IsSphereVisible(const Vector3& center,float radius) const{
+	for(const Plane& plane : planes_){
+		if(Distance(plane,center) < -radius){
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::ClipBox(const Vector3& boxMin,const Vector3& boxMax,Vector3& clippedMin,Vector3& clippedMax) const{
+	// 重なる部分は 12 枚の面 (視錐台 6 + 箱 6) で囲まれた凸多面体なので、
+	// 3 枚ずつの交点のうち全ての面の内側にあるもの (= 頂点) を囲めばよい
+	std::array<Plane,kPlaneCount + 6> planes;
+	std::copy(planes_.begin(),planes_.end(),planes.begin());
+	planes[kPlaneCount + 0] = {{1.0f, 0.0f, 0.0f}, -boxMin.x};
+	planes[kPlaneCount + 1] = {{-1.0f, 0.0f, 0.0f}, boxMax.x};
+	planes[kPlaneCount + 2] = {{0.0f, 1.0f, 0.0f}, -boxMin.y};
+	planes[kPlaneCount + 3] = {{0.0f, -1.0f, 0.0f}, boxMax.y};
+	planes[kPlaneCount + 4] = {{0.0f, 0.0f, 1.0f}, -boxMin.z};
+	planes[kPlaneCount + 5] = {{0.0f, 0.0f, -1.0f}, boxMax.z};
+
+	bool isFound = false;
+	for(size_t i = 0; i < planes.size(); ++i){
+		for(size_t j = i + 1; j < planes.size(); ++j){
+			for(size_t k = j + 1; k < planes.size(); ++k){
+				Vector3 point;
+				if(!Intersect(planes[i],planes[j],planes[k],point)){
+					continue;
+				}
+				// 交点は丸め誤差で面の少し外に出るので、大きさに応じて許す
+				float tolerance = 1.0e-4f * (1.0f + std::max({std::abs(point.x), std::abs(point.y), std::abs(point.z)}));
+				bool isInside = std::all_of(planes.begin(),planes.end(),[&](const Plane& plane){ return Distance(plane,point) >= -tolerance; });
+				if(!isInside){
+					continue;
+				}
+				if(!isFound){
+					clippedMin = point;
+					clippedMax = point;
+					isFound = true;
+					continue;
+				}
+				clippedMin = {std::min(clippedMin.x,point.x), std::min(clippedMin.y,point.y), std::min(clippedMin.z,point.z)};
+				clippedMax = {std::max(clippedMax.x,point.x), std::max(clippedMax.y,point.y), std::max(clippedMax.z,point.z)};
+			}
+		}
+	}
+	return isFound;
+}
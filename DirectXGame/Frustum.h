@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+
+using namespace KamataEngine;
+
+// ==========================================
+// 視錐台 (ビュー・プロジェクション行列から取り出した 6 枚の面)
+// 面は内側を向いていて、dot(normal, p) + distance >= 0 が内側 (normal は長さ 1)
+// 行列は Camera と同じ行ベクトルの掛け方 (v * M)、クリップ空間の z は 0～w
+// ==========================================
+class Frustum{
+public:
+	struct Plane{
+		Vector3 normal;
+		float distance;
+	};
+
+	enum PlaneIndex{
+		kLeft,
+		kRight,
+		kBottom,
+		kTop,
+		kNear,
+		kFar,
+		kPlaneCount,
+	};
+
+	static Frustum Create(const Matrix4x4& view,const Matrix4x4& projection);
+	static Frustum Create(const Matrix4x4& viewProjection);
+
+	const Plane& GetPlane(std::size_t index) const{ return planes_[index]; }
+
+	// 箱 (中心と各軸の半分の大きさ) が入っているかもしれなければ true
+	// (どれか1枚の面の完全に外側なら false。角の近くでは外でも true になることがある)
+	bool IsBoxVisible(const Vector3& center,const Vector3& extent) const;
+	bool IsSphereVisible(const Vector3& center,float radius) const;
+
+	// 視錐台と箱が重なる部分を囲む箱。重ならなければ false
+	bool ClipBox(const Vector3& boxMin,const Vector3& boxMax,Vector3& clippedMin,Vector3& clippedMax) const;
+
+private:
+	std::array<Plane,kPlaneCount> planes_;
+};
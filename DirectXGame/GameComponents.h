@@ -0,0 +1,29 @@
+#pragma once
+#include <math/Vector3.h>
+#include <math/Vector4.h>
+
+using namespace KamataEngine;
+
+// ==========================================
+// EntityWorld で共通に使うコンポーネント
+// (敵・ビーム・ヒットエフェクト固有のものはそれぞれのヘッダーにある)
+// D3D を使わないので AssetCooker の計測でも同じ型を使う
+// ==========================================
+
+// 姿勢 (当たり判定と描画で使う)
+struct TransformComponent{
+	Vector3 scale = {1.0f, 1.0f, 1.0f};
+	Vector3 rotation = {};
+	Vector3 translation = {};
+};
+
+// 前ティックの姿勢 (描画時の補間用)
+struct PrevTransformComponent{
+	Vector3 rotation = {};
+	Vector3 translation = {};
+};
+
+// 描画色
+struct ColorComponent{
+	Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+};
@@ -2,7 +2,10 @@
 #include "Math.h"
 #include "ParticleManager.h"
 #include "BossEffectSystem.h"
+#include "JumpSystem.h"
 #include "WallHitEffectSystem.h"
+#include "FixedTimestep.h"
+#include "TransformInterpolator.h"
 #include <windows.h>
 #include <string>
 
@@ -13,60 +16,57 @@ using namespace KamataEngine;
 
 // --- エフェクト生成 ---
 void GameScene::CreateEffect(const Vector3& position){
-	HitEffect* newHitEffect = HitEffect::Create(position);
-	hitEffects_.push_back(newHitEffect);
+	HitEffect::Create(world_,position);
 }
 
 // --- デストラクタ (終了処理) ---
 GameScene::~GameScene(){
 
+	TransformInterpolator::GetInstance()->UnregisterCamera(&camera_);
+
 	// 2Dリソース
 	delete sprite_;
 
 	// モデル類
+	// (AssetCache から借りたものはハンドルの破棄で参照が外れる)
 	delete model_;
-	delete modelArrow_;
-	delete modelBoss_;
-	delete modelBlock_;
-	delete modelSkydome_;
-	delete modelPlayer_;
-	delete modelAttack_;
-	delete modelDeathEffect_;
-	delete modelBeam_;
-	// modelParticle_ はParticleManager等で共用される場合があるため注意が必要だが、
-	// ここではCreateFromOBJで作ったものなら消してOK
-	// delete modelParticle_; // (メンバ変数として持っているなら)
-
-	// ステージ情報
-	for(std::vector<WorldTransform*>& worldTransformBlockLine : worldTransformBlocks_){
-		for(WorldTransform* worldTransformBlock : worldTransformBlockLine){
-			delete worldTransformBlock;
-		}
-	}
-	worldTransformBlocks_.clear();
+
+	// シーンの外まで残るエフェクトに渡したモデルも外す (以降はキャッシュが予算に応じて捨ててよい)
+	HitEffect::SetModel(ModelHandle());
+	ParticleManager::GetInstance()->GetBossEffectSystem()->ReleaseModel();
+	ParticleManager::GetInstance()->GetWallHitEffectSystem()->ReleaseModel();
+	ParticleManager::GetInstance()->GetJumpSystem()->ReleaseModel();
+
+	// ステージ
+	delete worldTransformBlockLayer_;
 	delete mapChipField_;
 
-	// カメラ
+	// カメラ・背景・フェード
+	delete cameraController_;
 	delete debugCamera_;
+	delete skydome_;
+	delete fade_;
 
-	// キャラクター・敵
+	// キャラクター・エフェクト
 	delete player_; // GameSceneで生成したplayerはここで消す
-	for(Enemy* enemy : enemies_){
-		delete enemy;
-	}
-	enemies_.clear();
+	delete deathParticlesInstance_;
+	// (敵・ビーム・ヒットエフェクトは world_ と一緒に消える)
 
-	// エフェクト・弾
-	delete deathParticles_;
-	for(HitEffect* hitEffect : hitEffects_){
-		delete hitEffect;
-	}
-	hitEffects_.clear();
+}
 
-	for(Beam* beam : beams_){
-		delete beam;
-	}
-	beams_.clear();
+// --- アセットの先読み ---
+std::vector<AssetRef> GameScene::PreloadAssets(){
+	AssetCache* assetCache = AssetCache::GetInstance();
+	return {
+	    assetCache->LoadModelAsync("SkyDome",true),
+	    assetCache->LoadModelAsync("block"),
+	    assetCache->LoadModelAsync("player"),
+	    assetCache->LoadModelAsync("attack_effect"),
+	    assetCache->LoadModelAsync("enemy"),
+	    assetCache->LoadModelAsync("deathParticle"),
+	    assetCache->LoadModelAsync("sphere"),
+	    assetCache->LoadTextureAsync("sample.png"),
+	};
 }
 
 // --- 初期化処理 ---
@@ -78,26 +78,26 @@ void GameScene::Initialize(){
 
 	// 背景（天球）
 	skydome_ = new Skydome();
-	modelSkydome_ = Model::CreateFromOBJ("SkyDome",true);
-	skydome_->Initialize(&camera_,modelSkydome_);
+	modelSkydome_ = AssetCache::GetInstance()->LoadModel("SkyDome",true);
+	skydome_->Initialize(&camera_,modelSkydome_.Get());
 
 	// マップ読み込み
-	mapChipField_ = new MapChipField;
+	mapChipField_ = new MapChipField();
 	// ★CSVから読み込み (MapChip2.csv のままでOKです)
 	mapChipField_->LoadMapChipCsv("Resources/MapChip2.csv");
 
-	modelBlock_ = Model::CreateFromOBJ("block");
+	modelBlock_ = AssetCache::GetInstance()->LoadModel("block");
 	GenerateBlocks(); // ブロック配置
 
 	// プレイヤー生成
 	player_ = new Player();
-	modelPlayer_ = Model::CreateFromOBJ("player");
-	modelAttack_ = Model::CreateFromOBJ("attack_effect");
+	modelPlayer_ = AssetCache::GetInstance()->LoadModel("player");
+	modelAttack_ = AssetCache::GetInstance()->LoadModel("attack_effect");
 	// プレイヤーの初期位置も、必要ならCSVから読み取るように改造できますが、一旦このままで
-	Vector3 playerPosition = mapChipField_->GetMapChipPositionByIndex(5,18);
+	playerStartPosition_ = mapChipField_->GetMapChipPositionByIndex(5,18);
 
 	player_->SetMapChipField(mapChipField_);
-	player_->Initialize(modelPlayer_,modelAttack_,&camera_,playerPosition);
+	player_->Initialize(modelPlayer_.Get(),modelAttack_.Get(),&camera_,playerStartPosition_);
 
 	// カメラコントローラー
 	cameraController_ = new CameraController();
@@ -108,27 +108,43 @@ void GameScene::Initialize(){
 	CameraController::Rect cameraArea = {12.0f, 100 - 12.0f, 6.0f, 6.0f};
 	cameraController_->SetMovableArea(cameraArea);
 
+	// 追従カメラも描画時に補間する
+	TransformInterpolator::GetInstance()->RegisterCamera(&camera_);
+
 	// --- 敵の生成 ---
-	modelBoss_ = Model::CreateFromOBJ("enemy");
+	modelBoss_ = AssetCache::GetInstance()->LoadModel("enemy");
 
 	// ===========================================================
 	// ★変更: 手動配置コードを削除し、CSVから自動生成するように変更
 	// ===========================================================
 	GenerateEnemies();
 
+	// リトライ用に敵の初期配置を保存
+	world_.SaveSnapshot();
+
 
 	// --- エフェクト・UI関連 ---
-	modelDeathEffect_ = Model::CreateFromOBJ("deathParticle");
-	modelParticle_ = Model::CreateFromOBJ("sphere"); // エフェクト用球体モデル
-	modelBeam_ = Model::CreateFromOBJ("sphere");     // ビーム用モデル
+	modelDeathEffect_ = AssetCache::GetInstance()->LoadModel("deathParticle");
+	modelParticle_ = AssetCache::GetInstance()->LoadModel("sphere"); // エフェクト用球体モデル
+	modelParticle_->SetModelLodErrorThreshold(ViewSettings::kEffectLodErrorThreshold);
+	modelBeam_ = modelParticle_;                                      // ビーム用モデル (同じ球を共有)
+
+	// ビームの色は全ビーム共通
+	beamColor_.Initialize();
+	beamColor_.SetColor({1.0f, 1.0f, 0.0f, 1.0f}); // 黄色
+	std::vector<BeamEvent> beamEventContainer;
+	beamEventContainer.reserve(kMaxBeams);
+	beamEvents_ = decltype(beamEvents_)(std::greater<BeamEvent>(),std::move(beamEventContainer));
+	// 撃ち始めてから描画中に定数バッファを作らないよう、敵 (先に借りる) とビームの分は先に作っておく
+	renderResourcePool_.Reserve(world_.Count<Enemy::State>() + kMaxBeams);
 
 	HitEffect::SetModel(modelParticle_);
 	HitEffect::SetCamera(&camera_);
 
 	// 矢印などのUI
-	modelArrow_ = Model::CreateFromOBJ("arrow");
-	textureHandle_ = TextureManager::Load("sample.png");
-	sprite_ = Sprite::Create(textureHandle_,{100, 50});
+	modelArrow_ = AssetCache::GetInstance()->RequestModel("arrow"); // 使う時に読み込む
+	textureHandle_ = AssetCache::GetInstance()->LoadTexture("sample.png");
+	sprite_ = Sprite::Create(textureHandle_.Get(),{100, 50});
 
 	// フェード初期化
 	phase_ = Phase::kFadeIn;
@@ -140,8 +156,43 @@ void GameScene::Initialize(){
 	// ※ main.cppで Initialize() されている前提ならここは不要だが、
 	// シーンごとにリセットするならモデルの再登録などが必要
 	// ParticleManager::GetInstance()->Initialize(); // mainで呼んでいれば不要
+	// (エフェクトはハンドルを持つので、シーンの間はモデルがキャッシュから捨てられない)
 	ParticleManager::GetInstance()->GetBossEffectSystem()->Initialize(modelParticle_);
 	ParticleManager::GetInstance()->GetWallHitEffectSystem()->Initialize(modelParticle_);
+	// ジャンプの埃はプレイヤーのモデルで描く (テクスチャは 0 番のまま)
+	ParticleManager::GetInstance()->GetJumpSystem()->Initialize(modelPlayer_,0u);
+}
+
+// --- リトライ (初期状態へ戻す) ---
+void GameScene::Reset(){
+	// プレイヤー・カメラ
+	player_->Reset();
+	isDebugCameraActive_ = false;
+	cameraController_->Reset();
+	camera_.UpdateMatrix();
+
+	// 敵を初期配置に戻す (ビーム・ヒットエフェクトも消える)
+	world_.RestoreSnapshot();
+	while(!beamEvents_.empty()){
+		beamEvents_.pop();
+	}
+	tick_ = 0;
+
+	// エフェクト
+	deathParticles_ = nullptr;
+	ParticleManager::GetInstance()->GetBossEffectSystem()->Clear();
+	ParticleManager::GetInstance()->GetWallHitEffectSystem()->Clear();
+	ParticleManager::GetInstance()->GetJumpSystem()->Clear();
+
+	// フェード・フェーズ
+	phase_ = Phase::kFadeIn;
+	fade_->Start(Fade::Status::FadeIn,1.0f);
+	finished_ = false;
+	isClear_ = false;
+
+	// Reset はティックの途中 (SaveState の後) で呼ばれるので、前回の状態も初期位置にしておく
+	// (しないと死んだ位置からスタート地点まで1ティックかけて補間で滑って見える)
+	TransformInterpolator::GetInstance()->Snap();
 }
 
 // --- フェーズ遷移管理 ---
@@ -151,8 +202,15 @@ void GameScene::ChangePhase(){
 		if(player_->IsDead()){
 			phase_ = Phase::kDeath;
 			const Vector3& deathParticlesPosition = player_->GetWorldPosition();
-			deathParticles_ = new DeathParticles;
-			deathParticles_->Initialize(modelDeathEffect_,&camera_,deathParticlesPosition);
+			// (定数バッファを作るのは最初の死亡の時だけ。2回目からは位置と経過時間を戻すだけ)
+			if(!deathParticlesInstance_){
+				deathParticlesInstance_ = new DeathParticles();
+				deathParticlesInstance_->Initialize(modelDeathEffect_.Get(),&camera_,deathParticlesPosition);
+			}
+			else{
+				deathParticlesInstance_->Reset(deathParticlesPosition);
+			}
+			deathParticles_ = deathParticlesInstance_;
 		}
 		break;
 	case Phase::kDeath:
@@ -166,21 +224,20 @@ void GameScene::GenerateBlocks(){
 	uint32_t numBlockVirtical = mapChipField_->GetNumBlockVirtical();
 	uint32_t numBlockHorizontal = mapChipField_->GetNumBlockHorizontal();
 
-	worldTransformBlocks_.resize(numBlockVirtical);
-	for(uint32_t i = 0; i < numBlockVirtical; ++i){
-		worldTransformBlocks_[i].resize(numBlockHorizontal);
-	}
-
-	for(uint32_t i = 0; i < numBlockVirtical; ++i){
-		for(uint32_t j = 0; j < numBlockHorizontal; ++j){
-			if(mapChipField_->GetMapChipTypeByIndex(j,i) == MapChipType::kBlock){
-				WorldTransform* worldTransform = new WorldTransform();
-				worldTransform->Initialize();
-				worldTransformBlocks_[i][j] = worldTransform;
-				worldTransformBlocks_[i][j]->translation_ = mapChipField_->GetMapChipPositionByIndex(j,i);
-			}
-		}
-	}
+	// 層の原点は左下のマス (段 0)。各ブロックはそこからマス目の分だけずらして描く
+	worldTransformBlockLayer_ = new WorldTransform();
+	worldTransformBlockLayer_->Initialize();
+	worldTransformBlockLayer_->translation_ = mapChipField_->GetMapChipPositionByIndex(0,numBlockVirtical - 1);
+	blockLayerTracker_.Invalidate(); // 定数バッファが新しくなったので、次の更新で必ず送る
+	blockLayout_.origin = worldTransformBlockLayer_->translation_;
+	blockLayout_.tileWidth = MapChipField::kBlockWidth;
+	blockLayout_.tileHeight = MapChipField::kBlockHeight;
+	blockLayout_.halfExtent = {MapChipField::kBlockWidth * 0.5f, MapChipField::kBlockHeight * 0.5f, MapChipField::kBlockWidth * 0.5f};
+
+	blockInstances_.GetInstances().Build(numBlockHorizontal,numBlockVirtical,[this](uint32_t column,uint32_t row){
+		return mapChipField_->GetMapChipTypeByIndex(column,row) == MapChipType::kBlock;
+	});
+	blockInstances_.Upload();
 }
 
 // =================================================================
@@ -188,22 +245,15 @@ void GameScene::GenerateBlocks(){
 // =================================================================
 void GameScene::Update(){
 
+	++tick_;
+
 	// --- 全体共有の更新 ---
-	ParticleManager::GetInstance()->Update(1.0f);
+	ParticleManager::GetInstance()->Update(FixedTimestep::kDeltaTime);
 
-	// 死亡・消滅フラグの回収 (remove_if)
-	hitEffects_.remove_if([](HitEffect* hitEffect){
-		if(hitEffect->IsDead()){ delete hitEffect; return true; }
-		return false;
-		});
-	enemies_.remove_if([](Enemy* enemy){
-		if(enemy->IsDead()){ delete enemy; return true; }
-		return false;
-		});
-	beams_.remove_if([](Beam* beam){
-		if(beam->IsDead()){ delete beam; return true; }
-		return false;
-		});
+	// ビームの着弾・寿命切れ
+	ProcessBeamEvents();
+	// 死亡・消滅フラグの回収
+	ReapEntities();
 
 	// フェーズチェック
 	ChangePhase();
@@ -226,19 +276,19 @@ void GameScene::Update(){
 		// ボスの生存チェック (クリア判定)
 		{
 			bool isBossAlive = false;
-			for(Enemy* enemy : enemies_){
-				if(enemy->GetType() == Enemy::Type::kBoss){
-					isBossAlive = true;
+			world_.ForEach<Enemy::State,TransformComponent>([&](Entity,Enemy::State& state,TransformComponent& transform){
+				if(isBossAlive || state.type != Enemy::Type::kBoss){
+					return;
+				}
+				isBossAlive = true;
 
-					// ボス用エフェクトの発生 (生存中のみ)
-					// ※ 頻度はランダムなどで調整しても良い
-					for(int i = 0; i < 2; i++){
-						Vector3 bossPos = enemy->GetWorldPosition();
-						ParticleManager::GetInstance()->GetBossEffectSystem()->Spawn(bossPos);
-					}
-					break;
+				// ボス用エフェクトの発生 (生存中のみ)
+				// ※ 頻度はランダムなどで調整しても良い
+				for(int i = 0; i < 2; i++){
+					Vector3 bossPos = Enemy::GetWorldPosition(transform);
+					ParticleManager::GetInstance()->GetBossEffectSystem()->Spawn(bossPos);
 				}
-			}
+			});
 			// ボスがいなければクリアへ
 			if(!isBossAlive){
 			phase_ = Phase::kFadeOut;
@@ -266,12 +316,11 @@ void GameScene::Update(){
 
 			// 1. ボスがまだ生きてるかチェック
 			bool isBossAlive = false;
-			for(Enemy* enemy : enemies_){
-				if(enemy->GetType() == Enemy::Type::kBoss){
+			world_.ForEach<Enemy::State>([&](Entity,Enemy::State& state){
+				if(state.type == Enemy::Type::kBoss){
 					isBossAlive = true;
-					break;
 				}
-			}
+			});
 
 			if(isBossAlive){
 				// ボスが生きてる ＝ 死んで終わった ＝ リトライ
@@ -306,40 +355,30 @@ void GameScene::UpdateGameObjects(){
 
 	player_->Update();
 
-	for(Enemy* enemy : enemies_){
-		enemy->Update();
-	}
+	Enemy::UpdateAll(world_);
+	HitEffect::UpdateAll(world_);
 
-	for(HitEffect* hitEffect : hitEffects_){
-		hitEffect->Update();
-	}
+	// ブロック層の行列更新 (動かないので、置き直した時だけ転送される)
+	WorldTransformUpdate(*worldTransformBlockLayer_,blockLayerTracker_);
 
-	// ブロック行列更新
-	for(std::vector<WorldTransform*>& worldTransformBlockLine : worldTransformBlocks_){
-		for(WorldTransform*& worldTransformBlock : worldTransformBlockLine){
-			if(!worldTransformBlock) continue;
-			WorldTransformUpdate(*worldTransformBlock);
-		}
-	}
-
-	// --- ビームの発射と更新 ---
+	// --- ビームの発射 ---
+	// (発射後の移動は解析的に求めるので、ビームごとの更新処理はない)
 	if(player_->IsShotBeam()){
-		Beam* newBeam = new Beam();
 		Vector3 startPos = player_->GetWorldPosition();
 		float rotY = player_->GetWorldTransform().rotation_.y;
-		Vector3 velocity = {sinf(rotY), 0, cosf(rotY)};
+		float sinY, cosY;
+		SinCos(rotY,sinY,cosY);
+		Vector3 velocity = {sinY, 0, cosY};
 		velocity *= 0.5f; // 弾速
-		newBeam->Initialize(modelBeam_,startPos,velocity);
-		beams_.push_back(newBeam);
+		FireBeam(startPos,velocity,false);
 	}
 
-	for(Enemy* enemy : enemies_){
+	world_.ForEach<Enemy::State,TransformComponent>([&](Entity,Enemy::State& state,TransformComponent& transform){
 		// ボスタイプ、かつ、敵ごとのタイマーが0になったら
-		if(enemy->GetType() == Enemy::Type::kBoss && enemy->IsTimeToFire()){
+		if(state.type == Enemy::Type::kBoss && Enemy::IsTimeToFire(state)){
 
 			// ★ここから下は前のコードと同じ（ビーム生成）
-			Beam* newBullet = new Beam();
-			Vector3 bossPos = enemy->GetWorldPosition();
+			Vector3 bossPos = Enemy::GetWorldPosition(transform);
 			Vector3 targetPos = player_->GetWorldPosition();
 			Vector3 velocity = targetPos - bossPos;
 
@@ -351,18 +390,65 @@ void GameScene::UpdateGameObjects(){
 			}
 			Vector3 speed = {velocity.x * 0.1f, velocity.y * 0.1f, velocity.z * 0.1f};
 
-			newBullet->Initialize(modelBeam_,bossPos,speed);
-			newBullet->SetIsEnemy(true);
+			FireBeam(bossPos,speed,true);
+		}
+	});
+
+	// ループ中に発射したビームをここで反映する
+	world_.Flush();
+}
+
+// --- ビーム発射 ---
+void GameScene::FireBeam(const Vector3& position,const Vector3& velocity,bool isEnemy){
+	Beam beam;
+	beam.Initialize(position,velocity,tick_,mapChipField_);
+	beam.SetIsEnemy(isEnemy);
+
+	// 敵のループ中からも呼ばれるので遅延生成 (エンティティ番号は先に決まる)
+	Entity entity = world_.DeferCreate(beam);
+	beamEvents_.push({beam.GetEventTick(), entity});
+}
+
+// --- ビームの予定イベント処理 ---
+// 先頭(一番早いイベント)だけ見ればよいので、何も起きないティックはほぼコストなし
+void GameScene::ProcessBeamEvents(){
+	while(!beamEvents_.empty() && beamEvents_.top().tick <= tick_){
+		Beam* beam = world_.Get<Beam>(beamEvents_.top().entity);
+		beamEvents_.pop();
 
-			beams_.push_back(newBullet);
+		// 既に他の理由で消えたビーム (古いエンティティ) は何もしない
+		if(!beam){
+			continue;
 		}
-	}
 
-	for(Beam* beam : beams_){
-		beam->Update();
+		if(!beam->IsDead() && beam->IsWallHitEvent()){
+			// 壁ヒットエフェクト発生
+			ParticleManager::GetInstance()->GetWallHitEffectSystem()->Spawn(beam->GetWorldPosition(tick_));
+		}
+		beam->OnCollision();
 	}
 }
 
+// --- 死亡・消滅したエンティティの回収 ---
+void GameScene::ReapEntities(){
+	world_.ForEach<Enemy::State>([&](Entity entity,Enemy::State& state){
+		if(state.isDead){
+			world_.DeferDestroy(entity);
+		}
+	});
+	world_.ForEach<HitEffect::State>([&](Entity entity,HitEffect::State& state){
+		if(HitEffect::IsDead(state)){
+			world_.DeferDestroy(entity);
+		}
+	});
+	world_.ForEach<Beam>([&](Entity entity,Beam& beam){
+		if(beam.IsDead()){
+			world_.DeferDestroy(entity);
+		}
+	});
+	world_.Flush();
+}
+
 // =================================================================
 // 描画処理
 // =================================================================
@@ -371,33 +457,51 @@ void GameScene::Draw(){
 	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
 	Model::PreDraw(dxCommon->GetCommandList());
 
+	// エンティティ用の定数バッファを先頭から借り直す
+	renderResourcePool_.Reset();
+	float alpha = TransformInterpolator::GetInstance()->GetAlpha();
+
 	// 1. 背景・ステージ
 	skydome_->Draw();
-	for(std::vector<WorldTransform*>& worldTransformBlockLine : worldTransformBlocks_){
-		for(WorldTransform*& worldTransformBlock : worldTransformBlockLine){
-			if(!worldTransformBlock) continue;
-			modelBlock_->Draw(*worldTransformBlock,camera_);
-		}
-	}
+	// (画面に入る列だけ。計算はマップの広さによらない)
+	Frustum frustum = Frustum::Create(camera_.matView,camera_.matProjection);
+	visibilityCuller_.Begin(frustum);
+	TileInstances::Rect visibleBlocks = blockInstances_.GetInstances().GetVisibleRect(frustum,blockLayout_,kBlockDrawMargin);
+	modelBlock_->DrawInstanced(*worldTransformBlockLayer_,camera_,blockInstances_,visibleBlocks,MapChipField::kBlockWidth,MapChipField::kBlockHeight);
 
 	// 2. キャラクター
 	if(!player_->IsDead()){
 		player_->Draw();
 	}
-	for(Enemy* enemy : enemies_){
-		enemy->Draw();
-	}
+	// (敵・ビーム・ヒットエフェクトは画面に入るものだけ)
+	Enemy::DrawAll(world_,modelBoss_.Get(),camera_,renderResourcePool_,visibilityCuller_,alpha);
 
 	// 3. エフェクト・弾
-	for(Beam* beam : beams_){
-		beam->Draw(camera_);
-	}
+	// (ビームは描画する時だけ位置を求める)
+	const float kBeamScale = 0.5f; // サイズ調整
+	const Vector3 beamScale = {kBeamScale, kBeamScale, kBeamScale};
+	uint32_t firstBeam = visibilityCuller_.GetTestedCount();
+	// (回転しないので、球は行列を作らずに位置と拡大から求める)
+	MeshModel* modelBeam = modelBeam_.Get();
+	world_.ForEach<Beam>([&](Entity,Beam& beam){
+		Vector3 center;
+		float radius;
+		modelBeam->GetWorldBoundingSphere(beam.GetRenderPosition(tick_,alpha),kBeamScale,center,radius);
+		visibilityCuller_.AddSphere(center,radius);
+	});
+	visibilityCuller_.Cull();
+	uint32_t beamIndex = firstBeam;
+	world_.ForEach<Beam>([&](Entity,Beam& beam){
+		if(!visibilityCuller_.IsVisible(beamIndex++)){
+			return;
+		}
+		const WorldTransform& worldTransform = renderResourcePool_.AcquireTransform(beamScale,{},beam.GetRenderPosition(tick_,alpha));
+		modelBeam_->Draw(worldTransform,camera_,&beamColor_);
+	});
 	if(deathParticles_){
 		deathParticles_->Draw();
 	}
-	for(HitEffect* hitEffect : hitEffects_){
-		hitEffect->Draw();
-	}
+	HitEffect::DrawAll(world_,renderResourcePool_,visibilityCuller_);
 
 	// 4. パーティクル一括描画
 	ParticleManager::GetInstance()->Draw(&camera_);
@@ -424,94 +528,62 @@ void GameScene::CheckAllCollisions(){
 	// --- 1. 自キャラ vs 敵キャラ (体当たり) ---
 	{
 		aabb1 = player_->GetAABB();
-		for(Enemy* enemy : enemies_){
-			if(enemy->IsCollisionDisabled()) continue;
+		world_.ForEach<Enemy::State,TransformComponent>([&](Entity,Enemy::State& state,TransformComponent& transform){
+			if(state.isCollisionDisabled) return;
 
-			aabb2 = enemy->GetAABB();
+			aabb2 = Enemy::GetAABB(transform);
 			if(IsCollision(aabb1,aabb2)){
-				player_->OnCollision(enemy);
-				enemy->OnCollision(player_);
+				player_->OnCollision(nullptr);
+				Enemy::OnCollision(state);
 			}
-		}
+		});
 	}
 
-	for(auto it = beams_.begin(); it != beams_.end(); ){
-		Beam* beam = *it;
-		Vector3 bPos = beam->GetWorldPosition();
-		bool hitWall = false;
+	// (ビーム vs 壁 は発射時に着弾ティックを計算済み。ProcessBeamEvents で処理する)
 
-		// 全ブロックと総当たりチェック
-		// ブロックのリスト(worldTransformBlocks_)を使って判定します
-		for(auto& line : worldTransformBlocks_){
-			for(WorldTransform* block : line){
-				if(!block) continue; // ブロックがない場所はスキップ
-
-				// ブロックの範囲 (中心から半径0.5の箱とみなす)
-				float minX = block->translation_.x - 0.5f;
-				float maxX = block->translation_.x + 0.5f;
-				float minY = block->translation_.y - 0.5f;
-				float maxY = block->translation_.y + 0.5f;
-				float minZ = block->translation_.z - 0.5f;
-				float maxZ = block->translation_.z + 0.5f;
-
-				// ビームがブロックの中にあるか？
-				if(bPos.x >= minX && bPos.x <= maxX &&
-					bPos.y >= minY && bPos.y <= maxY &&
-					bPos.z >= minZ && bPos.z <= maxZ){
-
-					hitWall = true;
-
-					// 壁ヒットエフェクト発生（もしエラーが出るならこの行は消してください）
-					ParticleManager::GetInstance()->GetWallHitEffectSystem()->Spawn(bPos);
-
-					break;
-				}
-			}
-			if(hitWall) break;
+	// --- 2. ビーム(プレイヤーの攻撃) vs 敵 ---
+	// 敵をマップのマス目に振り分け、ビームの周りのマスの敵とだけ比べる
+	// (当たるのは総当たりの時と同じく、ForEach の順で最初に重なった敵)
+	// (消えるビーム・出すエフェクトは最後の Flush でまとめて反映するので、ここで集めたポインタは最後まで使える)
+	enemyGrid_.Clear();
+	gridEnemies_.clear();
+	world_.ForEach<Enemy::State,TransformComponent>([&](Entity,Enemy::State& state,TransformComponent& transform){
+		enemyGrid_.Add(Enemy::GetWorldPosition(transform),Enemy::GetRadius(transform));
+		gridEnemies_.push_back({&state, &transform});
+	});
+	enemyGrid_.Build(MapChipField::kBlockWidth);
+
+	world_.ForEach<Beam>([&](Entity,Beam& beam){
+		if(beam.IsEnemy() || beam.IsDead()){
+			return; // 敵の弾ならスキップ（自爆防止）
 		}
 
-		if(hitWall){
-			delete beam;
-			it = beams_.erase(it); // ビーム削除
-		} else{
-			++it; // 次のビームへ
+		// 簡易的な球判定（1体に当たったら消える）
+		uint32_t index = enemyGrid_.FindFirst(beam.GetWorldPosition(tick_),beam.GetRadius());
+		if(index == CollisionGrid::kNone){
+			return;
 		}
-	}
+		GridEnemy& enemy = gridEnemies_[index];
 
-	// --- 2. ビーム(プレイヤーの攻撃) vs 敵 ---
-	for(auto itBeam = beams_.begin(); itBeam != beams_.end(); ++itBeam){
-		Beam* beam = *itBeam;
-		if(beam->IsEnemy()){
-			continue; // 敵の弾ならスキップ（自爆防止）
-		}
+		// ヒット処理
+		beam.OnCollision();              // ビーム消滅
+		Enemy::OnCollision(*enemy.state); // 敵へダメージ通知
 
-		for(Enemy* enemy : enemies_){
-			// 簡易的な球判定（距離の2乗チェック）
-			Vector3 posA = beam->GetWorldPosition();
-			Vector3 posB = enemy->GetWorldPosition();
-			Vector3 diff = posA - posB;
-			float distSq = diff.x * diff.x + diff.y * diff.y + diff.z * diff.z;
-			float r = beam->GetRadius() + enemy->GetRadius();
-			if(distSq <= r * r){
-				// ヒット処理
-				beam->OnCollision();         // ビーム消滅
-				enemy->OnCollision(player_); // 敵へダメージ通知
-
-				// ヒットエフェクト発生
-				CreateEffect(posB);
-				break; // 1体に当たったら消える
-			}
-		}
-	}
+		// ヒットエフェクト発生
+		CreateEffect(Enemy::GetWorldPosition(*enemy.transform));
+	});
 
 	// --- 3. 吸い込み判定 (プレイヤーの口 vs 敵の弾) ---
 	if(player_->IsInhaling()){
 
 		AABB inhaleArea = player_->GetInhaleArea();
 
-		for(auto it = beams_.begin(); it != beams_.end(); ){
-			Beam* beam = *it;
-			Vector3 bPos = beam->GetWorldPosition();
+		bool isCaught = false;
+		world_.ForEach<Beam>([&](Entity entity,Beam& beam){
+			if(isCaught || beam.IsDead()){
+				return; // 1発吸い込んだら終わり
+			}
+			Vector3 bPos = beam.GetWorldPosition(tick_);
 
 			// ビームが吸い込み範囲に入っているか？
 			if(bPos.x >= inhaleArea.min.x && bPos.x <= inhaleArea.max.x &&
@@ -519,44 +591,41 @@ void GameScene::CheckAllCollisions(){
 				bPos.z >= inhaleArea.min.z && bPos.z <= inhaleArea.max.z){
 
 				// ★吸い込み成功！
-				delete beam;
-				it = beams_.erase(it);
+				beam.OnCollision();
+				world_.DeferDestroy(entity);
 
 				player_->CatchAmmo(); // 満腹にする
-				break;
-			} else{
-				++it;
+				isCaught = true;
 			}
-		}
+		});
 	}
 
 	// --- 4. 敵の弾 vs プレイヤー本体 (ダメージ判定) ---
 	AABB playerBodyBox = player_->GetAABB();
 
-	for(auto it = beams_.begin(); it != beams_.end(); ){
-		Beam* beam = *it;
+	world_.ForEach<Beam>([&](Entity entity,Beam& beam){
 
 		// 1. 敵の弾じゃなければ無視
-		if(!beam->IsEnemy()){
-			++it;
-			continue;
+		if(!beam.IsEnemy() || beam.IsDead()){
+			return;
 		}
 
 		// 2. 当たり判定（プレイヤーの体の中に弾があるか？）
-		Vector3 bPos = beam->GetWorldPosition();
+		Vector3 bPos = beam.GetWorldPosition(tick_);
 		if(bPos.x >= playerBodyBox.min.x && bPos.x <= playerBodyBox.max.x &&
 			bPos.y >= playerBodyBox.min.y && bPos.y <= playerBodyBox.max.y &&
 			bPos.z >= playerBodyBox.min.z && bPos.z <= playerBodyBox.max.z){
 
 			// ★ヒット！ダメージ！
-			player_->OnCollision((Enemy*)nullptr);
+			player_->OnCollision(nullptr);
 
-			delete beam;
-			it = beams_.erase(it);
-		} else{
-			++it;
+			beam.OnCollision();
+			world_.DeferDestroy(entity);
 		}
-	}
+	});
+
+	// 消えたビーム・出したヒットエフェクトをここで反映する
+	world_.Flush();
 }
 
 void GameScene::GenerateEnemies(){
@@ -572,23 +641,20 @@ void GameScene::GenerateEnemies(){
 			// ★修正：数字(10)ではなく、名前(kZako)で判定する
 			if(type == MapChipType::kZako || type == MapChipType::kBoss){
 
-				Enemy* newEnemy = new Enemy();
 				Vector3 pos = mapChipField_->GetMapChipPositionByIndex(j,i);
 
 				// ボスかザコかを判定
 				Enemy::Type enemyType = (type == MapChipType::kBoss)?Enemy::Type::kBoss:Enemy::Type::kBoss;
 
-				newEnemy->Initialize(modelBoss_,&camera_,pos,enemyType);
+				Entity enemy = Enemy::Create(world_,pos,enemyType);
 
+				TransformComponent* transform = world_.Get<TransformComponent>(enemy);
 				if(type == MapChipType::kBoss){
-					newEnemy->SetScale({3.0f, 3.0f, 3.0f});
+					transform->scale = {3.0f, 3.0f, 3.0f};
 				} else{
 					// ザコは標準サイズ
-					newEnemy->SetScale({1.2f, 1.2f, 1.2f});
+					transform->scale = {1.2f, 1.2f, 1.2f};
 				}
-
-				newEnemy->SetGameScene(this);
-				enemies_.push_back(newEnemy);
 			}
 		}
 	}
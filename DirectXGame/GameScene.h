@@ -1,5 +1,7 @@
 #pragma once
 #include "KamataEngine.h"
+#include "AssetCache.h"
+#include "Beam.h"
 #include "CameraController.h"
 #include "DeathParticles.h"
 #include "Enemy.h"
@@ -9,9 +11,15 @@
 #include "Player.h"
 #include "skydome.h"
 
+#include "CollisionGrid.h"
+#include "EntityWorld.h"
+#include "RenderResourcePool.h"
+#include "TileInstanceBuffer.h"
+#include "VisibilityCuller.h"
+
+#include <functional>
 #include <vector>
-#include <list> 
-#include "Beam.h"
+#include <queue>
 
 using namespace KamataEngine;
 
@@ -24,8 +32,16 @@ public:
 	GameScene(){} // 明示的に書く場合
 	~GameScene();
 
+	// このシーンで使うアセットの読み込みをワーカーで先に始めておく
+	// (前のシーンの間に呼んでおけば、Initialize ではキャッシュから取るだけで済む)
+	// 返したハンドルは Initialize が終わるまで持っておく (参照が無いと予算を超えた時に捨てられる)
+	static std::vector<AssetRef> PreloadAssets();
+
 	// --- メインループ ---
 	void Initialize();
+	// 死亡からのリトライ用。Initialize 直後の状態に戻す
+	// (モデル・ブロック・定数バッファは読み直さずに使い回す)
+	void Reset();
 	void Update();
 	void Draw();
 
@@ -53,6 +69,15 @@ private:
 	// ★追加: ゲームオブジェクト一括更新 (コード整理用)
 	void UpdateGameObjects();
 
+	// 死亡・消滅したエンティティを回収する
+	void ReapEntities();
+
+	// ビームを発射して着弾・寿命切れを予定に入れる
+	void FireBeam(const Vector3& position,const Vector3& velocity,bool isEnemy);
+
+	// 予定時刻に達したビームのイベントを処理する
+	void ProcessBeamEvents();
+
 
 	// --- メンバ変数 ---
 
@@ -75,37 +100,73 @@ private:
 
 	// 2. ステージ・背景
 	Skydome* skydome_ = nullptr;
-	Model* modelSkydome_ = nullptr;
+	ModelHandle modelSkydome_;
 
 	MapChipField* mapChipField_ = nullptr;
-	Model* modelBlock_ = nullptr;
-	std::vector<std::vector<WorldTransform*>> worldTransformBlocks_;
+	ModelHandle modelBlock_;
+	// ブロックは1つの層としてまとめて描く (ブロックごとの行列は持たず、マス目の番号だけを送る)
+	// 描くのはカメラに映る列と、その左右 kBlockDrawMargin 列だけ
+	static inline const int32_t kBlockDrawMargin = 1;
+	WorldTransform* worldTransformBlockLayer_ = nullptr;
+	TransformChangeTracker blockLayerTracker_; // 層は動かないので転送は最初の1回だけ
+	TileInstanceBuffer blockInstances_;
+	TileInstances::Layout blockLayout_ = {};
 
 	// 3. プレイヤー
 	Player* player_ = nullptr;
-	Model* modelPlayer_ = nullptr;
-	Model* modelAttack_ = nullptr; // 攻撃エフェクト用
+	Vector3 playerStartPosition_ = {};
+	ModelHandle modelPlayer_;
+	ModelHandle modelAttack_; // 攻撃エフェクト用
+
+	// 敵・ビーム・ヒットエフェクトのエンティティ
+	EntityWorld world_;
+	// エンティティ描画用の定数バッファ (描画ごとに借りる)
+	RenderResourcePool renderResourcePool_;
+	// 敵・ビーム・ヒットエフェクトの視錐台カリング (毎フレーム積み直す。判定・省いた数もここで見る)
+	VisibilityCuller visibilityCuller_;
+	// ビーム vs 敵 の広域判定 (毎ティック積み直す。番号は gridEnemies_ と同じ)
+	CollisionGrid enemyGrid_;
+	struct GridEnemy{
+		Enemy::State* state;
+		TransformComponent* transform;
+	};
+	std::vector<GridEnemy> gridEnemies_;
 
 	// 4. 敵キャラクター
-	std::list<Enemy*> enemies_;
-	Model* modelEnemy_ = nullptr; // カカシ
-	Model* modelBoss_ = nullptr;  // ボス
+	ModelHandle modelEnemy_; // カカシ
+	ModelHandle modelBoss_;  // ボス
 
 	// 5. 弾(ビーム)
-	std::list<Beam*> beams_;
-	Model* modelBeam_ = nullptr;
+	// (ビーム本体は world_ の Beam コンポーネント)
+	// 同時に飛んでいるビームの数の目安。イベントの器と描画用の定数バッファを初めからこの数だけ用意する
+	// (超えても撃てる。その時は足りない分だけ作る)
+	static inline const uint32_t kMaxBeams = 256;
+	ModelHandle modelBeam_;
+	ObjectColor beamColor_; // 全ビーム共通の色
+
+	// ビームの予定イベント (壁への着弾 or 寿命切れ)
+	// 先に他の理由で消えたビームはエンティティの世代が合わなくなるので無視される
+	struct BeamEvent{
+		uint32_t tick;
+		Entity entity;
+		bool operator>(const BeamEvent& other) const{ return tick > other.tick; }
+	};
+	std::priority_queue<BeamEvent,std::vector<BeamEvent>,std::greater<BeamEvent>> beamEvents_;
+
+	// シーン開始からのティック数
+	uint32_t tick_ = 0;
 
 	// 6. パーティクル・エフェクト
-	DeathParticles* deathParticles_ = nullptr;
-	Model* modelDeathEffect_ = nullptr;
+	DeathParticles* deathParticles_ = nullptr; // 死亡演出中だけ有効
+	DeathParticles* deathParticlesInstance_ = nullptr; // リトライでも使い回す実体
+	ModelHandle modelDeathEffect_;
 
-	std::list<HitEffect*> hitEffects_;
-	Model* modelParticle_ = nullptr; // 汎用パーティクルモデル
+	ModelHandle modelParticle_; // 汎用パーティクルモデル
 
 	// 7. UI・その他
-	uint32_t textureHandle_ = 0;
+	TextureHandle textureHandle_;
 	Sprite* sprite_ = nullptr;
-	Model* modelArrow_ = nullptr;
+	ModelHandle modelArrow_; // (描く時まで読み込まない)
 
 	// 汎用モデル（必要なら使用）
 	Model* model_ = nullptr;
@@ -1,103 +1,125 @@
 #include "HitEffect.h"
 #include "Math.h"
+#include "RenderResourcePool.h"
+#include "VisibilityCuller.h"
+#include <algorithm>
 #include <cassert>
 #include <numbers>
 #include <random>
 
 using namespace KamataEngine;
 
-Model* HitEffect::model_ = nullptr;
+ModelHandle HitEffect::model_;
 Camera* HitEffect::camera_ = nullptr;
 
-HitEffect* HitEffect::Create(const KamataEngine::Vector3& position) {
-
-	HitEffect* instance = new HitEffect();
-	assert(instance);
-
-	instance->Initialize(position);
-
-	return instance;
-}
-
-void HitEffect::Initialize(const KamataEngine::Vector3& position) {
+Entity HitEffect::Create(EntityWorld& world, const KamataEngine::Vector3& position) {
 
 	std::random_device seedGenerator;
 	std::mt19937_64 randomEngine;
 	randomEngine.seed(seedGenerator());
 	std::uniform_real_distribution<float> rotationDistribution(-std::numbers::pi_v<float>, std::numbers::pi_v<float>);
 
+	State state;
+	state.position = position;
+	state.position.z = -1.0f;
+
 	// 楕円エフェクト
-	for (WorldTransform& worldTransform : ellipseWorldTransforms_) {
-		worldTransform.rotation_ = {0.0f, 0.0f, rotationDistribution(randomEngine)};
-		worldTransform.translation_ = position;
-		worldTransform.translation_.z = -1.0f;
-		worldTransform.Initialize();
+	for (float& rotation : state.ellipseRotations) {
+		rotation = rotationDistribution(randomEngine);
 	}
 
-	// 円形エフェクト
-	circleWorldTransform_.translation_ = position;
-	circleWorldTransform_.Initialize();
-	circleWorldTransform_.translation_.z = -1.0f;
-	objectColor_.Initialize();
+	// (当たり判定のループ中から呼ばれるので遅延生成。Flush で反映される)
+	return world.DeferCreate(state);
 }
 
-void HitEffect::Update() {
+void HitEffect::UpdateAll(EntityWorld& world) {
+	world.ForEach<State>([](Entity, State& state) {
+		if (IsDead(state)) {
+			return; // 既に消滅している場合は更新しない
+		}
 
-	if (IsDead()) {
-		return; // 既に消滅している場合は更新しない
-	}
+		switch (state.phase) {
+		case Phase::kSpread: {
+			++state.counter;
+			state.scale = 0.5f + static_cast<float>(state.counter) / kSpreadTime * 0.5f;
 
-	switch (state_) {
-	case State::kSpread: {
-		++counter_;
-		float scale = 0.5f + static_cast<float>(counter_) / kSpreadTime * 0.5f;
-		const float slashScale = 2.0f;
-		for (auto& slashWorldTransform : ellipseWorldTransforms_) {
-			slashWorldTransform.scale_ = {0.1f, scale * slashScale, 1.0f};
+			if (state.counter >= kSpreadTime) {
+				state.phase = Phase::kFade;
+				state.counter = 0; // カウンターをリセット
+			}
+			break;
 		}
+		case Phase::kFade: {
+			++state.counter;
+			state.alpha = 1.0f - static_cast<float>(state.counter) / kFadeTime;
 
-		const float circleScale = 1.0;
-
-		circleWorldTransform_.scale_ = {scale * circleScale, scale * circleScale, 1.0f};
+			if (++state.counter >= kFadeTime) {
+				state.phase = Phase::kDead;
+			}
 
-		if (counter_ >= kSpreadTime) {
-			state_ = State::kFade;
-			counter_ = 0; // カウンターをリセット
+			break;
 		}
-		break;
-	}
-	case State::kFade: {
-		++counter_;
-		objectColor_.SetColor(Vector4{1.0f, 1.0f, 1.0f, 1.0f - static_cast<float>(counter_) / kFadeTime});
-
-		if (++counter_ >= kFadeTime) {
-			state_ = State::kDead;
+		default:
+			break;
 		}
-
-		break;
-	}
-	default:
-		break;
-	}
-
-	for (auto& slashWorldTransform : ellipseWorldTransforms_) {
-		WorldTransformUpdate(slashWorldTransform);
-	}
-
-	WorldTransformUpdate(circleWorldTransform_);
+	});
 }
 
-void HitEffect::Draw() {
-	assert(model_);
+void HitEffect::DrawAll(EntityWorld& world, RenderResourcePool& renderResourcePool, VisibilityCuller& culler) {
+	MeshModel* model = model_.Get();
+	assert(model);
 	assert(camera_);
 
-	if (IsDead()) {
-		return; // 既に消滅している場合は描画しない
-	}
+	// 楕円・円の大きさと向き (囲む形を求める時と描く時で同じものを使う)
+	const float slashScale = 2.0f;
+	const float circleScale = 1.0;
+	auto forEachPart = [&](const State& state, auto&& function) {
+		for (float rotation : state.ellipseRotations) {
+			function(Vector3{0.1f, state.scale * slashScale, 1.0f}, Vector3{0.0f, 0.0f, rotation});
+		}
+		function(Vector3{state.scale * circleScale, state.scale * circleScale, 1.0f}, Vector3{});
+	};
+
+	// 1. 楕円と円をまとめて囲む箱を積み、画面の外のものを除く
+	uint32_t first = culler.GetTestedCount();
+	world.ForEach<State>([&](Entity, State& state) {
+		if (IsDead(state)) {
+			return;
+		}
+		Vector3 boxMin;
+		Vector3 boxMax;
+		bool isFirstPart = true;
+		forEachPart(state, [&](const Vector3& scale, const Vector3& rotation) {
+			Vector3 center;
+			Vector3 extent;
+			model->GetWorldBoundingBox(MakeAffineMatrix(scale, rotation, state.position), center, extent);
+			Vector3 partMin = {center.x - extent.x, center.y - extent.y, center.z - extent.z};
+			Vector3 partMax = {center.x + extent.x, center.y + extent.y, center.z + extent.z};
+			boxMin = isFirstPart ? partMin : Vector3{std::min(boxMin.x, partMin.x), std::min(boxMin.y, partMin.y), std::min(boxMin.z, partMin.z)};
+			boxMax = isFirstPart ? partMax : Vector3{std::max(boxMax.x, partMax.x), std::max(boxMax.y, partMax.y), std::max(boxMax.z, partMax.z)};
+			isFirstPart = false;
+		});
+		culler.AddBox({(boxMin.x + boxMax.x) * 0.5f, (boxMin.y + boxMax.y) * 0.5f, (boxMin.z + boxMax.z) * 0.5f},
+		              {(boxMax.x - boxMin.x) * 0.5f, (boxMax.y - boxMin.y) * 0.5f, (boxMax.z - boxMin.z) * 0.5f});
+	});
+	culler.Cull();
+
+	// 2. 見えるものだけ描く (ForEach の順は 1. と同じ)
+	uint32_t index = first;
+	world.ForEach<State>([&](Entity, State& state) {
+		if (IsDead(state)) {
+			return; // 既に消滅している場合は描画しない
+		}
+		if (!culler.IsVisible(index++)) {
+			return;
+		}
 
-	for (auto& slashWorldTransform : ellipseWorldTransforms_) {
-		model_->Draw(slashWorldTransform, *camera_, &objectColor_);
-	}
+		ObjectColor& objectColor = renderResourcePool.AcquireColor();
+		objectColor.SetColor(Vector4{1.0f, 1.0f, 1.0f, state.alpha});
 
-	model_->Draw(circleWorldTransform_, *camera_, &objectColor_);
-}
\ No newline at end of file
+		forEachPart(state, [&](const Vector3& scale, const Vector3& rotation) {
+			const WorldTransform& worldTransform = renderResourcePool.AcquireTransform(scale, rotation, state.position);
+			model->Draw(worldTransform, *camera_, &objectColor);
+		});
+	});
+}
@@ -1,46 +1,44 @@
 #include <KamataEngine.h>
+#include "AssetCache.h"
+#include "EntityWorld.h"
+#include "HitEffectState.h"
+#include <array>
 #include <cstdint>
 
+class RenderResourcePool;
+class VisibilityCuller;
+
 #pragma once
+// ヒットエフェクトは EntityWorld のエンティティとして持つ (HitEffect::State)
+// このクラスはヒットエフェクトの生成・更新・描画をまとめたもの
 class HitEffect {
 public:
-	enum class State {
-		kSpread, // 拡大中
-		kFade,   // フェードアウト中
-		kDead    // 死亡
-	};
+	using Phase = HitEffectPhase;
 
-	static void SetModel(KamataEngine::Model* model) { model_ = model; }
-	static void SetCamera(KamataEngine::Camera* camera) { camera_ = camera; }
-	static HitEffect* Create(const KamataEngine::Vector3& position);
+	static const inline uint32_t kellipseEffectNum = HitEffectState::kEllipseCount;
 
-	void Update();
+	// エフェクトごとの状態 (コンポーネント。中身は HitEffectState.h)
+	using State = HitEffectState;
 
-	void Draw();
+	// (ハンドルを持つので、設定している間はキャッシュに捨てられない。シーンの終わりに空のハンドルで外す)
+	static void SetModel(const ModelHandle& model) { model_ = model; }
+	static void SetCamera(KamataEngine::Camera* camera) { camera_ = camera; }
+	static Entity Create(EntityWorld& world, const KamataEngine::Vector3& position);
 
-	bool IsDead() const { return state_ == State::kDead; }
+	static void UpdateAll(EntityWorld& world);
 
-private:
-	HitEffect() = default;
+	// 画面に入るものだけ描く (囲む形は culler に積んで判定する)
+	static void DrawAll(EntityWorld& world, RenderResourcePool& renderResourcePool, VisibilityCuller& culler);
 
-	void Initialize(const KamataEngine::Vector3& position);
+	static bool IsDead(const State& state) { return state.phase == Phase::kDead; }
 
+private:
 	static inline const uint32_t kSpreadTime = 10;
 
 	static inline const uint32_t kFadeTime = 20;
 
 	static inline const uint32_t kLifetime = kSpreadTime + kFadeTime;
 
-	static KamataEngine::Model* model_;
+	static ModelHandle model_;
 	static KamataEngine::Camera* camera_;
-
-	static const inline uint32_t kellipseEffectNum = 2;
-
-	std::array<KamataEngine::WorldTransform, kellipseEffectNum> ellipseWorldTransforms_;
-
-	KamataEngine::WorldTransform circleWorldTransform_;
-	State state_ = State::kSpread;
-
-	uint32_t counter_ = 0;
-	KamataEngine::ObjectColor objectColor_;
-};
\ No newline at end of file
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <math/Vector3.h>
+
+// ==========================================
+// ヒットエフェクトのエンティティのコンポーネント (HitEffect::State)
+// HitEffect.h は描画のためにエンジンを読むので、コンポーネントだけここに分ける
+// (D3D を使わないので AssetCooker の計測でも同じ型を使う)
+// ==========================================
+
+// HitEffect::Phase
+enum class HitEffectPhase{
+	kSpread, // 拡大中
+	kFade,   // フェードアウト中
+	kDead    // 死亡
+};
+
+// エフェクトごとの状態 (HitEffect::State)
+struct HitEffectState{
+	// 楕円の数
+	static const inline uint32_t kEllipseCount = 2;
+
+	HitEffectPhase phase = HitEffectPhase::kSpread;
+	uint32_t counter = 0;
+	KamataEngine::Vector3 position = {};
+	std::array<float,kEllipseCount> ellipseRotations = {};
+	float scale = 0.5f;
+	float alpha = 1.0f;
+};
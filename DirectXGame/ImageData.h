@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ==========================================
+// CPU 側の画像 (RGBA 各8ビット、色は sRGB のまま)
+// PngLoader で読み、TextureCompressor / CookedTexture で使う
+// ==========================================
+struct ImageData{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels; // width * height * 4 (左上から行ごと)
+
+	const uint8_t* GetPixel(uint32_t x,uint32_t y) const{ return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+	uint8_t* GetPixel(uint32_t x,uint32_t y){ return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+
+	// 全画素が不透明なら true
+	bool IsOpaque() const{
+		for(size_t i = 3; i < pixels.size(); i += 4){
+			if(pixels[i] != 255){
+				return false;
+			}
+		}
+		return true;
+	}
+};
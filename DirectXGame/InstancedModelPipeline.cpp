@@ -0,0 +1,117 @@
+#include "InstancedModelPipeline.h"
+#include <cassert>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+#include <string>
+
+#pragma comment(lib,"d3dcompiler.lib")
+
+namespace{
+
+// ModelCommon のパイプラインと同じ出力先
+const DXGI_FORMAT kRenderTargetFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+const DXGI_FORMAT kDepthStencilFormat = DXGI_FORMAT_D32_FLOAT;
+
+Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(const wchar_t* path,const char* target){
+	UINT flags = 0;
+#ifdef _DEBUG
+	flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+	Microsoft::WRL::ComPtr<ID3DBlob> blob;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+	HRESULT result = D3DCompileFromFile(path,nullptr,D3D_COMPILE_STANDARD_FILE_INCLUDE,"main",target,flags,0,&blob,&errorBlob);
+	if(FAILED(result)){
+		if(errorBlob){
+			std::string message(static_cast<const char*>(errorBlob->GetBufferPointer()),errorBlob->GetBufferSize());
+			OutputDebugStringA(message.c_str());
+		}
+		assert(false);
+	}
+	return blob;
+}
+
+} // namespace
+
+InstancedModelPipeline* InstancedModelPipeline::GetInstance(){
+	static InstancedModelPipeline instance;
+	return &instance;
+}
+
+void InstancedModelPipeline::Initialize(){
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	Microsoft::WRL::ComPtr<ID3DBlob> vsBlob = CompileShader(L"Resources/shaders/ObjInstancedVS.hlsl","vs_5_0");
+	Microsoft::WRL::ComPtr<ID3DBlob> psBlob = CompileShader(L"Resources/shaders/ObjInstancedPS.hlsl","ps_5_0");
+
+	// 頂点はスロット 0 (Mesh::VertexPosNormalUv)、インスタンスはスロット 1 (TileInstance)
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+	    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,   0},
+	    {"NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,   0},
+	    {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,   0},
+	    {"TILE",     0, DXGI_FORMAT_R16G16_SINT,     1, 0,                            D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	    {"COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM,  1, 4,                            D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	};
+
+	// ルートシグネチャ (0～5 は Model::RoomParameter と同じ)
+	CD3DX12_DESCRIPTOR_RANGE textureRange;
+	textureRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV,1,0); // t0
+	CD3DX12_ROOT_PARAMETER rootParameters[kTileLayer + 1] = {};
+	rootParameters[static_cast<UINT>(Model::RoomParameter::kWorldTransform)].InitAsConstantBufferView(0);
+	rootParameters[static_cast<UINT>(Model::RoomParameter::kCamera)].InitAsConstantBufferView(1);
+	rootParameters[static_cast<UINT>(Model::RoomParameter::kMaterial)].InitAsConstantBufferView(2);
+	rootParameters[static_cast<UINT>(Model::RoomParameter::kTexture)].InitAsDescriptorTable(1,&textureRange);
+	rootParameters[static_cast<UINT>(Model::RoomParameter::kLight)].InitAsConstantBufferView(3);
+	rootParameters[static_cast<UINT>(Model::RoomParameter::kObjectColor)].InitAsConstantBufferView(4);
+	rootParameters[kTileLayer].InitAsConstants(2,5);
+
+	CD3DX12_STATIC_SAMPLER_DESC samplerDesc(0,D3D12_FILTER_MIN_MAG_MIP_LINEAR);
+	CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init(_countof(rootParameters),rootParameters,1,&samplerDesc,D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	Microsoft::WRL::ComPtr<ID3DBlob> rootSignatureBlob;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+	HRESULT result = D3D12SerializeRootSignature(&rootSignatureDesc,D3D_ROOT_SIGNATURE_VERSION_1_0,&rootSignatureBlob,&errorBlob);
+	assert(SUCCEEDED(result));
+	result = device->CreateRootSignature(0,rootSignatureBlob->GetBufferPointer(),rootSignatureBlob->GetBufferSize(),IID_PPV_ARGS(&rootSignature_));
+	assert(SUCCEEDED(result));
+
+	// パイプライン (半透明は Model と同じくアルファブレンド)
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineDesc = {};
+	pipelineDesc.pRootSignature = rootSignature_.Get();
+	pipelineDesc.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+	pipelineDesc.PS = CD3DX12_SHADER_BYTECODE(psBlob.Get());
+	pipelineDesc.InputLayout = {inputLayout, _countof(inputLayout)};
+	pipelineDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	pipelineDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	pipelineDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	pipelineDesc.DSVFormat = kDepthStencilFormat;
+
+	D3D12_RENDER_TARGET_BLEND_DESC& blendDesc = pipelineDesc.BlendState.RenderTarget[0];
+	blendDesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+	blendDesc.BlendEnable = TRUE;
+	blendDesc.BlendOp = D3D12_BLEND_OP_ADD;
+	blendDesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blendDesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	blendDesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blendDesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blendDesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+
+	pipelineDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	pipelineDesc.NumRenderTargets = 1;
+	pipelineDesc.RTVFormats[0] = kRenderTargetFormat;
+	pipelineDesc.SampleDesc.Count = 1;
+	result = device->CreateGraphicsPipelineState(&pipelineDesc,IID_PPV_ARGS(&pipelineState_));
+	assert(SUCCEEDED(result));
+	(void)result;
+}
+
+void InstancedModelPipeline::SetPipeline(ID3D12GraphicsCommandList* commandList,float tileWidth,float tileHeight){
+	if(!pipelineState_){
+		Initialize();
+	}
+	commandList->SetPipelineState(pipelineState_.Get());
+	commandList->SetGraphicsRootSignature(rootSignature_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	const float tileSize[2] = {tileWidth, tileHeight};
+	commandList->SetGraphicsRoot32BitConstants(kTileLayer,2,tileSize,0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "KamataEngine.h"
+#include <d3d12.h>
+#include <wrl.h>
+
+using namespace KamataEngine;
+
+// ==========================================
+// インスタンス描画用のパイプライン (ObjInstancedVS / ObjInstancedPS)
+// ルートパラメータ 0～5 は Model::RoomParameter と同じ並びなので、
+// ModelCommon のライト・行列のコマンドとマテリアルのコマンドをそのまま使える
+// 頂点は Model と同じ (スロット 0)。スロット 1 にインスタンスごとの TileInstance を読む
+// 初めて使う時に作る (シェーダーは Model と同じく実行時にコンパイルする)
+// ==========================================
+class InstancedModelPipeline{
+public:
+	// タイルの大きさ (b5、32bit 定数 2 つ)
+	static inline const UINT kTileLayer = static_cast<UINT>(Model::RoomParameter::kObjectColor) + 1;
+
+	static InstancedModelPipeline* GetInstance();
+
+	// パイプラインとルートシグネチャを切り替える (戻すのは ModelCommon::PreDraw)
+	void SetPipeline(ID3D12GraphicsCommandList* commandList,float tileWidth,float tileHeight);
+
+private:
+	InstancedModelPipeline() = default;
+	~InstancedModelPipeline() = default;
+	InstancedModelPipeline(const InstancedModelPipeline&) = delete;
+	InstancedModelPipeline& operator=(const InstancedModelPipeline&) = delete;
+
+	void Initialize();
+
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
+};
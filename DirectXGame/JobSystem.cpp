@@ -0,0 +1,67 @@
+#include "JobSystem.h"
+
+JobSystem* JobSystem::GetInstance(){
+	static JobSystem instance;
+	return &instance;
+}
+
+JobSystem::~JobSystem(){
+	Shutdown();
+}
+
+void JobSystem::Initialize(uint32_t numThreads){
+	if(!threads_.empty()){
+		return;
+	}
+	if(numThreads == 0){
+		uint32_t cores = std::thread::hardware_concurrency();
+		numThreads = cores > 1 ? cores - 1 : 1;
+	}
+
+	isStopping_ = false;
+	threads_.reserve(numThreads);
+	for(uint32_t i = 0; i < numThreads; ++i){
+		threads_.emplace_back([this](){ WorkerMain(); });
+	}
+}
+
+void JobSystem::Shutdown(){
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+	}
+	condition_.notify_all();
+	for(std::thread& thread : threads_){
+		thread.join();
+	}
+	threads_.clear();
+}
+
+void JobSystem::Submit(std::function<void()> job){
+	if(threads_.empty()){
+		job();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(std::move(job));
+	}
+	condition_.notify_one();
+}
+
+void JobSystem::WorkerMain(){
+	for(;;){
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock,[this](){ return isStopping_ || !jobs_.empty(); });
+			// 止める時も、残っているジョブは全部片付けてから抜ける
+			if(jobs_.empty()){
+				return;
+			}
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+		}
+		job();
+	}
+}
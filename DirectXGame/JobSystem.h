@@ -0,0 +1,44 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ==========================================
+// ワーカースレッドのプール
+// ・Submit したジョブを空いているワーカーが順に実行する
+// ・ジョブの中から D3D12 のコマンドやエンジンの読み込み関数を呼んではいけない
+//   (GPU に関わる処理はメインスレッドに戻してから行う)
+// ・Initialize 前 (ワーカー0本) は Submit した場でそのまま実行する
+// ==========================================
+class JobSystem{
+public:
+	static JobSystem* GetInstance();
+
+	// ワーカーを起動する (0 ならコア数 - 1 本。メインスレッドの分を空けておく)
+	void Initialize(uint32_t numThreads = 0);
+	// 積まれているジョブを全て終わらせてからワーカーを止める
+	void Shutdown();
+
+	// ジョブを積む
+	void Submit(std::function<void()> job);
+
+	uint32_t GetThreadCount() const{ return static_cast<uint32_t>(threads_.size()); }
+
+private:
+	JobSystem() = default;
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	void WorkerMain();
+
+	std::vector<std::thread> threads_;
+	std::deque<std::function<void()>> jobs_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	bool isStopping_ = false;
+};
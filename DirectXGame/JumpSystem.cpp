@@ -1,6 +1,6 @@
 #include "JumpSystem.h"
 
-void JumpSystem::Initialize(Model *model, uint32_t textureHandle) {
+void JumpSystem::Initialize(const ModelHandle &model, uint32_t textureHandle) {
   model_ = model;
   textureHandle_ = textureHandle;
   worldTransform_.Initialize();
@@ -28,6 +28,13 @@ void JumpSystem::Spawn(Vector3 position) {
   }
 }
 
+void JumpSystem::Clear() { particles_.clear(); }
+
+void JumpSystem::ReleaseModel() {
+  Clear();
+  model_.Reset();
+}
+
 void JumpSystem::Update(float deltaTime) {
   for (auto it = particles_.begin(); it != particles_.end();) {
     it->Update(deltaTime);
@@ -39,11 +46,29 @@ void JumpSystem::Update(float deltaTime) {
   }
 }
 
-void JumpSystem::Draw(Camera *camera) {
-  if (!model_)
+void JumpSystem::Draw(Camera *camera, VisibilityCuller &culler) {
+  MeshModel *model = model_.Get();
+  if (!model)
     return;
 
+  // 粒を囲む球を積んで、画面の外のものを除く
+  uint32_t first = culler.GetTestedCount();
   for (const auto &p : particles_) {
+    Vector3 center;
+    float radius;
+    model->GetWorldBoundingSphere(
+        MakeAffineMatrix({p.scale, p.scale, p.scale}, worldTransform_.rotation_,
+                         p.position),
+        center, radius);
+    culler.AddSphere(center, radius);
+  }
+  culler.Cull();
+
+  uint32_t index = first;
+  for (const auto &p : particles_) {
+    if (!culler.IsVisible(index++)) {
+      continue;
+    }
     worldTransform_.translation_ = p.position;
     worldTransform_.scale_ = {p.scale, p.scale, p.scale};
 
@@ -52,7 +77,7 @@ void JumpSystem::Draw(Camera *camera) {
     colorHelper_.SetColor({0.9f, 0.9f, 0.9f, alpha});
 
     WorldTransformUpdate(worldTransform_);
-    model_->Draw(worldTransform_, *camera, textureHandle_, &colorHelper_);
+    model->Draw(worldTransform_, *camera, textureHandle_, &colorHelper_);
   }
 
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "AssetCache.h"
 #include "JumpParticle.h"
 #include "ParticleManager.h"
 #include <list>
@@ -6,19 +7,25 @@
 class JumpSystem : public EffectSystemBase {
 public:
   // プレイヤーモデルとテクスチャを受け取る
-  void Initialize(Model *model, uint32_t textureHandle);
+  // (ハンドルを持つので、このシステムが使っている間はキャッシュに捨てられない)
+  void Initialize(const ModelHandle &model, uint32_t textureHandle);
 
   void Update(float deltaTime) override;
-  void Draw(Camera *camera) override;
+  void Draw(Camera *camera, VisibilityCuller &culler) override;
 
   // ジャンプした位置（足元）を指定して発生させる
   void Spawn(Vector3 position);
 
+  // 全て消す (リトライ用)
+  void Clear();
+  // 粒を消してモデルの参照を外す (シーンの終わりに呼ぶ)
+  void ReleaseModel();
+
 private:
   std::list<JumpParticle> particles_;
 
   WorldTransform worldTransform_;
-  Model *model_ = nullptr;
+  ModelHandle model_;
   uint32_t textureHandle_ = 0;
   ObjectColor colorHelper_;
 };
\ No newline at end of file
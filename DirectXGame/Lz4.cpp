@@ -0,0 +1,156 @@
+#include "Lz4.h"
+#include <cstdint>
+#include <cstring>
+
+namespace{
+
+const size_t kMinMatch = 4;
+const size_t kMaxOffset = 65535;
+// 形式の決まり: 最後の一致は終わりの12バイトより前で始まり、最後の5バイトは必ずリテラル
+const size_t kMatchStartLimit = 12;
+const size_t kLastLiterals = 5;
+const uint32_t kHashBits = 12;
+
+uint32_t Read32(const std::byte* data){
+	uint32_t value;
+	std::memcpy(&value,data,sizeof(value));
+	return value;
+}
+
+uint32_t Hash(uint32_t sequence){
+	return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// 15 以上の長さは 255 ずつ足していく
+void WriteLength(std::vector<std::byte>& output,size_t length){
+	for(; length >= 255; length -= 255){
+		output.push_back(std::byte{255});
+	}
+	output.push_back(static_cast<std::byte>(length));
+}
+
+void WriteSequence(std::vector<std::byte>& output,const std::byte* literals,size_t literalLength,size_t offset,size_t matchLength){
+	size_t matchCode = matchLength >= kMinMatch ? matchLength - kMinMatch : 0;
+	uint8_t token = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+	if(matchLength >= kMinMatch){
+		token |= static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+	}
+	output.push_back(static_cast<std::byte>(token));
+	if(literalLength >= 15){
+		WriteLength(output,literalLength - 15);
+	}
+	output.insert(output.end(),literals,literals + literalLength);
+	if(matchLength < kMinMatch){
+		return; // 最後のリテラルだけの組
+	}
+	output.push_back(static_cast<std::byte>(offset & 0xFF));
+	output.push_back(static_cast<std::byte>(offset >> 8));
+	if(matchCode >= 15){
+		WriteLength(output,matchCode - 15);
+	}
+}
+
+// 読めなければ false (長さが続くのに入力が尽きた)
+bool ReadLength(const std::byte*& cursor,const std::byte* end,size_t& length){
+	for(;;){
+		if(cursor >= end){
+			return false;
+		}
+		uint8_t value = static_cast<uint8_t>(*cursor++);
+		length += value;
+		if(value != 255){
+			return true;
+		}
+	}
+}
+
+} // namespace
+
+std::vector<std::byte> Lz4::Compress(std::span<const std::byte> source){
+	std::vector<std::byte> output;
+	output.reserve(source.size() + source.size() / 255 + 16);
+	const std::byte* data = source.data();
+	size_t size = source.size();
+
+	// 位置 + 1 を入れる (0 は空き)
+	std::vector<uint32_t> table(size_t{1} << kHashBits,0);
+	size_t anchor = 0;
+	size_t position = 0;
+	if(size >= kMatchStartLimit + 1){
+		size_t matchStartEnd = size - kMatchStartLimit;
+		size_t matchEnd = size - kLastLiterals;
+		while(position < matchStartEnd){
+			uint32_t sequence = Read32(data + position);
+			uint32_t& slot = table[Hash(sequence)];
+			size_t candidate = slot;
+			slot = static_cast<uint32_t>(position + 1);
+			if(candidate == 0 || position - (candidate - 1) > kMaxOffset || Read32(data + candidate - 1) != sequence){
+				++position;
+				continue;
+			}
+			size_t reference = candidate - 1;
+
+			size_t length = kMinMatch;
+			while(position + length < matchEnd && data[reference + length] == data[position + length]){
+				++length;
+			}
+			WriteSequence(output,data + anchor,position - anchor,position - reference,length);
+			position += length;
+			anchor = position;
+		}
+	}
+	WriteSequence(output,data + anchor,size - anchor,0,0);
+	return output;
+}
+
+bool Lz4::Decompress(std::span<const std::byte> source,std::span<std::byte> destination){
+	const std::byte* cursor = source.data();
+	const std::byte* end = cursor + source.size();
+	std::byte* output = destination.data();
+	std::byte* outputEnd = output + destination.size();
+
+	while(cursor < end){
+		uint8_t token = static_cast<uint8_t>(*cursor++);
+		size_t literalLength = token >> 4;
+		if(literalLength == 15 && !ReadLength(cursor,end,literalLength)){
+			return false;
+		}
+		if(literalLength > static_cast<size_t>(end - cursor) || literalLength > static_cast<size_t>(outputEnd - output)){
+			return false;
+		}
+		if(literalLength > 0){
+			std::memcpy(output,cursor,literalLength);
+			cursor += literalLength;
+			output += literalLength;
+		}
+		if(cursor == end){
+			break; // 最後の組はリテラルだけ
+		}
+
+		if(end - cursor < 2){
+			return false;
+		}
+		size_t offset = static_cast<size_t>(cursor[0]) | static_cast<size_t>(cursor[1]) << 8;
+		cursor += 2;
+		size_t matchLength = token & 15;
+		if(matchLength == 15 && !ReadLength(cursor,end,matchLength)){
+			return false;
+		}
+		matchLength += kMinMatch;
+		if(offset == 0 || offset > static_cast<size_t>(output - destination.data()) || matchLength > static_cast<size_t>(outputEnd - output)){
+			return false;
+		}
+		// 重なっている (offset < 長さ) と同じ並びの繰り返しになるので、1バイトずつ写す
+		const std::byte* match = output - offset;
+		if(offset >= matchLength){
+			std::memcpy(output,match,matchLength);
+			output += matchLength;
+		}
+		else{
+			for(size_t i = 0; i < matchLength; ++i){
+				*output++ = match[i];
+			}
+		}
+	}
+	return output == outputEnd;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// ==========================================
+// LZ4 のブロック形式での圧縮・展開
+// 展開は1バイトあたり数命令で、ディスクから読むより速い (パック内のテキストなど用)
+// 圧縮は1つのハッシュ表で一番近い候補だけを見る (速さ優先。率は本家の高速モードと同程度)
+// ==========================================
+class Lz4{
+public:
+	// 圧縮できなくても (元より大きくなっても) そのまま返す。使うかどうかは呼び出し側で決める
+	static std::vector<std::byte> Compress(std::span<const std::byte> source);
+	// destination の大きさちょうどに展開できた時だけ true (壊れたデータでも範囲外には書かない)
+	static bool Decompress(std::span<const std::byte> source,std::span<std::byte> destination);
+};
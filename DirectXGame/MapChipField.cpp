@@ -1,20 +1,26 @@
+#define NOMINMAX
+
 #include "MapChipField.h"
+#include "CookedLevel.h"
 #include <cassert>
-#include <fstream>
-#include <map>
-#include <sstream>
+#include <cmath>
+#include <limits>
 #include <string>
 
 // 内部リンケージ
 namespace{
 
-	std::map<std::string,MapChipType> mapChipTable = {
-		{"0", MapChipType::kBlank},
-		{"1", MapChipType::kBlock},
-		{"10", MapChipType::kZako},
-		{"11", MapChipType::kBoss},
-
-	};
+	// CSV (.kmap) のセルの値 → 種類 (知らない値は空白)
+	MapChipType ToMapChipType(uint8_t value){
+		switch(static_cast<MapChipType>(value)){
+		case MapChipType::kBlock:
+		case MapChipType::kZako:
+		case MapChipType::kBoss:
+			return static_cast<MapChipType>(value);
+		default:
+			return MapChipType::kBlank;
+		}
+	}
 }
 
 // マップチップデータをリセット
@@ -29,48 +35,29 @@ void MapChipField::ResetMapChipData(){
 }
 
 void MapChipField::LoadMapChipCsv(const std::string& filePath){
-	// ファイルを開く
-	std::ifstream file;
-	file.open(filePath);
-	assert(file.is_open());
-
-	//  マップチップCSV
-	std::stringstream mapChipCsv;
-
-	// ファイルの内容を文字列ストリームにコピー
-	mapChipCsv << file.rdbuf();
-
-	// ファイルを閉じる
-	file.close();
+	// クック済み (.kmap) が新しければそちらを読む
+	CookedLevel::Level level;
+	bool isLoaded = CookedLevel::IsUpToDate(filePath) && CookedLevel::Read(CookedLevel::GetPath(filePath),level);
+	if(!isLoaded){
+		isLoaded = CookedLevel::ParseCsv(filePath,level);
+	}
+	assert(isLoaded);
+	(void)isLoaded;
 
 	// マップチップデータをリセット
 	ResetMapChipData();
 
-	std::string line;
-
-	// CSVからマップチップデータを読み込む
-	for(uint32_t i = 0; i < kNumBlockVirtical; ++i){
-
-		getline(mapChipCsv,line);
-
-		// 1行分の文字列をストリームに変換して解析しやすくする
-		std::istringstream line_stream(line);
-
-		for(uint32_t j = 0; j < kNumBlockHorizontal; ++j){
-
-			std::string word;
-			getline(line_stream,word,',');
-
-			if(mapChipTable.contains(word)){
-				mapChipData_.data[i][j] = mapChipTable[word];
-			}
+	// 範囲外のセルは空白のまま
+	for(uint32_t i = 0; i < kNumBlockVirtical && i < level.height; ++i){
+		for(uint32_t j = 0; j < kNumBlockHorizontal && j < level.width; ++j){
+			mapChipData_.data[i][j] = ToMapChipType(level.cells[static_cast<size_t>(i) * level.width + j]);
 		}
 	}
 }
 
 Vector3 MapChipField::GetMapChipPositionByIndex(uint32_t xIndex,uint32_t yIndex){ return Vector3(kBlockWidth * xIndex,kBlockHeight * (kNumBlockVirtical - 1 - yIndex),0); }
 
-MapChipType MapChipField::GetMapChipTypeByIndex(uint32_t xIndex,uint32_t yIndex){
+MapChipType MapChipField::GetMapChipTypeByIndex(uint32_t xIndex,uint32_t yIndex) const{
 	if(xIndex < 0 || kNumBlockHorizontal - 1 < xIndex){
 		return MapChipType::kBlank;
 	}
@@ -104,4 +91,78 @@ MapChipField::Rect MapChipField::GetRectByIndex(uint32_t xIndex,uint32_t yIndex)
 
 	return rect;
 }
+// グリッドを1マスずつ辿る (Amanatides-Woo のDDA)
+bool MapChipField::RaycastBlock(const Vector3& origin,const Vector3& direction,float maxT,float& hitT) const{
+	const float kInfinity = std::numeric_limits<float>::infinity();
+
+	// ブロックの奥行き (z = 0 を中心に厚さ kBlockWidth) と交差する区間
+	float zEnter = 0.0f;
+	float zExit = maxT;
+	if(direction.z != 0.0f){
+		float t0 = (-kBlockWidth / 2.0f - origin.z) / direction.z;
+		float t1 = (+kBlockWidth / 2.0f - origin.z) / direction.z;
+		zEnter = std::max(zEnter,std::min(t0,t1));
+		zExit = std::min(zExit,std::max(t0,t1));
+	} else if(std::abs(origin.z) > kBlockWidth / 2.0f){
+		return false;
+	}
+	if(zEnter > zExit){
+		return false;
+	}
+
+	// マスの座標 (x は左から、row は下から数える)
+	int32_t cellX = static_cast<int32_t>(std::floor((origin.x + kBlockWidth / 2.0f) / kBlockWidth));
+	int32_t row = static_cast<int32_t>(std::floor((origin.y + kBlockHeight / 2.0f) / kBlockHeight));
+
+	int32_t stepX = (direction.x > 0.0f) ? 1 : -1;
+	int32_t stepRow = (direction.y > 0.0f) ? 1 : -1;
+
+	// 次の縦・横の境界に着くまでの t と、1マス進むのにかかる t
+	float tMaxX = kInfinity;
+	float tDeltaX = kInfinity;
+	if(direction.x != 0.0f){
+		float boundaryX = (static_cast<float>(cellX) + (stepX > 0 ? 0.5f : -0.5f)) * kBlockWidth;
+		tMaxX = (boundaryX - origin.x) / direction.x;
+		tDeltaX = kBlockWidth / std::abs(direction.x);
+	}
+	float tMaxY = kInfinity;
+	float tDeltaY = kInfinity;
+	if(direction.y != 0.0f){
+		float boundaryY = (static_cast<float>(row) + (stepRow > 0 ? 0.5f : -0.5f)) * kBlockHeight;
+		tMaxY = (boundaryY - origin.y) / direction.y;
+		tDeltaY = kBlockHeight / std::abs(direction.y);
+	}
+
+	float t = 0.0f;
+	while(t <= zExit){
+		float tExitCell = std::min(tMaxX,tMaxY);
+
+		bool inMap = cellX >= 0 && cellX < static_cast<int32_t>(kNumBlockHorizontal) &&
+			row >= 0 && row < static_cast<int32_t>(kNumBlockVirtical);
+		if(inMap && tExitCell >= zEnter){
+			uint32_t yIndex = kNumBlockVirtical - 1 - static_cast<uint32_t>(row);
+			if(GetMapChipTypeByIndex(static_cast<uint32_t>(cellX),yIndex) == MapChipType::kBlock){
+				hitT = std::max(t,zEnter);
+				return true;
+			}
+		}
+
+		// 次のマスへ
+		if(tMaxX < tMaxY){
+			t = tMaxX;
+			tMaxX += tDeltaX;
+			cellX += stepX;
+		} else{
+			t = tMaxY;
+			tMaxY += tDeltaY;
+			row += stepRow;
+		}
+
+		if(t == kInfinity){
+			break;
+		}
+	}
+
+	return false;
+}
 // eof
\ No newline at end of file
@@ -1,7 +1,6 @@
 #pragma once
 
-#include "KamataEngine.h"
-#include "Math.h"
+#include "ConstexprMath.h"
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -42,7 +41,7 @@ public:
 	void LoadMapChipCsv(const std::string& filePath);
 
 	Vector3 GetMapChipPositionByIndex(uint32_t xIndex,uint32_t yIndex);
-	MapChipType GetMapChipTypeByIndex(uint32_t xIndex,uint32_t yIndex);
+	MapChipType GetMapChipTypeByIndex(uint32_t xIndex,uint32_t yIndex) const;
 
 	uint32_t GetNumBlockVirtical() const{ return kNumBlockVirtical; }
 	uint32_t GetNumBlockHorizontal() const{ return kNumBlockHorizontal; }
@@ -52,6 +51,10 @@ public:
 	// 02_07 スライド33枚目
 	Rect GetRectByIndex(uint32_t xIndex,uint32_t yIndex);
 
+	// 直線 origin + direction * t (0 <= t <= maxT) が最初にブロックに入る t を求める
+	// ブロックに当たらなければ false
+	bool RaycastBlock(const Vector3& origin,const Vector3& direction,float maxT,float& hitT) const;
+
 private:
 	static inline const uint32_t kNumBlockVirtical = 20;
 	static inline const uint32_t kNumBlockHorizontal = 100;
@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile(){
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path){
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+	if(file == INVALID_HANDLE_VALUE){
+		return false;
+	}
+	LARGE_INTEGER size{};
+	if(!GetFileSizeEx(file,&size) || size.QuadPart == 0){
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+	if(!mapping){
+		CloseHandle(file);
+		return false;
+	}
+	void* view = MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+	if(!view){
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	file_ = file;
+	mapping_ = mapping;
+	data_ = static_cast<const std::byte*>(view);
+	size_ = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::Close(){
+	if(data_){
+		UnmapViewOfFile(data_);
+	}
+	if(mapping_){
+		CloseHandle(mapping_);
+	}
+	if(file_){
+		CloseHandle(file_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	mapping_ = nullptr;
+	file_ = nullptr;
+}
+
+void MappedFile::Prefetch(size_t offset,size_t size) const{
+	if(!data_ || offset >= size_){
+		return;
+	}
+	WIN32_MEMORY_RANGE_ENTRY range = {const_cast<std::byte*>(data_ + offset),(std::min)(size,size_ - offset)}; // (Windows.h の min マクロを避ける)
+	PrefetchVirtualMemory(GetCurrentProcess(),1,&range,0);
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path){
+	Close();
+
+	int file = open(path.c_str(),O_RDONLY);
+	if(file < 0){
+		return false;
+	}
+	struct stat status{};
+	if(fstat(file,&status) != 0 || status.st_size == 0){
+		close(file);
+		return false;
+	}
+	void* view = mmap(nullptr,static_cast<size_t>(status.st_size),PROT_READ,MAP_PRIVATE,file,0);
+	if(view == MAP_FAILED){
+		close(file);
+		return false;
+	}
+
+	file_ = file;
+	data_ = static_cast<const std::byte*>(view);
+	size_ = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+void MappedFile::Close(){
+	if(data_){
+		munmap(const_cast<std::byte*>(data_),size_);
+	}
+	if(file_ >= 0){
+		close(file_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	file_ = -1;
+}
+
+void MappedFile::Prefetch(size_t offset,size_t size) const{
+	if(!data_ || offset >= size_){
+		return;
+	}
+	// (madvise はページ境界から)
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t begin = offset / pageSize * pageSize;
+	size_t end = offset + std::min(size,size_ - offset);
+	madvise(const_cast<std::byte*>(data_ + begin),end - begin,MADV_WILLNEED);
+}
+
+#endif
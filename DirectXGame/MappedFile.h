@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// ==========================================
+// 読み取り専用でメモリにマップしたファイル
+// 中身はページ単位で必要になった時に読まれるので、開くだけならほぼコストがない
+// ==========================================
+class MappedFile{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const{ return data_ != nullptr; }
+	const std::byte* GetData() const{ return data_; }
+	size_t GetSize() const{ return size_; }
+
+	// この範囲をまとめて読み込ませる (触った時に1ページずつ読むのではなく、大きな連続読みにする)
+	void Prefetch(size_t offset,size_t size) const;
+
+private:
+	const std::byte* data_ = nullptr;
+	size_t size_ = 0;
+#ifdef _WIN32
+	void* file_ = nullptr;    // HANDLE
+	void* mapping_ = nullptr; // HANDLE
+#else
+	int file_ = -1;
+#endif
+};
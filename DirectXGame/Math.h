@@ -1,5 +1,9 @@
 #pragma once
+#include "ConstexprMath.h"
 #include "KamataEngine.h"
+#include "MathKernels.h"
+#include "SimdMath.h"
+#include "TransformChangeTracker.h"
 
 /// AL3サンプルプログラム用の数学ライブラリ。
 /// MT3準拠で、KamataEngine内部の数学ライブラリと重複する。
@@ -36,35 +40,13 @@ struct AABB {
 	Vector3 max;
 };
 
-Vector3 operator+(const Vector3& v);
-Vector3 operator-(const Vector3& v);
-
-const Vector3 operator+(const Vector3& lhv, const Vector3& rhv);
-
-inline Vector3 operator/(const Vector3& v, float scalar) { return {v.x / scalar, v.y / scalar, v.z / scalar}; }
-
-Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t);
-
-const Vector3 operator*(const Vector3& v1, const float f);
-
-// 代入演算子オーバーロード
-Vector3& operator+=(Vector3& lhs, const Vector3& rhv);
-Vector3& operator-=(Vector3& lhs, const Vector3& rhv);
-Vector3& operator*=(Vector3& v, float s);
-Vector3& operator/=(Vector3& v, float s);
-
-// 単位行列の作成
-Matrix4x4 MakeIdentityMatrix();
-// スケーリング行列の作成
-Matrix4x4 MakeScaleMatrix(const Vector3& scale);
 // 回転行列の作成
 Matrix4x4 MakeRotateXMatrix(float theta);
 Matrix4x4 MakeRotateYMatrix(float theta);
 Matrix4x4 MakeRotateZMatrix(float theta);
-// 平行移動行列の作成
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate);
 // アフィン変換行列の作成
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vector3& translate);
+// (ベクトルの演算子、単位・スケール・平行移動の行列、Lerp とイージングは ConstexprMath.h)
 
 // 代入演算子オーバーロード
 Matrix4x4& operator*=(Matrix4x4& lhm, const Matrix4x4& rhm);
@@ -73,18 +55,17 @@ Matrix4x4& operator*=(Matrix4x4& lhm, const Matrix4x4& rhm);
 Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2);
 
 void WorldTransformUpdate(WorldTransform& worldTransform);
+// 前回送った時から値が変わっている時だけ行列を作って転送する (転送したら true)
+bool WorldTransformUpdate(WorldTransform& worldTransform, TransformChangeTracker& tracker);
 
-float Lerp(float x1, float x2, float t);
-
-float EaseIn(float x1, float x2, float t);
-
-float EaseOut(float x1, float x2, float t);
-
-float EaseInOut(float x1, float x2, float t);
-
-bool IsCollision(const AABB& aabb1, const AABB& aabb2);
+constexpr bool IsCollision(const AABB& aabb1, const AABB& aabb2) {
+	return (aabb1.min.x <= aabb2.max.x && aabb1.max.x >= aabb2.min.x) && // x軸
+	       (aabb1.min.y <= aabb2.max.y && aabb1.max.y >= aabb2.min.y) && // y軸
+	       (aabb1.min.z <= aabb2.max.z && aabb1.max.z >= aabb2.min.z);   // z軸
+}
 
+// w で割る (射影行列用)。アフィン行列なら SimdMath.h の TransformAffine の方が速い
 Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
 
-inline float ToRadians(float degrees) { return degrees * (3.1415f / 180.0f); }
-inline float ToDegrees(float radians) { return radians * (180.0f / 3.1415f); }
\ No newline at end of file
+constexpr float ToRadians(float degrees) { return degrees * (3.1415f / 180.0f); }
+constexpr float ToDegrees(float radians) { return radians * (180.0f / 3.1415f); }
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "MathKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numbers>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MATH_KERNELS_SSE2
+#endif
+
+namespace{
+
+// ゲームは速い方を使う (結果を std と比べる時は kStandard に切り替える)
+MathPrecision currentPrecision = MathPrecision::kFast;
+
+// (v + 1.5 * 2^23) - 1.5 * 2^23 で最も近い整数に丸める (|v| < 2^22。cvtps と同じ偶数丸め)
+const float kRoundMagic = 12582912.0f;
+
+const float kTwoOverPi = 0.636619772f;
+// π/2 を 3 つに分けたもの (1つ目は下位ビットが 0 なので、|q| < 2^15 くらいまで q を掛けても丸めが出ない)
+const float kHalfPi1 = 1.5703125f;
+const float kHalfPi2 = 4.837512969970703125e-4f;
+const float kHalfPi3 = 7.54978995489188216e-8f;
+// [-π/4, π/4] の sin / cos の多項式の係数
+const float kSin1 = -1.6666654611e-1f;
+const float kSin2 = 8.3321608736e-3f;
+const float kSin3 = -1.9515295891e-4f;
+const float kCos1 = 4.166664568298827e-2f;
+const float kCos2 = -1.388731625493765e-3f;
+const float kCos3 = 2.443315711809948e-5f;
+
+// 2^f (f は [-0.5, 0.5]) の係数 (ln2^k / k!)
+const float kExp1 = 0.693147181f;
+const float kExp2 = 0.240226507f;
+const float kExp3 = 0.0555041087f;
+const float kExp4 = 0.00961812911f;
+const float kExp5 = 0.00133335581f;
+const float kExp6 = 0.000154035304f;
+const float kExp7 = 1.52527338e-5f;
+
+const float kSqrtHalf = 0.707106781f;
+const float kInverseLn2 = 1.44269504f;
+const float kTwoPi = 2.0f * std::numbers::pi_v<float>;
+const float kInverseTwoPi = 1.0f / kTwoPi;
+
+float ToFloat(int32_t bits){
+	float value;
+	std::memcpy(&value,&bits,sizeof(value));
+	return value;
+}
+
+int32_t ToBits(float value){
+	int32_t bits;
+	std::memcpy(&bits,&value,sizeof(bits));
+	return bits;
+}
+
+// condition なら a、そうでなければ b (三項演算子だと分岐になることがあり、象限のように半々で変わる所では予測が外れる)
+float Select(bool condition,float a,float b){
+	int32_t mask = -static_cast<int32_t>(condition);
+	return ToFloat((ToBits(a) & mask) | (ToBits(b) & ~mask));
+}
+
+float RoundToNearest(float value){
+	return (value + kRoundMagic) - kRoundMagic;
+}
+
+void SinCosFast(float angle,float& sin,float& cos){
+	float quadrant = RoundToNearest(angle * kTwoOverPi);
+	float x = ((angle - quadrant * kHalfPi1) - quadrant * kHalfPi2) - quadrant * kHalfPi3;
+	float z = x * x;
+	float s = ((kSin3 * z + kSin2) * z + kSin1) * z * x + x;
+	float c = ((kCos3 * z + kCos2) * z + kCos1) * z * z - 0.5f * z + 1.0f;
+
+	// 象限ごとに sin と cos を入れ替え、符号を変える
+	int32_t n = static_cast<int32_t>(quadrant);
+	bool isSwapped = (n & 1) != 0;
+	float resultSin = Select(isSwapped,c,s);
+	float resultCos = Select(isSwapped,s,c);
+	sin = ToFloat(ToBits(resultSin) ^ static_cast<int32_t>(static_cast<uint32_t>(n & 2) << 30));
+	cos = ToFloat(ToBits(resultCos) ^ static_cast<int32_t>(static_cast<uint32_t>((n + 1) & 2) << 30));
+}
+
+float Exp2Fast(float value){
+	value = std::clamp(value,-127.0f,128.0f);
+	float integer = RoundToNearest(value);
+	float f = value - integer;
+	float p = ((((((kExp7 * f + kExp6) * f + kExp5) * f + kExp4) * f + kExp3) * f + kExp2) * f + kExp1) * f + 1.0f;
+	// 指数が -127 なら 0、128 なら無限大のビットになる
+	return p * ToFloat((static_cast<int32_t>(integer) + 127) << 23);
+}
+
+float Log2Fast(float value){
+	int32_t bits = ToBits(value);
+	float exponent = static_cast<float>(((bits >> 23) & 255) - 127);
+	float mantissa = ToFloat((bits & 0x007FFFFF) | 0x3F800000);
+	// [√0.5, √2] に寄せる (1 の近くの方が級数の収束が速い)
+	bool isLarge = mantissa > 2.0f * kSqrtHalf;
+	mantissa = Select(isLarge,mantissa * 0.5f,mantissa);
+	exponent = Select(isLarge,exponent + 1.0f,exponent);
+	// ln(m) = 2 atanh((m - 1) / (m + 1))
+	float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+	float t2 = t * t;
+	float ln = 2.0f * t * ((((t2 * (1.0f / 9.0f) + (1.0f / 7.0f)) * t2 + (1.0f / 5.0f)) * t2 + (1.0f / 3.0f)) * t2 + 1.0f);
+	return exponent + ln * kInverseLn2;
+}
+
+float PowFast(float base,float exponent){
+	float result = Exp2Fast(exponent * Log2Fast(base));
+	return Select(base > 0.0f,result,0.0f);
+}
+
+#ifdef MATH_KERNELS_SSE2
+// mask が立っているレーンは a、それ以外は b
+inline __m128 Select(__m128 mask,__m128 a,__m128 b){
+	return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+}
+
+inline __m128 RoundToNearest(__m128 value){
+	const __m128 magic = _mm_set1_ps(kRoundMagic);
+	return _mm_sub_ps(_mm_add_ps(value,magic),magic);
+}
+
+// 式はスカラー版と同じ (同じ順に計算するので結果も同じ)
+void SinCosFast(__m128 angle,__m128& sin,__m128& cos){
+	__m128 quadrant = RoundToNearest(_mm_mul_ps(angle,_mm_set1_ps(kTwoOverPi)));
+	__m128 x = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(angle,_mm_mul_ps(quadrant,_mm_set1_ps(kHalfPi1))),_mm_mul_ps(quadrant,_mm_set1_ps(kHalfPi2))),
+	                      _mm_mul_ps(quadrant,_mm_set1_ps(kHalfPi3)));
+	__m128 z = _mm_mul_ps(x,x);
+	__m128 s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSin3),z),_mm_set1_ps(kSin2)),z),_mm_set1_ps(kSin1)),z),x),x);
+	__m128 c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCos3),z),_mm_set1_ps(kCos2)),z),_mm_set1_ps(kCos1)),z),z),
+	                                 _mm_mul_ps(_mm_set1_ps(0.5f),z)),
+	                      _mm_set1_ps(1.0f));
+
+	__m128i n = _mm_cvtps_epi32(quadrant);
+	__m128 isSwapped = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(n,_mm_set1_epi32(1)),_mm_set1_epi32(1)));
+	__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(n,_mm_set1_epi32(2)),30));
+	__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(n,_mm_set1_epi32(1)),_mm_set1_epi32(2)),30));
+	sin = _mm_xor_ps(Select(isSwapped,c,s),sinSign);
+	cos = _mm_xor_ps(Select(isSwapped,s,c),cosSign);
+}
+
+__m128 Exp2Fast(__m128 value){
+	value = _mm_min_ps(_mm_max_ps(value,_mm_set1_ps(-127.0f)),_mm_set1_ps(128.0f));
+	__m128 integer = RoundToNearest(value);
+	__m128 f = _mm_sub_ps(value,integer);
+	__m128 p = _mm_set1_ps(kExp7);
+	for(float coefficient : {kExp6, kExp5, kExp4, kExp3, kExp2, kExp1, 1.0f}){
+		p = _mm_add_ps(_mm_mul_ps(p,f),_mm_set1_ps(coefficient));
+	}
+	__m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(integer),_mm_set1_epi32(127)),23);
+	return _mm_mul_ps(p,_mm_castsi128_ps(bits));
+}
+
+__m128 Log2Fast(__m128 value){
+	__m128i bits = _mm_castps_si128(value);
+	__m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits,23),_mm_set1_epi32(255)),_mm_set1_epi32(127)));
+	__m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits,_mm_set1_epi32(0x007FFFFF)),_mm_set1_epi32(0x3F800000)));
+	__m128 isLarge = _mm_cmpgt_ps(mantissa,_mm_set1_ps(2.0f * kSqrtHalf));
+	mantissa = Select(isLarge,_mm_mul_ps(mantissa,_mm_set1_ps(0.5f)),mantissa);
+	exponent = Select(isLarge,_mm_add_ps(exponent,_mm_set1_ps(1.0f)),exponent);
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 t = _mm_div_ps(_mm_sub_ps(mantissa,one),_mm_add_ps(mantissa,one));
+	__m128 t2 = _mm_mul_ps(t,t);
+	__m128 series = _mm_add_ps(_mm_mul_ps(t2,_mm_set1_ps(1.0f / 9.0f)),_mm_set1_ps(1.0f / 7.0f));
+	series = _mm_add_ps(_mm_mul_ps(series,t2),_mm_set1_ps(1.0f / 5.0f));
+	series = _mm_add_ps(_mm_mul_ps(series,t2),_mm_set1_ps(1.0f / 3.0f));
+	series = _mm_add_ps(_mm_mul_ps(series,t2),one);
+	__m128 ln = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.0f),t),series);
+	return _mm_add_ps(exponent,_mm_mul_ps(ln,_mm_set1_ps(kInverseLn2)));
+}
+
+__m128 PowFast(__m128 base,__m128 exponent){
+	__m128 result = Exp2Fast(_mm_mul_ps(exponent,Log2Fast(base)));
+	return _mm_and_ps(_mm_cmpgt_ps(base,_mm_setzero_ps()),result);
+}
+
+__m128 WrapAngle(__m128 angle){
+	__m128 turns = RoundToNearest(_mm_mul_ps(angle,_mm_set1_ps(kInverseTwoPi)));
+	return _mm_sub_ps(angle,_mm_mul_ps(turns,_mm_set1_ps(kTwoPi)));
+}
+#endif
+
+} // namespace
+
+void SetMathPrecision(MathPrecision precision){
+	currentPrecision = precision;
+}
+
+MathPrecision GetMathPrecision(){
+	return currentPrecision;
+}
+
+void SinCos(float angle,float& sin,float& cos){
+	if(currentPrecision == MathPrecision::kFast){
+		SinCosFast(angle,sin,cos);
+		return;
+	}
+	sin = std::sin(angle);
+	cos = std::cos(angle);
+}
+
+float Sin(float angle){
+	float sin, cos;
+	SinCos(angle,sin,cos);
+	return sin;
+}
+
+float Cos(float angle){
+	float sin, cos;
+	SinCos(angle,sin,cos);
+	return cos;
+}
+
+void SinCosBatch(const float* angles,size_t count,float* sins,float* coss){
+	size_t i = 0;
+	if(currentPrecision == MathPrecision::kFast){
+#ifdef MATH_KERNELS_SSE2
+		for(; i + 4 <= count; i += 4){
+			__m128 sin, cos;
+			SinCosFast(_mm_loadu_ps(angles + i),sin,cos);
+			_mm_storeu_ps(sins + i,sin);
+			_mm_storeu_ps(coss + i,cos);
+		}
+#endif
+	}
+	for(; i < count; ++i){
+		SinCos(angles[i],sins[i],coss[i]);
+	}
+}
+
+float Exp2(float value){
+	// 1 個ずつでは多項式の方が std::exp2 より遅い (AssetCooker kernels) ので、精度の設定に関係なく std を使う
+	return std::exp2(value);
+}
+
+void Exp2Batch(const float* values,size_t count,float* out){
+	size_t i = 0;
+	if(currentPrecision == MathPrecision::kFast){
+#ifdef MATH_KERNELS_SSE2
+		for(; i + 4 <= count; i += 4){
+			_mm_storeu_ps(out + i,Exp2Fast(_mm_loadu_ps(values + i)));
+		}
+#endif
+		// 4 個に満たない残りも同じ式で計算する (何個ずつ渡しても同じ値になる)
+		for(; i < count; ++i){
+			out[i] = Exp2Fast(values[i]);
+		}
+		return;
+	}
+	for(; i < count; ++i){
+		out[i] = std::exp2(values[i]);
+	}
+}
+
+float Pow(float base,float exponent){
+	// Exp2 と同じく、1 個ずつでは std::pow の方が速い
+	return std::pow(base,exponent);
+}
+
+void PowBatch(const float* bases,const float* exponents,size_t count,float* out){
+	size_t i = 0;
+	if(currentPrecision == MathPrecision::kFast){
+#ifdef MATH_KERNELS_SSE2
+		for(; i + 4 <= count; i += 4){
+			_mm_storeu_ps(out + i,PowFast(_mm_loadu_ps(bases + i),_mm_loadu_ps(exponents + i)));
+		}
+#endif
+		for(; i < count; ++i){
+			out[i] = PowFast(bases[i],exponents[i]);
+		}
+		return;
+	}
+	for(; i < count; ++i){
+		out[i] = std::pow(bases[i],exponents[i]);
+	}
+}
+
+float WrapAngle(float angle){
+	return angle - RoundToNearest(angle * kInverseTwoPi) * kTwoPi;
+}
+
+void WrapAngleBatch(const float* angles,size_t count,float* out){
+	size_t i = 0;
+#ifdef MATH_KERNELS_SSE2
+	for(; i + 4 <= count; i += 4){
+		_mm_storeu_ps(out + i,WrapAngle(_mm_loadu_ps(angles + i)));
+	}
+#endif
+	for(; i < count; ++i){
+		out[i] = WrapAngle(angles[i]);
+	}
+}
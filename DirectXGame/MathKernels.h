@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+
+// ==========================================
+// 三角関数・指数関数の近似 (多項式) と角度の折り返し
+// ・1 個ずつの版と、配列をまとめて計算する版 (…Batch。SSE2 で 4 個ずつ) がある
+//   sin / cos と角度の折り返しは、同じ入力なら 1 個ずつの版とまとめて計算する版の結果がビット単位で同じ
+//   2^x と pow の多項式はまとめて計算する版だけで使う (1 個ずつでは std の方が速いので、1 個ずつの版は常に std)
+// ・精度は実行中に切り替えられる (SetMathPrecision)
+//     kStandard … std::sin などをそのまま使う (これまでと同じ結果)
+//     kFast     … 多項式で近似する (誤差は下の各関数に書いた値。AssetCooker kernels で測る)
+// ・D3D を使わないので AssetCooker でも動く
+// ==========================================
+
+enum class MathPrecision{
+	kStandard,
+	kFast,
+};
+
+void SetMathPrecision(MathPrecision precision);
+MathPrecision GetMathPrecision();
+
+// sin と cos を同時に求める
+// kFast: π/2 ごとに折り返して [-π/4, π/4] の多項式 (sin は 7 次、cos は 8 次)
+//        |angle| <= 1e4 で絶対誤差 1e-7 以下 (std::sin は 3.3e-8)。それより大きい角度は折り返しの誤差が増える
+void SinCos(float angle,float& sin,float& cos);
+float Sin(float angle);
+float Cos(float angle);
+void SinCosBatch(const float* angles,size_t count,float* sins,float* coss);
+
+// 2 の value 乗 (Exp2 は std::exp2 と同じ)
+// Exp2Batch の kFast: 整数部は指数のビットに入れ、小数部 [-0.5, 0.5] を 7 次の多項式で近似する
+//                     相対誤差 1.2e-7 以下。value < -126 くらいで 0、value > 128 で無限大
+float Exp2(float value);
+void Exp2Batch(const float* values,size_t count,float* out);
+
+// base の exponent 乗 (base は 0 以上。Pow は std::pow と同じ)
+// PowBatch の kFast: exp2(exponent * log2(base))。log2 は [√0.5, √2] に寄せて atanh の級数
+//                    相対誤差 2.4e-7 + 1.2e-7 * |exponent * log2(base)| 以下。base が 0 の時は 0 を返す
+float Pow(float base,float exponent);
+void PowBatch(const float* bases,const float* exponents,size_t count,float* out);
+
+// 角度を [-π, π] に折り返す (2π の倍数を引くだけで、ループも分岐もしない。精度の設定には関係しない)
+float WrapAngle(float angle);
+void WrapAngleBatch(const float* angles,size_t count,float* out);
+
+// コンパイル時に表を作るための sin / cos (double のテイラー級数。constexpr の初期化で使う)
+// 実行時に呼ぶと遅いので、毎フレームの計算には上の SinCos を使う
+constexpr double SinConstexpr(double angle){
+	constexpr double kPi = 3.14159265358979323846;
+	// [-π, π] に寄せる (表を作る時の角度は小さいので、引く回数は少ない)
+	while(angle > kPi){
+		angle -= 2.0 * kPi;
+	}
+	while(angle < -kPi){
+		angle += 2.0 * kPi;
+	}
+	double term = angle;
+	double sum = angle;
+	for(int i = 1; i < 16; ++i){
+		term *= -angle * angle / ((2.0 * i) * (2.0 * i + 1.0));
+		sum += term;
+	}
+	return sum;
+}
+constexpr double CosConstexpr(double angle){
+	return SinConstexpr(angle + 3.14159265358979323846 / 2.0);
+}
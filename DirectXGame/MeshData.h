@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <math/Vector2.h>
+#include <math/Vector3.h>
+#include <string>
+#include <vector>
+
+using namespace KamataEngine;
+
+// ==========================================
+// CPU 側のモデルデータ (GPU バッファを作る前の状態)
+// ワーカースレッドやクックツールで作り、メインスレッドで MeshModel に変換する
+// 頂点とインデックスはモデル全体で1本ずつ持ち、メッシュはその範囲で表す
+// D3D のヘッダーを読まないので、クックツールは Windows 以外でもビルドできる
+// ==========================================
+struct MeshData{
+	// 頂点 (並びはエンジンの Mesh::VertexPosNormalUv と同じ。MeshModel.cpp で確かめる)
+	struct Vertex{
+		Vector3 pos;
+		Vector3 normal;
+		Vector2 uv;
+	};
+
+	// マテリアル (.mtl の newmtl 1つ分)
+	struct MaterialData{
+		std::string name;
+		Vector3 ambient = {0.3f, 0.3f, 0.3f};
+		Vector3 diffuse = {0.8f, 0.8f, 0.8f};
+		Vector3 specular = {0.0f, 0.0f, 0.0f};
+		float alpha = 1.0f;
+		std::string textureFilename; // モデルのフォルダからの相対パス (空なら白)
+	};
+
+	// メッシュ (.obj の g 1つ分)
+	// インデックスは vertexOffset からの相対番号
+	struct SubMesh{
+		std::string name;
+		int32_t materialIndex = -1; // -1 はデフォルトマテリアル
+		uint32_t vertexOffset = 0;
+		uint32_t vertexCount = 0;
+		uint32_t indexOffset = 0;
+		uint32_t indexCount = 0;
+	};
+
+	// インデックスの範囲
+	struct IndexRange{
+		uint32_t offset = 0;
+		uint32_t count = 0;
+	};
+
+	// 簡略化した段 (LOD1 以降)
+	// 頂点は元のメッシュと共有し、インデックスだけを indices の後ろに足す
+	struct Lod{
+		float error = 0.0f;                // 元の形からのずれ (モデルの半径に対する割合)
+		std::vector<IndexRange> subMeshes; // subMeshes と同じ並び (番号は各メッシュの vertexOffset から)
+	};
+
+	std::string name; // Resources/ 以下のフォルダ名
+	std::vector<MaterialData> materials;
+	std::vector<SubMesh> subMeshes;
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<Lod> lods; // 粗くなる順
+};
@@ -0,0 +1,366 @@
+#include "MeshModel.h"
+#include "CookedMesh.h"
+#include "InstancedModelPipeline.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "TextureAtlas.h"
+#include "TileInstanceBuffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <d3dx12.h>
+
+// 頂点はエンジンのパイプライン (Mesh::VertexPosNormalUv の入力レイアウト) でそのまま描くので、並びが同じでなければならない
+static_assert(sizeof(MeshData::Vertex) == sizeof(Mesh::VertexPosNormalUv));
+static_assert(offsetof(MeshData::Vertex,pos) == offsetof(Mesh::VertexPosNormalUv,pos));
+static_assert(offsetof(MeshData::Vertex,normal) == offsetof(Mesh::VertexPosNormalUv,normal));
+static_assert(offsetof(MeshData::Vertex,uv) == offsetof(Mesh::VertexPosNormalUv,uv));
+
+MeshModel* MeshModel::Create(const MeshData& meshData){
+	return Create(meshData.name,meshData.materials,meshData.subMeshes,meshData.lods,meshData.vertices,meshData.indices);
+}
+
+MeshModel* MeshModel::Create(const CookedMesh& cookedMesh){
+	return Create(cookedMesh.GetName(),cookedMesh.GetMaterials(),cookedMesh.GetSubMeshes(),cookedMesh.GetLods(),cookedMesh.GetVertices(),cookedMesh.GetIndices());
+}
+
+MeshModel* MeshModel::Create(const std::string& name,const std::vector<MeshData::MaterialData>& materials,const std::vector<MeshData::SubMesh>& subMeshes,
+                             const std::vector<MeshData::Lod>& lods,std::span<const MeshData::Vertex> vertices,std::span<const uint32_t> indices){
+	MeshModel* model = new MeshModel();
+	model->name_ = name;
+
+	// マテリアル (テクスチャはモデルのフォルダから読む。アトラスに入っていればそのページを使う)
+	// 中身が同じテクスチャは1つの名前にまとめ、値が同じマテリアルはモデルをまたいで共有する
+	const std::string directoryPath = name + "/";
+	const float kUvScale[2] = {1.0f, 1.0f};
+	const float kUvOffset[2] = {0.0f, 0.0f};
+	std::vector<Material*> modelMaterials;
+	std::vector<Material*> overrideMaterials;
+	for(const MeshData::MaterialData& data : materials){
+		const TextureAtlas::Region* region = data.textureFilename.empty() ? nullptr : TextureAtlas::GetInstance()->Find(directoryPath + data.textureFilename);
+		if(region){
+			modelMaterials.push_back(model->AcquireMaterial(data,TextureAtlas::GetInstance()->GetPage(region->page).fileName,region->uvScale,region->uvOffset));
+			// テクスチャを差し替えて描く時は UV をずらさない (テクスチャは読まない)
+			overrideMaterials.push_back(model->AcquireMaterial(data,"",kUvScale,kUvOffset));
+		}
+		else{
+			// (テクスチャの無いマテリアルは白一色)
+			std::string texture = data.textureFilename.empty() ? "white1x1.png" : ContentDeduplicator::GetInstance()->GetCanonicalTexture(directoryPath + data.textureFilename);
+			modelMaterials.push_back(model->AcquireMaterial(data,texture,kUvScale,kUvOffset));
+			overrideMaterials.push_back(modelMaterials.back());
+		}
+	}
+
+	// 頂点・インデックス (全メッシュ分をまとめて1本ずつ)
+	if(!vertices.empty() && !indices.empty()){
+		model->vertexBuffer_ = CreateBuffer(vertices.data(),vertices.size_bytes());
+		model->vbView_.BufferLocation = model->vertexBuffer_->GetGPUVirtualAddress();
+		model->vbView_.SizeInBytes = static_cast<UINT>(vertices.size_bytes());
+		model->vbView_.StrideInBytes = sizeof(MeshData::Vertex);
+
+		model->indexBuffer_ = CreateBuffer(indices.data(),indices.size_bytes());
+		model->ibView_.BufferLocation = model->indexBuffer_->GetGPUVirtualAddress();
+		model->ibView_.Format = DXGI_FORMAT_R32_UINT;
+		model->ibView_.SizeInBytes = static_cast<UINT>(indices.size_bytes());
+	}
+	model->vertexCount_ = static_cast<uint32_t>(vertices.size());
+	model->indexCount_ = static_cast<uint32_t>(indices.size());
+	model->memorySize_ = vertices.size_bytes() + indices.size_bytes();
+	MeshSimplifier::GetBoundingSphere(vertices,model->boundingCenter_,model->boundingRadius_);
+	MeshSimplifier::GetBoundingBox(vertices,model->boundingCenter_,model->boundingExtent_);
+
+	// メッシュ (段ごとに範囲だけが違う)
+	model->lods_.resize(lods.size() + 1);
+	model->lods_[0].error = 0.0f;
+	for(size_t i = 0; i < lods.size(); ++i){
+		model->lods_[i + 1].error = lods[i].error;
+	}
+	for(size_t s = 0; s < subMeshes.size(); ++s){
+		const MeshData::SubMesh& subMesh = subMeshes[s];
+		if(subMesh.indexCount == 0){
+			continue;
+		}
+		Material* material = nullptr;
+		Material* overrideMaterial = nullptr;
+		if(subMesh.materialIndex >= 0){
+			material = modelMaterials[subMesh.materialIndex];
+			overrideMaterial = overrideMaterials[subMesh.materialIndex];
+		}
+		else{
+			// マテリアルが無ければ白一色
+			material = model->AcquireMaterial(MeshData::MaterialData(),"white1x1.png",kUvScale,kUvOffset);
+			overrideMaterial = material;
+		}
+		for(size_t i = 0; i < model->lods_.size(); ++i){
+			MeshData::IndexRange range = {subMesh.indexOffset, subMesh.indexCount};
+			if(i > 0 && s < lods[i - 1].subMeshes.size()){
+				range = lods[i - 1].subMeshes[s];
+			}
+			if(range.count == 0){
+				continue;
+			}
+			Lod& lod = model->lods_[i];
+			lod.subMeshes.push_back({material, overrideMaterial, range.count, range.offset, static_cast<int32_t>(subMesh.vertexOffset)});
+			lod.triangleCount += range.count / 3;
+		}
+	}
+
+	return model;
+}
+
+Material* MeshModel::AcquireMaterial(const MeshData::MaterialData& data,const std::string& texture,const float uvScale[2],const float uvOffset[2]){
+	ContentDeduplicator::MaterialKey key = ContentDeduplicator::MakeMaterialKey(data,texture,uvScale,uvOffset);
+	std::weak_ptr<Material>& slot = sharedMaterials_[key];
+	std::shared_ptr<Material> material = slot.lock();
+	if(material){
+		++materialShareCount_;
+	}
+	else{
+		material = Material::Create();
+		material->name_ = data.name;
+		material->ambient_ = data.ambient;
+		material->diffuse_ = data.diffuse;
+		material->specular_ = data.specular;
+		material->alpha_ = data.alpha;
+		material->uvScale_ = {uvScale[0], uvScale[1], 1.0f};
+		material->uvOffset_ = {uvOffset[0], uvOffset[1], 0.0f};
+		if(!texture.empty()){
+			material->textureFilename_ = texture;
+			material->LoadTexture("");
+		}
+		material->Update();
+		slot = material;
+		++materialCreateCount_;
+	}
+	materials_.push_back(material);
+	return material.get();
+}
+
+MeshModel* MeshModel::CreateFromOBJ(const std::string& name,bool smoothing){
+	// クック済みがあれば解析せずに済む
+	if(CookedMesh::IsUpToDate(name,smoothing)){
+		CookedMesh cookedMesh;
+		if(cookedMesh.Open(CookedMesh::GetPath(name,smoothing))){
+			return Create(cookedMesh);
+		}
+	}
+
+	MeshData meshData;
+	bool isLoaded = ObjParser::Load(name,smoothing,meshData,0);
+	assert(isLoaded);
+	(void)isLoaded;
+	MeshOptimizer::Optimize(meshData);
+	MeshSimplifier::GenerateLods(meshData);
+	return Create(meshData);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> MeshModel::CreateBuffer(const void* data,size_t size){
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	// (Mesh と同じく、アップロードヒープに置いてそのまま読ませる)
+	CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+	HRESULT result = device->CreateCommittedResource(&heapProperties,D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,nullptr,IID_PPV_ARGS(&buffer));
+	assert(SUCCEEDED(result));
+
+	void* mapped = nullptr;
+	result = buffer->Map(0,nullptr,&mapped);
+	assert(SUCCEEDED(result));
+	std::memcpy(mapped,data,size);
+	buffer->Unmap(0,nullptr);
+	(void)result;
+	return buffer;
+}
+
+ID3D12GraphicsCommandList* MeshModel::SetCommonCommands(const WorldTransform& worldTransform,const Camera& camera,const ObjectColor* objectColor){
+	ModelCommon* modelCommon = ModelCommon::GetInstance();
+	ID3D12GraphicsCommandList* commandList = modelCommon->GetCommandList();
+
+	modelCommon->LightCommand();
+	modelCommon->TransformCommand(worldTransform,camera);
+	if(!objectColor){
+		objectColor = modelCommon->GetObjectColor();
+	}
+	objectColor->SetGraphicsCommand(commandList,static_cast<UINT>(Model::RoomParameter::kObjectColor));
+
+	commandList->IASetVertexBuffers(0,1,&vbView_);
+	commandList->IASetIndexBuffer(&ibView_);
+	return commandList;
+}
+
+uint32_t MeshModel::SelectLod(const WorldTransform& worldTransform,const Camera& camera) const{
+	if(lods_.size() <= 1 || boundingRadius_ <= 0.0f){
+		return 0;
+	}
+
+	// 囲む球をワールドへ
+	Vector3 center;
+	float radius;
+	GetWorldBoundingSphere(worldTransform.matWorld_,center,radius);
+
+	// カメラの位置 (ビュー行列の逆の平行移動)
+	const Matrix4x4& view = camera.matView;
+	Vector3 eye = {
+	    -(view.m[3][0] * view.m[0][0] + view.m[3][1] * view.m[0][1] + view.m[3][2] * view.m[0][2]),
+	    -(view.m[3][0] * view.m[1][0] + view.m[3][1] * view.m[1][1] + view.m[3][2] * view.m[1][2]),
+	    -(view.m[3][0] * view.m[2][0] + view.m[3][1] * view.m[2][1] + view.m[3][2] * view.m[2][2]),
+	};
+	Vector3 toCenter = {center.x - eye.x, center.y - eye.y, center.z - eye.z};
+	float distance = std::sqrt(toCenter.x * toCenter.x + toCenter.y * toCenter.y + toCenter.z * toCenter.z);
+	if(distance <= radius){
+		return 0;
+	}
+
+	// 半径が画面上で何ピクセルになるか (投影行列の m[1][1] は 1 / tan(fovY / 2))
+	float radiusPixels = radius * camera.matProjection.m[1][1] * (static_cast<float>(WinApp::kWindowHeight) * 0.5f) / distance;
+
+	// ずれが閾値に収まる一番粗い段
+	float threshold = modelLodErrorThreshold_ > 0.0f ? modelLodErrorThreshold_ : lodErrorThreshold_;
+	uint32_t selected = 0;
+	for(uint32_t i = 1; i < lods_.size(); ++i){
+		if(lods_[i].error * radiusPixels > threshold){
+			break;
+		}
+		selected = i;
+	}
+	return selected;
+}
+
+void MeshModel::GetWorldBoundingSphere(const Matrix4x4& world,Vector3& center,float& radius) const{
+	const Vector3& c = boundingCenter_;
+	center = {
+	    c.x * world.m[0][0] + c.y * world.m[1][0] + c.z * world.m[2][0] + world.m[3][0],
+	    c.x * world.m[0][1] + c.y * world.m[1][1] + c.z * world.m[2][1] + world.m[3][1],
+	    c.x * world.m[0][2] + c.y * world.m[1][2] + c.z * world.m[2][2] + world.m[3][2],
+	};
+	// 拡大は一番大きい軸で見る
+	float scale = 0.0f;
+	for(int row = 0; row < 3; ++row){
+		scale = std::max(scale,std::sqrt(world.m[row][0] * world.m[row][0] + world.m[row][1] * world.m[row][1] + world.m[row][2] * world.m[row][2]));
+	}
+	radius = boundingRadius_ * scale;
+}
+
+void MeshModel::GetWorldBoundingSphere(const Vector3& position,float scale,Vector3& center,float& radius) const{
+	center = {
+	    boundingCenter_.x * scale + position.x,
+	    boundingCenter_.y * scale + position.y,
+	    boundingCenter_.z * scale + position.z,
+	};
+	radius = boundingRadius_ * scale;
+}
+
+void MeshModel::GetWorldBoundingBox(const Matrix4x4& world,Vector3& center,Vector3& extent) const{
+	const Vector3& c = boundingCenter_;
+	const Vector3& e = boundingExtent_;
+	center = {
+	    c.x * world.m[0][0] + c.y * world.m[1][0] + c.z * world.m[2][0] + world.m[3][0],
+	    c.x * world.m[0][1] + c.y * world.m[1][1] + c.z * world.m[2][1] + world.m[3][1],
+	    c.x * world.m[0][2] + c.y * world.m[1][2] + c.z * world.m[2][2] + world.m[3][2],
+	};
+	// 各軸の半分の大きさは、行列の成分の絶対値を掛けたもの (回転した箱を囲む AABB)
+	extent = {
+	    e.x * std::abs(world.m[0][0]) + e.y * std::abs(world.m[1][0]) + e.z * std::abs(world.m[2][0]),
+	    e.x * std::abs(world.m[0][1]) + e.y * std::abs(world.m[1][1]) + e.z * std::abs(world.m[2][1]),
+	    e.x * std::abs(world.m[0][2]) + e.y * std::abs(world.m[1][2]) + e.z * std::abs(world.m[2][2]),
+	};
+}
+
+void MeshModel::ResetDrawCounts(){
+	drawnTriangles_ = 0;
+	fullTriangles_ = 0;
+	drawCallCount_ = 0;
+}
+
+const MeshModel::Lod& MeshModel::BeginDraw(const WorldTransform& worldTransform,const Camera& camera){
+	const Lod& lod = lods_[SelectLod(worldTransform,camera)];
+	drawnTriangles_ += lod.triangleCount;
+	fullTriangles_ += lods_[0].triangleCount;
+	return lod;
+}
+
+void MeshModel::Draw(const WorldTransform& worldTransform,const Camera& camera,const ObjectColor* objectColor){
+	if(lods_.empty() || lods_[0].subMeshes.empty()){
+		return;
+	}
+	const Lod& lod = BeginDraw(worldTransform,camera);
+	ID3D12GraphicsCommandList* commandList = SetCommonCommands(worldTransform,camera,objectColor);
+	for(const SubMesh& subMesh : lod.subMeshes){
+		subMesh.material->SetGraphicsCommand(commandList,static_cast<UINT>(Model::RoomParameter::kMaterial),static_cast<UINT>(Model::RoomParameter::kTexture));
+		commandList->DrawIndexedInstanced(subMesh.indexCount,1,subMesh.startIndex,subMesh.baseVertex,0);
+		++drawCallCount_;
+	}
+}
+
+void MeshModel::Draw(const WorldTransform& worldTransform,const Camera& camera,uint32_t textureHandle,const ObjectColor* objectColor){
+	if(lods_.empty() || lods_[0].subMeshes.empty()){
+		return;
+	}
+	const Lod& lod = BeginDraw(worldTransform,camera);
+	ID3D12GraphicsCommandList* commandList = SetCommonCommands(worldTransform,camera,objectColor);
+	for(const SubMesh& subMesh : lod.subMeshes){
+		subMesh.overrideMaterial->SetGraphicsCommand(commandList,static_cast<UINT>(Model::RoomParameter::kMaterial),static_cast<UINT>(Model::RoomParameter::kTexture),textureHandle);
+		commandList->DrawIndexedInstanced(subMesh.indexCount,1,subMesh.startIndex,subMesh.baseVertex,0);
+		++drawCallCount_;
+	}
+}
+
+namespace{
+
+// インスタンス描画のコマンドをコマンドリストに積む (範囲の番号でマテリアルを選ぶ)
+class CommandListTileRecorder : public TileDrawRecorder{
+public:
+	CommandListTileRecorder(ID3D12GraphicsCommandList* commandList,std::span<Material* const> materials) : commandList_(commandList),materials_(materials){}
+
+	void Draw(size_t index,const Range& range,uint32_t startInstance,uint32_t instanceCount) override{
+		materials_[index]->SetGraphicsCommand(commandList_,static_cast<UINT>(Model::RoomParameter::kMaterial),static_cast<UINT>(Model::RoomParameter::kTexture));
+		commandList_->DrawIndexedInstanced(range.indexCount,instanceCount,range.startIndex,range.baseVertex,startInstance);
+		++drawCount;
+		triangleCount += static_cast<uint64_t>(range.indexCount / 3) * instanceCount;
+	}
+
+	uint32_t drawCount = 0;
+	uint64_t triangleCount = 0;
+
+private:
+	ID3D12GraphicsCommandList* commandList_;
+	std::span<Material* const> materials_;
+};
+
+} // namespace
+
+void MeshModel::DrawInstanced(const WorldTransform& layerTransform,const Camera& camera,const TileInstanceBuffer& instances,const TileInstances::Rect& visible,
+                              float tileWidth,float tileHeight,const ObjectColor* objectColor){
+	if(lods_.empty() || lods_[0].subMeshes.empty() || instances.GetUploadedCount() == 0 || visible.IsEmpty()){
+		return;
+	}
+	assert(instances.GetUploadedCount() == instances.GetInstances().GetCount());
+	const Lod& lod = lods_[0];
+
+	// ルートシグネチャを替えるとそれまでの設定が外れるので、パイプラインを先に替える
+	ModelCommon* modelCommon = ModelCommon::GetInstance();
+	ID3D12GraphicsCommandList* commandList = modelCommon->GetCommandList();
+	InstancedModelPipeline::GetInstance()->SetPipeline(commandList,tileWidth,tileHeight);
+	SetCommonCommands(layerTransform,camera,objectColor);
+	commandList->IASetVertexBuffers(1,1,&instances.GetView());
+
+	// (器は前回の大きさが残るので、2回目からは確保しない)
+	instancedRanges_.clear();
+	instancedMaterials_.clear();
+	for(const SubMesh& subMesh : lod.subMeshes){
+		instancedRanges_.push_back({subMesh.indexCount, subMesh.startIndex, subMesh.baseVertex});
+		instancedMaterials_.push_back(subMesh.material);
+	}
+	CommandListTileRecorder recorder(commandList,instancedMaterials_);
+	instances.GetInstances().Record(recorder,instancedRanges_,visible);
+	drawCallCount_ += recorder.drawCount;
+	drawnTriangles_ += recorder.triangleCount;
+	fullTriangles_ += recorder.triangleCount;
+
+	// 続けて Draw で描けるよう Model のパイプラインに戻す
+	modelCommon->PreDraw(commandList);
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "KamataEngine.h"
+#include "ContentDeduplicator.h"
+#include "MeshData.h"
+#include "TileInstances.h"
+#include "ViewSettings.h"
+#include <d3d12.h>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wrl.h>
+
+class CookedMesh;
+class TileInstanceBuffer;
+
+using namespace KamataEngine;
+
+// ==========================================
+// ゲーム側のモデル
+// Model と同じシェーダー・ルートパラメータで描くが、
+// 読み込み (CPU) と GPU バッファ作成を分けられるようにしたもの
+// ・MeshData はワーカースレッドで作ってよい
+// ・Create (GPU バッファとテクスチャの作成) はメインスレッドで呼ぶ
+// 頂点・インデックスはモデル全体で1本ずつのバッファに入れ、メッシュは範囲で描く
+// LOD があれば、画面上の大きさから誤差が閾値に収まる一番粗い段を選んで描く
+// テクスチャが TextureAtlas に入っていれば、そのページと UV のスケール・オフセットを使う
+// 中身が同じテクスチャは1度だけ読み、値が同じマテリアルはモデルをまたいで共有する (ContentDeduplicator)
+// タイル層 (同じモデルを並べたマップチップなど) は DrawInstanced で層全体を1回で描ける
+// 描画は Model::PreDraw ～ Model::PostDraw の間で行う
+// ==========================================
+class MeshModel{
+public:
+	// CPU 側のデータから作る
+	static MeshModel* Create(const MeshData& meshData);
+	// クック済みファイルから作る (マップされた頂点をそのままアップロードする)
+	static MeshModel* Create(const CookedMesh& cookedMesh);
+	// 頂点とインデックスは借りるだけ (GPU バッファに写したら使わない)
+	static MeshModel* Create(const std::string& name,const std::vector<MeshData::MaterialData>& materials,const std::vector<MeshData::SubMesh>& subMeshes,
+	                         const std::vector<MeshData::Lod>& lods,std::span<const MeshData::Vertex> vertices,std::span<const uint32_t> indices);
+	// その場で読み込んで作る (Model::CreateFromOBJ と同じ。クック済みがあればそちらを使う)
+	static MeshModel* CreateFromOBJ(const std::string& name,bool smoothing = false);
+
+	~MeshModel() = default;
+
+	void Draw(const WorldTransform& worldTransform,const Camera& camera,const ObjectColor* objectColor = nullptr);
+	// テクスチャを差し替えて描く
+	void Draw(const WorldTransform& worldTransform,const Camera& camera,uint32_t textureHandle,const ObjectColor* objectColor = nullptr);
+
+	// instances のうち visible の列に置いたものを、メッシュごとに1回の描画で描く
+	// (layerTransform は層の原点。マスは tileWidth × tileHeight ずつ平行移動する。LOD は使わない)
+	// 別のパイプラインで描き、描いた後で Model のパイプラインに戻す
+	void DrawInstanced(const WorldTransform& layerTransform,const Camera& camera,const TileInstanceBuffer& instances,const TileInstances::Rect& visible,
+	                   float tileWidth,float tileHeight,const ObjectColor* objectColor = nullptr);
+
+	// 描く段を選ぶ (0 が元のメッシュ)
+	uint32_t SelectLod(const WorldTransform& worldTransform,const Camera& camera) const;
+
+	// world に置いた時に全頂点を囲む形 (視錐台カリング用)
+	// 球は拡大の一番大きい軸で広げ、箱は回転した AABB を囲み直す
+	void GetWorldBoundingSphere(const Matrix4x4& world,Vector3& center,float& radius) const;
+	void GetWorldBoundingBox(const Matrix4x4& world,Vector3& center,Vector3& extent) const;
+	// 回転せず全軸 scale 倍で position に置いた時の球 (行列を作らずに求める。ビームなど数の多いもの用)
+	void GetWorldBoundingSphere(const Vector3& position,float scale,Vector3& center,float& radius) const;
+
+	// LOD を選ぶ時に許す画面上のずれ (ピクセル)
+	static void SetLodErrorThreshold(float pixels){ lodErrorThreshold_ = pixels; }
+	static float GetLodErrorThreshold(){ return lodErrorThreshold_; }
+	// このモデルだけ許すずれを変える (0 なら上の全体の値を使う)
+	void SetModelLodErrorThreshold(float pixels){ modelLodErrorThreshold_ = pixels; }
+
+	// 描いた三角形・描画コマンドの数 (ResetDrawCounts からの合計)
+	static void ResetDrawCounts();
+	static uint32_t GetDrawCallCount(){ return drawCallCount_; }
+	static uint64_t GetDrawnTriangleCount(){ return drawnTriangles_; }
+	// LOD を使わなかった場合の三角形の数
+	static uint64_t GetFullTriangleCount(){ return fullTriangles_; }
+
+	// 作ったマテリアルと、既にあるものを使い回した数
+	static uint32_t GetMaterialCreateCount(){ return materialCreateCount_; }
+	static uint32_t GetMaterialShareCount(){ return materialShareCount_; }
+
+	const std::string& GetName() const{ return name_; }
+	uint32_t GetLodCount() const{ return static_cast<uint32_t>(lods_.size()); }
+	uint32_t GetVertexCount() const{ return vertexCount_; }
+	uint32_t GetIndexCount() const{ return indexCount_; }
+	// GPU バッファの大きさ (バイト)
+	size_t GetMemorySize() const{ return memorySize_; }
+
+	// アップロードヒープにバッファを作って data を写す
+	static Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(const void* data,size_t size);
+
+private:
+	// 1メッシュ分の描画範囲
+	struct SubMesh{
+		Material* material;
+		Material* overrideMaterial; // テクスチャを差し替えて描く時用 (アトラスを使っていなければ material と同じ)
+		uint32_t indexCount;
+		uint32_t startIndex;
+		int32_t baseVertex;
+	};
+
+	// 1段分
+	struct Lod{
+		float error = 0.0f;            // モデルの半径に対するずれ
+		uint32_t triangleCount = 0;
+		std::vector<SubMesh> subMeshes;
+	};
+
+	MeshModel() = default;
+
+	// 値が同じマテリアルがあればそれを使い、無ければ作る (texture が空ならテクスチャを読まない)
+	Material* AcquireMaterial(const MeshData::MaterialData& data,const std::string& texture,const float uvScale[2],const float uvOffset[2]);
+
+	// ライト・行列・色・頂点バッファのコマンドを積む
+	ID3D12GraphicsCommandList* SetCommonCommands(const WorldTransform& worldTransform,const Camera& camera,const ObjectColor* objectColor);
+	// 数えてから描く段を返す
+	const Lod& BeginDraw(const WorldTransform& worldTransform,const Camera& camera);
+
+	static inline float lodErrorThreshold_ = ViewSettings::kLodErrorThreshold;
+	static inline uint64_t drawnTriangles_ = 0;
+	static inline uint64_t fullTriangles_ = 0;
+	static inline uint32_t drawCallCount_ = 0;
+	// モデルをまたいで共有するマテリアル
+	static inline std::unordered_map<ContentDeduplicator::MaterialKey,std::weak_ptr<Material>,ContentDeduplicator::MaterialKeyHash> sharedMaterials_;
+	static inline uint32_t materialCreateCount_ = 0;
+	static inline uint32_t materialShareCount_ = 0;
+
+	std::string name_;
+	std::vector<Lod> lods_; // [0] が元のメッシュ
+	float modelLodErrorThreshold_ = 0.0f;
+	// 使っているマテリアル (どのモデルからも使われなくなったら消える)
+	std::vector<std::shared_ptr<Material>> materials_;
+	// DrawInstanced でサブメッシュごとの範囲とマテリアルを渡す器 (描くたびに clear して使い回す)
+	std::vector<TileDrawRecorder::Range> instancedRanges_;
+	std::vector<Material*> instancedMaterials_;
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer_;
+	D3D12_VERTEX_BUFFER_VIEW vbView_ = {};
+	D3D12_INDEX_BUFFER_VIEW ibView_ = {};
+
+	// モデル空間での囲む球と AABB (中心は同じ)
+	Vector3 boundingCenter_ = {0.0f, 0.0f, 0.0f};
+	float boundingRadius_ = 0.0f;
+	Vector3 boundingExtent_ = {0.0f, 0.0f, 0.0f};
+
+	uint32_t vertexCount_ = 0;
+	uint32_t indexCount_ = 0;
+	size_t memorySize_ = 0;
+};
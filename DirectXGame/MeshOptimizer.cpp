@@ -0,0 +1,328 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace{
+
+// Forsyth の得点の定数 (元の記事の値)
+const uint32_t kForsythCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriangleScore = 0.75f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+const uint32_t kNoTriangle = UINT32_MAX;
+
+// キャッシュの位置 (-1 はキャッシュの外) と、まだ描いていない三角形の数から頂点の得点を出す
+float VertexScore(int32_t cachePosition,uint32_t remaining){
+	if(remaining == 0){
+		return -1.0f;
+	}
+	float score = 0.0f;
+	if(cachePosition >= 0){
+		if(cachePosition < 3){
+			// 直前の三角形の頂点は、すぐに使うとかえって偏るので少し下げる
+			score = kLastTriangleScore;
+		}
+		else{
+			float scale = 1.0f / static_cast<float>(kForsythCacheSize - 3);
+			score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale,kCacheDecayPower);
+		}
+	}
+	// 残りの少ない頂点を先に片付ける
+	score += kValenceBoostScale / std::pow(static_cast<float>(remaining),kValenceBoostPower);
+	return score;
+}
+
+// FIFO キャッシュで失敗した回数
+uint32_t CountCacheMisses(std::span<const uint32_t> indices,uint32_t numVertices,uint32_t cacheSize){
+	// 頂点ごとに入れた時刻を持つと、まだキャッシュにあるかがすぐにわかる
+	std::vector<uint32_t> timestamps(numVertices,0);
+	uint32_t time = cacheSize + 1;
+	uint32_t misses = 0;
+	for(uint32_t index : indices){
+		if(time - timestamps[index] > cacheSize){
+			timestamps[index] = time++;
+			++misses;
+		}
+	}
+	return misses;
+}
+
+// 並べ替えられるメッシュか (三角形のリストになっているか)
+bool IsTriangleList(const MeshData::SubMesh& subMesh){
+	return subMesh.indexCount >= 3 && subMesh.indexCount % 3 == 0;
+}
+
+std::span<uint32_t> GetIndices(MeshData& meshData,const MeshData::SubMesh& subMesh){
+	return std::span<uint32_t>(meshData.indices).subspan(subMesh.indexOffset,subMesh.indexCount);
+}
+
+void ReorderForVertexCache(std::span<uint32_t> indices,uint32_t numVertices){
+	const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+
+	// 頂点ごとの隣接三角形 ([offsets[v], offsets[v] + remaining[v]) がまだ描いていないもの)
+	std::vector<uint32_t> remaining(numVertices,0);
+	for(uint32_t index : indices){
+		++remaining[index];
+	}
+	std::vector<uint32_t> offsets(numVertices + 1,0);
+	for(uint32_t v = 0; v < numVertices; ++v){
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> cursors(offsets.begin(),offsets.end() - 1);
+		for(uint32_t i = 0; i < indices.size(); ++i){
+			adjacency[cursors[indices[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<int32_t> cachePositions(numVertices,-1);
+	std::vector<float> vertexScores(numVertices);
+	for(uint32_t v = 0; v < numVertices; ++v){
+		vertexScores[v] = VertexScore(-1,remaining[v]);
+	}
+	std::vector<float> triangleScores(numTriangles);
+	uint32_t best = kNoTriangle;
+	for(uint32_t t = 0; t < numTriangles; ++t){
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		if(best == kNoTriangle || triangleScores[t] > triangleScores[best]){
+			best = t;
+		}
+	}
+
+	std::vector<uint8_t> isEmitted(numTriangles,0);
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(kForsythCacheSize + 3);
+	newCache.reserve(kForsythCacheSize + 3);
+	uint32_t searchCursor = 0;
+
+	for(uint32_t emitted = 0; emitted < numTriangles; ++emitted){
+		// 候補が無ければ、まだ描いていない最初の三角形から続ける
+		if(best == kNoTriangle){
+			while(isEmitted[searchCursor]){
+				++searchCursor;
+			}
+			best = searchCursor;
+		}
+
+		const uint32_t triangle[3] = {indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2]};
+		output.insert(output.end(),triangle,triangle + 3);
+		isEmitted[best] = 1;
+
+		// 描いた三角形を隣接から外す
+		for(uint32_t v : triangle){
+			uint32_t* begin = adjacency.data() + offsets[v];
+			uint32_t* end = begin + remaining[v];
+			uint32_t* found = std::find(begin,end,best);
+			if(found != end){
+				*found = *(end - 1);
+				--remaining[v];
+			}
+		}
+
+		// 今の三角形の頂点をキャッシュの先頭に入れる
+		newCache.clear();
+		for(uint32_t v : triangle){
+			if(std::find(newCache.begin(),newCache.end(),v) == newCache.end()){
+				newCache.push_back(v);
+			}
+		}
+		for(uint32_t v : cache){
+			if(v != triangle[0] && v != triangle[1] && v != triangle[2]){
+				newCache.push_back(v);
+			}
+		}
+		// 押し出された頂点
+		for(size_t i = kForsythCacheSize; i < newCache.size(); ++i){
+			cachePositions[newCache[i]] = -1;
+			vertexScores[newCache[i]] = VertexScore(-1,remaining[newCache[i]]);
+		}
+		if(newCache.size() > kForsythCacheSize){
+			newCache.resize(kForsythCacheSize);
+		}
+		for(size_t i = 0; i < newCache.size(); ++i){
+			cachePositions[newCache[i]] = static_cast<int32_t>(i);
+			vertexScores[newCache[i]] = VertexScore(static_cast<int32_t>(i),remaining[newCache[i]]);
+		}
+
+		// キャッシュにある頂点を使う三角形から次を選ぶ
+		best = kNoTriangle;
+		for(uint32_t v : newCache){
+			for(uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; ++i){
+				uint32_t t = adjacency[i];
+				triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				if(best == kNoTriangle || triangleScores[t] > triangleScores[best]){
+					best = t;
+				}
+			}
+		}
+		std::swap(cache,newCache);
+	}
+
+	std::copy(output.begin(),output.end(),indices.begin());
+}
+
+Vector3 Add(const Vector3& a,const Vector3& b){
+	return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+Vector3 Scale(const Vector3& v,float s){
+	return {v.x * s, v.y * s, v.z * s};
+}
+
+void ReorderForOverdraw(std::span<uint32_t> indices,std::span<const MeshData::Vertex> vertices,uint32_t cacheSize,float threshold){
+	const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+	const uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+
+	// キャッシュの切れ目 (3頂点とも入っていない三角形) でクラスタに分ける
+	// (クラスタの中の並びは変えないので、キャッシュの効率はほぼ保たれる)
+	std::vector<uint32_t> clusterStarts;
+	{
+		std::vector<uint32_t> timestamps(numVertices,0);
+		uint32_t time = cacheSize + 1;
+		for(uint32_t t = 0; t < numTriangles; ++t){
+			uint32_t misses = 0;
+			for(uint32_t k = 0; k < 3; ++k){
+				uint32_t index = indices[t * 3 + k];
+				if(time - timestamps[index] > cacheSize){
+					timestamps[index] = time++;
+					++misses;
+				}
+			}
+			if(t == 0 || misses == 3){
+				clusterStarts.push_back(t);
+			}
+		}
+	}
+	const size_t numClusters = clusterStarts.size();
+	if(numClusters <= 1){
+		return;
+	}
+	clusterStarts.push_back(numTriangles);
+
+	// クラスタの中心と向き (法線は OBJ の頂点法線を使う。巻き順に左右されない)
+	std::vector<Vector3> centroids(numClusters,Vector3{0.0f, 0.0f, 0.0f});
+	std::vector<Vector3> normals(numClusters,Vector3{0.0f, 0.0f, 0.0f});
+	Vector3 meshCentroid = {0.0f, 0.0f, 0.0f};
+	for(size_t c = 0; c < numClusters; ++c){
+		for(uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t){
+			for(uint32_t k = 0; k < 3; ++k){
+				const MeshData::Vertex& vertex = vertices[indices[t * 3 + k]];
+				centroids[c] = Add(centroids[c],vertex.pos);
+				normals[c] = Add(normals[c],vertex.normal);
+			}
+		}
+		meshCentroid = Add(meshCentroid,centroids[c]);
+		centroids[c] = Scale(centroids[c],1.0f / static_cast<float>((clusterStarts[c + 1] - clusterStarts[c]) * 3));
+	}
+	meshCentroid = Scale(meshCentroid,1.0f / static_cast<float>(numTriangles * 3));
+
+	// 外側を向いているクラスタほど先に描く (手前の面で奥の面を隠せる)
+	std::vector<float> keys(numClusters);
+	for(size_t c = 0; c < numClusters; ++c){
+		const Vector3& n = normals[c];
+		float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+		Vector3 d = {centroids[c].x - meshCentroid.x, centroids[c].y - meshCentroid.y, centroids[c].z - meshCentroid.z};
+		keys[c] = length > 0.0f ? (d.x * n.x + d.y * n.y + d.z * n.z) / length : 0.0f;
+	}
+	std::vector<uint32_t> order(numClusters);
+	for(uint32_t c = 0; c < numClusters; ++c){
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(),order.end(),[&](uint32_t a,uint32_t b){ return keys[a] > keys[b]; });
+
+	std::vector<uint32_t> reordered;
+	reordered.reserve(indices.size());
+	for(uint32_t c : order){
+		reordered.insert(reordered.end(),indices.begin() + clusterStarts[c] * 3,indices.begin() + clusterStarts[c + 1] * 3);
+	}
+
+	// キャッシュの効率が落ちすぎるなら元のまま
+	uint32_t before = CountCacheMisses(indices,numVertices,cacheSize);
+	uint32_t after = CountCacheMisses(reordered,numVertices,cacheSize);
+	if(static_cast<float>(after) <= static_cast<float>(before) * threshold){
+		std::copy(reordered.begin(),reordered.end(),indices.begin());
+	}
+}
+
+} // namespace
+
+void MeshOptimizer::Optimize(MeshData& meshData){
+	OptimizeVertexCache(meshData);
+	OptimizeOverdraw(meshData);
+	OptimizeVertexFetch(meshData);
+}
+
+void MeshOptimizer::OptimizeVertexCache(MeshData& meshData){
+	for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+		if(IsTriangleList(subMesh)){
+			ReorderForVertexCache(GetIndices(meshData,subMesh),subMesh.vertexCount);
+		}
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices,uint32_t numVertices){
+	if(indices.size() >= 3 && indices.size() % 3 == 0){
+		ReorderForVertexCache(indices,numVertices);
+	}
+}
+
+void MeshOptimizer::OptimizeOverdraw(MeshData& meshData,float threshold){
+	for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+		if(IsTriangleList(subMesh)){
+			std::span<const MeshData::Vertex> vertices = std::span<const MeshData::Vertex>(meshData.vertices).subspan(subMesh.vertexOffset,subMesh.vertexCount);
+			ReorderForOverdraw(GetIndices(meshData,subMesh),vertices,kCacheSize,threshold);
+		}
+	}
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData& meshData){
+	// 使われる順に並べ直す (どこからも使われない頂点はここで落ちる)
+	assert(meshData.lods.empty());
+	std::vector<MeshData::Vertex> vertices;
+	vertices.reserve(meshData.vertices.size());
+	std::vector<uint32_t> remap;
+	for(MeshData::SubMesh& subMesh : meshData.subMeshes){
+		remap.assign(subMesh.vertexCount,UINT32_MAX);
+		uint32_t newOffset = static_cast<uint32_t>(vertices.size());
+		for(uint32_t& index : GetIndices(meshData,subMesh)){
+			if(remap[index] == UINT32_MAX){
+				remap[index] = static_cast<uint32_t>(vertices.size()) - newOffset;
+				vertices.push_back(meshData.vertices[subMesh.vertexOffset + index]);
+			}
+			index = remap[index];
+		}
+		subMesh.vertexOffset = newOffset;
+		subMesh.vertexCount = static_cast<uint32_t>(vertices.size()) - newOffset;
+	}
+	meshData.vertices = std::move(vertices);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(const MeshData& meshData,uint32_t cacheSize){
+	uint64_t misses = 0;
+	uint64_t numTriangles = 0;
+	uint64_t numVertices = 0;
+	for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+		std::span<const uint32_t> indices = std::span<const uint32_t>(meshData.indices).subspan(subMesh.indexOffset,subMesh.indexCount);
+		misses += CountCacheMisses(indices,subMesh.vertexCount,cacheSize);
+		numTriangles += subMesh.indexCount / 3;
+		numVertices += subMesh.vertexCount;
+	}
+
+	CacheStats stats;
+	if(numTriangles > 0){
+		stats.acmr = static_cast<float>(misses) / static_cast<float>(numTriangles);
+	}
+	if(numVertices > 0){
+		stats.atvr = static_cast<float>(misses) / static_cast<float>(numVertices);
+	}
+	return stats;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "MeshData.h"
+#include <cstdint>
+#include <span>
+
+// ==========================================
+// GPU 向けのメッシュの並べ替え (CPU 側だけ)
+// 三角形と頂点の並び順だけを変え、形は変えない
+// ・頂点キャッシュ: Forsyth の方法で、最近使った頂点を使う三角形を先に描く
+// ・オーバードロー: キャッシュの切れ目でクラスタに分け、外を向いたクラスタを先に描く
+// ・頂点フェッチ: インデックスで最初に使われる順に頂点を並べ直す
+// クック時 (AssetCooker) と OBJ から読む時に使う
+// ==========================================
+class MeshOptimizer{
+public:
+	// 頂点キャッシュの効率
+	struct CacheStats{
+		float acmr = 0.0f; // 三角形1つあたりの頂点シェーダー実行回数 (0.5 ～ 3、小さいほど良い)
+		float atvr = 0.0f; // 頂点1つあたりの頂点シェーダー実行回数 (1 が最良)
+	};
+
+	// 既定のキャッシュの大きさ (FIFO で数える)
+	static inline const uint32_t kCacheSize = 16;
+	// オーバードローのための並べ替えで許す ACMR の悪化 (倍率)
+	static inline const float kOverdrawThreshold = 1.05f;
+
+	// 3つをまとめて行う (メッシュごと)
+	static void Optimize(MeshData& meshData);
+
+	// (LOD のインデックスはそのまま。OptimizeVertexFetch は LOD を作る前に呼ぶ)
+	static void OptimizeVertexCache(MeshData& meshData);
+	static void OptimizeOverdraw(MeshData& meshData,float threshold = kOverdrawThreshold);
+	static void OptimizeVertexFetch(MeshData& meshData);
+
+	// インデックスの並びだけを頂点キャッシュ向けに並べ替える
+	static void OptimizeVertexCache(std::span<uint32_t> indices,uint32_t numVertices);
+
+	// FIFO キャッシュで頂点シェーダーの実行回数を数える (メッシュごとにキャッシュは空から)
+	static CacheStats AnalyzeVertexCache(const MeshData& meshData,uint32_t cacheSize = kCacheSize);
+};
@@ -0,0 +1,462 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace{
+
+// 平面までの二乗距離の和 (対称 4x4 行列の上三角)
+struct Quadric{
+	double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+	double b2 = 0.0, bc = 0.0, bd = 0.0;
+	double c2 = 0.0, cd = 0.0;
+	double d2 = 0.0;
+	double weight = 0.0;
+};
+
+void AddPlane(Quadric& q,double a,double b,double c,double d,double weight){
+	q.a2 += weight * a * a;
+	q.ab += weight * a * b;
+	q.ac += weight * a * c;
+	q.ad += weight * a * d;
+	q.b2 += weight * b * b;
+	q.bc += weight * b * c;
+	q.bd += weight * b * d;
+	q.c2 += weight * c * c;
+	q.cd += weight * c * d;
+	q.d2 += weight * d * d;
+	q.weight += weight;
+}
+
+void AddQuadric(Quadric& q,const Quadric& r){
+	q.a2 += r.a2;
+	q.ab += r.ab;
+	q.ac += r.ac;
+	q.ad += r.ad;
+	q.b2 += r.b2;
+	q.bc += r.bc;
+	q.bd += r.bd;
+	q.c2 += r.c2;
+	q.cd += r.cd;
+	q.d2 += r.d2;
+	q.weight += r.weight;
+}
+
+// 点 p を動かした時の二乗距離の重み付き平均
+double Evaluate(const Quadric& q,const Vector3& p){
+	double x = p.x;
+	double y = p.y;
+	double z = p.z;
+	double error = q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x +
+	               q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y +
+	               q.c2 * z * z + 2.0 * q.cd * z + q.d2;
+	return q.weight > 0.0 ? std::max(error,0.0) / q.weight : 0.0;
+}
+
+struct DoubleVector{
+	double x;
+	double y;
+	double z;
+};
+
+DoubleVector Subtract(const Vector3& a,const Vector3& b){
+	return {static_cast<double>(a.x) - b.x, static_cast<double>(a.y) - b.y, static_cast<double>(a.z) - b.z};
+}
+
+DoubleVector Cross(const DoubleVector& a,const DoubleVector& b){
+	return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+double Dot(const DoubleVector& a,const DoubleVector& b){
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+DoubleVector TriangleNormal(const Vector3& p0,const Vector3& p1,const Vector3& p2){
+	return Cross(Subtract(p1,p0),Subtract(p2,p0));
+}
+
+// 位置をビット列のまま比べるためのキー
+using PositionKey = std::array<uint32_t,3>;
+
+struct PositionKeyHash{
+	size_t operator()(const PositionKey& key) const{
+		uint64_t hash = 14695981039346656037ull;
+		for(uint32_t word : key){
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+		return static_cast<size_t>(hash);
+	}
+};
+
+uint64_t EdgeKey(uint32_t a,uint32_t b){
+	return (uint64_t{a} << 32) | b;
+}
+
+struct Triangle{
+	uint32_t points[3];   // 位置の番号 (縮めると付け替わる)
+	uint32_t vertices[3]; // 元の頂点 (法線や UV を選び直す時の手がかり)
+	bool isRemoved;
+};
+
+// 辺を縮める候補 (from を to に寄せる)
+struct Collapse{
+	uint32_t from;
+	uint32_t to;
+	double error;
+};
+
+} // namespace
+
+void MeshSimplifier::GetBoundingBox(std::span<const MeshData::Vertex> vertices,Vector3& center,Vector3& extent){
+	center = {0.0f, 0.0f, 0.0f};
+	extent = {0.0f, 0.0f, 0.0f};
+	if(vertices.empty()){
+		return;
+	}
+	Vector3 minimum = vertices[0].pos;
+	Vector3 maximum = vertices[0].pos;
+	for(const MeshData::Vertex& vertex : vertices){
+		minimum = {std::min(minimum.x,vertex.pos.x), std::min(minimum.y,vertex.pos.y), std::min(minimum.z,vertex.pos.z)};
+		maximum = {std::max(maximum.x,vertex.pos.x), std::max(maximum.y,vertex.pos.y), std::max(maximum.z,vertex.pos.z)};
+	}
+	center = {(minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f};
+	extent = {(maximum.x - minimum.x) * 0.5f, (maximum.y - minimum.y) * 0.5f, (maximum.z - minimum.z) * 0.5f};
+}
+
+void MeshSimplifier::GetBoundingSphere(std::span<const MeshData::Vertex> vertices,Vector3& center,float& radius){
+	radius = 0.0f;
+	Vector3 extent;
+	GetBoundingBox(vertices,center,extent);
+	float radiusSquared = 0.0f;
+	for(const MeshData::Vertex& vertex : vertices){
+		float x = vertex.pos.x - center.x;
+		float y = vertex.pos.y - center.y;
+		float z = vertex.pos.z - center.z;
+		radiusSquared = std::max(radiusSquared,x * x + y * y + z * z);
+	}
+	radius = std::sqrt(radiusSquared);
+}
+
+float MeshSimplifier::Simplify(std::span<const MeshData::Vertex> vertices,std::span<const uint32_t> indices,uint32_t targetTriangles,float maxError,
+                               std::vector<uint32_t>& result){
+	result.clear();
+
+	// 同じ位置の頂点を1点にまとめる (法線や UV の継ぎ目で分かれていても同じ点として縮める)
+	std::vector<uint32_t> vertexToPoint(vertices.size());
+	std::vector<Vector3> points;
+	std::vector<std::vector<uint32_t>> pointVertices;
+	{
+		std::unordered_map<PositionKey,uint32_t,PositionKeyHash> lookup;
+		for(uint32_t v = 0; v < vertices.size(); ++v){
+			PositionKey key;
+			std::memcpy(key.data(),&vertices[v].pos,sizeof(key));
+			auto [it,isInserted] = lookup.try_emplace(key,static_cast<uint32_t>(points.size()));
+			if(isInserted){
+				points.push_back(vertices[v].pos);
+				pointVertices.emplace_back();
+			}
+			vertexToPoint[v] = it->second;
+			pointVertices[it->second].push_back(v);
+		}
+	}
+	const size_t numPoints = points.size();
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(indices.size() / 3);
+	for(size_t i = 0; i + 2 < indices.size(); i += 3){
+		Triangle triangle{};
+		for(uint32_t k = 0; k < 3; ++k){
+			triangle.vertices[k] = indices[i + k];
+			triangle.points[k] = vertexToPoint[indices[i + k]];
+		}
+		// 元から潰れている三角形は捨てる
+		if(triangle.points[0] != triangle.points[1] && triangle.points[1] != triangle.points[2] && triangle.points[2] != triangle.points[0]){
+			triangles.push_back(triangle);
+		}
+	}
+
+	// 面の平面を、その面に触れている点に面積の重みで足す
+	std::vector<Quadric> quadrics(numPoints);
+	for(const Triangle& triangle : triangles){
+		const Vector3& p0 = points[triangle.points[0]];
+		DoubleVector normal = TriangleNormal(p0,points[triangle.points[1]],points[triangle.points[2]]);
+		double length = std::sqrt(Dot(normal,normal));
+		if(length <= 0.0){
+			continue;
+		}
+		normal = {normal.x / length, normal.y / length, normal.z / length};
+		double d = -(normal.x * p0.x + normal.y * p0.y + normal.z * p0.z);
+		for(uint32_t point : triangle.points){
+			AddPlane(quadrics[point],normal.x,normal.y,normal.z,d,length * 0.5);
+		}
+	}
+
+	// 逆向きの辺が無い辺は穴の縁
+	std::unordered_set<uint64_t> edges;
+	for(const Triangle& triangle : triangles){
+		for(uint32_t k = 0; k < 3; ++k){
+			edges.insert(EdgeKey(triangle.points[k],triangle.points[(k + 1) % 3]));
+		}
+	}
+	std::vector<uint8_t> isBorder(numPoints,0);
+	std::unordered_set<uint64_t> borderEdges;
+	for(const Triangle& triangle : triangles){
+		for(uint32_t k = 0; k < 3; ++k){
+			uint32_t a = triangle.points[k];
+			uint32_t b = triangle.points[(k + 1) % 3];
+			if(!edges.contains(EdgeKey(b,a))){
+				isBorder[a] = 1;
+				isBorder[b] = 1;
+				borderEdges.insert(EdgeKey(a,b));
+				borderEdges.insert(EdgeKey(b,a));
+
+				// 縁からはみ出さないよう、縁を含み面に垂直な平面も足す
+				const Vector3& p0 = points[triangle.points[0]];
+				DoubleVector normal = TriangleNormal(p0,points[triangle.points[1]],points[triangle.points[2]]);
+				DoubleVector edge = Subtract(points[b],points[a]);
+				DoubleVector side = Cross(edge,normal);
+				double length = std::sqrt(Dot(side,side));
+				if(length > 0.0){
+					side = {side.x / length, side.y / length, side.z / length};
+					double d = -(side.x * points[a].x + side.y * points[a].y + side.z * points[a].z);
+					double weight = Dot(edge,edge);
+					AddPlane(quadrics[a],side.x,side.y,side.z,d,weight);
+					AddPlane(quadrics[b],side.x,side.y,side.z,d,weight);
+				}
+			}
+		}
+	}
+
+	// 縁の点は縁に沿ってしか動かせない
+	auto canCollapse = [&](uint32_t from,uint32_t to){
+		return !isBorder[from] || (isBorder[to] && borderEdges.contains(EdgeKey(from,to)));
+	};
+
+	size_t liveTriangles = triangles.size();
+	const double maxErrorSquared = static_cast<double>(maxError) * maxError;
+	double worstError = 0.0;
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> pointTriangleOffsets(numPoints + 1);
+	std::vector<uint32_t> pointTriangles;
+	std::vector<uint8_t> isTouched(numPoints);
+	std::vector<uint32_t> remap(numPoints);
+
+	// 1回ごとに候補を安い順に並べ、重ならないものをまとめて縮める
+	while(liveTriangles > targetTriangles){
+		collapses.clear();
+		for(const Triangle& triangle : triangles){
+			if(triangle.isRemoved){
+				continue;
+			}
+			for(uint32_t k = 0; k < 3; ++k){
+				uint32_t a = triangle.points[k];
+				uint32_t b = triangle.points[(k + 1) % 3];
+				Quadric sum = quadrics[a];
+				AddQuadric(sum,quadrics[b]);
+				Collapse best = {a, b, -1.0};
+				if(canCollapse(a,b)){
+					best.error = Evaluate(sum,points[b]);
+				}
+				if(canCollapse(b,a)){
+					double error = Evaluate(sum,points[a]);
+					if(best.error < 0.0 || error < best.error){
+						best = {b, a, error};
+					}
+				}
+				if(best.error >= 0.0){
+					collapses.push_back(best);
+				}
+			}
+		}
+		std::sort(collapses.begin(),collapses.end(),[](const Collapse& a,const Collapse& b){ return a.error < b.error; });
+
+		// 点ごとの三角形
+		std::fill(pointTriangleOffsets.begin(),pointTriangleOffsets.end(),0);
+		for(const Triangle& triangle : triangles){
+			if(!triangle.isRemoved){
+				for(uint32_t point : triangle.points){
+					++pointTriangleOffsets[point + 1];
+				}
+			}
+		}
+		for(size_t p = 0; p < numPoints; ++p){
+			pointTriangleOffsets[p + 1] += pointTriangleOffsets[p];
+		}
+		pointTriangles.resize(pointTriangleOffsets[numPoints]);
+		{
+			std::vector<uint32_t> cursors(pointTriangleOffsets.begin(),pointTriangleOffsets.end() - 1);
+			for(uint32_t t = 0; t < triangles.size(); ++t){
+				if(!triangles[t].isRemoved){
+					for(uint32_t point : triangles[t].points){
+						pointTriangles[cursors[point]++] = t;
+					}
+				}
+			}
+		}
+
+		std::fill(isTouched.begin(),isTouched.end(),0);
+		for(uint32_t p = 0; p < numPoints; ++p){
+			remap[p] = p;
+		}
+		size_t removed = 0;
+		for(const Collapse& collapse : collapses){
+			if(collapse.error > maxErrorSquared || liveTriangles - removed <= targetTriangles){
+				break;
+			}
+			if(isTouched[collapse.from] || isTouched[collapse.to]){
+				continue;
+			}
+
+			// 周りの面が裏返るなら縮めない
+			bool isFlipped = false;
+			size_t numShared = 0;
+			for(uint32_t i = pointTriangleOffsets[collapse.from]; i < pointTriangleOffsets[collapse.from + 1]; ++i){
+				const Triangle& triangle = triangles[pointTriangles[i]];
+				if(triangle.points[0] == collapse.to || triangle.points[1] == collapse.to || triangle.points[2] == collapse.to){
+					++numShared;
+					continue;
+				}
+				Vector3 moved[3];
+				for(uint32_t k = 0; k < 3; ++k){
+					moved[k] = points[triangle.points[k] == collapse.from ? collapse.to : triangle.points[k]];
+				}
+				DoubleVector before = TriangleNormal(points[triangle.points[0]],points[triangle.points[1]],points[triangle.points[2]]);
+				DoubleVector after = TriangleNormal(moved[0],moved[1],moved[2]);
+				if(Dot(before,after) <= 0.0){
+					isFlipped = true;
+					break;
+				}
+			}
+			if(isFlipped){
+				continue;
+			}
+
+			remap[collapse.from] = collapse.to;
+			AddQuadric(quadrics[collapse.to],quadrics[collapse.from]);
+			worstError = std::max(worstError,collapse.error);
+			removed += numShared;
+			// 形の変わった面に触れている点はこの回はもう動かさない
+			isTouched[collapse.to] = 1;
+			for(uint32_t i = pointTriangleOffsets[collapse.from]; i < pointTriangleOffsets[collapse.from + 1]; ++i){
+				for(uint32_t point : triangles[pointTriangles[i]].points){
+					isTouched[point] = 1;
+				}
+			}
+		}
+		if(removed == 0){
+			break;
+		}
+
+		for(Triangle& triangle : triangles){
+			if(triangle.isRemoved){
+				continue;
+			}
+			for(uint32_t& point : triangle.points){
+				point = remap[point];
+			}
+			if(triangle.points[0] == triangle.points[1] || triangle.points[1] == triangle.points[2] || triangle.points[2] == triangle.points[0]){
+				triangle.isRemoved = true;
+				--liveTriangles;
+			}
+		}
+	}
+
+	// 寄せた先の点の頂点から、元の頂点に一番近い向き・UV のものを選ぶ
+	result.reserve(liveTriangles * 3);
+	for(const Triangle& triangle : triangles){
+		if(triangle.isRemoved){
+			continue;
+		}
+		for(uint32_t k = 0; k < 3; ++k){
+			uint32_t original = triangle.vertices[k];
+			uint32_t point = triangle.points[k];
+			if(vertexToPoint[original] == point){
+				result.push_back(original);
+				continue;
+			}
+			const MeshData::Vertex& reference = vertices[original];
+			uint32_t best = pointVertices[point][0];
+			float bestScore = -1e30f;
+			for(uint32_t candidate : pointVertices[point]){
+				const MeshData::Vertex& vertex = vertices[candidate];
+				float du = vertex.uv.x - reference.uv.x;
+				float dv = vertex.uv.y - reference.uv.y;
+				float score = vertex.normal.x * reference.normal.x + vertex.normal.y * reference.normal.y + vertex.normal.z * reference.normal.z - (du * du + dv * dv);
+				if(score > bestScore){
+					bestScore = score;
+					best = candidate;
+				}
+			}
+			result.push_back(best);
+		}
+	}
+	return static_cast<float>(std::sqrt(worstError));
+}
+
+void MeshSimplifier::GenerateLods(MeshData& meshData,const Settings& settings){
+	// 前に作った段は捨てる
+	uint32_t baseIndexCount = 0;
+	for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+		baseIndexCount = std::max(baseIndexCount,subMesh.indexOffset + subMesh.indexCount);
+	}
+	meshData.indices.resize(baseIndexCount);
+	meshData.lods.clear();
+
+	Vector3 center;
+	float radius = 0.0f;
+	GetBoundingSphere(meshData.vertices,center,radius);
+	if(radius <= 0.0f){
+		return;
+	}
+	const float errorLimit = settings.maxError * radius;
+
+	// 1つ前の段から続けて減らす (誤差は段ごとの値を足して上限とみなす)
+	const size_t numSubMeshes = meshData.subMeshes.size();
+	std::vector<std::vector<uint32_t>> current(numSubMeshes);
+	std::vector<float> errors(numSubMeshes,0.0f);
+	size_t previousTriangles = 0;
+	for(size_t s = 0; s < numSubMeshes; ++s){
+		const MeshData::SubMesh& subMesh = meshData.subMeshes[s];
+		current[s].assign(meshData.indices.begin() + subMesh.indexOffset,meshData.indices.begin() + subMesh.indexOffset + subMesh.indexCount);
+		previousTriangles += subMesh.indexCount / 3;
+	}
+
+	std::vector<std::vector<uint32_t>> next(numSubMeshes);
+	for(uint32_t level = 0; level < settings.maxLods && previousTriangles > settings.minTriangles; ++level){
+		size_t totalTriangles = 0;
+		float levelError = 0.0f;
+		for(size_t s = 0; s < numSubMeshes; ++s){
+			const MeshData::SubMesh& subMesh = meshData.subMeshes[s];
+			uint32_t numTriangles = static_cast<uint32_t>(current[s].size() / 3);
+			uint32_t target = std::max(static_cast<uint32_t>(static_cast<float>(numTriangles) * settings.ratio),std::min(numTriangles,settings.minTriangles));
+			if(current[s].size() % 3 != 0 || errors[s] >= errorLimit){
+				next[s] = current[s];
+			}
+			else{
+				std::span<const MeshData::Vertex> vertices = std::span<const MeshData::Vertex>(meshData.vertices).subspan(subMesh.vertexOffset,subMesh.vertexCount);
+				errors[s] += Simplify(vertices,current[s],target,errorLimit - errors[s],next[s]);
+				MeshOptimizer::OptimizeVertexCache(next[s],subMesh.vertexCount);
+			}
+			totalTriangles += next[s].size() / 3;
+			levelError = std::max(levelError,errors[s] / radius);
+		}
+		// ほとんど減らなければ、それ以上の段は作らない
+		if(static_cast<float>(totalTriangles) > static_cast<float>(previousTriangles) * 0.9f){
+			break;
+		}
+
+		MeshData::Lod& lod = meshData.lods.emplace_back();
+		lod.error = levelError;
+		for(size_t s = 0; s < numSubMeshes; ++s){
+			lod.subMeshes.push_back({static_cast<uint32_t>(meshData.indices.size()), static_cast<uint32_t>(next[s].size())});
+			meshData.indices.insert(meshData.indices.end(),next[s].begin(),next[s].end());
+		}
+		std::swap(current,next);
+		previousTriangles = totalTriangles;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "MeshData.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ==========================================
+// 二次誤差 (Garland-Heckbert) による簡略化と LOD の作成 (CPU 側だけ)
+// ・同じ位置の頂点を1点として辺を縮める (点は動かさず、片方の端に寄せる)
+// ・穴の縁の点は縁に沿ってしか動かさない
+// ・頂点は元のものを使い回すので、LOD はインデックスだけを増やす
+// クック時 (AssetCooker) と OBJ から読む時に使う
+// ==========================================
+class MeshSimplifier{
+public:
+	struct Settings{
+		float ratio = 0.5f;          // 1段ごとに三角形をこの割合まで減らす
+		uint32_t maxLods = 6;        // 作る段数の上限 (LOD0 を除く)
+		uint32_t minTriangles = 8;   // これより少なくはしない
+		float maxError = 0.5f;       // 誤差の上限 (モデルの半径に対する割合)
+	};
+
+	// MeshData::lods を作り直す (MeshOptimizer の後に呼ぶ)
+	static void GenerateLods(MeshData& meshData,const Settings& settings);
+	static void GenerateLods(MeshData& meshData){ GenerateLods(meshData,Settings()); }
+
+	// 三角形を targetTriangles 個まで減らす (誤差が maxError を超える縮め方はしない)
+	// 結果のインデックスを result に入れ、実際の誤差 (距離) を返す
+	static float Simplify(std::span<const MeshData::Vertex> vertices,std::span<const uint32_t> indices,uint32_t targetTriangles,float maxError,
+	                      std::vector<uint32_t>& result);
+
+	// 頂点を囲む球 (中心は AABB の中心。LOD の誤差はこの半径に対する割合で表す)
+	static void GetBoundingSphere(std::span<const MeshData::Vertex> vertices,Vector3& center,float& radius);
+	// 頂点を囲む AABB (中心と各軸の半分の大きさ)
+	static void GetBoundingBox(std::span<const MeshData::Vertex> vertices,Vector3& center,Vector3& extent);
+};
@@ -0,0 +1,211 @@
+#include "ObjLoader.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace{
+
+// フルパスで書かれていてもファイル名だけを取り出す
+std::string GetFileName(const std::string& path){
+	size_t pos = path.find_last_of("/\\");
+	return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+// 同じ位置を使う頂点の法線を平均する (メッシュごと)
+void SmoothNormals(MeshData& meshData,const MeshData::SubMesh& subMesh,const std::vector<uint32_t>& positionIndices,size_t numPositions){
+	std::vector<Vector3> sums(numPositions,Vector3{0.0f, 0.0f, 0.0f});
+	for(uint32_t i = 0; i < subMesh.vertexCount; ++i){
+		Vector3& sum = sums[positionIndices[i]];
+		const Vector3& normal = meshData.vertices[subMesh.vertexOffset + i].normal;
+		sum.x += normal.x;
+		sum.y += normal.y;
+		sum.z += normal.z;
+	}
+	for(uint32_t i = 0; i < subMesh.vertexCount; ++i){
+		Vector3 normal = sums[positionIndices[i]];
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if(length > 0.0f){
+			meshData.vertices[subMesh.vertexOffset + i].normal = {normal.x / length, normal.y / length, normal.z / length};
+		}
+	}
+}
+
+} // namespace
+
+bool ObjLoader::Load(const std::string& name,bool smoothing,MeshData& meshData){
+	const std::string directoryPath = "Resources/" + name + "/";
+	std::ifstream file(directoryPath + name + ".obj");
+	if(!file.is_open()){
+		return false;
+	}
+
+	meshData = MeshData();
+	meshData.name = name;
+
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> texcoords;
+
+	meshData.subMeshes.emplace_back();
+	// 各頂点がどの位置から作られたか (平滑化用)
+	std::vector<uint32_t> positionIndices;
+
+	// 今のメッシュの範囲を確定する
+	auto finishSubMesh = [&](){
+		MeshData::SubMesh& current = meshData.subMeshes.back();
+		current.vertexCount = static_cast<uint32_t>(meshData.vertices.size()) - current.vertexOffset;
+		current.indexCount = static_cast<uint32_t>(meshData.indices.size()) - current.indexOffset;
+		if(smoothing){
+			SmoothNormals(meshData,current,positionIndices,positions.size());
+		}
+		positionIndices.clear();
+	};
+
+	std::string line;
+	while(std::getline(file,line)){
+		std::istringstream lineStream(line);
+		std::string key;
+		std::getline(lineStream,key,' ');
+
+		if(key == "mtllib"){
+			std::string fileName;
+			lineStream >> fileName;
+			LoadMaterials(directoryPath,fileName,meshData);
+		}
+		else if(key == "g"){
+			// 今のメッシュに中身があれば次のメッシュへ
+			MeshData::SubMesh& current = meshData.subMeshes.back();
+			if(!current.name.empty() && meshData.vertices.size() > current.vertexOffset){
+				finishSubMesh();
+				MeshData::SubMesh& next = meshData.subMeshes.emplace_back();
+				next.vertexOffset = static_cast<uint32_t>(meshData.vertices.size());
+				next.indexOffset = static_cast<uint32_t>(meshData.indices.size());
+			}
+			lineStream >> meshData.subMeshes.back().name;
+		}
+		else if(key == "v"){
+			Vector3 position{};
+			lineStream >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		}
+		else if(key == "vt"){
+			Vector2 texcoord{};
+			lineStream >> texcoord.x >> texcoord.y;
+			texcoord.y = 1.0f - texcoord.y; // V 方向反転
+			texcoords.push_back(texcoord);
+		}
+		else if(key == "vn"){
+			Vector3 normal{};
+			lineStream >> normal.x >> normal.y >> normal.z;
+			normals.push_back(normal);
+		}
+		else if(key == "usemtl"){
+			MeshData::SubMesh& current = meshData.subMeshes.back();
+			if(current.materialIndex < 0){
+				std::string materialName;
+				lineStream >> materialName;
+				for(size_t i = 0; i < meshData.materials.size(); ++i){
+					if(meshData.materials[i].name == materialName){
+						current.materialIndex = static_cast<int32_t>(i);
+						break;
+					}
+				}
+			}
+		}
+		else if(key == "f"){
+			const MeshData::SubMesh& current = meshData.subMeshes.back();
+			uint32_t firstVertex = static_cast<uint32_t>(meshData.vertices.size()) - current.vertexOffset;
+			uint32_t faceIndexCount = 0;
+
+			std::string indexString;
+			while(std::getline(lineStream,indexString,' ')){
+				if(indexString.empty()){
+					continue;
+				}
+				// "v/vt/vn" か "v//vn"
+				uint32_t indexPosition = 0;
+				uint32_t indexTexcoord = 0;
+				uint32_t indexNormal = 0;
+				size_t slash1 = indexString.find('/');
+				size_t slash2 = slash1 == std::string::npos ? std::string::npos : indexString.find('/',slash1 + 1);
+				indexPosition = static_cast<uint32_t>(std::stoul(indexString.substr(0,slash1)));
+				if(slash2 != std::string::npos){
+					if(slash2 > slash1 + 1){
+						indexTexcoord = static_cast<uint32_t>(std::stoul(indexString.substr(slash1 + 1,slash2 - slash1 - 1)));
+					}
+					indexNormal = static_cast<uint32_t>(std::stoul(indexString.substr(slash2 + 1)));
+				}
+
+				MeshData::Vertex vertex{};
+				vertex.pos = positions[indexPosition - 1];
+				if(indexNormal != 0){
+					vertex.normal = normals[indexNormal - 1];
+				}
+				if(indexTexcoord != 0){
+					vertex.uv = texcoords[indexTexcoord - 1];
+				}
+				meshData.vertices.push_back(vertex);
+				positionIndices.push_back(indexPosition - 1);
+
+				// 4点目以降は扇状に三角形を足す (四角形なら 0,1,2 と 0,2,3)
+				uint32_t vertexIndex = firstVertex + faceIndexCount;
+				if(faceIndexCount >= 3){
+					meshData.indices.push_back(firstVertex);
+					meshData.indices.push_back(vertexIndex - 1);
+					meshData.indices.push_back(vertexIndex);
+				}
+				else{
+					meshData.indices.push_back(vertexIndex);
+				}
+				++faceIndexCount;
+			}
+		}
+	}
+	finishSubMesh();
+
+	return true;
+}
+
+void ObjLoader::LoadMaterials(const std::string& directoryPath,const std::string& fileName,MeshData& meshData){
+	std::ifstream file(directoryPath + fileName);
+	if(!file.is_open()){
+		return;
+	}
+
+	MeshData::MaterialData* material = nullptr;
+	std::string line;
+	while(std::getline(file,line)){
+		std::istringstream lineStream(line);
+		std::string key;
+		std::getline(lineStream,key,' ');
+		// 先頭のタブは無視
+		if(!key.empty() && key[0] == '\t'){
+			key.erase(key.begin());
+		}
+
+		if(key == "newmtl"){
+			material = &meshData.materials.emplace_back();
+			lineStream >> material->name;
+		}
+		else if(!material){
+			continue;
+		}
+		else if(key == "Ka"){
+			lineStream >> material->ambient.x >> material->ambient.y >> material->ambient.z;
+		}
+		else if(key == "Kd"){
+			lineStream >> material->diffuse.x >> material->diffuse.y >> material->diffuse.z;
+		}
+		else if(key == "Ks"){
+			lineStream >> material->specular.x >> material->specular.y >> material->specular.z;
+		}
+		else if(key == "d"){
+			lineStream >> material->alpha;
+		}
+		else if(key == "map_Kd"){
+			std::string path;
+			lineStream >> path;
+			material->textureFilename = GetFileName(path);
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "MeshData.h"
+#include <string>
+
+// ==========================================
+// OBJ/MTL の読み込み (CPU 側だけ)
+// Model::CreateFromOBJ と同じ解釈で MeshData を作る
+// GPU に触らないので、ワーカースレッドから呼んでよい
+// ゲームでは ObjParser を使う。こちらは読み込み結果を突き合わせる基準として残している
+// ==========================================
+class ObjLoader{
+public:
+	// Resources/<name>/<name>.obj を読む。smoothing なら同じ位置の頂点の法線を平均する
+	static bool Load(const std::string& name,bool smoothing,MeshData& meshData);
+
+private:
+	static void LoadMaterials(const std::string& directoryPath,const std::string& fileName,MeshData& meshData);
+};
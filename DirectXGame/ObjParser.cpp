@@ -0,0 +1,488 @@
+#include "ObjParser.h"
+#include "ParallelFor.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace{
+
+// これより小さいファイルは分けずに読む (スレッドを立てる方が高くつく)
+const size_t kMinChunkSize = 64 * 1024;
+// 省略された vt/vn
+const uint32_t kNone = UINT32_MAX;
+
+// 面の1頂点 (チャンク内で読んだままの番号)
+// OBJ の番号 (1始まり、0 は省略)。relative のビットが立っている要素は負の番号で、
+// チャンク内でそれまでに出てきた数からの位置 (0始まり、前のチャンクを指すと負) を入れてある
+struct RawCorner{
+	int32_t position;
+	int32_t texcoord;
+	int32_t normal;
+	uint32_t relative;
+};
+
+// 0始まりの通し番号に直した面の1頂点
+struct Corner{
+	uint32_t position;
+	uint32_t texcoord;
+	uint32_t normal;
+};
+
+// 面の間に挟まっている命令 (出てきた順に処理する)
+struct Command{
+	enum class Type{
+		kMaterialLibrary,
+		kGroup,
+		kUseMaterial,
+	};
+	Type type;
+	uint32_t faceIndex; // この命令の前にある面の数
+	std::string_view argument;
+};
+
+// ファイルを行の切れ目で分けた1つ分
+struct Chunk{
+	std::string_view text;
+	std::vector<Vector3> positions;
+	std::vector<Vector2> texcoords;
+	std::vector<Vector3> normals;
+	std::vector<RawCorner> corners;
+	std::vector<uint32_t> faceSizes; // 面ごとの頂点数
+	std::vector<Command> commands;
+};
+
+// g 1つ分の範囲
+struct SubMeshRange{
+	MeshData::SubMesh subMesh;
+	uint32_t faceBegin = 0;
+	uint32_t faceEnd = 0;
+	uint32_t cornerBegin = 0;
+	uint32_t cornerEnd = 0;
+};
+
+// メッシュごとに作った頂点とインデックス
+struct BuiltMesh{
+	std::vector<MeshData::Vertex> vertices;
+	std::vector<uint32_t> indices;
+};
+
+// 重複除去のハッシュの1枠
+struct Slot{
+	Corner key;
+	uint32_t vertexIndex; // kNone なら空き
+};
+
+bool IsSpace(char c){
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+// 空白を飛ばして次の単語を切り出す (行末なら空)
+std::string_view NextToken(const char*& cursor,const char* end){
+	while(cursor < end && IsSpace(*cursor)){
+		++cursor;
+	}
+	const char* begin = cursor;
+	while(cursor < end && !IsSpace(*cursor)){
+		++cursor;
+	}
+	return {begin, static_cast<size_t>(cursor - begin)};
+}
+
+float ParseFloat(std::string_view token){
+	// from_chars は先頭の + を受け付けない
+	if(!token.empty() && token[0] == '+'){
+		token.remove_prefix(1);
+	}
+	float value = 0.0f;
+	std::from_chars(token.data(),token.data() + token.size(),value);
+	return value;
+}
+
+// "v/vt/vn" の1要素
+void ParseIndex(std::string_view part,size_t count,uint32_t relativeBit,int32_t& value,uint32_t& relative){
+	int32_t raw = 0;
+	std::from_chars(part.data(),part.data() + part.size(),raw);
+	if(raw < 0){
+		value = static_cast<int32_t>(count) + raw;
+		relative |= relativeBit;
+	}
+	else{
+		value = raw;
+	}
+}
+
+// フルパスで書かれていてもファイル名だけを取り出す
+std::string GetFileName(std::string_view path){
+	size_t pos = path.find_last_of("/\\");
+	return std::string(pos == std::string_view::npos ? path : path.substr(pos + 1));
+}
+
+const char* FindLineEnd(const char* cursor,const char* end){
+	const void* found = std::memchr(cursor,'\n',static_cast<size_t>(end - cursor));
+	return found ? static_cast<const char*>(found) : end;
+}
+
+void ParseChunk(Chunk& chunk){
+	const char* cursor = chunk.text.data();
+	const char* end = cursor + chunk.text.size();
+	while(cursor < end){
+		const char* lineEnd = FindLineEnd(cursor,end);
+		std::string_view key = NextToken(cursor,lineEnd);
+
+		if(key == "v"){
+			Vector3& position = chunk.positions.emplace_back();
+			position.x = ParseFloat(NextToken(cursor,lineEnd));
+			position.y = ParseFloat(NextToken(cursor,lineEnd));
+			position.z = ParseFloat(NextToken(cursor,lineEnd));
+		}
+		else if(key == "vt"){
+			Vector2& texcoord = chunk.texcoords.emplace_back();
+			texcoord.x = ParseFloat(NextToken(cursor,lineEnd));
+			texcoord.y = 1.0f - ParseFloat(NextToken(cursor,lineEnd)); // V 方向反転
+		}
+		else if(key == "vn"){
+			Vector3& normal = chunk.normals.emplace_back();
+			normal.x = ParseFloat(NextToken(cursor,lineEnd));
+			normal.y = ParseFloat(NextToken(cursor,lineEnd));
+			normal.z = ParseFloat(NextToken(cursor,lineEnd));
+		}
+		else if(key == "f"){
+			uint32_t faceSize = 0;
+			for(std::string_view token = NextToken(cursor,lineEnd); !token.empty(); token = NextToken(cursor,lineEnd)){
+				// "v" "v/vt" "v//vn" "v/vt/vn"
+				RawCorner& corner = chunk.corners.emplace_back();
+				corner = {};
+				size_t slash1 = token.find('/');
+				ParseIndex(token.substr(0,slash1),chunk.positions.size(),1,corner.position,corner.relative);
+				if(slash1 != std::string_view::npos){
+					size_t slash2 = token.find('/',slash1 + 1);
+					ParseIndex(token.substr(slash1 + 1,slash2 == std::string_view::npos ? std::string_view::npos : slash2 - slash1 - 1),
+					           chunk.texcoords.size(),2,corner.texcoord,corner.relative);
+					if(slash2 != std::string_view::npos){
+						ParseIndex(token.substr(slash2 + 1),chunk.normals.size(),4,corner.normal,corner.relative);
+					}
+				}
+				++faceSize;
+			}
+			chunk.faceSizes.push_back(faceSize);
+		}
+		else if(key == "g" || key == "usemtl" || key == "mtllib"){
+			Command::Type type = key == "g" ? Command::Type::kGroup : key == "usemtl" ? Command::Type::kUseMaterial : Command::Type::kMaterialLibrary;
+			chunk.commands.push_back({type, static_cast<uint32_t>(chunk.faceSizes.size()), NextToken(cursor,lineEnd)});
+		}
+
+		cursor = lineEnd + 1;
+	}
+}
+
+// チャンク内の番号を通し番号にする (範囲外なら false)
+bool ResolveIndex(int32_t value,bool isRelative,size_t base,size_t count,bool isRequired,uint32_t& result){
+	if(isRelative){
+		int64_t index = static_cast<int64_t>(base) + value;
+		if(index < 0 || index >= static_cast<int64_t>(count)){
+			return false;
+		}
+		result = static_cast<uint32_t>(index);
+		return true;
+	}
+	if(value == 0){
+		result = kNone;
+		return !isRequired;
+	}
+	if(value < 0 || static_cast<size_t>(value) > count){
+		return false;
+	}
+	result = static_cast<uint32_t>(value - 1);
+	return true;
+}
+
+uint32_t HashCorner(const Corner& corner){
+	uint64_t hash = ((uint64_t{corner.position} << 32) | corner.texcoord) * 0x9E3779B97F4A7C15ull;
+	hash ^= uint64_t{corner.normal} * 0xC2B2AE3D27D4EB4Full;
+	hash ^= hash >> 29;
+	return static_cast<uint32_t>(hash);
+}
+
+// 1メッシュ分の頂点を作る (同じ v/vt/vn の組は1頂点にまとめる)
+void BuildSubMesh(const SubMeshRange& range,const std::vector<Corner>& corners,const std::vector<uint32_t>& faceSizes,
+                  const std::vector<Vector3>& positions,const std::vector<Vector2>& texcoords,const std::vector<Vector3>& normals,
+                  bool smoothing,BuiltMesh& mesh){
+	uint32_t numCorners = range.cornerEnd - range.cornerBegin;
+	uint32_t capacity = 16;
+	while(capacity < numCorners * 2){
+		capacity *= 2;
+	}
+	const uint32_t mask = capacity - 1;
+	std::vector<Slot> slots(capacity,Slot{{}, kNone});
+
+	mesh.vertices.reserve(numCorners);
+	mesh.indices.reserve(numCorners * 3 / 2);
+	// 各頂点がどの位置から作られたか (平滑化用)
+	std::vector<uint32_t> vertexPositions;
+	std::vector<Vector3> sums;
+	if(smoothing){
+		vertexPositions.reserve(numCorners);
+		sums.assign(positions.size(),Vector3{0.0f, 0.0f, 0.0f});
+	}
+
+	uint32_t cornerIndex = range.cornerBegin;
+	for(uint32_t face = range.faceBegin; face < range.faceEnd; ++face){
+		uint32_t firstVertex = 0;
+		uint32_t previousVertex = 0;
+		for(uint32_t k = 0; k < faceSizes[face]; ++k){
+			const Corner& corner = corners[cornerIndex++];
+
+			// 空きが見つかるまで隣の枠を探す
+			uint32_t slotIndex = HashCorner(corner) & mask;
+			while(slots[slotIndex].vertexIndex != kNone &&
+			      (slots[slotIndex].key.position != corner.position || slots[slotIndex].key.texcoord != corner.texcoord || slots[slotIndex].key.normal != corner.normal)){
+				slotIndex = (slotIndex + 1) & mask;
+			}
+			Slot& slot = slots[slotIndex];
+			if(slot.vertexIndex == kNone){
+				slot.key = corner;
+				slot.vertexIndex = static_cast<uint32_t>(mesh.vertices.size());
+				MeshData::Vertex& vertex = mesh.vertices.emplace_back();
+				vertex = {};
+				vertex.pos = positions[corner.position];
+				if(corner.normal != kNone){
+					vertex.normal = normals[corner.normal];
+				}
+				if(corner.texcoord != kNone){
+					vertex.uv = texcoords[corner.texcoord];
+				}
+				if(smoothing){
+					vertexPositions.push_back(corner.position);
+				}
+			}
+			if(smoothing && corner.normal != kNone){
+				// ObjLoader と同じく面の頂点ごとに足す (まとめる前の数だけ重みがつく)
+				Vector3& sum = sums[corner.position];
+				const Vector3& normal = normals[corner.normal];
+				sum.x += normal.x;
+				sum.y += normal.y;
+				sum.z += normal.z;
+			}
+
+			// 4点目以降は扇状に三角形を足す (四角形なら 0,1,2 と 0,2,3)
+			uint32_t vertexIndex = slot.vertexIndex;
+			if(k >= 3){
+				mesh.indices.push_back(firstVertex);
+				mesh.indices.push_back(previousVertex);
+				mesh.indices.push_back(vertexIndex);
+			}
+			else{
+				mesh.indices.push_back(vertexIndex);
+			}
+			if(k == 0){
+				firstVertex = vertexIndex;
+			}
+			previousVertex = vertexIndex;
+		}
+	}
+
+	if(smoothing){
+		for(size_t i = 0; i < mesh.vertices.size(); ++i){
+			Vector3 normal = sums[vertexPositions[i]];
+			float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			if(length > 0.0f){
+				mesh.vertices[i].normal = {normal.x / length, normal.y / length, normal.z / length};
+			}
+		}
+	}
+}
+
+} // namespace
+
+bool ObjParser::Load(const std::string& name,bool smoothing,MeshData& meshData,uint32_t numThreads){
+	const std::string directoryPath = "Resources/" + name + "/";
+	FileView file;
+	if(!VirtualFileSystem::GetInstance()->Open(directoryPath + name + ".obj",file)){
+		return false;
+	}
+	std::string_view text(reinterpret_cast<const char*>(file.GetData()),file.GetSize());
+	if(!Parse(text,directoryPath,smoothing,meshData,numThreads)){
+		return false;
+	}
+	meshData.name = name;
+	return true;
+}
+
+bool ObjParser::Parse(std::string_view text,const std::string& directoryPath,bool smoothing,MeshData& meshData,uint32_t numThreads){
+	meshData = MeshData();
+	if(numThreads == 0){
+		numThreads = std::max(1u,std::thread::hardware_concurrency());
+	}
+
+	// 行の切れ目で分けて並列に読む
+	size_t numChunks = std::clamp<size_t>(text.size() / kMinChunkSize,1,numThreads);
+	std::vector<Chunk> chunks(numChunks);
+	size_t chunkBegin = 0;
+	for(size_t i = 0; i < numChunks; ++i){
+		size_t chunkEnd = text.size();
+		if(i + 1 < numChunks){
+			chunkEnd = std::max(chunkBegin,text.size() * (i + 1) / numChunks);
+			size_t newline = text.find('\n',chunkEnd);
+			chunkEnd = newline == std::string_view::npos ? text.size() : newline + 1;
+		}
+		chunks[i].text = text.substr(chunkBegin,chunkEnd - chunkBegin);
+		chunkBegin = chunkEnd;
+	}
+	ParallelFor(numChunks,numThreads,[&](size_t i){ ParseChunk(chunks[i]); });
+
+	// 通し番号にしてつなげる
+	std::vector<Vector3> positions;
+	std::vector<Vector2> texcoords;
+	std::vector<Vector3> normals;
+	std::vector<Corner> corners;
+	std::vector<uint32_t> faceSizes;
+	std::vector<Command> commands;
+	size_t numPositions = 0;
+	size_t numTexcoords = 0;
+	size_t numNormals = 0;
+	size_t numCorners = 0;
+	size_t numFaces = 0;
+	for(const Chunk& chunk : chunks){
+		numPositions += chunk.positions.size();
+		numTexcoords += chunk.texcoords.size();
+		numNormals += chunk.normals.size();
+		numCorners += chunk.corners.size();
+		numFaces += chunk.faceSizes.size();
+	}
+	positions.reserve(numPositions);
+	texcoords.reserve(numTexcoords);
+	normals.reserve(numNormals);
+	corners.reserve(numCorners);
+	faceSizes.reserve(numFaces);
+	for(const Chunk& chunk : chunks){
+		size_t positionBase = positions.size();
+		size_t texcoordBase = texcoords.size();
+		size_t normalBase = normals.size();
+		uint32_t faceBase = static_cast<uint32_t>(faceSizes.size());
+		positions.insert(positions.end(),chunk.positions.begin(),chunk.positions.end());
+		texcoords.insert(texcoords.end(),chunk.texcoords.begin(),chunk.texcoords.end());
+		normals.insert(normals.end(),chunk.normals.begin(),chunk.normals.end());
+		faceSizes.insert(faceSizes.end(),chunk.faceSizes.begin(),chunk.faceSizes.end());
+		for(const RawCorner& raw : chunk.corners){
+			// 後ろの番号は OBJ では前方参照できないが、ファイル全体で範囲内かだけを見る
+			Corner& corner = corners.emplace_back();
+			if(!ResolveIndex(raw.position,raw.relative & 1,positionBase,numPositions,true,corner.position) ||
+			   !ResolveIndex(raw.texcoord,raw.relative & 2,texcoordBase,numTexcoords,false,corner.texcoord) ||
+			   !ResolveIndex(raw.normal,raw.relative & 4,normalBase,numNormals,false,corner.normal)){
+				return false;
+			}
+		}
+		for(Command command : chunk.commands){
+			command.faceIndex += faceBase;
+			commands.push_back(command);
+		}
+	}
+
+	// 命令を順に処理してメッシュの範囲を決める
+	std::vector<SubMeshRange> ranges(1);
+	uint32_t faceCursor = 0;
+	uint32_t cornerCursor = 0;
+	auto advanceTo = [&](uint32_t faceIndex){
+		for(; faceCursor < faceIndex; ++faceCursor){
+			cornerCursor += faceSizes[faceCursor];
+		}
+		ranges.back().faceEnd = faceCursor;
+		ranges.back().cornerEnd = cornerCursor;
+	};
+	for(const Command& command : commands){
+		advanceTo(command.faceIndex);
+		SubMeshRange& current = ranges.back();
+		switch(command.type){
+		case Command::Type::kMaterialLibrary:{
+			FileView file;
+			if(VirtualFileSystem::GetInstance()->Open(directoryPath + std::string(command.argument),file)){
+				ParseMaterials(std::string_view(reinterpret_cast<const char*>(file.GetData()),file.GetSize()),meshData);
+			}
+			break;
+		}
+		case Command::Type::kGroup:
+			// 今のメッシュに中身があれば次のメッシュへ
+			if(!current.subMesh.name.empty() && current.cornerEnd > current.cornerBegin){
+				SubMeshRange& next = ranges.emplace_back();
+				next.faceBegin = next.faceEnd = faceCursor;
+				next.cornerBegin = next.cornerEnd = cornerCursor;
+			}
+			if(!command.argument.empty()){
+				ranges.back().subMesh.name = command.argument;
+			}
+			break;
+		case Command::Type::kUseMaterial:
+			if(current.subMesh.materialIndex < 0){
+				for(size_t i = 0; i < meshData.materials.size(); ++i){
+					if(meshData.materials[i].name == command.argument){
+						current.subMesh.materialIndex = static_cast<int32_t>(i);
+						break;
+					}
+				}
+			}
+			break;
+		}
+	}
+	advanceTo(static_cast<uint32_t>(faceSizes.size()));
+
+	// メッシュごとに頂点を作る (メッシュどうしは独立しているので並列にできる)
+	std::vector<BuiltMesh> meshes(ranges.size());
+	ParallelFor(ranges.size(),numThreads,[&](size_t i){
+		BuildSubMesh(ranges[i],corners,faceSizes,positions,texcoords,normals,smoothing,meshes[i]);
+	});
+
+	size_t totalVertices = 0;
+	size_t totalIndices = 0;
+	for(const BuiltMesh& mesh : meshes){
+		totalVertices += mesh.vertices.size();
+		totalIndices += mesh.indices.size();
+	}
+	meshData.vertices.reserve(totalVertices);
+	meshData.indices.reserve(totalIndices);
+	for(size_t i = 0; i < ranges.size(); ++i){
+		MeshData::SubMesh& subMesh = meshData.subMeshes.emplace_back(std::move(ranges[i].subMesh));
+		subMesh.vertexOffset = static_cast<uint32_t>(meshData.vertices.size());
+		subMesh.vertexCount = static_cast<uint32_t>(meshes[i].vertices.size());
+		subMesh.indexOffset = static_cast<uint32_t>(meshData.indices.size());
+		subMesh.indexCount = static_cast<uint32_t>(meshes[i].indices.size());
+		meshData.vertices.insert(meshData.vertices.end(),meshes[i].vertices.begin(),meshes[i].vertices.end());
+		meshData.indices.insert(meshData.indices.end(),meshes[i].indices.begin(),meshes[i].indices.end());
+	}
+	return true;
+}
+
+void ObjParser::ParseMaterials(std::string_view text,MeshData& meshData){
+	MeshData::MaterialData* material = nullptr;
+	const char* cursor = text.data();
+	const char* end = cursor + text.size();
+	while(cursor < end){
+		const char* lineEnd = FindLineEnd(cursor,end);
+		std::string_view key = NextToken(cursor,lineEnd);
+
+		if(key == "newmtl"){
+			material = &meshData.materials.emplace_back();
+			material->name = NextToken(cursor,lineEnd);
+		}
+		else if(material){
+			// (newmtl より前の行は無視)
+			if(key == "Ka" || key == "Kd" || key == "Ks"){
+				Vector3& color = key == "Ka" ? material->ambient : key == "Kd" ? material->diffuse : material->specular;
+				color.x = ParseFloat(NextToken(cursor,lineEnd));
+				color.y = ParseFloat(NextToken(cursor,lineEnd));
+				color.z = ParseFloat(NextToken(cursor,lineEnd));
+			}
+			else if(key == "d"){
+				material->alpha = ParseFloat(NextToken(cursor,lineEnd));
+			}
+			else if(key == "map_Kd"){
+				material->textureFilename = GetFileName(NextToken(cursor,lineEnd));
+			}
+		}
+
+		cursor = lineEnd + 1;
+	}
+}
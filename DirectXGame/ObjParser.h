@@ -0,0 +1,26 @@
+#pragma once
+#include "MeshData.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ==========================================
+// 速い OBJ/MTL の読み込み (CPU 側だけ)
+// ObjLoader と同じ解釈だが、
+// ・ファイルはマップして文字列をコピーせずに読む (数値は std::from_chars)
+// ・同じ v/vt/vn の組はオープンアドレスのハッシュで1頂点にまとめる
+// ・ファイルを行の切れ目で分けて複数スレッドで読み、メッシュごとの頂点作成も並列に行う
+// スレッドは自前で立てる (JobSystem のジョブの中から呼んでも待ち合わせで詰まらない)
+// ==========================================
+class ObjParser{
+public:
+	// Resources/<name>/<name>.obj を読む
+	// numThreads は呼び出し元を含めたスレッド数 (0 ならコア数、1 なら並列にしない)
+	static bool Load(const std::string& name,bool smoothing,MeshData& meshData,uint32_t numThreads = 1);
+
+	// メモリ上の OBJ を読む (mtllib は directoryPath から探す)
+	static bool Parse(std::string_view text,const std::string& directoryPath,bool smoothing,MeshData& meshData,uint32_t numThreads = 1);
+
+private:
+	static void ParseMaterials(std::string_view text,MeshData& meshData);
+};
@@ -0,0 +1,282 @@
+#include "PackFile.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+namespace{
+
+// 一番大きいバケットから順に、空いたスロットに収まる変位をこの回数まで探す
+const uint32_t kMaxDisplacement = 1u << 20;
+// 1バケットに入る名前の平均 (大きいほど表は小さく、作るのに時間がかかる)
+const uint32_t kKeysPerBucket = 4;
+
+uint64_t AlignUp(uint64_t value,uint64_t alignment){
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t Mix(uint64_t value){
+	value ^= value >> 30;
+	value *= 0xBF58476D1CE4E5B9ull;
+	value ^= value >> 27;
+	value *= 0x94D049BB133111EBull;
+	value ^= value >> 31;
+	return value;
+}
+
+bool ReadWholeFile(const std::string& path,std::vector<std::byte>& data){
+	std::ifstream file(path,std::ios::binary | std::ios::ate);
+	if(!file.is_open()){
+		return false;
+	}
+	data.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()),static_cast<std::streamsize>(data.size()));
+	return file.good() || data.empty();
+}
+
+} // namespace
+
+std::string PackFile::NormalizePath(std::string_view path){
+	if(path.starts_with("./")){
+		path.remove_prefix(2);
+	}
+	std::string result(path);
+	for(char& c : result){
+		if(c == '\\'){
+			c = '/';
+		}
+		else if(c >= 'A' && c <= 'Z'){
+			c = static_cast<char>(c - 'A' + 'a');
+		}
+	}
+	return result;
+}
+
+uint64_t PackFile::HashName(std::string_view name){
+	// FNV-1a を混ぜ直して、下位のビットも偏らないようにする
+	uint64_t hash = 14695981039346656037ull;
+	for(char c : name){
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return Mix(hash);
+}
+
+uint32_t PackFile::GetSlot(uint64_t hash,uint32_t displacement,uint32_t slotCount){
+	return static_cast<uint32_t>(Mix(hash ^ (displacement * 0x9E3779B97F4A7C15ull)) % slotCount);
+}
+
+bool PackFile::BuildTable(const std::vector<uint64_t>& hashes,uint32_t bucketCount,std::vector<uint32_t>& displacements,std::vector<uint32_t>& slots){
+	uint32_t slotCount = static_cast<uint32_t>(hashes.size());
+	std::vector<std::vector<uint32_t>> buckets(bucketCount);
+	for(uint32_t i = 0; i < slotCount; ++i){
+		buckets[(hashes[i] >> 32) % bucketCount].push_back(i);
+	}
+	std::vector<uint32_t> order(bucketCount);
+	for(uint32_t i = 0; i < bucketCount; ++i){
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(),order.end(),[&](uint32_t a,uint32_t b){ return buckets[a].size() > buckets[b].size(); });
+
+	displacements.assign(bucketCount,0);
+	slots.assign(slotCount,UINT32_MAX);
+	std::vector<uint32_t> candidate;
+	for(uint32_t bucketIndex : order){
+		const std::vector<uint32_t>& bucket = buckets[bucketIndex];
+		if(bucket.empty()){
+			break;
+		}
+		bool isPlaced = false;
+		for(uint32_t displacement = 0; displacement < kMaxDisplacement && !isPlaced; ++displacement){
+			candidate.clear();
+			isPlaced = true;
+			for(uint32_t key : bucket){
+				uint32_t slot = GetSlot(hashes[key],displacement,slotCount);
+				if(slots[slot] != UINT32_MAX || std::find(candidate.begin(),candidate.end(),slot) != candidate.end()){
+					isPlaced = false;
+					break;
+				}
+				candidate.push_back(slot);
+			}
+			if(isPlaced){
+				displacements[bucketIndex] = displacement;
+				for(size_t i = 0; i < bucket.size(); ++i){
+					slots[candidate[i]] = bucket[i];
+				}
+			}
+		}
+		if(!isPlaced){
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PackFile::Write(const std::vector<Source>& sources,const std::string& path,WriteStats& stats){
+	stats = WriteStats();
+	uint32_t entryCount = static_cast<uint32_t>(sources.size());
+
+	// 名前
+	std::vector<std::string> names(entryCount);
+	std::vector<uint64_t> hashes(entryCount);
+	std::unordered_set<std::string> seen;
+	for(uint32_t i = 0; i < entryCount; ++i){
+		names[i] = NormalizePath(sources[i].path);
+		hashes[i] = HashName(names[i]);
+		if(!seen.insert(names[i]).second){
+			return false;
+		}
+	}
+	uint32_t bucketCount = std::max(1u,(entryCount + kKeysPerBucket - 1) / kKeysPerBucket);
+	std::vector<uint32_t> displacements;
+	std::vector<uint32_t> slots;
+	if(!BuildTable(hashes,bucketCount,displacements,slots)){
+		return false;
+	}
+
+	// 中身 (縮むものだけ圧縮する)
+	std::vector<std::vector<std::byte>> contents(entryCount);
+	std::vector<FileEntry> entries(entryCount);
+	std::string nameBlock;
+	for(uint32_t i = 0; i < entryCount; ++i){
+		std::vector<std::byte>& data = contents[i];
+		if(!ReadWholeFile(sources[i].path,data)){
+			return false;
+		}
+		FileEntry& entry = entries[i];
+		entry = {};
+		entry.size = data.size();
+		entry.storedSize = data.size();
+		if(sources[i].isCompressible && !data.empty()){
+			std::vector<std::byte> compressed = Lz4::Compress(data);
+			// 1/8 も縮まないなら、展開の手間をかけずにそのまま渡す方がよい
+			if(compressed.size() <= data.size() - data.size() / 8){
+				data = std::move(compressed);
+				entry.storedSize = data.size();
+				entry.flags |= kCompressed;
+				++stats.compressedCount;
+			}
+		}
+		entry.nameOffset = static_cast<uint32_t>(nameBlock.size());
+		entry.nameLength = static_cast<uint32_t>(names[i].size());
+		nameBlock += names[i];
+		stats.originalBytes += entry.size;
+		stats.storedBytes += entry.storedSize;
+	}
+
+	// 配置
+	FileHeader header = {};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.entryCount = entryCount;
+	header.bucketCount = bucketCount;
+	uint64_t entriesOffset = AlignUp(sizeof(FileHeader) + sizeof(uint32_t) * (static_cast<uint64_t>(bucketCount) + entryCount),alignof(FileEntry));
+	header.namesOffset = entriesOffset + sizeof(FileEntry) * entryCount;
+	header.namesSize = nameBlock.size();
+	header.dataOffset = AlignUp(header.namesOffset + header.namesSize,kAlignment);
+	uint64_t offset = header.dataOffset;
+	for(uint32_t i = 0; i < entryCount; ++i){
+		entries[i].offset = offset;
+		offset = AlignUp(offset + entries[i].storedSize,kAlignment);
+		if(sources[i].isTraced){
+			header.tracedSize = entries[i].offset + entries[i].storedSize - header.dataOffset;
+		}
+	}
+
+	std::ofstream file(path,std::ios::binary | std::ios::trunc);
+	if(!file.is_open()){
+		return false;
+	}
+	auto writeBytes = [&](const void* data,uint64_t size){ file.write(static_cast<const char*>(data),static_cast<std::streamsize>(size)); };
+	auto padTo = [&](uint64_t position){
+		static const char kZeros[kAlignment] = {};
+		uint64_t current = static_cast<uint64_t>(file.tellp());
+		writeBytes(kZeros,position - current);
+	};
+	writeBytes(&header,sizeof(header));
+	writeBytes(displacements.data(),sizeof(uint32_t) * displacements.size());
+	writeBytes(slots.data(),sizeof(uint32_t) * slots.size());
+	padTo(entriesOffset);
+	writeBytes(entries.data(),sizeof(FileEntry) * entries.size());
+	writeBytes(nameBlock.data(),nameBlock.size());
+	for(uint32_t i = 0; i < entryCount; ++i){
+		padTo(entries[i].offset);
+		writeBytes(contents[i].data(),contents[i].size());
+	}
+	stats.entryCount = entryCount;
+	stats.fileBytes = static_cast<uint64_t>(file.tellp());
+	return file.good();
+}
+
+bool PackFile::Open(const std::string& path){
+	Close();
+	if(!file_.Open(path) || file_.GetSize() < sizeof(FileHeader)){
+		Close();
+		return false;
+	}
+	const std::byte* data = file_.GetData();
+	uint64_t size = file_.GetSize();
+	std::memcpy(&header_,data,sizeof(header_));
+	uint64_t entriesOffset = AlignUp(sizeof(FileHeader) + sizeof(uint32_t) * (static_cast<uint64_t>(header_.bucketCount) + header_.entryCount),alignof(FileEntry));
+	if(header_.magic != kMagic || header_.version != kVersion || header_.bucketCount == 0 ||
+	   header_.namesOffset != entriesOffset + sizeof(FileEntry) * header_.entryCount || header_.namesOffset + header_.namesSize > size){
+		Close();
+		return false;
+	}
+
+	displacements_ = reinterpret_cast<const uint32_t*>(data + sizeof(FileHeader));
+	slots_ = displacements_ + header_.bucketCount;
+	entries_ = reinterpret_cast<const FileEntry*>(data + entriesOffset);
+	names_ = reinterpret_cast<const char*>(data + header_.namesOffset);
+
+	// 壊れたパックで範囲外を読まないよう、最初に1度だけ確かめる
+	for(uint32_t i = 0; i < header_.entryCount; ++i){
+		const FileEntry& entry = entries_[i];
+		if(slots_[i] >= header_.entryCount || entry.offset > size || entry.storedSize > size - entry.offset ||
+		   static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header_.namesSize || ((entry.flags & kCompressed) == 0 && entry.storedSize != entry.size)){
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void PackFile::Close(){
+	file_.Close();
+	header_ = {};
+	displacements_ = nullptr;
+	slots_ = nullptr;
+	entries_ = nullptr;
+	names_ = nullptr;
+}
+
+bool PackFile::Find(std::string_view path,Item& item) const{
+	if(header_.entryCount == 0){
+		return false;
+	}
+	std::string name = NormalizePath(path);
+	uint64_t hash = HashName(name);
+	uint32_t displacement = displacements_[(hash >> 32) % header_.bucketCount];
+	const FileEntry& entry = entries_[slots_[GetSlot(hash,displacement,header_.entryCount)]];
+	// 無い名前も必ずどこかのスロットに当たるので、名前を比べて確かめる
+	if(std::string_view(names_ + entry.nameOffset,entry.nameLength) != name){
+		return false;
+	}
+	item.stored = {file_.GetData() + entry.offset,static_cast<size_t>(entry.storedSize)};
+	item.size = entry.size;
+	item.isCompressed = (entry.flags & kCompressed) != 0;
+	return true;
+}
+
+std::string_view PackFile::GetEntryPath(uint32_t index) const{
+	const FileEntry& entry = entries_[index];
+	return std::string_view(names_ + entry.nameOffset,entry.nameLength);
+}
+
+void PackFile::Prefetch(){
+	if(IsOpen()){
+		file_.Prefetch(0,static_cast<size_t>(header_.dataOffset + header_.tracedSize));
+	}
+}
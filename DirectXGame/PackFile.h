@@ -0,0 +1,102 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ==========================================
+// リソースのパック (.kpak)
+// [ヘッダ][変位 (uint32 × バケット数)][スロット (uint32 × エントリ数)][エントリ][名前] … 4096 境界 … [中身][中身]…
+// ・名前は区切りを / にして小文字にしたもの ("resources/player/player.obj")
+// ・目次は最小完全ハッシュ (CHD): 名前のハッシュでバケットを決め、バケットの変位を混ぜて
+//   スロットを1つに決める。1回引けば必ずそのエントリか、無いかのどちらか
+// ・中身はページ (4096) 境界に置くので、マップしたまま渡せる (クック済みメッシュの頂点など)
+// ・圧縮するかはエントリごと (LZ4)。縮まないものはそのまま置く
+// ・中身は渡された順に並べる (読み込みの記録順に並べれば、起動時の読み込みが先頭からの連続読みになる)
+// ==========================================
+class PackFile{
+public:
+	static inline const uint32_t kMagic = 0x4B41504B; // "KPAK"
+	// 形式を変えたら上げる
+	static inline const uint32_t kVersion = 1;
+	static inline const uint64_t kAlignment = 4096;
+
+	// 書き出すファイル (パスは作業フォルダからの相対)
+	struct Source{
+		std::string path;
+		bool isCompressible = false; // 圧縮を試す (テキストなど)
+		bool isTraced = false;       // 読み込みの記録に載っていた (先頭にまとめて先読みする)
+	};
+
+	struct WriteStats{
+		uint32_t entryCount = 0;
+		uint32_t compressedCount = 0;
+		uint64_t originalBytes = 0; // 元のファイルの合計
+		uint64_t storedBytes = 0;   // パック内の中身の合計 (圧縮後、境界の余白は除く)
+		uint64_t fileBytes = 0;     // パック全体
+	};
+
+	// 引いた結果
+	struct Item{
+		std::span<const std::byte> stored; // パック内の中身 (圧縮していれば圧縮したまま)
+		uint64_t size = 0;                 // 元の大きさ
+		bool isCompressed = false;
+	};
+
+	// 区切りを / にして小文字にする (Windows と同じく大文字小文字を区別しない)
+	static std::string NormalizePath(std::string_view path);
+
+	// sources の順に並べて書き出す。読めないファイルや、大文字小文字だけが違う名前があれば失敗
+	static bool Write(const std::vector<Source>& sources,const std::string& path,WriteStats& stats);
+
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const{ return file_.IsOpen(); }
+
+	// 無ければ false
+	bool Find(std::string_view path,Item& item) const;
+
+	uint32_t GetEntryCount() const{ return header_.entryCount; }
+	std::string_view GetEntryPath(uint32_t index) const;
+
+	// 目次と、記録順に並べた区間 (起動時に読むもの) をまとめて先読みさせる
+	void Prefetch();
+
+private:
+	struct FileHeader{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t bucketCount;
+		uint64_t namesOffset;
+		uint64_t namesSize;
+		uint64_t dataOffset;  // 最初の中身 (ここまでが目次)
+		uint64_t tracedSize;  // dataOffset からの、記録順に並べた区間の長さ
+	};
+
+	struct FileEntry{
+		uint64_t offset;
+		uint64_t size;
+		uint64_t storedSize;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	static inline const uint32_t kCompressed = 1;
+
+	static uint64_t HashName(std::string_view name);
+	static uint32_t GetSlot(uint64_t hash,uint32_t displacement,uint32_t slotCount);
+	// 全てのスロットが埋まる変位を探す (見つからなければ false)
+	static bool BuildTable(const std::vector<uint64_t>& hashes,uint32_t bucketCount,std::vector<uint32_t>& displacements,std::vector<uint32_t>& slots);
+
+	MappedFile file_;
+	FileHeader header_ = {};
+	const uint32_t* displacements_ = nullptr;
+	const uint32_t* slots_ = nullptr;
+	const FileEntry* entries_ = nullptr;
+	const char* names_ = nullptr;
+};
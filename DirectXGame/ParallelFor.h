@@ -0,0 +1,42 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// ==========================================
+// count 個の仕事を numThreads 本 (呼び出し元を含む。0 ならコア数) で分け合う
+// スレッドはその場で立てて終わるまで待つ (JobSystem のジョブの中から呼んでも詰まらない)
+// ObjParser やテクスチャのクックのような、まとまった CPU 処理用
+// ==========================================
+template<typename Function>
+void ParallelFor(size_t count,uint32_t numThreads,const Function& function){
+	if(numThreads == 0){
+		numThreads = std::max(1u,std::thread::hardware_concurrency());
+	}
+	size_t numWorkers = std::min<size_t>(numThreads,count);
+	if(numWorkers <= 1){
+		for(size_t i = 0; i < count; ++i){
+			function(i);
+		}
+		return;
+	}
+
+	std::atomic<size_t> next = 0;
+	auto worker = [&](){
+		for(size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)){
+			function(i);
+		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(numWorkers - 1);
+	for(size_t i = 1; i < numWorkers; ++i){
+		threads.emplace_back(worker);
+	}
+	worker();
+	for(std::thread& thread : threads){
+		thread.join();
+	}
+}
@@ -42,8 +42,10 @@ void ParticleManager::Update(float deltaTime){
 }
 
 void ParticleManager::Draw(Camera* camera){
+	// 画面に入らない粒は各システムが描かずに飛ばす
+	culler.Begin(Frustum::Create(camera->matView,camera->matProjection));
 	for(auto const& [name,system] : systems){
-		system->Draw(camera);
+		system->Draw(camera,culler);
 	}
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "KamataEngine.h" // 基盤となるKamataEngineのヘッダーファイル
+#include "VisibilityCuller.h" // 画面外のパーティクルを描かないための判定
 #include <map>            // エフェクトシステムを名前で管理するためのマップ
 #include <string>         // システム名に使用する文字列
 #include <vector> // 将来的な拡張用のベクトル（現在は未使用だが、インクルードされている）
@@ -20,7 +21,8 @@ public:
 
   /// @brief 描画処理（純粋仮想関数 = 継承クラスでの実装が必須）
   /// @param camera 描画に使用するカメラ情報
-  virtual void Draw(Camera *camera) = 0;
+  /// @param culler 視錐台カリング（粒の囲む形を積んで Cull し、見えるものだけ描く）
+  virtual void Draw(Camera *camera, VisibilityCuller &culler) = 0;
 };
 
 /// @brief すべてのエフェクトシステムを管理するシングルトンクラス
@@ -32,6 +34,9 @@ private:
   // エフェクトシステムの名前とインスタンスを保持するマップ
   std::map<std::string, EffectSystemBase *> systems;
 
+  // 全システムで共有する視錐台カリング（Draw のたびにカメラから作り直す）
+  VisibilityCuller culler;
+
   // 外部からのインスタンス生成を防ぐためのプライベートコンストラクタ
   ParticleManager() = default;
 
@@ -51,6 +56,9 @@ public:
   /// @param camera 描画に使用するカメラ情報
   void Draw(Camera *camera);
 
+  /// @brief 直前の Draw で判定したパーティクルの数（画面外で省いた数の確認用）
+  const VisibilityCuller &GetCuller() const { return culler; }
+
   /// @brief
   /// ParticleManagerと管理下のエフェクトシステムを終了・クリーンアップする
   void Shutdown();
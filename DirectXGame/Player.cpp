@@ -5,14 +5,19 @@
 #include "MapChipField.h"
 #include "Math.h"
 #include "ParticleManager.h"
+#include "TransformInterpolator.h"
 #include <algorithm>
 #include <cassert>
 #include <numbers>
 
+Player::~Player(){
+	TransformInterpolator::GetInstance()->Unregister(&worldTransform_);
+}
+
 // =================================================================
 // 初期化処理
 // =================================================================
-void Player::Initialize(Model* model,Model* modelAttack,Camera* camera,const Vector3& position){
+void Player::Initialize(MeshModel* model,MeshModel* modelAttack,Camera* camera,const Vector3& position){
 	assert(model);
 
 	// --- モデルとカメラのセット ---
@@ -30,18 +35,32 @@ void Player::Initialize(Model* model,Model* modelAttack,Camera* camera,const Vec
 	worldTransformAttack_.translation_ = worldTransform_.translation_;
 	worldTransformAttack_.rotation_ = worldTransform_.rotation_;
 
-	// --- パーティクルシステムの取得 ---
-	JumpSystem* jump = ParticleManager::GetInstance()->GetJumpSystem();
-	if(jump){
-		jump->Initialize(model_,textureHandle_);
-	}
-
 	// --- パラメータ初期化 ---
 	objectColor_.Initialize();
+	state_ = State();
+
+	// 描画補間の対象にする
+	TransformInterpolator::GetInstance()->Register(&worldTransform_);
+
+	// リトライで戻す状態を取っておく
+	initialSnapshot_ = {state_, worldTransform_.scale_, worldTransform_.rotation_, worldTransform_.translation_};
+}
 
-	// ★追加: 状態のリセット
-	isInhaling_ = false;
-	hasAmmo_ = false;
+// =================================================================
+// リトライ用のリセット (モデル・定数バッファは作り直さない)
+// =================================================================
+void Player::Reset(){
+	// --- 状態と本体の姿勢は Initialize 直後の値をそのまま書き戻す ---
+	state_ = initialSnapshot_.state;
+	worldTransform_.scale_ = initialSnapshot_.scale;
+	worldTransform_.rotation_ = initialSnapshot_.rotation;
+	worldTransform_.translation_ = initialSnapshot_.translation;
+	worldTransformAttack_.translation_ = worldTransform_.translation_;
+	worldTransformAttack_.rotation_ = worldTransform_.rotation_;
+	// (本体は TransformInterpolator が描画前に補間して転送するので、ここでは行列を作るだけ)
+	worldTransform_.matWorld_ = MakeAffineMatrix(worldTransform_.scale_,worldTransform_.rotation_,worldTransform_.translation_);
+	WorldTransformUpdate(worldTransformAttack_,attackTransformTracker_);
+	objectColor_.SetColor({1.0f, 1.0f, 1.0f, 1.0f});
 }
 
 // =================================================================
@@ -50,10 +69,10 @@ void Player::Initialize(Model* model,Model* modelAttack,Camera* camera,const Vec
 void Player::Update(){
 
 	// --- 行動遷移リクエストの処理 ---
-	if(behaviorRequest_ != Behavior::kUnknown){
-		behavior_ = behaviorRequest_;
+	if(state_.behaviorRequest != Behavior::kUnknown){
+		state_.behavior = state_.behaviorRequest;
 
-		switch(behavior_){
+		switch(state_.behavior){
 		case Behavior::kRoot:
 		default:
 			BehaviorRootInitialize();
@@ -66,11 +85,11 @@ void Player::Update(){
 			break;
 		}
 
-		behaviorRequest_ = Behavior::kUnknown;
+		state_.behaviorRequest = Behavior::kUnknown;
 	}
 
 	// --- 現在の振る舞いごとの更新 ---
-	switch(behavior_){
+	switch(state_.behavior){
 	case Behavior::kRoot:
 	default:
 		BehaviorRootUpdate(); // 通常移動
@@ -84,10 +103,10 @@ void Player::Update(){
 	}
 
 	// --- 色の反映（状態に合わせて色を変える） ---
-	if(hasAmmo_){
+	if(state_.hasAmmo){
 		// 弾を持っている時：オレンジ（満腹）
 		objectColor_.SetColor({1.0f, 0.5f, 0.0f, 1.0f});
-	} else if(isInhaling_){
+	} else if(state_.isInhaling){
 		// 吸い込み中：青（吸い込み）
 		objectColor_.SetColor({0.5f, 0.5f, 1.0f, 1.0f});
 	} else{
@@ -96,8 +115,13 @@ void Player::Update(){
 	}
 
 	// --- 行列更新 ---
-	WorldTransformUpdate(worldTransform_);
-	WorldTransformUpdate(worldTransformAttack_);
+	// (本体は TransformInterpolator が描画前に補間して転送するので、ここでは行列を作るだけ)
+	worldTransform_.matWorld_ = MakeAffineMatrix(worldTransform_.scale_,worldTransform_.rotation_,worldTransform_.translation_);
+	WorldTransformUpdate(worldTransformAttack_,attackTransformTracker_);
+
+	// 次のティックのトリガー判定用にキー状態を保存
+	state_.preTickPushSpace = Input::GetInstance()->PushKey(DIK_SPACE);
+	state_.preTickPushUp = Input::GetInstance()->PushKey(DIK_UP);
 }
 
 // =================================================================
@@ -120,7 +144,7 @@ void Player::BehaviorRootUpdate(){
 
 	// --- マップ衝突判定 ---
 	CollisionMapInfo collisionMapInfo = {};
-	collisionMapInfo.move = velocity_;
+	collisionMapInfo.move = state_.velocity;
 	collisionMapInfo.landing = false;
 	collisionMapInfo.hitWall = false;
 
@@ -129,18 +153,18 @@ void Player::BehaviorRootUpdate(){
 	worldTransform_.translation_ += collisionMapInfo.move;
 
 	if(collisionMapInfo.ceiling){
-		velocity_.y = 0;
+		state_.velocity.y = 0;
 	}
 	UpdateOnWall(collisionMapInfo);
 	UpdateOnGround(collisionMapInfo);
 
 	// --- 旋回アニメーション ---
-	if(turnTimer_ > 0.0f){
-		turnTimer_ = std::max(turnTimer_ - (1.0f / 60.0f),0.0f);
+	if(state_.turnTimer > 0.0f){
+		state_.turnTimer = std::max(state_.turnTimer - FixedTimestep::kDeltaTime,0.0f);
 		float destinationRotationYTable[] = {std::numbers::pi_v<float> / 2.0f,
 											 std::numbers::pi_v<float> *3.0f / 2.0f};
-		float destinationRotationY = destinationRotationYTable[static_cast<uint32_t>(lrDirection_)];
-		worldTransform_.rotation_.y = EaseInOut(destinationRotationY,turnFirstRotationY_,turnTimer_ / kTimeTurn);
+		float destinationRotationY = destinationRotationYTable[static_cast<uint32_t>(state_.lrDirection)];
+		worldTransform_.rotation_.y = EaseInOut(destinationRotationY,state_.turnFirstRotationY,state_.turnTimer / kTimeTurn);
 	}
 
 	// =========================================================
@@ -148,22 +172,22 @@ void Player::BehaviorRootUpdate(){
 	// =========================================================
 
 	// まだ弾を持っていない場合 -> 「吸い込み」が可能
-	if(!hasAmmo_){
+	if(!state_.hasAmmo){
 		if(Input::GetInstance()->PushKey(DIK_SPACE)){
 			// スペースキーを押している間、吸い込み状態にする
-			isInhaling_ = true;
+			state_.isInhaling = true;
 		} else{
-			isInhaling_ = false;
+			state_.isInhaling = false;
 		}
 	}
 	// すでに弾を持っている場合 -> 「吐き出し」が可能
 	else{
-		isInhaling_ = false; // 満腹なので吸い込めない
+		state_.isInhaling = false; // 満腹なので吸い込めない
 
 		// スペースキーで発射！
-		if(Input::GetInstance()->TriggerKey(DIK_SPACE)){
-			behaviorRequest_ = Behavior::kShot; // 射撃ステートへ遷移
-			hasAmmo_ = false; // 弾を消費して空っぽに戻る
+		if(TriggerKeyOnTick(DIK_SPACE,state_.preTickPushSpace)){
+			state_.behaviorRequest = Behavior::kShot; // 射撃ステートへ遷移
+			state_.hasAmmo = false; // 弾を消費して空っぽに戻る
 		}
 	}
 }
@@ -172,58 +196,58 @@ void Player::BehaviorRootUpdate(){
 // 振る舞い: ソード攻撃 (今回は未使用に近いが残しておく)
 // =================================================================
 void Player::BehaviorAttackInitialize(){
-	attackParameter_ = 0;
-	velocity_ = {};
-	attackPhase_ = AttackPhase::kAnticipation;
+	state_.attackParameter = 0;
+	state_.velocity = {};
+	state_.attackPhase = AttackPhase::kAnticipation;
 }
 
 void Player::BehaviorAttackUpdate(){
 	// 既存コード維持（もしソード攻撃を使いたくなったとき用）
 	const Vector3 attackVelocity = {0.8f, 0.0f, 0.0f};
 	Vector3 velocity{};
-	attackParameter_++;
+	state_.attackParameter++;
 
-	switch(attackPhase_){
+	switch(state_.attackPhase){
 	case AttackPhase::kAnticipation:
 	default:
 	{
 		velocity = {};
-		float t = static_cast<float>(attackParameter_) / kAnticipationTime;
+		float t = static_cast<float>(state_.attackParameter) / kAnticipationTime;
 		worldTransform_.scale_.z = EaseOut(1.0f,0.3f,t);
 		worldTransform_.scale_.y = EaseOut(1.0f,1.6f,t);
 
-		if(attackParameter_ >= kAnticipationTime){
-			attackPhase_ = AttackPhase::kAction;
-			attackParameter_ = 0;
+		if(state_.attackParameter >= kAnticipationTime){
+			state_.attackPhase = AttackPhase::kAction;
+			state_.attackParameter = 0;
 		}
 		break;
 	}
 	case AttackPhase::kAction:
 	{
-		if(lrDirection_ == LRDirection::kRight){
+		if(state_.lrDirection == LRDirection::kRight){
 			velocity = +attackVelocity;
 		} else{
 			velocity = -attackVelocity;
 		}
-		float t = static_cast<float>(attackParameter_) / kActionTime;
+		float t = static_cast<float>(state_.attackParameter) / kActionTime;
 		worldTransform_.scale_.z = EaseOut(0.3f,1.3f,t);
 		worldTransform_.scale_.y = EaseIn(1.6f,0.7f,t);
 
-		if(attackParameter_ >= kActionTime){
-			attackPhase_ = AttackPhase::kRecovery;
-			attackParameter_ = 0;
+		if(state_.attackParameter >= kActionTime){
+			state_.attackPhase = AttackPhase::kRecovery;
+			state_.attackParameter = 0;
 		}
 		break;
 	}
 	case AttackPhase::kRecovery:
 	{
 		velocity = {};
-		float t = static_cast<float>(attackParameter_) / kRecoveryTime;
+		float t = static_cast<float>(state_.attackParameter) / kRecoveryTime;
 		worldTransform_.scale_.z = EaseOut(1.3f,1.0f,t);
 		worldTransform_.scale_.y = EaseOut(0.7f,1.0f,t);
 
-		if(attackParameter_ >= kRecoveryTime){
-			behaviorRequest_ = Behavior::kRoot;
+		if(state_.attackParameter >= kRecoveryTime){
+			state_.behaviorRequest = Behavior::kRoot;
 		}
 		break;
 	}
@@ -243,22 +267,22 @@ void Player::BehaviorAttackUpdate(){
 // =================================================================
 void Player::BehaviorShotInitialize(){
 	// 足を止める
-	velocity_ = {};
+	state_.velocity = {};
 
 	// 硬直時間（吐き出しモーションの時間）
-	shotTimer_ = kShotTime;
+	state_.shotTimer = kShotTime;
 
 	// GameScene側で検知して弾を生成するフラグON
-	isShotBeamRequest_ = true;
+	state_.isShotBeamRequest = true;
 }
 
 void Player::BehaviorShotUpdate(){
 	// 重力のみ適用
-	velocity_.y += -kGravityAcceleration / 60.0f;
-	velocity_.y = std::max(velocity_.y,-kLimitFallSpeed);
+	state_.velocity.y += -kGravityAcceleration * FixedTimestep::kDeltaTime;
+	state_.velocity.y = std::max(state_.velocity.y,-kLimitFallSpeed);
 
 	CollisionMapInfo collisionMapInfo = {};
-	collisionMapInfo.move = velocity_;
+	collisionMapInfo.move = state_.velocity;
 	collisionMapInfo.landing = false;
 	collisionMapInfo.hitWall = false;
 
@@ -267,10 +291,10 @@ void Player::BehaviorShotUpdate(){
 	worldTransform_.translation_ += collisionMapInfo.move;
 	UpdateOnGround(collisionMapInfo);
 
-	shotTimer_--;
+	state_.shotTimer--;
 
-	if(shotTimer_ <= 0){
-		behaviorRequest_ = Behavior::kRoot;
+	if(state_.shotTimer <= 0){
+		state_.behaviorRequest = Behavior::kRoot;
 	}
 }
 
@@ -284,7 +308,7 @@ AABB Player::GetInhaleArea(){
 
 	AABB area;
 	// プレイヤーの向いている方向の前方に判定ボックスを作る
-	if(lrDirection_ == LRDirection::kRight){
+	if(state_.lrDirection == LRDirection::kRight){
 		area.min = {pos.x + 0.5f, pos.y - 1.5f, pos.z - 2.0f};
 		area.max = {pos.x + 0.5f + range, pos.y + 1.5f, pos.z + 2.0f};
 	} else{
@@ -300,41 +324,41 @@ AABB Player::GetInhaleArea(){
 // =================================================================
 void Player::InputMove(){
 
-	if(onGround_){
-		isHovering_ = false;
+	if(state_.onGround){
+		state_.isHovering = false;
 
 		if(Input::GetInstance()->PushKey(DIK_RIGHT) || Input::GetInstance()->PushKey(DIK_LEFT)){
 			Vector3 acceleration = {};
 
 			if(Input::GetInstance()->PushKey(DIK_RIGHT)){
-				if(velocity_.x < 0.0f){ velocity_.x *= (1.0f - kAttenuation); }
-				acceleration.x += kAcceleration / 60.0f;
-				if(lrDirection_ != LRDirection::kRight){
-					lrDirection_ = LRDirection::kRight;
-					turnFirstRotationY_ = worldTransform_.rotation_.y;
-					turnTimer_ = kTimeTurn;
+				if(state_.velocity.x < 0.0f){ state_.velocity.x *= (1.0f - kAttenuation); }
+				acceleration.x += kAcceleration * FixedTimestep::kDeltaTime;
+				if(state_.lrDirection != LRDirection::kRight){
+					state_.lrDirection = LRDirection::kRight;
+					state_.turnFirstRotationY = worldTransform_.rotation_.y;
+					state_.turnTimer = kTimeTurn;
 				}
 			} else if(Input::GetInstance()->PushKey(DIK_LEFT)){
-				if(velocity_.x > 0.0f){ velocity_.x *= (1.0f - kAttenuation); }
-				acceleration.x -= kAcceleration / 60.0f;
-				if(lrDirection_ != LRDirection::kLeft){
-					lrDirection_ = LRDirection::kLeft;
-					turnFirstRotationY_ = worldTransform_.rotation_.y;
-					turnTimer_ = kTimeTurn;
+				if(state_.velocity.x > 0.0f){ state_.velocity.x *= (1.0f - kAttenuation); }
+				acceleration.x -= kAcceleration * FixedTimestep::kDeltaTime;
+				if(state_.lrDirection != LRDirection::kLeft){
+					state_.lrDirection = LRDirection::kLeft;
+					state_.turnFirstRotationY = worldTransform_.rotation_.y;
+					state_.turnTimer = kTimeTurn;
 				}
 			}
-			velocity_ += acceleration;
-			velocity_.x = std::clamp(velocity_.x,-kLimitRunSpeed,kLimitRunSpeed);
+			state_.velocity += acceleration;
+			state_.velocity.x = std::clamp(state_.velocity.x,-kLimitRunSpeed,kLimitRunSpeed);
 		} else{
-			velocity_.x *= (1.0f - kAttenuation);
+			state_.velocity.x *= (1.0f - kAttenuation);
 		}
 
-		if(std::abs(velocity_.x) <= 0.0001f){
-			velocity_.x = 0.0f;
+		if(std::abs(state_.velocity.x) <= 0.0001f){
+			state_.velocity.x = 0.0f;
 		}
 
 		if(Input::GetInstance()->PushKey(DIK_UP)){
-			velocity_ += Vector3(0,kJumpAcceleration / 60.0f,0);
+			state_.velocity += Vector3(0,kJumpAcceleration * FixedTimestep::kDeltaTime,0);
 
 			JumpSystem* jumpSys = ParticleManager::GetInstance()->GetJumpSystem();
 			if(jumpSys){
@@ -344,35 +368,35 @@ void Player::InputMove(){
 			}
 		}
 	} else{
-		isHovering_ = true;
+		state_.isHovering = true;
 
-		if(Input::GetInstance()->TriggerKey(DIK_UP)){
-			velocity_.y += kHoverImpulse;
-			velocity_.y = std::min(velocity_.y,kLimitHoverImpulseSpeed);
+		if(TriggerKeyOnTick(DIK_UP,state_.preTickPushUp)){
+			state_.velocity.y += kHoverImpulse;
+			state_.velocity.y = std::min(state_.velocity.y,kLimitHoverImpulseSpeed);
 		} else{
-			isHovering_ = false;
-			velocity_ += Vector3(0,-kGravityAcceleration / 60.0f,0);
-			velocity_.y = std::max(velocity_.y,-kLimitFallSpeed);
+			state_.isHovering = false;
+			state_.velocity += Vector3(0,-kGravityAcceleration * FixedTimestep::kDeltaTime,0);
+			state_.velocity.y = std::max(state_.velocity.y,-kLimitFallSpeed);
 		}
 
 		if(Input::GetInstance()->PushKey(DIK_RIGHT)){
-			velocity_.x += kAirControlAcceleration / 60.0f;
-			if(lrDirection_ != LRDirection::kRight){
-				lrDirection_ = LRDirection::kRight;
-				turnFirstRotationY_ = worldTransform_.rotation_.y;
-				turnTimer_ = kTimeTurn;
+			state_.velocity.x += kAirControlAcceleration * FixedTimestep::kDeltaTime;
+			if(state_.lrDirection != LRDirection::kRight){
+				state_.lrDirection = LRDirection::kRight;
+				state_.turnFirstRotationY = worldTransform_.rotation_.y;
+				state_.turnTimer = kTimeTurn;
 			}
 		} else if(Input::GetInstance()->PushKey(DIK_LEFT)){
-			velocity_.x -= kAirControlAcceleration / 60.0f;
-			if(lrDirection_ != LRDirection::kLeft){
-				lrDirection_ = LRDirection::kLeft;
-				turnFirstRotationY_ = worldTransform_.rotation_.y;
-				turnTimer_ = kTimeTurn;
+			state_.velocity.x -= kAirControlAcceleration * FixedTimestep::kDeltaTime;
+			if(state_.lrDirection != LRDirection::kLeft){
+				state_.lrDirection = LRDirection::kLeft;
+				state_.turnFirstRotationY = worldTransform_.rotation_.y;
+				state_.turnTimer = kTimeTurn;
 			}
 		}
 
-		velocity_.x = std::clamp(velocity_.x,-kLimitAirSpeed,kLimitAirSpeed);
-		velocity_.x *= (1.0f - kAirAttenuation);
+		state_.velocity.x = std::clamp(state_.velocity.x,-kLimitAirSpeed,kLimitAirSpeed);
+		state_.velocity.x *= (1.0f - kAirAttenuation);
 	}
 }
 
@@ -387,16 +411,16 @@ void Player::OnCollision(const Enemy* enemy){
 	}
 	(void)enemy;
 
-	canICrear = true;
-	counter++;
-	if(canICrear){
-		if(counter <= 3000){
-			canICrear1 = true;
+	state_.canICrear = true;
+	state_.counter++;
+	if(state_.canICrear){
+		if(state_.counter <= 3000){
+			state_.canICrear1 = true;
 		}
 	}
 
-	 isDead_ = true;
-	isCollisionDisabled_ = true;
+	 state_.isDead = true;
+	state_.isCollisionDisabled = true;
 }
 
 // --- 以下、マップチップ判定処理（変更なし） ---
@@ -562,9 +586,9 @@ AABB Player::GetAABB(){
 
 // 壁張り付き・接地状態の更新
 void Player::UpdateOnGround(const CollisionMapInfo& info){
-	if(onGround_){
-		if(velocity_.y > 0.0f){
-			onGround_ = false;
+	if(state_.onGround){
+		if(state_.velocity.y > 0.0f){
+			state_.onGround = false;
 		} else{
 			std::array<Vector3,kNumCorner> positionsNew;
 			for(uint32_t i = 0; i < positionsNew.size(); ++i){
@@ -582,19 +606,19 @@ void Player::UpdateOnGround(const CollisionMapInfo& info){
 				hit = true;
 			}
 
-			if(!hit){ onGround_ = false; }
+			if(!hit){ state_.onGround = false; }
 		}
 	} else{
 		if(info.landing){
-			onGround_ = true;
-			velocity_.x *= (1.0f - kAttenuationLanding);
-			velocity_.y = 0.0f;
+			state_.onGround = true;
+			state_.velocity.x *= (1.0f - kAttenuationLanding);
+			state_.velocity.y = 0.0f;
 		}
 	}
 }
 
 void Player::UpdateOnWall(const CollisionMapInfo& info){
 	if(info.hitWall){
-		velocity_.x *= (1.0f - kAttenuationWall);
+		state_.velocity.x *= (1.0f - kAttenuationWall);
 	}
 }
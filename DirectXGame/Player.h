@@ -1,6 +1,8 @@
 #pragma once
 #include "KamataEngine.h"
+#include "FixedTimestep.h"
 #include "Math.h"
+#include "MeshModel.h"
 
 using namespace KamataEngine;
 
@@ -48,16 +50,20 @@ public:
 	// パブリック関数 (外部から呼ぶもの)
 	// =========================================================
 
+	~Player();
+
 	// 初期化・更新・描画
-	void Initialize(Model* model,Model* modelAttack,Camera* camera,const Vector3& position);
+	void Initialize(MeshModel* model,MeshModel* modelAttack,Camera* camera,const Vector3& position);
+	// リトライ時に Initialize 直後の状態へ戻す (モデル・定数バッファは作り直さない)
+	void Reset();
 	void Update();
 	void Draw();
 
 	// --- ゲッター・セッター ---
 	const WorldTransform& GetWorldTransform() const{ return worldTransform_; }
-	const Vector3& GetVelocity() const{ return velocity_; }
+	const Vector3& GetVelocity() const{ return state_.velocity; }
 	Vector3 GetWorldPosition() const;
-	AbilityType GetAbilityType() const{ return abilityType_; } // 現在の能力取得
+	AbilityType GetAbilityType() const{ return state_.abilityType; } // 現在の能力取得
 	AABB GetAABB();
 
 	void SetMapChipField(MapChipField* mapChipField){ mapChipField_ = mapChipField; }
@@ -65,34 +71,34 @@ public:
 	void GetMapChipField(MapChipField** mapChipField){ *mapChipField = mapChipField_; }
 
 	// --- 状態判定・フラグ処理 ---
-	bool IsDead() const{ return isDead_; }
-	bool IsAttack() const{ return behavior_ == Behavior::kAttack && attackPhase_ == AttackPhase::kAction; }
-	bool IsCollisionDisabled() const{ return isCollisionDisabled_; }
+	bool IsDead() const{ return state_.isDead; }
+	bool IsAttack() const{ return state_.behavior == Behavior::kAttack && state_.attackPhase == AttackPhase::kAction; }
+	bool IsCollisionDisabled() const{ return state_.isCollisionDisabled; }
 
 	// テスト用フラグ
-	bool CanICrear() const{ return canICrear; }
-	bool CanICrear1() const{ return canICrear1; }
+	bool CanICrear() const{ return state_.canICrear; }
+	bool CanICrear1() const{ return state_.canICrear1; }
 
 	// 衝突コールバック
 	void OnCollision(const Enemy* enemy);
 
 	// 射撃リクエスト確認（呼び出すとフラグが折れる）
 	bool IsShotBeam(){
-		if(isShotBeamRequest_){
-			isShotBeamRequest_ = false;
+		if(state_.isShotBeamRequest){
+			state_.isShotBeamRequest = false;
 			return true;
 		}
 		return false;
 	}
 
 	// 吸い込み中かどうか
-	bool IsInhaling() const{ return isInhaling_; }
+	bool IsInhaling() const{ return state_.isInhaling; }
 
 	// 弾を持っているか（満腹か）
-	bool HasAmmo() const{ return hasAmmo_; }
+	bool HasAmmo() const{ return state_.hasAmmo; }
 
 	// 弾を飲み込んだときに呼ぶ関数
-	void CatchAmmo(){ hasAmmo_ = true; }
+	void CatchAmmo(){ state_.hasAmmo = true; }
 
 	// 吸い込み判定エリア（口元の判定）を取得
 	AABB GetInhaleArea();
@@ -135,6 +141,12 @@ private:
 	// ユーティリティ
 	Vector3 CornerPosition(const Vector3& center,Corner corner);
 
+	// ティック単位のトリガー判定
+	// (固定タイムステップでは描画フレームとティックが一致せず、Input::TriggerKeyだと取りこぼすため)
+	bool TriggerKeyOnTick(BYTE keyNumber,bool preTickPush) const{
+		return Input::GetInstance()->PushKey(keyNumber) && !preTickPush;
+	}
+
 
 	// =========================================================
 	// メンバ変数
@@ -142,43 +154,65 @@ private:
 
 	// --- システム・モデル ---
 	WorldTransform worldTransform_;
-	Model* model_ = nullptr;
-	Model* modelAttack_ = nullptr;
+	MeshModel* model_ = nullptr;
+	MeshModel* modelAttack_ = nullptr;
 	WorldTransform worldTransformAttack_;
+	TransformChangeTracker attackTransformTracker_; // 攻撃エフェクトは動いた時だけ転送する
 	KamataEngine::ObjectColor objectColor_; // 色変更用
 	Camera* camera_ = nullptr;
-	uint32_t textureHandle_ = 0u;
 
 	// --- ステージ情報 ---
 	MapChipField* mapChipField_ = nullptr;
 
-	// --- 物理・移動パラメータ ---
-	Vector3 velocity_ = {};
-	LRDirection lrDirection_ = LRDirection::kRight;
-	float turnFirstRotationY_ = 0.0f;
-	float turnTimer_ = 0.0f;
-	bool onGround_ = true;
-	bool isHovering_ = false;
-
-	// --- 状態管理 ---
-	bool isDead_ = false;
-	bool isCollisionDisabled_ = false;
-	bool canICrear = false;
-	bool canICrear1 = false;
-	int counter = 0;
-
-	// --- ステートマシン ---
-	Behavior behavior_ = Behavior::kRoot;
-	Behavior behaviorRequest_ = Behavior::kUnknown;
-
-	// 攻撃パラメータ
-	AttackPhase attackPhase_ = AttackPhase::kUnknown;
-	uint32_t attackParameter_ = 0;
-
-	// 能力・射撃パラメータ
-	AbilityType abilityType_ = AbilityType::Sword;
-	bool isShotBeamRequest_ = false;
-	uint32_t shotTimer_ = 0;
+	// --- ゲームプレイの状態 ---
+	// 値だけを持つ (定数バッファ・モデル・ポインタは持たない)
+	// Initialize の最後に initialSnapshot_ に取り、リトライではそれを丸ごと書き戻す
+	struct State{
+		// 物理・移動パラメータ
+		Vector3 velocity = {};
+		LRDirection lrDirection = LRDirection::kRight;
+		float turnFirstRotationY = 0.0f;
+		float turnTimer = 0.0f;
+		bool onGround = true;
+		bool isHovering = false;
+
+		// 状態管理
+		bool isDead = false;
+		bool isCollisionDisabled = false;
+		bool canICrear = false;
+		bool canICrear1 = false;
+		int counter = 0;
+
+		// ステートマシン
+		Behavior behavior = Behavior::kRoot;
+		Behavior behaviorRequest = Behavior::kUnknown;
+
+		// 攻撃パラメータ
+		AttackPhase attackPhase = AttackPhase::kUnknown;
+		uint32_t attackParameter = 0;
+
+		// 能力・射撃パラメータ
+		AbilityType abilityType = AbilityType::Sword;
+		bool isShotBeamRequest = false;
+		uint32_t shotTimer = 0;
+
+		bool isInhaling = false; // 吸い込みキーを押しているか
+		bool hasAmmo = false;    // 敵の弾を保持しているか
+
+		// 前ティックのキー状態
+		bool preTickPushSpace = false;
+		bool preTickPushUp = false;
+	};
+	State state_;
+
+	// リトライで戻す値 (状態と、本体の姿勢)
+	struct Snapshot{
+		State state;
+		Vector3 scale;
+		Vector3 rotation;
+		Vector3 translation;
+	};
+	Snapshot initialSnapshot_ = {};
 
 	// =========================================================
 	// 定数 (調整用パラメータ)
@@ -207,7 +241,7 @@ private:
 	const float kLimitAirSpeed = kLimitRunSpeed * 0.7f;
 	const float kAirAttenuation = 0.02f;
 	const float kHoverImpulse = 25.0f;
-	const float kLimitHoverImpulseSpeed = kJumpAcceleration / 60.0f;
+	const float kLimitHoverImpulseSpeed = kJumpAcceleration * FixedTimestep::kDeltaTime;
 
 	// アクションフレーム数
 	static inline const uint32_t kAnticipationTime = 8;
@@ -215,7 +249,4 @@ private:
 	static inline const uint32_t kRecoveryTime = 12;
 	static inline const uint32_t kShotTime = 20; // 射撃硬直
 
-	bool isInhaling_ = false; // 吸い込みキーを押しているか
-	bool hasAmmo_ = false;    // 敵の弾を保持しているか
-
 };
\ No newline at end of file
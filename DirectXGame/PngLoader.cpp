@@ -0,0 +1,630 @@
+#include "PngLoader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace{
+
+// ------------------------------------------
+// inflate (RFC 1951)
+// ------------------------------------------
+
+// 下位ビットから読む
+class BitReader{
+public:
+	BitReader(const uint8_t* data,size_t size) : current_(data),end_(data + size){}
+
+	uint32_t Peek(int count){
+		Refill();
+		return static_cast<uint32_t>(bits_ & ((uint64_t(1) << count) - 1));
+	}
+	void Skip(int count){
+		bits_ >>= count;
+		numBits_ -= count;
+	}
+	uint32_t Read(int count){
+		uint32_t value = Peek(count);
+		Skip(count);
+		return value;
+	}
+	// バイト境界まで捨てる
+	void AlignToByte(){ Skip(numBits_ & 7); }
+
+	// 溜めたビットを戻してから、バイト単位で読む (無圧縮ブロック用)
+	const uint8_t* TakeBytes(size_t count){
+		int unread = numBits_ / 8 - padding_;
+		current_ -= std::max(unread,0);
+		bits_ = 0;
+		numBits_ = 0;
+		padding_ = 0;
+		if(unread < 0 || static_cast<size_t>(end_ - current_) < count){
+			isOverrun_ = true;
+			return nullptr;
+		}
+		const uint8_t* bytes = current_;
+		current_ += count;
+		return bytes;
+	}
+
+	// 終わりの先の (埋めた) ビットまで使ったら true
+	bool IsOverrun() const{ return isOverrun_ || numBits_ < padding_ * 8; }
+
+private:
+	void Refill(){
+		while(numBits_ <= 56){
+			if(current_ < end_){
+				bits_ |= static_cast<uint64_t>(*current_++) << numBits_;
+			}
+			else{
+				// 終わりの先は 0 として読む
+				++padding_;
+			}
+			numBits_ += 8;
+		}
+	}
+
+	const uint8_t* current_;
+	const uint8_t* end_;
+	uint64_t bits_ = 0;
+	int numBits_ = 0;
+	int padding_ = 0; // 終わりの先で埋めたバイト数
+	bool isOverrun_ = false;
+};
+
+// 正準ハフマン符号
+// 短い符号は表を1回引くだけ、長い符号は1ビットずつたどる
+class Huffman{
+public:
+	static const int kMaxBits = 15;
+	static const int kFastBits = 10;
+
+	bool Build(const uint8_t* lengths,int numSymbols){
+		std::fill(std::begin(counts_),std::end(counts_),uint16_t(0));
+		for(int i = 0; i < numSymbols; ++i){
+			++counts_[lengths[i]];
+		}
+		counts_[0] = 0;
+
+		// 符号が多すぎないか (足りないのは許す。距離の符号が1つだけの場合がある)
+		int left = 1;
+		for(int length = 1; length <= kMaxBits; ++length){
+			left = (left << 1) - counts_[length];
+			if(left < 0){
+				return false;
+			}
+		}
+
+		uint16_t offsets[kMaxBits + 2] = {};
+		for(int length = 1; length <= kMaxBits; ++length){
+			offsets[length + 1] = offsets[length] + counts_[length];
+		}
+		for(int i = 0; i < numSymbols; ++i){
+			if(lengths[i] != 0){
+				symbols_[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+			}
+		}
+
+		// 表 (ビットの並びを逆にした符号で引く)
+		std::fill(std::begin(fast_),std::end(fast_),uint16_t(0));
+		uint32_t code = 0;
+		int index = 0;
+		for(int length = 1; length <= kMaxBits; ++length){
+			for(int k = 0; k < counts_[length]; ++k, ++code, ++index){
+				if(length > kFastBits){
+					continue;
+				}
+				uint32_t reversed = 0;
+				for(int bit = 0; bit < length; ++bit){
+					reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+				}
+				for(uint32_t entry = reversed; entry < (1u << kFastBits); entry += 1u << length){
+					fast_[entry] = static_cast<uint16_t>((length << 9) | symbols_[index]);
+				}
+			}
+			code <<= 1;
+		}
+		return true;
+	}
+
+	// 符号が壊れていれば -1
+	int Decode(BitReader& reader) const{
+		uint16_t entry = fast_[reader.Peek(kFastBits)];
+		if(entry != 0){
+			reader.Skip(entry >> 9);
+			return entry & 0x1FF;
+		}
+		int code = 0;
+		int first = 0;
+		int index = 0;
+		for(int length = 1; length <= kMaxBits; ++length){
+			code |= static_cast<int>(reader.Read(1));
+			int count = counts_[length];
+			if(code - first < count){
+				return symbols_[index + code - first];
+			}
+			index += count;
+			first = (first + count) << 1;
+			code <<= 1;
+		}
+		return -1;
+	}
+
+private:
+	uint16_t counts_[kMaxBits + 1];
+	uint16_t symbols_[288];
+	uint16_t fast_[1 << kFastBits];
+};
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// 圧縮ブロック1つ分を output に足す
+bool InflateBlock(BitReader& reader,const Huffman& literals,const Huffman& distances,std::vector<uint8_t>& output,size_t& size){
+	for(;;){
+		int symbol = literals.Decode(reader);
+		if(symbol < 0 || reader.IsOverrun()){
+			return false;
+		}
+		if(symbol < 256){
+			if(size >= output.size()){
+				return false;
+			}
+			output[size++] = static_cast<uint8_t>(symbol);
+			continue;
+		}
+		if(symbol == 256){
+			return true;
+		}
+		symbol -= 257;
+		if(symbol >= 29){
+			return false;
+		}
+		size_t length = kLengthBase[symbol] + reader.Read(kLengthExtra[symbol]);
+		int distanceSymbol = distances.Decode(reader);
+		if(distanceSymbol < 0 || distanceSymbol >= 30){
+			return false;
+		}
+		size_t distance = kDistanceBase[distanceSymbol] + reader.Read(kDistanceExtra[distanceSymbol]);
+		if(distance > size || length > output.size() - size){
+			return false;
+		}
+		uint8_t* destination = output.data() + size;
+		const uint8_t* source = destination - distance;
+		if(distance >= length){
+			std::memcpy(destination,source,length);
+		}
+		else{
+			// 重なる時は1バイトずつ (繰り返しになる)
+			for(size_t i = 0; i < length; ++i){
+				destination[i] = source[i];
+			}
+		}
+		size += length;
+	}
+}
+
+// zlib 形式を展開する (大きさは PNG のヘッダからわかっているので、ちょうどの大きさを渡す)
+bool Inflate(std::span<const uint8_t> data,std::vector<uint8_t>& output){
+	if(data.size() < 2 || (data[0] & 0x0F) != 8 || (data[0] << 8 | data[1]) % 31 != 0 || (data[1] & 0x20) != 0){
+		return false;
+	}
+	BitReader reader(data.data() + 2,data.size() - 2);
+	size_t size = 0;
+
+	Huffman fixedLiterals;
+	Huffman fixedDistances;
+	bool hasFixed = false;
+	Huffman literals;
+	Huffman distances;
+
+	bool isFinal = false;
+	while(!isFinal){
+		isFinal = reader.Read(1) != 0;
+		uint32_t type = reader.Read(2);
+		if(type == 0){
+			// 無圧縮
+			reader.AlignToByte();
+			const uint8_t* header = reader.TakeBytes(4);
+			if(!header){
+				return false;
+			}
+			uint32_t length = header[0] | header[1] << 8;
+			uint32_t inverse = header[2] | header[3] << 8;
+			if((length ^ 0xFFFF) != inverse || length > output.size() - size){
+				return false;
+			}
+			const uint8_t* bytes = reader.TakeBytes(length);
+			if(!bytes){
+				return false;
+			}
+			std::memcpy(output.data() + size,bytes,length);
+			size += length;
+		}
+		else if(type == 1){
+			// 固定ハフマン
+			if(!hasFixed){
+				uint8_t lengths[288];
+				std::fill(lengths,lengths + 144,uint8_t(8));
+				std::fill(lengths + 144,lengths + 256,uint8_t(9));
+				std::fill(lengths + 256,lengths + 280,uint8_t(7));
+				std::fill(lengths + 280,lengths + 288,uint8_t(8));
+				fixedLiterals.Build(lengths,288);
+				std::fill(lengths,lengths + 30,uint8_t(5));
+				fixedDistances.Build(lengths,30);
+				hasFixed = true;
+			}
+			if(!InflateBlock(reader,fixedLiterals,fixedDistances,output,size)){
+				return false;
+			}
+		}
+		else if(type == 2){
+			// 動的ハフマン (符号の長さ自体も符号化されている)
+			uint32_t numLiterals = reader.Read(5) + 257;
+			uint32_t numDistances = reader.Read(5) + 1;
+			uint32_t numCodeLengths = reader.Read(4) + 4;
+			static const uint8_t kOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+			uint8_t codeLengths[19] = {};
+			for(uint32_t i = 0; i < numCodeLengths; ++i){
+				codeLengths[kOrder[i]] = static_cast<uint8_t>(reader.Read(3));
+			}
+			Huffman lengthCode;
+			if(numLiterals > 286 || numDistances > 30 || !lengthCode.Build(codeLengths,19)){
+				return false;
+			}
+			uint8_t lengths[286 + 30] = {};
+			uint32_t count = 0;
+			while(count < numLiterals + numDistances){
+				int symbol = lengthCode.Decode(reader);
+				if(symbol < 0 || reader.IsOverrun()){
+					return false;
+				}
+				if(symbol < 16){
+					lengths[count++] = static_cast<uint8_t>(symbol);
+					continue;
+				}
+				uint8_t value = 0;
+				uint32_t repeat = 0;
+				if(symbol == 16){
+					if(count == 0){
+						return false;
+					}
+					value = lengths[count - 1];
+					repeat = 3 + reader.Read(2);
+				}
+				else if(symbol == 17){
+					repeat = 3 + reader.Read(3);
+				}
+				else{
+					repeat = 11 + reader.Read(7);
+				}
+				if(count + repeat > numLiterals + numDistances){
+					return false;
+				}
+				std::fill(lengths + count,lengths + count + repeat,value);
+				count += repeat;
+			}
+			if(lengths[256] == 0 || !literals.Build(lengths,numLiterals) || !distances.Build(lengths + numLiterals,numDistances)){
+				return false;
+			}
+			if(!InflateBlock(reader,literals,distances,output,size)){
+				return false;
+			}
+		}
+		else{
+			return false;
+		}
+		if(reader.IsOverrun()){
+			return false;
+		}
+	}
+	return size == output.size();
+}
+
+// ------------------------------------------
+// PNG
+// ------------------------------------------
+
+uint32_t ReadBigEndian(const uint8_t* bytes){
+	return static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16 | static_cast<uint32_t>(bytes[2]) << 8 | bytes[3];
+}
+
+struct Header{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t bitDepth = 0;
+	uint32_t colorType = 0;
+	uint32_t channels = 0;
+	bool isInterlaced = false;
+
+	uint8_t palette[256][4] = {};
+	uint32_t paletteSize = 0;
+	bool hasColorKey = false;
+	uint16_t colorKey[3] = {};
+
+	// 1画素の大きさ (ビット)
+	uint32_t GetBitsPerPixel() const{ return channels * bitDepth; }
+	// 1行の大きさ (フィルタの種類の1バイトを除く)
+	size_t GetRowBytes(uint32_t rowWidth) const{ return (static_cast<size_t>(rowWidth) * GetBitsPerPixel() + 7) / 8; }
+};
+
+// 7段のインターレース (開始位置と間隔)
+struct Pass{
+	uint32_t x;
+	uint32_t y;
+	uint32_t stepX;
+	uint32_t stepY;
+};
+const Pass kAdam7[7] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+const Pass kSinglePass = {0, 0, 1, 1};
+
+uint32_t GetPassSize(uint32_t size,uint32_t start,uint32_t step){
+	return size > start ? (size - start + step - 1) / step : 0;
+}
+
+uint8_t Paeth(int a,int b,int c){
+	int p = a + b - c;
+	int pa = std::abs(p - a);
+	int pb = std::abs(p - b);
+	int pc = std::abs(p - c);
+	if(pa <= pb && pa <= pc){
+		return static_cast<uint8_t>(a);
+	}
+	return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// フィルタを戻す (row はその場で書き換える。previous は前の行で、最初の行は 0 の並び)
+bool Unfilter(uint8_t type,uint8_t* row,const uint8_t* previous,size_t rowBytes,size_t pixelBytes){
+	switch(type){
+	case 0:
+		break;
+	case 1:
+		for(size_t i = pixelBytes; i < rowBytes; ++i){
+			row[i] = static_cast<uint8_t>(row[i] + row[i - pixelBytes]);
+		}
+		break;
+	case 2:
+		for(size_t i = 0; i < rowBytes; ++i){
+			row[i] = static_cast<uint8_t>(row[i] + previous[i]);
+		}
+		break;
+	case 3:
+		for(size_t i = 0; i < rowBytes; ++i){
+			int left = i >= pixelBytes ? row[i - pixelBytes] : 0;
+			row[i] = static_cast<uint8_t>(row[i] + ((left + previous[i]) >> 1));
+		}
+		break;
+	case 4:
+		for(size_t i = 0; i < rowBytes; ++i){
+			int left = i >= pixelBytes ? row[i - pixelBytes] : 0;
+			int upperLeft = i >= pixelBytes ? previous[i - pixelBytes] : 0;
+			row[i] = static_cast<uint8_t>(row[i] + Paeth(left,previous[i],upperLeft));
+		}
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+// 行の中の index 番目の値 (ビット深度のまま)
+uint32_t GetSample(const uint8_t* row,size_t index,uint32_t bitDepth){
+	switch(bitDepth){
+	case 8:
+		return row[index];
+	case 16:
+		return static_cast<uint32_t>(row[index * 2]) << 8 | row[index * 2 + 1];
+	default:{
+		size_t bit = index * bitDepth;
+		uint32_t shift = 8 - bitDepth - static_cast<uint32_t>(bit & 7);
+		return (row[bit / 8] >> shift) & ((1u << bitDepth) - 1);
+	}
+	}
+}
+
+// 値を8ビットに広げる
+uint8_t ToByte(uint32_t sample,uint32_t bitDepth){
+	if(bitDepth == 16){
+		return static_cast<uint8_t>((sample * 255 + 32767) / 65535);
+	}
+	return static_cast<uint8_t>(sample * 255 / ((1u << bitDepth) - 1));
+}
+
+// 1行を RGBA にして画像へ置く
+void StoreRow(const Header& header,const uint8_t* row,uint32_t rowWidth,const Pass& pass,uint32_t passY,ImageData& image){
+	uint32_t y = pass.y + passY * pass.stepY;
+	for(uint32_t passX = 0; passX < rowWidth; ++passX){
+		uint8_t* pixel = image.GetPixel(pass.x + passX * pass.stepX,y);
+		size_t first = static_cast<size_t>(passX) * header.channels;
+		switch(header.colorType){
+		case 0:{ // グレー
+			uint32_t gray = GetSample(row,first,header.bitDepth);
+			pixel[0] = pixel[1] = pixel[2] = ToByte(gray,header.bitDepth);
+			pixel[3] = header.hasColorKey && gray == header.colorKey[0] ? 0 : 255;
+			break;
+		}
+		case 2:{ // RGB
+			uint32_t rgb[3];
+			for(uint32_t c = 0; c < 3; ++c){
+				rgb[c] = GetSample(row,first + c,header.bitDepth);
+				pixel[c] = ToByte(rgb[c],header.bitDepth);
+			}
+			bool isKey = header.hasColorKey && rgb[0] == header.colorKey[0] && rgb[1] == header.colorKey[1] && rgb[2] == header.colorKey[2];
+			pixel[3] = isKey ? 0 : 255;
+			break;
+		}
+		case 3:{ // パレット (範囲外は黒)
+			uint32_t index = GetSample(row,first,header.bitDepth);
+			if(index < header.paletteSize){
+				std::memcpy(pixel,header.palette[index],4);
+			}
+			else{
+				pixel[0] = pixel[1] = pixel[2] = 0;
+				pixel[3] = 255;
+			}
+			break;
+		}
+		case 4: // グレー + α
+			pixel[0] = pixel[1] = pixel[2] = ToByte(GetSample(row,first,header.bitDepth),header.bitDepth);
+			pixel[3] = ToByte(GetSample(row,first + 1,header.bitDepth),header.bitDepth);
+			break;
+		default: // RGBA
+			for(uint32_t c = 0; c < 4; ++c){
+				pixel[c] = ToByte(GetSample(row,first + c,header.bitDepth),header.bitDepth);
+			}
+			break;
+		}
+	}
+}
+
+bool IsValidDepth(uint32_t colorType,uint32_t bitDepth){
+	switch(colorType){
+	case 0:
+		return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+	case 3:
+		return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8;
+	case 2:
+	case 4:
+	case 6:
+		return bitDepth == 8 || bitDepth == 16;
+	default:
+		return false;
+	}
+}
+
+} // namespace
+
+bool PngLoader::Load(const std::string& path,ImageData& image){
+	MappedFile file;
+	if(!file.Open(path)){
+		return false;
+	}
+	return Decode(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(file.GetData()),file.GetSize()),image);
+}
+
+bool PngLoader::Decode(std::span<const uint8_t> data,ImageData& image){
+	image = ImageData();
+	static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	if(data.size() < 8 || std::memcmp(data.data(),kSignature,8) != 0){
+		return false;
+	}
+
+	// チャンクを集める (IDAT はつなげる)
+	Header header;
+	std::vector<uint8_t> compressed;
+	bool hasHeader = false;
+	size_t position = 8;
+	for(;;){
+		if(data.size() - position < 12){
+			return false;
+		}
+		uint32_t length = ReadBigEndian(&data[position]);
+		const uint8_t* type = &data[position + 4];
+		const uint8_t* body = &data[position + 8];
+		if(length > data.size() - position - 12){
+			return false;
+		}
+		position += 12 + static_cast<size_t>(length);
+
+		if(std::memcmp(type,"IHDR",4) == 0){
+			if(length < 13){
+				return false;
+			}
+			header.width = ReadBigEndian(body);
+			header.height = ReadBigEndian(body + 4);
+			header.bitDepth = body[8];
+			header.colorType = body[9];
+			header.isInterlaced = body[12] == 1;
+			if(header.width == 0 || header.height == 0 || body[10] != 0 || body[11] != 0 || body[12] > 1 || !IsValidDepth(header.colorType,header.bitDepth)){
+				return false;
+			}
+			static const uint32_t kChannels[7] = {1, 0, 3, 1, 2, 0, 4};
+			header.channels = kChannels[header.colorType];
+			hasHeader = true;
+		}
+		else if(std::memcmp(type,"PLTE",4) == 0){
+			header.paletteSize = std::min<uint32_t>(length / 3,256);
+			for(uint32_t i = 0; i < header.paletteSize; ++i){
+				header.palette[i][0] = body[i * 3];
+				header.palette[i][1] = body[i * 3 + 1];
+				header.palette[i][2] = body[i * 3 + 2];
+				header.palette[i][3] = 255;
+			}
+		}
+		else if(std::memcmp(type,"tRNS",4) == 0){
+			if(header.colorType == 3){
+				for(uint32_t i = 0; i < std::min<uint32_t>(length,256); ++i){
+					header.palette[i][3] = body[i];
+				}
+			}
+			else if(header.colorType == 0 && length >= 2){
+				header.colorKey[0] = static_cast<uint16_t>(body[0] << 8 | body[1]);
+				header.hasColorKey = true;
+			}
+			else if(header.colorType == 2 && length >= 6){
+				for(uint32_t c = 0; c < 3; ++c){
+					header.colorKey[c] = static_cast<uint16_t>(body[c * 2] << 8 | body[c * 2 + 1]);
+				}
+				header.hasColorKey = true;
+			}
+		}
+		else if(std::memcmp(type,"IDAT",4) == 0){
+			compressed.insert(compressed.end(),body,body + length);
+		}
+		else if(std::memcmp(type,"IEND",4) == 0){
+			break;
+		}
+		else if((type[0] & 0x20) == 0){
+			// 知らない必須チャンク
+			return false;
+		}
+	}
+	if(!hasHeader || (header.colorType == 3 && header.paletteSize == 0)){
+		return false;
+	}
+
+	// 展開後の大きさ (各行の先頭にフィルタの種類が1バイトある)
+	const Pass* passes = header.isInterlaced ? kAdam7 : &kSinglePass;
+	size_t numPasses = header.isInterlaced ? 7 : 1;
+	size_t rawSize = 0;
+	for(size_t p = 0; p < numPasses; ++p){
+		uint32_t passWidth = GetPassSize(header.width,passes[p].x,passes[p].stepX);
+		uint32_t passHeight = GetPassSize(header.height,passes[p].y,passes[p].stepY);
+		if(passWidth != 0){
+			rawSize += (header.GetRowBytes(passWidth) + 1) * passHeight;
+		}
+	}
+	std::vector<uint8_t> raw(rawSize);
+	if(!Inflate(compressed,raw)){
+		return false;
+	}
+
+	image.width = header.width;
+	image.height = header.height;
+	image.pixels.resize(static_cast<size_t>(header.width) * header.height * 4);
+	size_t pixelBytes = std::max<size_t>(1,header.GetBitsPerPixel() / 8);
+	uint8_t* current = raw.data();
+	for(size_t p = 0; p < numPasses; ++p){
+		uint32_t passWidth = GetPassSize(header.width,passes[p].x,passes[p].stepX);
+		uint32_t passHeight = GetPassSize(header.height,passes[p].y,passes[p].stepY);
+		if(passWidth == 0 || passHeight == 0){
+			continue;
+		}
+		size_t rowBytes = header.GetRowBytes(passWidth);
+		std::vector<uint8_t> zeros(rowBytes,0);
+		const uint8_t* previous = zeros.data();
+		for(uint32_t y = 0; y < passHeight; ++y){
+			uint8_t* row = current + 1;
+			if(!Unfilter(current[0],row,previous,rowBytes,pixelBytes)){
+				image = ImageData();
+				return false;
+			}
+			StoreRow(header,row,passWidth,passes[p],y,image);
+			previous = row;
+			current += rowBytes + 1;
+		}
+	}
+	return true;
+}
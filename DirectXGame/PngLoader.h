@@ -0,0 +1,19 @@
+#pragma once
+#include "ImageData.h"
+#include <cstdint>
+#include <span>
+#include <string>
+
+// ==========================================
+// PNG の読み込み (CPU 側だけ、外部ライブラリなし)
+// 全ての色の種類・ビット深度・インターレースを RGBA 各8ビットにする
+// (16ビットは丸めて8ビットに、tRNS は透明度にする。CRC と Adler-32 は確かめない)
+// テクスチャのクック (AssetCooker と、AssetCache の非同期読み込みのワーカー) で使う
+// ==========================================
+class PngLoader{
+public:
+	static bool Load(const std::string& path,ImageData& image);
+
+	// メモリ上の PNG を読む
+	static bool Decode(std::span<const uint8_t> data,ImageData& image);
+};
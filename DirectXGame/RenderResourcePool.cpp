@@ -0,0 +1,14 @@
+#include "RenderResourcePool.h"
+#include "Math.h"
+
+void RenderResourceTraits::Initialize(WorldTransform& worldTransform){
+	worldTransform.Initialize();
+}
+
+void RenderResourceTraits::Initialize(ObjectColor& objectColor){
+	objectColor.Initialize();
+}
+
+void RenderResourceTraits::Transfer(WorldTransform& worldTransform){
+	WorldTransformUpdate(worldTransform);
+}
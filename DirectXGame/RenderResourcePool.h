@@ -0,0 +1,27 @@
+#pragma once
+#include "KamataEngine.h"
+#include "RenderResourcePoolBase.h"
+
+using namespace KamataEngine;
+
+// RenderResourcePool で貸し出すエンジンの定数バッファと、その転送
+struct RenderResourceTraits{
+	using Transform = WorldTransform;
+	using Color = ObjectColor;
+
+	static void Initialize(WorldTransform& worldTransform);
+	static void Initialize(ObjectColor& objectColor);
+	// 行列を作って定数バッファへ送る (WorldTransformUpdate と同じ)
+	static void Transfer(WorldTransform& worldTransform);
+};
+
+// ==========================================
+// 描画用リソースの使い回しプール
+// Model::Draw は描画ごとに別の定数バッファが必要なので、
+// エンティティ側では持たず、描画のたびにここから順番に借りる
+// (足りなくなった時だけ作り、以降のフレームでは作り直さない)
+// 借りる順番はフレームごとにほぼ同じなので、トランスフォームは同じ番の前回の値と比べ、
+// 変わっていなければ (止まっている敵など) 行列の計算も転送もしない
+// (処理は RenderResourcePoolBase。AssetCooker uploads は同じものを記録用の Traits で動かす)
+// ==========================================
+class RenderResourcePool : public RenderResourcePoolBase<RenderResourceTraits>{};
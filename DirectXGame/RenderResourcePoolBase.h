@@ -0,0 +1,83 @@
+#pragma once
+#include "TransformChangeTracker.h"
+#include <memory>
+#include <vector>
+
+// ==========================================
+// 描画用リソースの使い回しプールの本体 (RenderResourcePool の中身)
+// 借りた順番に定数バッファを使い回し、同じ番の前回の値と変わっていなければ行列の計算も転送もしない
+// 定数バッファの型と転送は Traits に任せるので D3D を使わず、AssetCooker でも同じ処理を動かせる
+// Traits に要るもの:
+//   using Transform / using Color   … 貸し出す型 (Transform は scale_ rotation_ translation_ を持つ)
+//   static void Initialize(Transform&) / static void Initialize(Color&) … 初めて作った時に1度だけ呼ぶ
+//   static void Transfer(Transform&) … 行列を作って定数バッファへ送る (値が変わった時だけ呼ばれる)
+// ==========================================
+template<class Traits>
+class RenderResourcePoolBase{
+public:
+	using Transform = typename Traits::Transform;
+	using Color = typename Traits::Color;
+
+	// フレームの描画前に呼ぶ (貸し出し位置を先頭に戻す)
+	void Reset(){
+		transformCursor_ = 0;
+		colorCursor_ = 0;
+	}
+
+	// 値を入れ、前回この番で送った値と違う時だけ行列を作って転送したものを返す
+	const Transform& AcquireTransform(const Vector3& scale,const Vector3& rotation,const Vector3& translation){
+		if(transformCursor_ == transforms_.size()){
+			TransformSlot slot;
+			slot.transform = std::make_unique<Transform>();
+			Traits::Initialize(*slot.transform);
+			transforms_.push_back(std::move(slot));
+		}
+		TransformSlot& slot = transforms_[transformCursor_++];
+		Transform& transform = *slot.transform;
+		transform.scale_ = scale;
+		transform.rotation_ = rotation;
+		transform.translation_ = translation;
+		if(slot.tracker.Update(scale,rotation,translation)){
+			Traits::Transfer(transform);
+		}
+		return transform;
+	}
+
+	Color& AcquireColor(){
+		if(colorCursor_ == colors_.size()){
+			auto color = std::make_unique<Color>();
+			Traits::Initialize(*color);
+			colors_.push_back(std::move(color));
+		}
+		return *colors_[colorCursor_++];
+	}
+
+	// トランスフォームを transformCount 個まで先に作っておく (描画中に初めて足りなくなって作らないように)
+	// (それより多く借りた時は、今まで通り足りない分だけ作る)
+	void Reserve(size_t transformCount){
+		transforms_.reserve(transformCount);
+		while(transforms_.size() < transformCount){
+			TransformSlot slot;
+			slot.transform = std::make_unique<Transform>();
+			Traits::Initialize(*slot.transform);
+			transforms_.push_back(std::move(slot));
+		}
+	}
+
+	// これまでに作った定数バッファの数
+	size_t GetTransformCount() const{ return transforms_.size(); }
+	size_t GetColorCount() const{ return colors_.size(); }
+
+private:
+	// (定数バッファは作った後に動かせないので、1つずつ確保して持つ)
+	struct TransformSlot{
+		std::unique_ptr<Transform> transform;
+		TransformChangeTracker tracker;
+	};
+
+	std::vector<TransformSlot> transforms_;
+	size_t transformCursor_ = 0;
+
+	std::vector<std::unique_ptr<Color>> colors_;
+	size_t colorCursor_ = 0;
+};
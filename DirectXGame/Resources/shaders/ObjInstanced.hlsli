@@ -0,0 +1,13 @@
+// タイル層のインスタンス描画 (Obj と同じ定数バッファに、タイルの大きさを足したもの)
+
+cbuffer TileLayer : register(b5) {
+	float2 tileSize; // 1マスの幅・高さ
+};
+
+struct VSInstancedOutput {
+	float4 svpos : SV_POSITION; // システム用頂点座標
+	float4 worldpos : POSITION; // ワールド座標
+	float3 normal : NORMAL;     // 法線
+	float2 uv : TEXCOORD;       // uv値
+	float4 color : COLOR;       // インスタンスの色
+};
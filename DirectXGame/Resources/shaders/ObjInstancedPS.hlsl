@@ -0,0 +1,11 @@
+#include "ObjShading.hlsli"
+#include "ObjInstanced.hlsli"
+
+float4 main(VSInstancedOutput input) : SV_TARGET {
+	VSOutput shading;
+	shading.svpos = input.svpos;
+	shading.worldpos = input.worldpos;
+	shading.normal = input.normal;
+	shading.uv = input.uv;
+	return ShadeObj(shading) * color * input.color;
+}
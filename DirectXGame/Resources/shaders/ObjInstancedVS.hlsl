@@ -0,0 +1,20 @@
+#include "Obj.hlsli"
+#include "ObjInstanced.hlsli"
+
+// tile はマス目の番号 (R16G16_SINT)、instanceColor は RGBA8 (R8G8B8A8_UNORM)
+VSInstancedOutput main(float4 pos : POSITION, float3 normal : NORMAL, float2 uv : TEXCOORD, int2 tile : TILE, float4 instanceColor : COLOR) {
+	// 回転・拡大は層のワールド行列で全タイル共通。タイルはワールド座標で平行移動だけする
+	float4 worldNormal = normalize(mul(float4(normal, 0), world));
+	float4 worldPos = mul(pos, world);
+	worldPos.xy += float2(tile) * tileSize;
+
+	VSInstancedOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = mul(worldPos, mul(view, projection));
+
+	output.worldpos = worldPos;
+	output.normal = worldNormal.xyz;
+	output.uv = uv;
+	output.color = instanceColor;
+
+	return output;
+}
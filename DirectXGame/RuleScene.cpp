@@ -3,6 +3,7 @@
 RuleScene::~RuleScene(){
 	// スプライトとフェードの削除
 	delete sprite_;
+	delete loadingBar_;
 	delete fade_;
 	if(Audio::GetInstance()->IsPlaying(bgmHandle_)){
 		Audio::GetInstance()->StopWave(bgmHandle_);
@@ -11,11 +12,15 @@ RuleScene::~RuleScene(){
 
 void RuleScene::Initialize(){
 	// 画像の読み込み
-	textureHandle_ = TextureManager::Load("ruleScene.png");
+	textureHandle_ = AssetCache::GetInstance()->LoadTexture("ruleScene.png");
 
 	// スプライト生成 (画面サイズに合わせて生成)
 	// ※WinApp::kWindowWidth 等が使えない場合は直接数値を指定してください (例: 1280, 720)
-	sprite_ = Sprite::Create(textureHandle_,{0.0f,0.0f});
+	sprite_ = Sprite::Create(textureHandle_.Get(),{0.0f,0.0f});
+
+	// 読み込みバー (白1x1を伸ばして使う)
+	loadingBar_ = Sprite::Create(0,{0.0f,WinApp::kWindowHeight - kLoadingBarHeight});
+	loadingBar_->SetSize({0.0f,kLoadingBarHeight});
 
 	// フェード初期化
 	fade_ = new Fade();
@@ -24,11 +29,13 @@ void RuleScene::Initialize(){
 	// フェードイン開始
 	fade_->Start(Fade::Status::FadeIn,1.0f);
 
-	bgmDataHandle_ = Audio::GetInstance()->LoadWave("BGM/ruleScene.wav");
-	seDataHandle_ = Audio::GetInstance()->LoadWave("SE/enter.wav");
+	bgmDataHandle_ = AssetCache::GetInstance()->LoadSound("BGM/ruleScene.wav");
+	seDataHandle_ = AssetCache::GetInstance()->LoadSound("SE/enter.wav");
 }
 
 void RuleScene::Update(){
+	// 読み込みの進み具合をバーの長さにする
+	loadingBar_->SetSize({WinApp::kWindowWidth * AssetCache::GetInstance()->GetLoadProgress(),kLoadingBarHeight});
 
 	switch(phase_){
 	case Phase::kFadeIn:
@@ -69,6 +76,10 @@ void RuleScene::Draw(){
 	if(sprite_){
 		sprite_->Draw();
 	}
+	// 読み込み中だけバーを出す
+	if(AssetCache::GetInstance()->IsLoading()){
+		loadingBar_->Draw();
+	}
 
 	// スプライト描画後処理
 	Sprite::PostDraw();
@@ -79,14 +90,14 @@ void RuleScene::Draw(){
 
 void RuleScene::PlayBgm(){
 	if(!isPlayBgm_){
-		bgmHandle_ = Audio::GetInstance()->PlayWave(bgmDataHandle_,true,0.2f);
+		bgmHandle_ = Audio::GetInstance()->PlayWave(bgmDataHandle_.Get(),true,0.2f);
 		isPlayBgm_ = true;
 	}
 }
 
 void RuleScene::PlaySe(){
 	if(!isPlaySe_){
-		seHandle_ = Audio::GetInstance()->PlayWave(seDataHandle_,false,0.3f);
+		seHandle_ = Audio::GetInstance()->PlayWave(seDataHandle_.Get(),false,0.3f);
 		isPlaySe_ = true;
 	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "AssetCache.h"
 #include "Fade.h"
 #include "KamataEngine.h"
 
@@ -28,9 +29,12 @@ public:
 
 private:
 	// 画像ハンドル
-	uint32_t textureHandle_ = 0;
+	TextureHandle textureHandle_;
 	// スプライト
 	Sprite* sprite_ = nullptr;
+	// 次のシーンの読み込み状況 (画面下のバー)
+	Sprite* loadingBar_ = nullptr;
+	static inline const float kLoadingBarHeight = 8.0f;
 
 	bool finished_ = false;
 
@@ -38,11 +42,11 @@ private:
 
 	Phase phase_ = Phase::kFadeIn;
 
-	uint32_t bgmDataHandle_;
+	SoundHandle bgmDataHandle_;
 	uint32_t bgmHandle_;
 	bool isPlayBgm_ = false;
 
-	uint32_t seDataHandle_;
+	SoundHandle seDataHandle_;
 	uint32_t seHandle_;
 	bool isPlaySe_ = false;
 };
\ No newline at end of file
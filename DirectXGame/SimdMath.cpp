@@ -0,0 +1,223 @@
+#include "SimdMath.h"
+#include "MathKernels.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define SIMD_MATH_SSE2
+#endif
+
+namespace{
+
+#ifdef SIMD_MATH_SSE2
+// 行ベクトルなので、結果の行は rhs の 4 行を lhs の行の成分で重み付けして足したもの (operator*= と同じ順に足す)
+inline __m128 MultiplyRow(const float* row,__m128 rhs0,__m128 rhs1,__m128 rhs2,__m128 rhs3){
+	__m128 result = _mm_mul_ps(_mm_set1_ps(row[0]),rhs0);
+	result = _mm_add_ps(result,_mm_mul_ps(_mm_set1_ps(row[1]),rhs1));
+	result = _mm_add_ps(result,_mm_mul_ps(_mm_set1_ps(row[2]),rhs2));
+	return _mm_add_ps(result,_mm_mul_ps(_mm_set1_ps(row[3]),rhs3));
+}
+
+inline void MultiplyMatrixSimd(const Matrix4x4& lhs,const Matrix4x4& rhs,Matrix4x4& out){
+	__m128 rhs0 = _mm_loadu_ps(rhs.m[0]);
+	__m128 rhs1 = _mm_loadu_ps(rhs.m[1]);
+	__m128 rhs2 = _mm_loadu_ps(rhs.m[2]);
+	__m128 rhs3 = _mm_loadu_ps(rhs.m[3]);
+	// lhs と out が同じでも壊れないように、4 行とも計算してから書く
+	__m128 row0 = MultiplyRow(lhs.m[0],rhs0,rhs1,rhs2,rhs3);
+	__m128 row1 = MultiplyRow(lhs.m[1],rhs0,rhs1,rhs2,rhs3);
+	__m128 row2 = MultiplyRow(lhs.m[2],rhs0,rhs1,rhs2,rhs3);
+	__m128 row3 = MultiplyRow(lhs.m[3],rhs0,rhs1,rhs2,rhs3);
+	_mm_storeu_ps(out.m[0],row0);
+	_mm_storeu_ps(out.m[1],row1);
+	_mm_storeu_ps(out.m[2],row2);
+	_mm_storeu_ps(out.m[3],row3);
+}
+
+// 4 個分の成分から 4 個の行列を作る (式は ComposeAffineMatrix と同じ)
+void ComposeAffineLanes(const float* scaleX,const float* scaleY,const float* scaleZ,const float* rotationX,const float* rotationY,const float* rotationZ,const float* translationX,
+                        const float* translationY,const float* translationZ,Matrix4x4* out){
+	// 三角関数も 4 個ずつ (ComposeAffineMatrix の SinCos と同じ結果になる)
+	alignas(16) float sinX[4], cosX[4], sinY[4], cosY[4], sinZ[4], cosZ[4];
+	SinCosBatch(rotationX,4,sinX,cosX);
+	SinCosBatch(rotationY,4,sinY,cosY);
+	SinCosBatch(rotationZ,4,sinZ,cosZ);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	__m128 sx = _mm_load_ps(sinX), cx = _mm_load_ps(cosX);
+	__m128 sy = _mm_load_ps(sinY), cy = _mm_load_ps(cosY);
+	__m128 sz = _mm_load_ps(sinZ), cz = _mm_load_ps(cosZ);
+	__m128 negSx = _mm_xor_ps(sx,signBit);
+	__m128 negSy = _mm_xor_ps(sy,signBit);
+	__m128 negSz = _mm_xor_ps(sz,signBit);
+	__m128 scaleXs = _mm_loadu_ps(scaleX);
+	__m128 scaleYs = _mm_loadu_ps(scaleY);
+	__m128 scaleZs = _mm_loadu_ps(scaleZ);
+
+	__m128 zxSin = _mm_mul_ps(sz,sx);
+	__m128 zxCos = _mm_mul_ps(cz,sx);
+	__m128 m00 = _mm_mul_ps(scaleXs,_mm_add_ps(_mm_mul_ps(cz,cy),_mm_mul_ps(zxSin,sy)));
+	__m128 m01 = _mm_mul_ps(scaleXs,_mm_mul_ps(sz,cx));
+	__m128 m02 = _mm_mul_ps(scaleXs,_mm_add_ps(_mm_mul_ps(cz,negSy),_mm_mul_ps(zxSin,cy)));
+	__m128 m10 = _mm_mul_ps(scaleYs,_mm_add_ps(_mm_mul_ps(negSz,cy),_mm_mul_ps(zxCos,sy)));
+	__m128 m11 = _mm_mul_ps(scaleYs,_mm_mul_ps(cz,cx));
+	__m128 m12 = _mm_mul_ps(scaleYs,_mm_add_ps(_mm_mul_ps(negSz,negSy),_mm_mul_ps(zxCos,cy)));
+	__m128 m20 = _mm_mul_ps(scaleZs,_mm_mul_ps(cx,sy));
+	__m128 m21 = _mm_mul_ps(scaleZs,negSx);
+	__m128 m22 = _mm_mul_ps(scaleZs,_mm_mul_ps(cx,cy));
+	__m128 m30 = _mm_loadu_ps(translationX);
+	__m128 m31 = _mm_loadu_ps(translationY);
+	__m128 m32 = _mm_loadu_ps(translationZ);
+	__m128 m03 = _mm_setzero_ps(), m13 = _mm_setzero_ps(), m23 = _mm_setzero_ps(), m33 = _mm_set1_ps(1.0f);
+
+	// 成分ごと -> 行列ごと に並べ替える (行ごとに 4x4 の転置)
+	_MM_TRANSPOSE4_PS(m00,m01,m02,m03);
+	_MM_TRANSPOSE4_PS(m10,m11,m12,m13);
+	_MM_TRANSPOSE4_PS(m20,m21,m22,m23);
+	_MM_TRANSPOSE4_PS(m30,m31,m32,m33);
+	const __m128 rows[4][4] = {
+	    {m00, m10, m20, m30},
+	    {m01, m11, m21, m31},
+	    {m02, m12, m22, m32},
+	    {m03, m13, m23, m33},
+	};
+	for(size_t lane = 0; lane < 4; ++lane){
+		for(size_t row = 0; row < 4; ++row){
+			_mm_storeu_ps(out[lane].m[row],rows[lane][row]);
+		}
+	}
+}
+#endif
+
+} // namespace
+
+Matrix4x4 ComposeAffineMatrix(const Vector3& scale,const Vector3& rotation,const Vector3& translation){
+	float sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos(rotation.x,sinX,cosX);
+	SinCos(rotation.y,sinY,cosY);
+	SinCos(rotation.z,sinZ,cosZ);
+
+	// Rz * Rx * Ry を展開したもの (MakeRotate…Matrix を掛けた時と同じ順に足す。0 を掛ける項は省く)
+	float zxSin = sinZ * sinX;
+	float zxCos = cosZ * sinX;
+	Matrix4x4 result;
+	result.m[0][0] = scale.x * (cosZ * cosY + zxSin * sinY);
+	result.m[0][1] = scale.x * (sinZ * cosX);
+	result.m[0][2] = scale.x * (cosZ * -sinY + zxSin * cosY);
+	result.m[0][3] = 0.0f;
+	result.m[1][0] = scale.y * (-sinZ * cosY + zxCos * sinY);
+	result.m[1][1] = scale.y * (cosZ * cosX);
+	result.m[1][2] = scale.y * (-sinZ * -sinY + zxCos * cosY);
+	result.m[1][3] = 0.0f;
+	result.m[2][0] = scale.z * (cosX * sinY);
+	result.m[2][1] = scale.z * -sinX;
+	result.m[2][2] = scale.z * (cosX * cosY);
+	result.m[2][3] = 0.0f;
+	result.m[3][0] = translation.x;
+	result.m[3][1] = translation.y;
+	result.m[3][2] = translation.z;
+	result.m[3][3] = 1.0f;
+	return result;
+}
+
+void ComposeAffineMatrices(const AffineComponents& components,size_t begin,size_t count,Matrix4x4* out){
+	size_t i = 0;
+#ifdef SIMD_MATH_SSE2
+	for(; i + 4 <= count; i += 4){
+		size_t index = begin + i;
+		ComposeAffineLanes(components.scaleX + index,components.scaleY + index,components.scaleZ + index,components.rotationX + index,components.rotationY + index,
+		                   components.rotationZ + index,components.translationX + index,components.translationY + index,components.translationZ + index,out + i);
+	}
+#endif
+	for(; i < count; ++i){
+		size_t index = begin + i;
+		out[i] = ComposeAffineMatrix({components.scaleX[index], components.scaleY[index], components.scaleZ[index]},
+		                             {components.rotationX[index], components.rotationY[index], components.rotationZ[index]},
+		                             {components.translationX[index], components.translationY[index], components.translationZ[index]});
+	}
+}
+
+void ComposeAffineMatrices(const Vector3* scales,const Vector3* rotations,const Vector3* translations,size_t count,Matrix4x4* out){
+	size_t i = 0;
+#ifdef SIMD_MATH_SSE2
+	// 4 個分を成分ごとに並べ替えてから作る
+	for(; i + 4 <= count; i += 4){
+		alignas(16) float lanes[9][4];
+		for(size_t lane = 0; lane < 4; ++lane){
+			const Vector3& scale = scales[i + lane];
+			const Vector3& rotation = rotations[i + lane];
+			const Vector3& translation = translations[i + lane];
+			lanes[0][lane] = scale.x;
+			lanes[1][lane] = scale.y;
+			lanes[2][lane] = scale.z;
+			lanes[3][lane] = rotation.x;
+			lanes[4][lane] = rotation.y;
+			lanes[5][lane] = rotation.z;
+			lanes[6][lane] = translation.x;
+			lanes[7][lane] = translation.y;
+			lanes[8][lane] = translation.z;
+		}
+		ComposeAffineLanes(lanes[0],lanes[1],lanes[2],lanes[3],lanes[4],lanes[5],lanes[6],lanes[7],lanes[8],out + i);
+	}
+#endif
+	for(; i < count; ++i){
+		out[i] = ComposeAffineMatrix(scales[i],rotations[i],translations[i]);
+	}
+}
+
+Matrix4x4 MultiplyMatrix(const Matrix4x4& lhs,const Matrix4x4& rhs){
+	Matrix4x4 result;
+#ifdef SIMD_MATH_SSE2
+	MultiplyMatrixSimd(lhs,rhs,result);
+#else
+	for(size_t i = 0; i < 4; ++i){
+		for(size_t j = 0; j < 4; ++j){
+			result.m[i][j] = lhs.m[i][0] * rhs.m[0][j] + lhs.m[i][1] * rhs.m[1][j] + lhs.m[i][2] * rhs.m[2][j] + lhs.m[i][3] * rhs.m[3][j];
+		}
+	}
+#endif
+	return result;
+}
+
+void MultiplyMatrices(const Matrix4x4* lhs,const Matrix4x4* rhs,size_t count,Matrix4x4* out){
+	for(size_t i = 0; i < count; ++i){
+#ifdef SIMD_MATH_SSE2
+		MultiplyMatrixSimd(lhs[i],rhs[i],out[i]);
+#else
+		out[i] = MultiplyMatrix(lhs[i],rhs[i]);
+#endif
+	}
+}
+
+void TransformAffinePoints(const Vector3* points,size_t count,const Matrix4x4& matrix,Vector3* out){
+	size_t i = 0;
+#ifdef SIMD_MATH_SSE2
+	const __m128 m00 = _mm_set1_ps(matrix.m[0][0]), m01 = _mm_set1_ps(matrix.m[0][1]), m02 = _mm_set1_ps(matrix.m[0][2]);
+	const __m128 m10 = _mm_set1_ps(matrix.m[1][0]), m11 = _mm_set1_ps(matrix.m[1][1]), m12 = _mm_set1_ps(matrix.m[1][2]);
+	const __m128 m20 = _mm_set1_ps(matrix.m[2][0]), m21 = _mm_set1_ps(matrix.m[2][1]), m22 = _mm_set1_ps(matrix.m[2][2]);
+	const __m128 m30 = _mm_set1_ps(matrix.m[3][0]), m31 = _mm_set1_ps(matrix.m[3][1]), m32 = _mm_set1_ps(matrix.m[3][2]);
+	for(; i + 4 <= count; i += 4){
+		// xyz xyz xyz xyz の 12 個を x 4 個・y 4 個・z 4 個 に並べ替える
+		const float* source = &points[i].x;
+		__m128 a = _mm_loadu_ps(source);     // x0 y0 z0 x1
+		__m128 b = _mm_loadu_ps(source + 4); // y1 z1 x2 y2
+		__m128 c = _mm_loadu_ps(source + 8); // z2 x3 y3 z3
+		__m128 x = _mm_shuffle_ps(a,_mm_shuffle_ps(b,c,_MM_SHUFFLE(1,0,0,2)),_MM_SHUFFLE(3,0,3,0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(0,0,1,1)),_mm_shuffle_ps(b,c,_MM_SHUFFLE(2,2,3,3)),_MM_SHUFFLE(2,0,2,0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(1,1,2,2)),_mm_shuffle_ps(c,c,_MM_SHUFFLE(3,3,0,0)),_MM_SHUFFLE(2,0,2,0));
+
+		// TransformAffine と同じ順に足す
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x,m00),_mm_mul_ps(y,m10)),_mm_mul_ps(z,m20)),m30);
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x,m01),_mm_mul_ps(y,m11)),_mm_mul_ps(z,m21)),m31);
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x,m02),_mm_mul_ps(y,m12)),_mm_mul_ps(z,m22)),m32);
+
+		// 元の並びに戻す
+		float* destination = &out[i].x;
+		_mm_storeu_ps(destination,_mm_shuffle_ps(_mm_shuffle_ps(rx,ry,_MM_SHUFFLE(0,0,0,0)),_mm_shuffle_ps(rz,rx,_MM_SHUFFLE(1,1,0,0)),_MM_SHUFFLE(2,0,2,0)));
+		_mm_storeu_ps(destination + 4,_mm_shuffle_ps(_mm_shuffle_ps(ry,rz,_MM_SHUFFLE(1,1,1,1)),_mm_shuffle_ps(rx,ry,_MM_SHUFFLE(2,2,2,2)),_MM_SHUFFLE(2,0,2,0)));
+		_mm_storeu_ps(destination + 8,_mm_shuffle_ps(_mm_shuffle_ps(rz,rx,_MM_SHUFFLE(3,3,2,2)),_mm_shuffle_ps(ry,rz,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(2,0,2,0)));
+	}
+#endif
+	for(; i < count; ++i){
+		out[i] = TransformAffine(points[i],matrix);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+
+using namespace KamataEngine;
+
+// ==========================================
+// 行列・点の計算の SIMD 版 (SSE2)
+// ・行列は行ベクトルの掛け方 (v * M)、アフィン行列は MakeAffineMatrix と同じ S * Rz * Rx * Ry * T
+// ・math.cpp のこれまでの書き方と足す順まで同じにしてあり、結果はビット単位で一致する (AssetCooker matrix で確かめる)
+//   FMA は丸めが変わるので使わない (プロジェクトも /arch の指定なしで SSE2 まで)
+// ・まとめて計算する版 (…s) は 4 個ずつ処理し、残りは 1 個ずつ
+// ・sin / cos は MathKernels の SinCos を使う (精度は SetMathPrecision に従う)
+// ・D3D を使わないので AssetCooker でも動く
+// ==========================================
+
+// スケール・回転・平行移動からアフィン行列を作る (5 つの行列を掛けずに、展開した式で直接作る)
+Matrix4x4 ComposeAffineMatrix(const Vector3& scale,const Vector3& rotation,const Vector3& translation);
+
+// 成分ごとの配列で渡す時の入力 (TransformHierarchy など)
+struct AffineComponents{
+	const float* scaleX;
+	const float* scaleY;
+	const float* scaleZ;
+	const float* rotationX;
+	const float* rotationY;
+	const float* rotationZ;
+	const float* translationX;
+	const float* translationY;
+	const float* translationZ;
+};
+// components の [begin, begin + count) から行列を作って out[0 .. count) に書く
+void ComposeAffineMatrices(const AffineComponents& components,size_t begin,size_t count,Matrix4x4* out);
+void ComposeAffineMatrices(const Vector3* scales,const Vector3* rotations,const Vector3* translations,size_t count,Matrix4x4* out);
+
+// lhs * rhs (1 行につき 4 回の掛け算と 3 回の足し算を 4 列まとめて行う)
+Matrix4x4 MultiplyMatrix(const Matrix4x4& lhs,const Matrix4x4& rhs);
+// out[i] = lhs[i] * rhs[i]
+void MultiplyMatrices(const Matrix4x4* lhs,const Matrix4x4* rhs,size_t count,Matrix4x4* out);
+
+// アフィン行列で点を動かす (w で割らない。Transform と違い、射影行列には使えない)
+inline Vector3 TransformAffine(const Vector3& point,const Matrix4x4& matrix){
+	return {
+	    point.x * matrix.m[0][0] + point.y * matrix.m[1][0] + point.z * matrix.m[2][0] + matrix.m[3][0],
+	    point.x * matrix.m[0][1] + point.y * matrix.m[1][1] + point.z * matrix.m[2][1] + matrix.m[3][1],
+	    point.x * matrix.m[0][2] + point.y * matrix.m[1][2] + point.z * matrix.m[2][2] + matrix.m[3][2],
+	};
+}
+// out[i] = TransformAffine(points[i], matrix) (points と out は同じ配列でもよい)
+void TransformAffinePoints(const Vector3* points,size_t count,const Matrix4x4& matrix,Vector3* out);
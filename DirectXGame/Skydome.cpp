@@ -1,7 +1,8 @@
 #include "Skydome.h"
+#include "Math.h"
 #include <assert.h>
 
-void Skydome::Initialize(Camera* camera, Model* model) {
+void Skydome::Initialize(Camera* camera, MeshModel* model) {
 
 	assert(model);
 
@@ -10,6 +11,6 @@ void Skydome::Initialize(Camera* camera, Model* model) {
 	model_ = model;
 }
 
-void Skydome::Update() { worldTransform_.TransferMatrix(); }
+void Skydome::Update() { WorldTransformUpdate(worldTransform_, transformTracker_); }
 
 void Skydome::Draw() { model_->Draw(worldTransform_, *camera_); }
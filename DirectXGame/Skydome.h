@@ -1,16 +1,20 @@
 #pragma once
 #include "KamataEngine.h"
+#include "MeshModel.h"
+#include "TransformChangeTracker.h"
 using namespace KamataEngine;
 
 class Skydome {
 public:
-	void Initialize(Camera* camera,Model* model);
+	void Initialize(Camera* camera,MeshModel* model);
 	void Update();
 	void Draw();
 
 private:
 	WorldTransform worldTransform_;
+	// 空は動かないので、転送は最初の1回だけ
+	TransformChangeTracker transformTracker_;
 
 	Camera* camera_;
-	Model* model_ = nullptr;
+	MeshModel* model_ = nullptr;
 };
@@ -0,0 +1,308 @@
+#include "TextureAtlas.h"
+#include "ContentDeduplicator.h"
+#include "CookedTexture.h"
+#include "PngLoader.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#ifdef _MSC_VER
+#pragma warning(push,0)
+#endif
+#include <imstb_rectpack.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace{
+
+// UV が 0 ～ 1 に収まっているとみなす誤差
+const float kUvEpsilon = 1e-3f;
+
+uint32_t AlignUp(uint32_t value,uint32_t alignment){
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// 詰める前の1枚
+struct Item{
+	std::string fileName;
+	ImageData image;
+	uint32_t cellWidth = 0; // 余白込みの大きさ
+	uint32_t cellHeight = 0;
+	bool isSolid = false; // 1x1 (余白を付けず、区画全体をその色で塗る)
+	std::vector<std::string> aliases; // 中身が同じで、同じ場所を使う別の名前
+};
+
+// 1グループ (同じ形式) を必要なだけのページに詰める
+bool PackGroup(std::vector<Item>& items,TextureCompressor::Format format,const char* prefix,TextureAtlas::Result& result,
+               std::vector<std::string>& order,uint32_t numThreads){
+	const uint32_t kPadding = TextureAtlas::kPadding;
+	const uint32_t kMaxPageSize = TextureAtlas::kMaxPageSize;
+
+	std::vector<stbrp_rect> remaining(items.size());
+	for(size_t i = 0; i < items.size(); ++i){
+		remaining[i] = {};
+		remaining[i].id = static_cast<int>(i);
+		remaining[i].w = static_cast<stbrp_coord>(items[i].cellWidth);
+		remaining[i].h = static_cast<stbrp_coord>(items[i].cellHeight);
+	}
+	std::vector<stbrp_node> nodes(kMaxPageSize);
+
+	uint32_t pageNumber = 0;
+	while(!remaining.empty()){
+		// 最大の大きさに詰め、入らなかった分は次のページへ
+		stbrp_context context;
+		stbrp_init_target(&context,static_cast<int>(kMaxPageSize),static_cast<int>(kMaxPageSize),nodes.data(),static_cast<int>(nodes.size()));
+		stbrp_pack_rects(&context,remaining.data(),static_cast<int>(remaining.size()));
+		std::vector<stbrp_rect> packed;
+		std::vector<stbrp_rect> rest;
+		for(const stbrp_rect& rect : remaining){
+			(rect.was_packed ? packed : rest).push_back(rect);
+		}
+		if(packed.empty()){
+			return false;
+		}
+
+		// 使った範囲に切り詰める (区画は kPadding の倍数なので、ページも4の倍数になる)
+		TextureAtlas::Page page;
+		for(const stbrp_rect& rect : packed){
+			page.width = std::max(page.width,static_cast<uint32_t>(rect.x + rect.w));
+			page.height = std::max(page.height,static_cast<uint32_t>(rect.y + rect.h));
+		}
+		page.fileName = std::string("atlas/") + prefix + std::to_string(pageNumber) + ".cooked.dds";
+		page.format = format;
+
+		ImageData pageImage;
+		pageImage.width = page.width;
+		pageImage.height = page.height;
+		pageImage.pixels.assign(static_cast<size_t>(page.width) * page.height * 4,0);
+		uint32_t pageIndex = static_cast<uint32_t>(result.pages.size());
+		for(const stbrp_rect& rect : packed){
+			const Item& item = items[rect.id];
+			uint32_t cellX = static_cast<uint32_t>(rect.x);
+			uint32_t cellY = static_cast<uint32_t>(rect.y);
+			uint32_t padding = item.isSolid ? 0 : kPadding;
+			// 区画全体に、範囲外は端の画素を繰り返して写す
+			for(uint32_t y = 0; y < item.cellHeight; ++y){
+				uint32_t sourceY = std::min(static_cast<uint32_t>(std::max(static_cast<int>(y) - static_cast<int>(padding),0)),item.image.height - 1);
+				for(uint32_t x = 0; x < item.cellWidth; ++x){
+					uint32_t sourceX = std::min(static_cast<uint32_t>(std::max(static_cast<int>(x) - static_cast<int>(padding),0)),item.image.width - 1);
+					const uint8_t* source = item.image.GetPixel(sourceX,sourceY);
+					std::copy(source,source + 4,pageImage.GetPixel(cellX + x,cellY + y));
+				}
+			}
+
+			TextureAtlas::Region region;
+			region.page = pageIndex;
+			if(item.isSolid){
+				// どの UV でも区画の中心を読む
+				region.x = cellX;
+				region.y = cellY;
+				region.width = item.cellWidth;
+				region.height = item.cellHeight;
+				region.uvScale[0] = 0.0f;
+				region.uvScale[1] = 0.0f;
+				region.uvOffset[0] = (static_cast<float>(cellX) + static_cast<float>(item.cellWidth) * 0.5f) / static_cast<float>(page.width);
+				region.uvOffset[1] = (static_cast<float>(cellY) + static_cast<float>(item.cellHeight) * 0.5f) / static_cast<float>(page.height);
+			}
+			else{
+				region.x = cellX + kPadding;
+				region.y = cellY + kPadding;
+				region.width = item.image.width;
+				region.height = item.image.height;
+				region.uvScale[0] = static_cast<float>(region.width) / static_cast<float>(page.width);
+				region.uvScale[1] = static_cast<float>(region.height) / static_cast<float>(page.height);
+				region.uvOffset[0] = static_cast<float>(region.x) / static_cast<float>(page.width);
+				region.uvOffset[1] = static_cast<float>(region.y) / static_cast<float>(page.height);
+			}
+			page.usedPixels += static_cast<uint64_t>(item.image.width) * item.image.height;
+			result.regions[item.fileName] = region;
+			order.push_back(item.fileName);
+			for(const std::string& alias : item.aliases){
+				result.regions[alias] = region;
+				order.push_back(alias);
+			}
+		}
+
+		if(!CookedTexture::Write(pageImage,format,"Resources/" + page.fileName,numThreads,TextureAtlas::kMipLevels)){
+			return false;
+		}
+		result.pages.push_back(page);
+		remaining = std::move(rest);
+		++pageNumber;
+	}
+	return true;
+}
+
+} // namespace
+
+std::string TextureAtlas::GetManifestPath(){
+	return "Resources/atlas/atlas.txt";
+}
+
+void TextureAtlas::AddSources(const MeshData& meshData,std::vector<Source>& sources){
+	for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+		if(subMesh.materialIndex < 0){
+			continue;
+		}
+		const MeshData::MaterialData& material = meshData.materials[subMesh.materialIndex];
+		if(material.textureFilename.empty()){
+			continue;
+		}
+
+		bool isRepeated = false;
+		for(uint32_t i = 0; i < subMesh.vertexCount && !isRepeated; ++i){
+			const Vector2& uv = meshData.vertices[subMesh.vertexOffset + i].uv;
+			isRepeated = uv.x < -kUvEpsilon || uv.x > 1.0f + kUvEpsilon || uv.y < -kUvEpsilon || uv.y > 1.0f + kUvEpsilon;
+		}
+
+		std::string fileName = meshData.name + "/" + material.textureFilename;
+		auto it = std::find_if(sources.begin(),sources.end(),[&](const Source& source){ return source.fileName == fileName; });
+		if(it == sources.end()){
+			sources.push_back({fileName, isRepeated});
+		}
+		else{
+			it->isRepeated = it->isRepeated || isRepeated;
+		}
+	}
+}
+
+bool TextureAtlas::Build(const std::vector<Source>& sources,Result& result,uint32_t numThreads){
+	result = Result();
+
+	// 読み込んで、入れられるものを不透明と α ありに分ける
+	std::vector<Item> opaqueItems;
+	std::vector<Item> alphaItems;
+	std::unordered_map<std::string,std::pair<std::vector<Item>*,size_t>> itemsByContents; // 中身で揃えた名前 → 詰める画像
+	for(const Source& source : sources){
+		if(!source.fileName.ends_with(".png")){
+			result.skipped.push_back({source.fileName, "not PNG"});
+			continue;
+		}
+		Item item;
+		item.fileName = source.fileName;
+		if(!PngLoader::Load("Resources/" + source.fileName,item.image)){
+			result.skipped.push_back({source.fileName, "load failed"});
+			continue;
+		}
+		item.isSolid = item.image.width == 1 && item.image.height == 1;
+		if(!item.isSolid && source.isRepeated){
+			result.skipped.push_back({source.fileName, "UV repeats"});
+			continue;
+		}
+		if(item.image.width > kMaxTextureSize || item.image.height > kMaxTextureSize){
+			result.skipped.push_back({source.fileName, "too large"});
+			continue;
+		}
+
+		// 中身が同じものは1度だけ詰める
+		std::string canonicalName = ContentDeduplicator::GetInstance()->GetCanonicalTexture(source.fileName);
+		auto it = itemsByContents.find(canonicalName);
+		if(it != itemsByContents.end()){
+			(*it->second.first)[it->second.second].aliases.push_back(source.fileName);
+			continue;
+		}
+		item.cellWidth = item.isSolid ? kPadding : AlignUp(item.image.width + kPadding * 2,kPadding);
+		item.cellHeight = item.isSolid ? kPadding : AlignUp(item.image.height + kPadding * 2,kPadding);
+		std::vector<Item>& items = item.image.IsOpaque() ? opaqueItems : alphaItems;
+		itemsByContents.emplace(canonicalName,std::make_pair(&items,items.size()));
+		items.push_back(std::move(item));
+	}
+
+	// 前のページは残さない
+	std::error_code errorCode;
+	std::filesystem::remove_all("Resources/atlas",errorCode);
+	std::filesystem::create_directories("Resources/atlas",errorCode);
+	if(errorCode){
+		return false;
+	}
+
+	std::vector<std::string> order;
+	if(!PackGroup(opaqueItems,TextureCompressor::Format::kBC1,"opaque",result,order,numThreads) ||
+	   !PackGroup(alphaItems,TextureCompressor::Format::kBC7,"alpha",result,order,numThreads)){
+		return false;
+	}
+
+	// マニフェスト
+	std::ofstream file(GetManifestPath());
+	if(!file.is_open()){
+		return false;
+	}
+	file << "# page <file> <width> <height> <format> <used pixels>\n";
+	file << "# region <texture> <page> <x> <y> <width> <height> <uv scale x y> <uv offset x y>\n";
+	file << std::setprecision(9);
+	for(const Page& page : result.pages){
+		file << "page " << std::quoted(page.fileName) << " " << page.width << " " << page.height << " " << TextureCompressor::GetName(page.format) << " "
+		     << page.usedPixels << "\n";
+	}
+	for(const std::string& fileName : order){
+		const Region& region = result.regions[fileName];
+		file << "region " << std::quoted(fileName) << " " << region.page << " " << region.x << " " << region.y << " " << region.width << " " << region.height
+		     << " " << region.uvScale[0] << " " << region.uvScale[1] << " " << region.uvOffset[0] << " " << region.uvOffset[1] << "\n";
+	}
+	return file.good();
+}
+
+TextureAtlas* TextureAtlas::GetInstance(){
+	static TextureAtlas instance;
+	return &instance;
+}
+
+bool TextureAtlas::ReadManifest(const std::string& path,std::vector<Page>& pages,std::unordered_map<std::string,Region>& regions){
+	pages.clear();
+	regions.clear();
+	std::ifstream file(path);
+	if(!file.is_open()){
+		return false;
+	}
+	std::error_code errorCode;
+	auto manifestTime = std::filesystem::last_write_time(path,errorCode);
+
+	std::vector<bool> isPageValid;
+	std::string line;
+	while(std::getline(file,line)){
+		std::istringstream stream(line);
+		std::string kind;
+		stream >> kind;
+		if(kind == "page"){
+			Page page;
+			std::string formatName;
+			stream >> std::quoted(page.fileName) >> page.width >> page.height >> formatName >> page.usedPixels;
+			for(TextureCompressor::Format format : {TextureCompressor::Format::kBC1, TextureCompressor::Format::kBC3, TextureCompressor::Format::kBC7}){
+				if(formatName == TextureCompressor::GetName(format)){
+					page.format = format;
+				}
+			}
+			isPageValid.push_back(!stream.fail() && std::filesystem::exists("Resources/" + page.fileName,errorCode));
+			pages.push_back(page);
+		}
+		else if(kind == "region"){
+			std::string fileName;
+			Region region;
+			stream >> std::quoted(fileName) >> region.page >> region.x >> region.y >> region.width >> region.height >> region.uvScale[0] >> region.uvScale[1] >>
+			    region.uvOffset[0] >> region.uvOffset[1];
+			if(stream.fail() || region.page >= pages.size() || !isPageValid[region.page]){
+				continue;
+			}
+			// 詰めた後に元の画像が変わっていたら、クックし直すまでは元の画像を使う
+			auto sourceTime = std::filesystem::last_write_time("Resources/" + fileName,errorCode);
+			if(!errorCode && sourceTime > manifestTime){
+				continue;
+			}
+			regions[fileName] = region;
+		}
+	}
+	return true;
+}
+
+const TextureAtlas::Region* TextureAtlas::Find(const std::string& fileName){
+	if(!isLoaded_){
+		ReadManifest(GetManifestPath(),pages_,regions_);
+		isLoaded_ = true;
+	}
+	auto it = regions_.find(fileName);
+	return it == regions_.end() ? nullptr : &it->second;
+}
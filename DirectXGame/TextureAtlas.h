@@ -0,0 +1,96 @@
+#pragma once
+#include "MeshData.h"
+#include "TextureCompressor.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ==========================================
+// モデル用の小さいテクスチャをまとめたアトラス
+// クック時 (AssetCooker) に imstb_rectpack で詰めてページ (.cooked.dds) とマニフェストを書き、
+// 実行時は MeshModel がマテリアルのテクスチャをページに差し替え、m_uv_scale / m_uv_offset で場所を指す
+// ・UV が 0 ～ 1 をはみ出す (繰り返す) マテリアルのテクスチャは入れない
+// ・1x1 は UV に関係なく1色なので、スケール 0 で中心を指す
+// ・各画像のまわりは端の画素を伸ばして埋め、ミップ kMipLevels 段まで隣がにじまないようにする
+// ・不透明なものは BC1、α があるものは BC7 のページに分ける
+// ・中身が同じ画像は1か所だけに置き、どの名前からもそこを指す
+// ==========================================
+class TextureAtlas{
+public:
+	// これより大きい画像は入れない
+	// (アトラスのページはミップ kMipLevels 段しか持たないので、大きい画像を入れると遠くで細かいミップが足りずにちらつく。
+	//  大きいものはミップを最後まで持つ単独のテクスチャのままにする)
+	static inline const uint32_t kMaxTextureSize = 256;
+	// 1ページの最大 (詰め終えたら使った範囲に切り詰める)
+	static inline const uint32_t kMaxPageSize = 4096;
+	// 画像のまわりの余白と、置く位置の単位 (ミップ3段目の1画素)
+	static inline const uint32_t kPadding = 8;
+	static inline const uint32_t kMipLevels = 4;
+
+	// マテリアルから参照されているテクスチャ
+	struct Source{
+		std::string fileName;    // Resources/ からの相対
+		bool isRepeated = false; // どこかで UV が 0 ～ 1 をはみ出している
+	};
+
+	struct Page{
+		std::string fileName; // Resources/ からの相対 (atlas/opaque0.cooked.dds など)
+		uint32_t width = 0;
+		uint32_t height = 0;
+		TextureCompressor::Format format = TextureCompressor::Format::kBC1;
+		uint64_t usedPixels = 0; // 元の画像が占める画素数 (余白は含めない)
+	};
+
+	struct Region{
+		uint32_t page = 0;
+		uint32_t x = 0; // ページ内の画像の位置 (余白は含めない。1x1 は塗った範囲)
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		float uvScale[2] = {1.0f, 1.0f};
+		float uvOffset[2] = {0.0f, 0.0f};
+	};
+
+	// 入れなかったテクスチャと理由
+	struct Skipped{
+		std::string fileName;
+		std::string reason;
+	};
+
+	struct Result{
+		std::vector<Page> pages;
+		std::unordered_map<std::string,Region> regions;
+		std::vector<Skipped> skipped;
+	};
+
+	// Resources/atlas/atlas.txt
+	static std::string GetManifestPath();
+
+	// --- クック時 ---
+	// モデルのマテリアルが使うテクスチャを sources に足す (同じ名前はまとめる)
+	static void AddSources(const MeshData& meshData,std::vector<Source>& sources);
+	// 画像を読んで詰め、ページとマニフェストを書き出す
+	static bool Build(const std::vector<Source>& sources,Result& result,uint32_t numThreads = 0);
+
+	// --- 実行時 ---
+	static TextureAtlas* GetInstance();
+
+	// マニフェストを読む (元の画像がマニフェストより新しいものは除く)
+	static bool ReadManifest(const std::string& path,std::vector<Page>& pages,std::unordered_map<std::string,Region>& regions);
+
+	// Resources/ からの相対のテクスチャ名で探す (無ければ nullptr)
+	// 初めて呼んだ時にマニフェストを読む。メインスレッドから呼ぶ
+	const Region* Find(const std::string& fileName);
+	const Page& GetPage(uint32_t index) const{ return pages_[index]; }
+
+private:
+	TextureAtlas() = default;
+	~TextureAtlas() = default;
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+	bool isLoaded_ = false;
+	std::vector<Page> pages_;
+	std::unordered_map<std::string,Region> regions_;
+};
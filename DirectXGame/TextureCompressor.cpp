@@ -0,0 +1,902 @@
+#include "TextureCompressor.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXTURE_COMPRESSOR_SSE2
+#endif
+
+namespace{
+
+// ブロックの16画素 (チャンネルごとに並べて、4画素ずつ SIMD で読めるようにする)
+struct alignas(16) Block{
+	float channels[4][16]; // R, G, B, A (0 ～ 255)
+};
+
+Block LoadBlock(const uint8_t* pixels){
+	Block block;
+	for(int i = 0; i < 16; ++i){
+		for(int c = 0; c < 4; ++c){
+			block.channels[c][i] = pixels[i * 4 + c];
+		}
+	}
+	return block;
+}
+
+// 各画素に一番近い色 (palette の番号) を選んで indices に入れ、誤差の二乗和を返す
+// numChannels が 3 なら α は比べない
+float FindNearest(const Block& block,const float (*palette)[4],int numColors,int numChannels,uint8_t* indices){
+	float total = 0.0f;
+#ifdef TEXTURE_COMPRESSOR_SSE2
+	for(int first = 0; first < 16; first += 4){
+		__m128 best = _mm_set1_ps(FLT_MAX);
+		__m128i bestIndex = _mm_setzero_si128();
+		for(int k = 0; k < numColors; ++k){
+			__m128 distance = _mm_setzero_ps();
+			for(int c = 0; c < numChannels; ++c){
+				__m128 difference = _mm_sub_ps(_mm_load_ps(&block.channels[c][first]),_mm_set1_ps(palette[k][c]));
+				distance = _mm_add_ps(distance,_mm_mul_ps(difference,difference));
+			}
+			// 同じ近さなら番号の小さい方を残す
+			__m128i isCloser = _mm_castps_si128(_mm_cmplt_ps(distance,best));
+			best = _mm_min_ps(distance,best);
+			bestIndex = _mm_or_si128(_mm_and_si128(isCloser,_mm_set1_epi32(k)),_mm_andnot_si128(isCloser,bestIndex));
+		}
+		alignas(16) float distances[4];
+		alignas(16) int32_t bestIndices[4];
+		_mm_store_ps(distances,best);
+		_mm_store_si128(reinterpret_cast<__m128i*>(bestIndices),bestIndex);
+		for(int i = 0; i < 4; ++i){
+			indices[first + i] = static_cast<uint8_t>(bestIndices[i]);
+			total += distances[i];
+		}
+	}
+#else
+	for(int i = 0; i < 16; ++i){
+		float best = FLT_MAX;
+		for(int k = 0; k < numColors; ++k){
+			float distance = 0.0f;
+			for(int c = 0; c < numChannels; ++c){
+				float difference = block.channels[c][i] - palette[k][c];
+				distance += difference * difference;
+			}
+			if(distance < best){
+				best = distance;
+				indices[i] = static_cast<uint8_t>(k);
+			}
+		}
+		total += best;
+	}
+#endif
+	return total;
+}
+
+// 主成分の軸 (共分散行列をべき乗法で) と平均
+void ComputePrincipalAxis(const Block& block,int numChannels,float* mean,float* axis){
+	for(int c = 0; c < numChannels; ++c){
+		mean[c] = 0.0f;
+		for(int i = 0; i < 16; ++i){
+			mean[c] += block.channels[c][i];
+		}
+		mean[c] /= 16.0f;
+	}
+	float covariance[4][4] = {};
+	for(int i = 0; i < 16; ++i){
+		float d[4];
+		for(int c = 0; c < numChannels; ++c){
+			d[c] = block.channels[c][i] - mean[c];
+		}
+		for(int a = 0; a < numChannels; ++a){
+			for(int b = 0; b < numChannels; ++b){
+				covariance[a][b] += d[a] * d[b];
+			}
+		}
+	}
+
+	// 始めは分散が一番大きいチャンネルの列 (0 に直交した向きから始めないように)
+	int largest = 0;
+	for(int c = 1; c < numChannels; ++c){
+		if(covariance[c][c] > covariance[largest][largest]){
+			largest = c;
+		}
+	}
+	for(int c = 0; c < numChannels; ++c){
+		axis[c] = covariance[c][largest];
+	}
+	for(int iteration = 0; iteration < 8; ++iteration){
+		float next[4] = {};
+		float length = 0.0f;
+		for(int a = 0; a < numChannels; ++a){
+			for(int b = 0; b < numChannels; ++b){
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length = std::max(length,std::abs(next[a]));
+		}
+		if(length < 1e-8f){
+			break;
+		}
+		for(int c = 0; c < numChannels; ++c){
+			axis[c] = next[c] / length;
+		}
+	}
+	float length = 0.0f;
+	for(int c = 0; c < numChannels; ++c){
+		length += axis[c] * axis[c];
+	}
+	length = std::sqrt(length);
+	for(int c = 0; c < numChannels; ++c){
+		axis[c] = length > 1e-8f ? axis[c] / length : 0.0f;
+	}
+}
+
+// 軸に投影した時の両端を端点の初期値にする
+void ComputeExtents(const Block& block,int numChannels,float* endpoint0,float* endpoint1){
+	float mean[4];
+	float axis[4];
+	ComputePrincipalAxis(block,numChannels,mean,axis);
+	float minimum = FLT_MAX;
+	float maximum = -FLT_MAX;
+	for(int i = 0; i < 16; ++i){
+		float t = 0.0f;
+		for(int c = 0; c < numChannels; ++c){
+			t += (block.channels[c][i] - mean[c]) * axis[c];
+		}
+		minimum = std::min(minimum,t);
+		maximum = std::max(maximum,t);
+	}
+	for(int c = 0; c < numChannels; ++c){
+		endpoint0[c] = std::clamp(mean[c] + axis[c] * maximum,0.0f,255.0f);
+		endpoint1[c] = std::clamp(mean[c] + axis[c] * minimum,0.0f,255.0f);
+	}
+}
+
+// 番号ごとの重み (端点0 の割合) から、二乗誤差が最小になる端点を求め直す
+// 全部が同じ重みなら解けないので false
+bool FitEndpoints(const Block& block,int numChannels,const uint8_t* indices,const float* weights,float* endpoint0,float* endpoint1){
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ax[4] = {};
+	float bx[4] = {};
+	for(int i = 0; i < 16; ++i){
+		float a = weights[indices[i]];
+		float b = 1.0f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for(int c = 0; c < numChannels; ++c){
+			ax[c] += a * block.channels[c][i];
+			bx[c] += b * block.channels[c][i];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if(std::abs(determinant) < 1e-6f){
+		return false;
+	}
+	for(int c = 0; c < numChannels; ++c){
+		endpoint0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant,0.0f,255.0f);
+		endpoint1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant,0.0f,255.0f);
+	}
+	return true;
+}
+
+bool IsSolid(const uint8_t* pixels,int numChannels){
+	for(int i = 1; i < 16; ++i){
+		if(std::memcmp(pixels,pixels + i * 4,numChannels) != 0){
+			return false;
+		}
+	}
+	return true;
+}
+
+// ------------------------------------------
+// BC1 (色の部分は BC3 でも使う)
+// ------------------------------------------
+
+int Expand5(int value){ return (value << 3) | (value >> 2); }
+int Expand6(int value){ return (value << 2) | (value >> 4); }
+
+uint16_t To565(const float* color){
+	int r = static_cast<int>(std::lround(color[0] * 31.0f / 255.0f));
+	int g = static_cast<int>(std::lround(color[1] * 63.0f / 255.0f));
+	int b = static_cast<int>(std::lround(color[2] * 31.0f / 255.0f));
+	return static_cast<uint16_t>(std::clamp(r,0,31) << 11 | std::clamp(g,0,63) << 5 | std::clamp(b,0,31));
+}
+
+void From565(uint16_t value,int* color){
+	color[0] = Expand5(value >> 11);
+	color[1] = Expand6((value >> 5) & 0x3F);
+	color[2] = Expand5(value & 0x1F);
+}
+
+// 4色モードの色 (0 と 1 が端点、2 と 3 はその間の 1/3 と 2/3)
+void MakeBC1Palette(uint16_t color0,uint16_t color1,float (*palette)[4]){
+	int c0[3];
+	int c1[3];
+	From565(color0,c0);
+	From565(color1,c1);
+	for(int c = 0; c < 3; ++c){
+		palette[0][c] = static_cast<float>(c0[c]);
+		palette[1][c] = static_cast<float>(c1[c]);
+		palette[2][c] = static_cast<float>((2 * c0[c] + c1[c] + 1) / 3);
+		palette[3][c] = static_cast<float>((c0[c] + 2 * c1[c] + 1) / 3);
+	}
+}
+
+// 1色だけのブロック用: 1/3 の点がその値に一番近くなる端点の組 (チャンネルごと)
+struct SingleColorTable{
+	uint8_t endpoints5[256][2];
+	uint8_t endpoints6[256][2];
+};
+
+void BuildSingleColorEntry(int bits,uint8_t (*endpoints)[2]){
+	int maximum = (1 << bits) - 1;
+	for(int value = 0; value < 256; ++value){
+		int bestError = 256;
+		for(int e0 = 0; e0 <= maximum; ++e0){
+			for(int e1 = 0; e1 <= maximum; ++e1){
+				int a = bits == 5 ? Expand5(e0) : Expand6(e0);
+				int b = bits == 5 ? Expand5(e1) : Expand6(e1);
+				int error = std::abs((2 * a + b + 1) / 3 - value);
+				if(error < bestError){
+					bestError = error;
+					endpoints[value][0] = static_cast<uint8_t>(e0);
+					endpoints[value][1] = static_cast<uint8_t>(e1);
+				}
+			}
+		}
+	}
+}
+
+const SingleColorTable& GetSingleColorTable(){
+	static const SingleColorTable table = [](){
+		SingleColorTable result;
+		BuildSingleColorEntry(5,result.endpoints5);
+		BuildSingleColorEntry(6,result.endpoints6);
+		return result;
+	}();
+	return table;
+}
+
+void WriteBC1(uint16_t color0,uint16_t color1,const uint8_t* indices,uint8_t* block){
+	uint32_t bits = 0;
+	for(int i = 0; i < 16; ++i){
+		bits |= static_cast<uint32_t>(indices[i]) << (i * 2);
+	}
+	block[0] = static_cast<uint8_t>(color0);
+	block[1] = static_cast<uint8_t>(color0 >> 8);
+	block[2] = static_cast<uint8_t>(color1);
+	block[3] = static_cast<uint8_t>(color1 >> 8);
+	std::memcpy(block + 4,&bits,4);
+}
+
+// 端点の順を 4色モードに合わせ (color0 > color1)、番号を選び直して誤差を返す
+float SelectBC1Indices(const Block& block,uint16_t& color0,uint16_t& color1,uint8_t* indices){
+	if(color0 < color1){
+		std::swap(color0,color1);
+	}
+	float palette[4][4];
+	MakeBC1Palette(color0,color1,palette);
+	// (color0 == color1 なら全部 0 番になる)
+	return FindNearest(block,palette,4,3,indices);
+}
+
+void CompressBC1(const uint8_t* pixels,uint8_t* block){
+	uint8_t indices[16];
+	if(IsSolid(pixels,3)){
+		const SingleColorTable& table = GetSingleColorTable();
+		uint16_t color0 = static_cast<uint16_t>(table.endpoints5[pixels[0]][0] << 11 | table.endpoints6[pixels[1]][0] << 5 | table.endpoints5[pixels[2]][0]);
+		uint16_t color1 = static_cast<uint16_t>(table.endpoints5[pixels[0]][1] << 11 | table.endpoints6[pixels[1]][1] << 5 | table.endpoints5[pixels[2]][1]);
+		uint8_t index = 2;
+		if(color0 < color1){
+			std::swap(color0,color1);
+			index = 3;
+		}
+		else if(color0 == color1){
+			index = 0;
+		}
+		std::fill(indices,indices + 16,index);
+		WriteBC1(color0,color1,indices,block);
+		return;
+	}
+
+	Block colors = LoadBlock(pixels);
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeExtents(colors,3,endpoint0,endpoint1);
+	uint16_t bestColor0 = To565(endpoint0);
+	uint16_t bestColor1 = To565(endpoint1);
+	uint8_t bestIndices[16];
+	float bestError = SelectBC1Indices(colors,bestColor0,bestColor1,bestIndices);
+
+	// 選んだ番号に合わせて端点を詰め直す (良くならなくなるまで)
+	static const float kWeights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+	for(int iteration = 0; iteration < 2 && bestError > 0.0f; ++iteration){
+		if(!FitEndpoints(colors,3,bestIndices,kWeights,endpoint0,endpoint1)){
+			break;
+		}
+		uint16_t color0 = To565(endpoint0);
+		uint16_t color1 = To565(endpoint1);
+		float error = SelectBC1Indices(colors,color0,color1,indices);
+		if(error >= bestError){
+			break;
+		}
+		bestError = error;
+		bestColor0 = color0;
+		bestColor1 = color1;
+		std::memcpy(bestIndices,indices,16);
+	}
+	WriteBC1(bestColor0,bestColor1,bestIndices,block);
+}
+
+void DecompressBC1(const uint8_t* block,bool isBC1,uint8_t* pixels){
+	uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+	uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+	uint32_t bits;
+	std::memcpy(&bits,block + 4,4);
+
+	int c0[3];
+	int c1[3];
+	From565(color0,c0);
+	From565(color1,c1);
+	uint8_t palette[4][4];
+	for(int c = 0; c < 3; ++c){
+		palette[0][c] = static_cast<uint8_t>(c0[c]);
+		palette[1][c] = static_cast<uint8_t>(c1[c]);
+		// BC2/BC3 の色は常に4色として読む
+		if(color0 > color1 || !isBC1){
+			palette[2][c] = static_cast<uint8_t>((2 * c0[c] + c1[c] + 1) / 3);
+			palette[3][c] = static_cast<uint8_t>((c0[c] + 2 * c1[c] + 1) / 3);
+		}
+		else{
+			palette[2][c] = static_cast<uint8_t>((c0[c] + c1[c] + 1) / 2);
+			palette[3][c] = 0;
+		}
+	}
+	palette[0][3] = palette[1][3] = palette[2][3] = 255;
+	palette[3][3] = color0 > color1 || !isBC1 ? 255 : 0;
+	for(int i = 0; i < 16; ++i){
+		std::memcpy(pixels + i * 4,palette[(bits >> (i * 2)) & 3],4);
+	}
+}
+
+// ------------------------------------------
+// BC3 の α (BC4 と同じ形)
+// ------------------------------------------
+
+// α の8段階 (alpha0 > alpha1 なら補間6つ、そうでなければ補間4つと 0, 255)
+void MakeAlphaPalette(int alpha0,int alpha1,int* palette){
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	if(alpha0 > alpha1){
+		for(int i = 1; i < 7; ++i){
+			palette[i + 1] = ((7 - i) * alpha0 + i * alpha1 + 3) / 7;
+		}
+	}
+	else{
+		for(int i = 1; i < 5; ++i){
+			palette[i + 1] = ((5 - i) * alpha0 + i * alpha1 + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+int SelectAlphaIndices(const uint8_t* pixels,int alpha0,int alpha1,uint8_t* indices){
+	int palette[8];
+	MakeAlphaPalette(alpha0,alpha1,palette);
+	int total = 0;
+	for(int i = 0; i < 16; ++i){
+		int alpha = pixels[i * 4 + 3];
+		int best = INT32_MAX;
+		for(int k = 0; k < 8; ++k){
+			int difference = alpha - palette[k];
+			if(difference * difference < best){
+				best = difference * difference;
+				indices[i] = static_cast<uint8_t>(k);
+			}
+		}
+		total += best;
+	}
+	return total;
+}
+
+void CompressAlpha(const uint8_t* pixels,uint8_t* block){
+	int minimum = 255;
+	int maximum = 0;
+	// 0 と 255 を除いた範囲 (6段階モード用)
+	int innerMinimum = 255;
+	int innerMaximum = 0;
+	for(int i = 0; i < 16; ++i){
+		int alpha = pixels[i * 4 + 3];
+		minimum = std::min(minimum,alpha);
+		maximum = std::max(maximum,alpha);
+		if(alpha != 0 && alpha != 255){
+			innerMinimum = std::min(innerMinimum,alpha);
+			innerMaximum = std::max(innerMaximum,alpha);
+		}
+	}
+
+	uint8_t indices[16];
+	int alpha0 = maximum;
+	int alpha1 = minimum;
+	int error = SelectAlphaIndices(pixels,alpha0,alpha1,indices);
+	if(error > 0 && (minimum == 0 || maximum == 255)){
+		if(innerMinimum > innerMaximum){
+			innerMinimum = innerMaximum = minimum == 0 ? maximum : minimum;
+		}
+		uint8_t innerIndices[16];
+		int innerError = SelectAlphaIndices(pixels,innerMinimum,innerMaximum,innerIndices);
+		if(innerError < error){
+			alpha0 = innerMinimum;
+			alpha1 = innerMaximum;
+			std::memcpy(indices,innerIndices,16);
+		}
+	}
+
+	block[0] = static_cast<uint8_t>(alpha0);
+	block[1] = static_cast<uint8_t>(alpha1);
+	uint64_t bits = 0;
+	for(int i = 0; i < 16; ++i){
+		bits |= static_cast<uint64_t>(indices[i]) << (i * 3);
+	}
+	for(int i = 0; i < 6; ++i){
+		block[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+	}
+}
+
+void DecompressAlpha(const uint8_t* block,uint8_t* pixels){
+	int palette[8];
+	MakeAlphaPalette(block[0],block[1],palette);
+	uint64_t bits = 0;
+	for(int i = 0; i < 6; ++i){
+		bits |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+	}
+	for(int i = 0; i < 16; ++i){
+		pixels[i * 4 + 3] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+	}
+}
+
+// ------------------------------------------
+// BC7 モード 6
+// ------------------------------------------
+
+const int kBC7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// 7ビット + p ビットの端点 (4チャンネル)
+struct BC7Endpoint{
+	int values[4]; // 0 ～ 127
+	int pBit;
+
+	int Decode(int c) const{ return values[c] << 1 | pBit; }
+};
+
+// p ビットの 0 と 1 を両方試して近い方にする
+BC7Endpoint QuantizeBC7(const float* color){
+	BC7Endpoint best = {};
+	float bestError = FLT_MAX;
+	for(int pBit = 0; pBit < 2; ++pBit){
+		BC7Endpoint endpoint;
+		endpoint.pBit = pBit;
+		float error = 0.0f;
+		for(int c = 0; c < 4; ++c){
+			endpoint.values[c] = std::clamp(static_cast<int>(std::lround((color[c] - static_cast<float>(pBit)) * 0.5f)),0,127);
+			float difference = static_cast<float>(endpoint.Decode(c)) - color[c];
+			error += difference * difference;
+		}
+		if(error < bestError){
+			bestError = error;
+			best = endpoint;
+		}
+	}
+	return best;
+}
+
+int InterpolateBC7(int a,int b,int weight){
+	return ((64 - weight) * a + weight * b + 32) >> 6;
+}
+
+float SelectBC7Indices(const Block& block,const BC7Endpoint& endpoint0,const BC7Endpoint& endpoint1,uint8_t* indices){
+	float palette[16][4];
+	for(int k = 0; k < 16; ++k){
+		for(int c = 0; c < 4; ++c){
+			palette[k][c] = static_cast<float>(InterpolateBC7(endpoint0.Decode(c),endpoint1.Decode(c),kBC7Weights[k]));
+		}
+	}
+	return FindNearest(block,palette,16,4,indices);
+}
+
+// 下位ビットから詰める
+class BlockWriter{
+public:
+	explicit BlockWriter(uint8_t* block) : block_(block){ std::memset(block_,0,16); }
+	void Write(uint32_t value,int count){
+		for(int i = 0; i < count; ++i, ++position_){
+			block_[position_ / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (position_ % 8));
+		}
+	}
+
+private:
+	uint8_t* block_;
+	int position_ = 0;
+};
+
+class BlockReader{
+public:
+	explicit BlockReader(const uint8_t* block) : block_(block){}
+	uint32_t Read(int count){
+		uint32_t value = 0;
+		for(int i = 0; i < count; ++i, ++position_){
+			value |= static_cast<uint32_t>((block_[position_ / 8] >> (position_ % 8)) & 1) << i;
+		}
+		return value;
+	}
+
+private:
+	const uint8_t* block_;
+	int position_ = 0;
+};
+
+// モード 6: RGBA をまとめて1本の線で表す。誤差を返す
+float CompressBC7Mode6(const Block& colors,bool isSolid,uint8_t* block){
+	uint8_t bestIndices[16] = {};
+	BC7Endpoint best0;
+	BC7Endpoint best1;
+	float bestError = 0.0f;
+	if(isSolid){
+		// p ビットと合わせれば 8ビットの値はちょうど表せる
+		float color[4] = {colors.channels[0][0], colors.channels[1][0], colors.channels[2][0], colors.channels[3][0]};
+		best0 = best1 = QuantizeBC7(color);
+	}
+	else{
+		float endpoint0[4];
+		float endpoint1[4];
+		ComputeExtents(colors,4,endpoint0,endpoint1);
+		best0 = QuantizeBC7(endpoint0);
+		best1 = QuantizeBC7(endpoint1);
+		bestError = SelectBC7Indices(colors,best0,best1,bestIndices);
+
+		float weights[16];
+		for(int k = 0; k < 16; ++k){
+			weights[k] = 1.0f - static_cast<float>(kBC7Weights[k]) / 64.0f;
+		}
+		uint8_t indices[16];
+		for(int iteration = 0; iteration < 2 && bestError > 0.0f; ++iteration){
+			if(!FitEndpoints(colors,4,bestIndices,weights,endpoint0,endpoint1)){
+				break;
+			}
+			BC7Endpoint candidate0 = QuantizeBC7(endpoint0);
+			BC7Endpoint candidate1 = QuantizeBC7(endpoint1);
+			float error = SelectBC7Indices(colors,candidate0,candidate1,indices);
+			if(error >= bestError){
+				break;
+			}
+			bestError = error;
+			best0 = candidate0;
+			best1 = candidate1;
+			std::memcpy(bestIndices,indices,16);
+		}
+	}
+
+	// 最初の画素の番号は上位ビットが 0 でなければならない (端点を入れ替えて番号を裏返す)
+	if(bestIndices[0] >= 8){
+		std::swap(best0,best1);
+		for(uint8_t& index : bestIndices){
+			index = static_cast<uint8_t>(15 - index);
+		}
+	}
+
+	BlockWriter writer(block);
+	writer.Write(1 << 6,7);
+	for(int c = 0; c < 4; ++c){
+		writer.Write(best0.values[c],7);
+		writer.Write(best1.values[c],7);
+	}
+	writer.Write(best0.pBit,1);
+	writer.Write(best1.pBit,1);
+	writer.Write(bestIndices[0],3);
+	for(int i = 1; i < 16; ++i){
+		writer.Write(bestIndices[i],4);
+	}
+	return bestError;
+}
+
+const int kBC7Weights2[4] = {0, 21, 43, 64};
+
+int Expand7(int value){ return (value << 1) | (value >> 6); }
+
+void MakeBC7Mode5Palette(const int (*color)[3],float (*palette)[4]){
+	for(int k = 0; k < 4; ++k){
+		for(int c = 0; c < 3; ++c){
+			palette[k][c] = static_cast<float>(InterpolateBC7(Expand7(color[0][c]),Expand7(color[1][c]),kBC7Weights2[k]));
+		}
+	}
+}
+
+// モード 5: 色 (7ビット、4段階) と α (8ビット、4段階) を別々の線で表す。誤差を返す
+float CompressBC7Mode5(const Block& colors,uint8_t* block){
+	// 色
+	int color[2][3];
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeExtents(colors,3,endpoint0,endpoint1);
+	for(int c = 0; c < 3; ++c){
+		color[0][c] = std::clamp(static_cast<int>(std::lround(endpoint0[c] * 127.0f / 255.0f)),0,127);
+		color[1][c] = std::clamp(static_cast<int>(std::lround(endpoint1[c] * 127.0f / 255.0f)),0,127);
+	}
+	float palette[4][4];
+	MakeBC7Mode5Palette(color,palette);
+	uint8_t colorIndices[16];
+	float colorError = FindNearest(colors,palette,4,3,colorIndices);
+
+	float weights[4];
+	for(int k = 0; k < 4; ++k){
+		weights[k] = 1.0f - static_cast<float>(kBC7Weights2[k]) / 64.0f;
+	}
+	uint8_t indices[16];
+	for(int iteration = 0; iteration < 2 && colorError > 0.0f; ++iteration){
+		if(!FitEndpoints(colors,3,colorIndices,weights,endpoint0,endpoint1)){
+			break;
+		}
+		int candidate[2][3];
+		for(int c = 0; c < 3; ++c){
+			candidate[0][c] = std::clamp(static_cast<int>(std::lround(endpoint0[c] * 127.0f / 255.0f)),0,127);
+			candidate[1][c] = std::clamp(static_cast<int>(std::lround(endpoint1[c] * 127.0f / 255.0f)),0,127);
+		}
+		MakeBC7Mode5Palette(candidate,palette);
+		float error = FindNearest(colors,palette,4,3,indices);
+		if(error >= colorError){
+			break;
+		}
+		colorError = error;
+		std::memcpy(color,candidate,sizeof(color));
+		std::memcpy(colorIndices,indices,16);
+	}
+
+	// α (両端をそのまま端点にする)
+	int alpha[2] = {0, 255};
+	float alphaValues[16];
+	std::memcpy(alphaValues,colors.channels[3],sizeof(alphaValues));
+	alpha[0] = static_cast<int>(*std::max_element(alphaValues,alphaValues + 16));
+	alpha[1] = static_cast<int>(*std::min_element(alphaValues,alphaValues + 16));
+	uint8_t alphaIndices[16];
+	float alphaError = 0.0f;
+	for(int i = 0; i < 16; ++i){
+		float best = FLT_MAX;
+		for(int k = 0; k < 4; ++k){
+			float difference = alphaValues[i] - static_cast<float>(InterpolateBC7(alpha[0],alpha[1],kBC7Weights2[k]));
+			if(difference * difference < best){
+				best = difference * difference;
+				alphaIndices[i] = static_cast<uint8_t>(k);
+			}
+		}
+		alphaError += best;
+	}
+
+	// 最初の画素の番号の上位ビットを 0 にする (色と α で別々に)
+	if(colorIndices[0] >= 2){
+		std::swap(color[0],color[1]);
+		for(uint8_t& index : colorIndices){
+			index = static_cast<uint8_t>(3 - index);
+		}
+	}
+	if(alphaIndices[0] >= 2){
+		std::swap(alpha[0],alpha[1]);
+		for(uint8_t& index : alphaIndices){
+			index = static_cast<uint8_t>(3 - index);
+		}
+	}
+
+	BlockWriter writer(block);
+	writer.Write(1 << 5,6);
+	writer.Write(0,2); // 回転なし
+	for(int c = 0; c < 3; ++c){
+		writer.Write(color[0][c],7);
+		writer.Write(color[1][c],7);
+	}
+	writer.Write(alpha[0],8);
+	writer.Write(alpha[1],8);
+	for(int i = 0; i < 16; ++i){
+		writer.Write(colorIndices[i],i == 0 ? 1 : 2);
+	}
+	for(int i = 0; i < 16; ++i){
+		writer.Write(alphaIndices[i],i == 0 ? 1 : 2);
+	}
+	return colorError + alphaError;
+}
+
+void CompressBC7(const uint8_t* pixels,uint8_t* block){
+	Block colors = LoadBlock(pixels);
+	bool isSolid = IsSolid(pixels,4);
+	float error = CompressBC7Mode6(colors,isSolid,block);
+	if(error > 0.0f){
+		// α が色と別に動くブロックはモード 5 の方が良いことが多い
+		uint8_t candidate[16];
+		if(CompressBC7Mode5(colors,candidate) < error){
+			std::memcpy(block,candidate,16);
+		}
+	}
+}
+
+void FillMagenta(uint8_t* pixels){
+	for(int i = 0; i < 16; ++i){
+		pixels[i * 4 + 0] = 255;
+		pixels[i * 4 + 1] = 0;
+		pixels[i * 4 + 2] = 255;
+		pixels[i * 4 + 3] = 255;
+	}
+}
+
+void DecompressBC7(const uint8_t* block,uint8_t* pixels){
+	BlockReader reader(block);
+	if((block[0] & 0x3F) == 1 << 5){
+		// モード 5
+		reader.Read(6);
+		uint32_t rotation = reader.Read(2);
+		int color[2][3];
+		for(int c = 0; c < 3; ++c){
+			color[0][c] = Expand7(static_cast<int>(reader.Read(7)));
+			color[1][c] = Expand7(static_cast<int>(reader.Read(7)));
+		}
+		int alpha0 = static_cast<int>(reader.Read(8));
+		int alpha1 = static_cast<int>(reader.Read(8));
+		uint8_t colorIndices[16];
+		for(int i = 0; i < 16; ++i){
+			colorIndices[i] = static_cast<uint8_t>(reader.Read(i == 0 ? 1 : 2));
+		}
+		for(int i = 0; i < 16; ++i){
+			int alphaIndex = static_cast<int>(reader.Read(i == 0 ? 1 : 2));
+			uint8_t* pixel = pixels + i * 4;
+			for(int c = 0; c < 3; ++c){
+				pixel[c] = static_cast<uint8_t>(InterpolateBC7(color[0][c],color[1][c],kBC7Weights2[colorIndices[i]]));
+			}
+			pixel[3] = static_cast<uint8_t>(InterpolateBC7(alpha0,alpha1,kBC7Weights2[alphaIndex]));
+			if(rotation != 0){
+				std::swap(pixel[3],pixel[rotation - 1]);
+			}
+		}
+		return;
+	}
+	if((block[0] & 0x7F) != 1 << 6){
+		FillMagenta(pixels);
+		return;
+	}
+	// モード 6
+	reader.Read(7);
+	BC7Endpoint endpoint0;
+	BC7Endpoint endpoint1;
+	for(int c = 0; c < 4; ++c){
+		endpoint0.values[c] = static_cast<int>(reader.Read(7));
+		endpoint1.values[c] = static_cast<int>(reader.Read(7));
+	}
+	endpoint0.pBit = static_cast<int>(reader.Read(1));
+	endpoint1.pBit = static_cast<int>(reader.Read(1));
+	for(int i = 0; i < 16; ++i){
+		int index = static_cast<int>(reader.Read(i == 0 ? 3 : 4));
+		for(int c = 0; c < 4; ++c){
+			pixels[i * 4 + c] = static_cast<uint8_t>(InterpolateBC7(endpoint0.Decode(c),endpoint1.Decode(c),kBC7Weights[index]));
+		}
+	}
+}
+
+} // namespace
+
+const char* TextureCompressor::GetName(Format format){
+	switch(format){
+	case Format::kBC1:
+		return "BC1";
+	case Format::kBC3:
+		return "BC3";
+	default:
+		return "BC7";
+	}
+}
+
+size_t TextureCompressor::GetCompressedSize(uint32_t width,uint32_t height,Format format){
+	return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(format);
+}
+
+void TextureCompressor::CompressBlock(const uint8_t* pixels,Format format,uint8_t* block){
+	switch(format){
+	case Format::kBC1:
+		CompressBC1(pixels,block);
+		break;
+	case Format::kBC3:
+		CompressAlpha(pixels,block);
+		CompressBC1(pixels,block + 8);
+		break;
+	case Format::kBC7:
+		CompressBC7(pixels,block);
+		break;
+	}
+}
+
+void TextureCompressor::DecompressBlock(const uint8_t* block,Format format,uint8_t* pixels){
+	switch(format){
+	case Format::kBC1:
+		DecompressBC1(block,true,pixels);
+		break;
+	case Format::kBC3:
+		DecompressBC1(block + 8,false,pixels);
+		DecompressAlpha(block,pixels);
+		break;
+	case Format::kBC7:
+		DecompressBC7(block,pixels);
+		break;
+	}
+}
+
+std::vector<uint8_t> TextureCompressor::Compress(const ImageData& image,Format format,uint32_t numThreads){
+	uint32_t blocksX = (image.width + 3) / 4;
+	uint32_t blocksY = (image.height + 3) / 4;
+	uint32_t blockBytes = GetBlockBytes(format);
+	std::vector<uint8_t> result(GetCompressedSize(image.width,image.height,format));
+	if(result.empty()){
+		return result;
+	}
+
+	ParallelFor(blocksY,numThreads,[&](size_t blockY){
+		uint8_t pixels[64];
+		for(uint32_t blockX = 0; blockX < blocksX; ++blockX){
+			for(uint32_t y = 0; y < 4; ++y){
+				uint32_t sourceY = std::min(static_cast<uint32_t>(blockY) * 4 + y,image.height - 1);
+				for(uint32_t x = 0; x < 4; ++x){
+					uint32_t sourceX = std::min(blockX * 4 + x,image.width - 1);
+					std::memcpy(pixels + (y * 4 + x) * 4,image.GetPixel(sourceX,sourceY),4);
+				}
+			}
+			CompressBlock(pixels,format,&result[(blockY * blocksX + blockX) * blockBytes]);
+		}
+	});
+	return result;
+}
+
+ImageData TextureCompressor::Decompress(std::span<const uint8_t> data,uint32_t width,uint32_t height,Format format){
+	ImageData image;
+	if(data.size() < GetCompressedSize(width,height,format)){
+		return image;
+	}
+	image.width = width;
+	image.height = height;
+	image.pixels.resize(static_cast<size_t>(width) * height * 4);
+	uint32_t blocksX = (width + 3) / 4;
+	uint32_t blocksY = (height + 3) / 4;
+	uint32_t blockBytes = GetBlockBytes(format);
+	uint8_t pixels[64];
+	for(uint32_t blockY = 0; blockY < blocksY; ++blockY){
+		for(uint32_t blockX = 0; blockX < blocksX; ++blockX){
+			DecompressBlock(&data[(static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes],format,pixels);
+			for(uint32_t y = 0; y < 4 && blockY * 4 + y < height; ++y){
+				for(uint32_t x = 0; x < 4 && blockX * 4 + x < width; ++x){
+					std::memcpy(image.GetPixel(blockX * 4 + x,blockY * 4 + y),pixels + (y * 4 + x) * 4,4);
+				}
+			}
+		}
+	}
+	return image;
+}
+
+double TextureCompressor::ComputePsnr(const ImageData& expected,const ImageData& actual,bool alpha){
+	if(expected.pixels.size() != actual.pixels.size() || expected.pixels.empty()){
+		return 0.0;
+	}
+	double total = 0.0;
+	size_t count = 0;
+	for(size_t i = 0; i < expected.pixels.size(); i += 4){
+		for(size_t c = alpha ? 3 : 0; c < (alpha ? 4u : 3u); ++c){
+			double difference = static_cast<double>(expected.pixels[i + c]) - actual.pixels[i + c];
+			total += difference * difference;
+			++count;
+		}
+	}
+	if(total == 0.0){
+		return std::numeric_limits<double>::infinity();
+	}
+	double meanSquaredError = total / static_cast<double>(count);
+	return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "ImageData.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ==========================================
+// BC1 / BC3 / BC7 のブロック圧縮 (CPU 側だけ)
+// ・BC1: 主成分の軸で端点を決め、最小二乗で詰め直す (常に4色モード)
+// ・BC3: 色は BC1 と同じ、α は 8段階と 6段階 (+0/255) の良い方
+// ・BC7: 分割なしのモード 6 (RGBA をまとめて16段階) とモード 5 (色と α を別々に4段階) の良い方
+// 近い色を探すところは SSE2 で4画素ずつ行い、画像全体はブロックの行ごとに複数スレッドで分ける
+// 色は sRGB のまま扱う (DDS には *_UNORM_SRGB で書く)
+// ==========================================
+class TextureCompressor{
+public:
+	enum class Format{
+		kBC1, // 4ビット/画素 (不透明)
+		kBC3, // 8ビット/画素
+		kBC7, // 8ビット/画素
+	};
+
+	static const char* GetName(Format format);
+	// 4x4 ブロック1つのバイト数
+	static uint32_t GetBlockBytes(Format format){ return format == Format::kBC1 ? 8 : 16; }
+	static size_t GetCompressedSize(uint32_t width,uint32_t height,Format format);
+
+	// ブロック1つ (pixels は RGBA で16画素、左上から行ごと)
+	static void CompressBlock(const uint8_t* pixels,Format format,uint8_t* block);
+	// (BC7 はこのクラスが書くモード 5 と 6 だけを読める。他のモードは不透明なマゼンタにする)
+	static void DecompressBlock(const uint8_t* block,Format format,uint8_t* pixels);
+
+	// 画像全体 (端の欠けたブロックは端の画素を繰り返して埋める)
+	// numThreads は呼び出し元を含めたスレッド数 (0 ならコア数)
+	static std::vector<uint8_t> Compress(const ImageData& image,Format format,uint32_t numThreads = 0);
+	static ImageData Decompress(std::span<const uint8_t> data,uint32_t width,uint32_t height,Format format);
+
+	// ピーク信号対雑音比 (dB)。alpha が false なら RGB、true なら α だけを比べる (同じなら無限大)
+	static double ComputePsnr(const ImageData& expected,const ImageData& actual,bool alpha = false);
+};
@@ -0,0 +1,15 @@
+#include "TileInstanceBuffer.h"
+#include "MeshModel.h"
+
+void TileInstanceBuffer::Upload(){
+	buffer_.Reset();
+	view_ = {};
+	uploadedCount_ = instances_.GetCount();
+	if(uploadedCount_ == 0){
+		return;
+	}
+	buffer_ = MeshModel::CreateBuffer(instances_.Get().data(),instances_.GetSizeBytes());
+	view_.BufferLocation = buffer_->GetGPUVirtualAddress();
+	view_.SizeInBytes = static_cast<UINT>(instances_.GetSizeBytes());
+	view_.StrideInBytes = sizeof(TileInstance);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "TileInstances.h"
+#include <d3d12.h>
+#include <wrl.h>
+
+// ==========================================
+// GPU に置いたタイル層のインスタンス (MeshModel::DrawInstanced で描く)
+// 並びを GetInstances で組み、Upload で写す
+// 描画中のフレームが読んでいるバッファを作り直さないよう、Upload はシーンの初期化で呼ぶ
+// ==========================================
+class TileInstanceBuffer{
+public:
+	TileInstances& GetInstances(){ return instances_; }
+	const TileInstances& GetInstances() const{ return instances_; }
+
+	void Upload();
+	// Upload した数 (並びを変えて Upload していなければ GetInstances の数と違う)
+	uint32_t GetUploadedCount() const{ return uploadedCount_; }
+	const D3D12_VERTEX_BUFFER_VIEW& GetView() const{ return view_; }
+
+private:
+	TileInstances instances_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer_;
+	D3D12_VERTEX_BUFFER_VIEW view_ = {};
+	uint32_t uploadedCount_ = 0;
+};
@@ -0,0 +1,92 @@
+#include "TileInstances.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void CountingTileDrawRecorder::Draw(size_t index,const Range& range,uint32_t startInstance,uint32_t instanceCount){
+	(void)index;
+	(void)startInstance;
+	++drawCallCount_;
+	instanceCount_ += instanceCount;
+	triangleCount_ += static_cast<uint64_t>(range.indexCount / 3) * instanceCount;
+}
+
+uint32_t TileInstances::PackColor(float r,float g,float b,float a){
+	auto toByte = [](float value){ return static_cast<uint32_t>(std::lround(std::clamp(value,0.0f,1.0f) * 255.0f)); };
+	return toByte(r) | toByte(g) << 8 | toByte(b) << 16 | toByte(a) << 24;
+}
+
+void TileInstances::Clear(){
+	instances_.clear();
+	width_ = 0;
+	height_ = 0;
+	columnStarts_.assign(1,0);
+}
+
+void TileInstances::Add(int32_t x,int32_t y,uint32_t color){
+	assert(x >= INT16_MIN && x <= INT16_MAX && y >= INT16_MIN && y <= INT16_MAX);
+	instances_.push_back({static_cast<int16_t>(x), static_cast<int16_t>(y), color});
+}
+
+void TileInstances::Build(uint32_t width,uint32_t height,const std::function<bool(uint32_t column,uint32_t row)>& isSolid,uint32_t color){
+	Clear();
+	width_ = width;
+	height_ = height;
+	columnStarts_.reserve(static_cast<size_t>(width) + 1);
+	for(uint32_t column = 0; column < width; ++column){
+		for(uint32_t row = height; row-- > 0;){
+			if(isSolid(column,row)){
+				// 段は下から数える (MapChipField::GetMapChipPositionByIndex と同じ向き)
+				Add(static_cast<int32_t>(column),static_cast<int32_t>(height - 1 - row),color);
+			}
+		}
+		columnStarts_.push_back(GetCount());
+	}
+}
+
+TileInstances::Rect TileInstances::GetVisibleRect(const Frustum& frustum,const Layout& layout,int32_t margin) const{
+	if(width_ == 0 || height_ == 0){
+		return {};
+	}
+	// 層全体を囲む箱のうち、視錐台に入る部分
+	Vector3 layerMin = {layout.origin.x - layout.halfExtent.x, layout.origin.y - layout.halfExtent.y, layout.origin.z - layout.halfExtent.z};
+	Vector3 layerMax = {layout.origin.x + (width_ - 1) * layout.tileWidth + layout.halfExtent.x, layout.origin.y + (height_ - 1) * layout.tileHeight + layout.halfExtent.y,
+	                    layout.origin.z + layout.halfExtent.z};
+	Vector3 visibleMin;
+	Vector3 visibleMax;
+	if(!frustum.ClipBox(layerMin,layerMax,visibleMin,visibleMax)){
+		return {};
+	}
+
+	// マス i のメッシュは origin + i * 大きさ ± halfExtent にあるので、見える範囲と重なる i は
+	// (min - origin - halfExtent) / 大きさ 以上、(max - origin + halfExtent) / 大きさ 以下
+	auto toRange = [](float min,float max,float origin,float size,float halfExtent,int32_t margin,uint32_t count,int32_t& begin,int32_t& end){
+		begin = static_cast<int32_t>(std::ceil((min - origin - halfExtent) / size)) - margin;
+		end = static_cast<int32_t>(std::floor((max - origin + halfExtent) / size)) + 1 + margin;
+		begin = std::clamp(begin,0,static_cast<int32_t>(count));
+		end = std::clamp(end,begin,static_cast<int32_t>(count));
+	};
+	Rect rect;
+	toRange(visibleMin.x,visibleMax.x,layout.origin.x,layout.tileWidth,layout.halfExtent.x,margin,width_,rect.left,rect.right);
+	toRange(visibleMin.y,visibleMax.y,layout.origin.y,layout.tileHeight,layout.halfExtent.y,margin,height_,rect.bottom,rect.top);
+	return rect;
+}
+
+void TileInstances::Record(TileDrawRecorder& recorder,std::span<const TileDrawRecorder::Range> ranges,const Rect& rect) const{
+	if(rect.IsEmpty() || rect.left < 0 || rect.right > static_cast<int32_t>(width_)){
+		return;
+	}
+	uint32_t start = columnStarts_[rect.left];
+	uint32_t count = columnStarts_[rect.right] - start;
+	if(count == 0){
+		return;
+	}
+	for(size_t i = 0; i < ranges.size(); ++i){
+		recorder.Draw(i,ranges[i],start,count);
+	}
+}
+
+void TileInstances::GetOffset(const TileInstance& instance,float tileWidth,float tileHeight,float& x,float& y){
+	x = static_cast<float>(instance.x) * tileWidth;
+	y = static_cast<float>(instance.y) * tileHeight;
+}
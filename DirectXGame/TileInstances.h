@@ -0,0 +1,115 @@
+#pragma once
+#include "Frustum.h"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+// 1タイル分のインスタンスデータ (8 バイト)
+// 位置は行列ではなくマス目の番号だけを送り、頂点シェーダーで tile * タイルの大きさ だけずらす
+struct TileInstance{
+	int16_t x;      // 列 (左から)
+	int16_t y;      // 段 (下から。マップの行とは上下が逆)
+	uint32_t color; // RGBA8 (R が下位のバイト)。頂点シェーダーが色に掛ける
+};
+static_assert(sizeof(TileInstance) == 8,"TileInstance は入力レイアウト (R16G16_SINT + R8G8B8A8_UNORM) と同じ並び");
+
+// ==========================================
+// 描画コマンドの出し先
+// ゲームではコマンドリストに積み、AssetCooker では数えるだけ (D3D の無い環境で確かめる)
+// ==========================================
+class TileDrawRecorder{
+public:
+	// メッシュ1つ分のインデックスの範囲
+	struct Range{
+		uint32_t indexCount;
+		uint32_t startIndex;
+		int32_t baseVertex;
+	};
+
+	virtual ~TileDrawRecorder() = default;
+
+	// 範囲 index (Record に渡した順の番号。マテリアルの切り替えに使う) を instanceCount 個描く
+	virtual void Draw(size_t index,const Range& range,uint32_t startInstance,uint32_t instanceCount) = 0;
+};
+
+// 数えるだけの出し先
+class CountingTileDrawRecorder : public TileDrawRecorder{
+public:
+	void Draw(size_t index,const Range& range,uint32_t startInstance,uint32_t instanceCount) override;
+
+	uint32_t GetDrawCallCount() const{ return drawCallCount_; }
+	uint64_t GetInstanceCount() const{ return instanceCount_; }
+	uint64_t GetTriangleCount() const{ return triangleCount_; }
+
+private:
+	uint32_t drawCallCount_ = 0;
+	uint64_t instanceCount_ = 0;
+	uint64_t triangleCount_ = 0;
+};
+
+// ==========================================
+// タイル層 (マップチップのブロックなど) のインスタンスの並び
+// 同じメッシュを置くマス目を集め、層全体を1回の DrawIndexedInstanced で描けるようにする
+// ・列ごとに (左の列から、列の中は下から) 並べ、列の先頭の番号を覚えておく
+//   画面に入る列の範囲は連続した区間になるので、描く数は画面内の列の分だけになる
+// ・GPU へのアップロードはしない (ゲームでは TileInstanceBuffer が持つ)
+// ==========================================
+class TileInstances{
+public:
+	static inline const uint32_t kWhite = 0xFFFFFFFF;
+
+	// マス目の範囲 (列 left～right-1、段 bottom～top-1。段は下から)
+	struct Rect{
+		int32_t left = 0;
+		int32_t right = 0;
+		int32_t bottom = 0;
+		int32_t top = 0;
+
+		bool IsEmpty() const{ return left >= right || bottom >= top; }
+		uint32_t GetTileCount() const{ return IsEmpty() ? 0 : static_cast<uint32_t>((right - left) * (top - bottom)); }
+	};
+
+	// 層の置き方 (ワールド座標)
+	struct Layout{
+		Vector3 origin;     // マス (0, 0) の中心
+		float tileWidth;
+		float tileHeight;
+		Vector3 halfExtent; // 1マスに置くメッシュの半分の大きさ (中心から)
+	};
+
+	// 0～1 の色を RGBA8 にする
+	static uint32_t PackColor(float r,float g,float b,float a);
+
+	void Clear();
+	// マップ (上の行が row 0) の isSolid なマスを全て入れ直す (列・段の番号は int16 に収まること)
+	void Build(uint32_t width,uint32_t height,const std::function<bool(uint32_t column,uint32_t row)>& isSolid,uint32_t color = kWhite);
+
+	std::span<const TileInstance> Get() const{ return instances_; }
+	uint32_t GetCount() const{ return static_cast<uint32_t>(instances_.size()); }
+	size_t GetSizeBytes() const{ return instances_.size() * sizeof(TileInstance); }
+	uint32_t GetWidth() const{ return width_; }
+	uint32_t GetHeight() const{ return height_; }
+	Rect GetFullRect() const{ return {0, static_cast<int32_t>(width_), 0, static_cast<int32_t>(height_)}; }
+
+	// 視錐台に入るマスの範囲を、周りに margin マス広げて返す (層の外は切る)
+	// 計算は列・段の数によらず一定
+	Rect GetVisibleRect(const Frustum& frustum,const Layout& layout,int32_t margin) const;
+
+	// rect の列に入るインスタンスを、範囲ごとに1回ずつで描く
+	// (列の中は全ての段を描く。段の外は GPU が切り捨てる)
+	void Record(TileDrawRecorder& recorder,std::span<const TileDrawRecorder::Range> ranges,const Rect& rect) const;
+	void Record(TileDrawRecorder& recorder,std::span<const TileDrawRecorder::Range> ranges) const{ Record(recorder,ranges,GetFullRect()); }
+
+	// 頂点シェーダーと同じ計算 (層の原点からのずれ)
+	static void GetOffset(const TileInstance& instance,float tileWidth,float tileHeight,float& x,float& y);
+
+private:
+	void Add(int32_t x,int32_t y,uint32_t color);
+
+	std::vector<TileInstance> instances_;
+	uint32_t width_ = 0;
+	uint32_t height_ = 0;
+	// 列 x のインスタンスは [columnStarts_[x], columnStarts_[x + 1])
+	std::vector<uint32_t> columnStarts_;
+};
@@ -1,17 +1,16 @@
 #include "TitleScene.h"
+#include "FixedTimestep.h"
 #include "Math.h"
 #include <numbers>
 
 TitleScene::~TitleScene() {
-	delete modelPlayer_;
-	delete modelTitle_;
 	delete fade_;
 }
 
 void TitleScene::Initialize() {
 
-	modelTitle_ = Model::CreateFromOBJ("titleFont", true);
-	modelPlayer_ = Model::CreateFromOBJ("player");
+	modelTitle_ = AssetCache::GetInstance()->LoadModel("titleFont", true);
+	modelPlayer_ = AssetCache::GetInstance()->LoadModel("player");
 
 	// カメラ初期化
 	camera_.Initialize();
@@ -65,7 +64,7 @@ void TitleScene::Update() {
 	}
 
 
-	counter_ += 1.0f / 60.0f;
+	counter_ += FixedTimestep::kDeltaTime;
 	counter_ = std::fmod(counter_, kTimeTitleMove);
 
 	float angle = counter_ / kTimeTitleMove * 2.0f * std::numbers::pi_v<float>;
@@ -78,7 +77,7 @@ void TitleScene::Update() {
 	WorldTransformUpdate(worldTransformTitle_);
 
 	// アフィン変換～DirectXに転送（プレイヤー座標）
-	WorldTransformUpdate(worldTransformPlayer_);
+	WorldTransformUpdate(worldTransformPlayer_, playerTransformTracker_);
 }
 
 void TitleScene::Draw() {
@@ -1,6 +1,8 @@
 #pragma once
+#include "AssetCache.h"
 #include "Fade.h"
 #include "KamataEngine.h"
+#include "TransformChangeTracker.h"
 
 using namespace KamataEngine;
 
@@ -28,9 +30,10 @@ private:
 	Camera camera_;
 	WorldTransform worldTransformTitle_;
 	WorldTransform worldTransformPlayer_;
+	TransformChangeTracker playerTransformTracker_; // プレイヤーは動かないので転送は最初の1回だけ
 
-	Model* modelPlayer_ = nullptr;
-	Model* modelTitle_ = nullptr;
+	ModelHandle modelPlayer_;
+	ModelHandle modelTitle_;
 
 	float counter_ = 0.0f;
 	bool finished_ = false;
@@ -0,0 +1,28 @@
+#include "TransformChangeTracker.h"
+
+namespace{
+
+bool IsEqual(const Vector3& a,const Vector3& b){
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+} // namespace
+
+bool TransformChangeTracker::Update(const Vector3& scale,const Vector3& rotation,const Vector3& translation){
+	if(isValid_ && IsEqual(scale_,scale) && IsEqual(rotation_,rotation) && IsEqual(translation_,translation)){
+		++unchangedCount_;
+		return false;
+	}
+	scale_ = scale;
+	rotation_ = rotation;
+	translation_ = translation;
+	isValid_ = true;
+	++version_;
+	++changedCount_;
+	return true;
+}
+
+void TransformChangeTracker::ResetCounts(){
+	changedCount_ = 0;
+	unchangedCount_ = 0;
+}
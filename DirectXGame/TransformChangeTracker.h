@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <math/Vector3.h>
+
+using namespace KamataEngine;
+
+// ==========================================
+// トランスフォームの変更の追跡
+// 前回 GPU に送った時の スケール・回転・平行移動 を覚えておき、同じなら行列の計算も転送も省く
+// ・WorldTransform はエンジン側の型で、メンバーは色々な所から直接書き換えられるので、
+//   書き換えの時に印を付けるのではなく、送る直前に前回の値と比べる
+// ・定数バッファ1つにつき1つ持つ (同じバッファを別の追跡で送ると、送った中身と記録がずれる)
+// ・D3D を使わないので AssetCooker でも動く
+// ==========================================
+class TransformChangeTracker{
+public:
+	// 値が前回 true を返した時と違えば (初回は必ず) 記録を差し替えて true
+	bool Update(const Vector3& scale,const Vector3& rotation,const Vector3& translation);
+
+	// 次の Update を必ず true にする (定数バッファの中身を別の所で書き換えた時など)
+	void Invalidate(){ isValid_ = false; }
+
+	// 値が変わるたびに 1 増える
+	uint32_t GetVersion() const{ return version_; }
+
+	// Update で変わっていた・同じだった数 (ResetCounts からの合計)
+	static void ResetCounts();
+	static uint64_t GetChangedCount(){ return changedCount_; }
+	static uint64_t GetUnchangedCount(){ return unchangedCount_; }
+
+private:
+	Vector3 scale_ = {};
+	Vector3 rotation_ = {};
+	Vector3 translation_ = {};
+	uint32_t version_ = 0;
+	bool isValid_ = false;
+
+	static inline uint64_t changedCount_ = 0;
+	static inline uint64_t unchangedCount_ = 0;
+};
@@ -0,0 +1,297 @@
+#include "TransformHierarchy.h"
+#include "SimdMath.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace{
+
+// world = local * parent (math.cpp の operator*= と同じ順に足す)
+void MultiplyScalar(const Matrix4x4& local,const Matrix4x4& parent,Matrix4x4& world){
+	for(size_t i = 0; i < 4; ++i){
+		for(size_t j = 0; j < 4; ++j){
+			world.m[i][j] = local.m[i][0] * parent.m[0][j] + local.m[i][1] * parent.m[1][j] + local.m[i][2] * parent.m[2][j] + local.m[i][3] * parent.m[3][j];
+		}
+	}
+}
+
+} // namespace
+
+TransformHierarchy::Handle TransformHierarchy::Create(Handle parent,const Vector3& scale,const Vector3& rotation,const Vector3& translation){
+	Handle handle;
+	if(!freeHandles_.empty()){
+		handle = freeHandles_.back();
+		freeHandles_.pop_back();
+	}
+	else{
+		handle = static_cast<Handle>(handleToIndex_.size());
+		handleToIndex_.push_back(kNone);
+	}
+
+	// 後ろに足すので、親より前に来ることはない (並びは崩れない)
+	uint32_t index = GetCount();
+	handleToIndex_[handle] = index;
+	scaleX_.push_back(scale.x);
+	scaleY_.push_back(scale.y);
+	scaleZ_.push_back(scale.z);
+	rotationX_.push_back(rotation.x);
+	rotationY_.push_back(rotation.y);
+	rotationZ_.push_back(rotation.z);
+	translationX_.push_back(translation.x);
+	translationY_.push_back(translation.y);
+	translationZ_.push_back(translation.z);
+	parent_.push_back(parent == kNone ? -1 : static_cast<int32_t>(GetIndex(parent)));
+	dirty_.push_back(kLocalDirty);
+	handle_.push_back(handle);
+	local_.push_back({});
+	world_.push_back({});
+	return handle;
+}
+
+void TransformHierarchy::Destroy(Handle handle){
+	if(isOrderDirty_){
+		Reorder();
+	}
+	// 親が先に並んでいるので、前から見れば子孫は必ず印の付いた親の後に来る
+	uint32_t target = GetIndex(handle);
+	uint32_t count = GetCount();
+	std::vector<uint8_t> isRemoved(count,0);
+	std::vector<uint32_t> order;
+	order.reserve(count);
+	for(uint32_t i = 0; i < count; ++i){
+		isRemoved[i] = i == target || (parent_[i] >= 0 && isRemoved[parent_[i]]);
+		if(isRemoved[i]){
+			handleToIndex_[handle_[i]] = kNone;
+			freeHandles_.push_back(handle_[i]);
+		}
+		else{
+			order.push_back(i);
+		}
+	}
+	Permute(order);
+}
+
+void TransformHierarchy::Clear(){
+	for(std::vector<float>* values : {&scaleX_, &scaleY_, &scaleZ_, &rotationX_, &rotationY_, &rotationZ_, &translationX_, &translationY_, &translationZ_}){
+		values->clear();
+	}
+	parent_.clear();
+	dirty_.clear();
+	handle_.clear();
+	local_.clear();
+	world_.clear();
+	handleToIndex_.clear();
+	freeHandles_.clear();
+	isOrderDirty_ = false;
+	updatedCount_ = 0;
+}
+
+void TransformHierarchy::SetParent(Handle handle,Handle parent){
+	uint32_t index = GetIndex(handle);
+	int32_t parentIndex = parent == kNone ? -1 : static_cast<int32_t>(GetIndex(parent));
+#ifdef _DEBUG
+	// 自分の子孫を親にすると輪になる
+	for(int32_t i = parentIndex; i >= 0; i = parent_[i]){
+		assert(static_cast<uint32_t>(i) != index);
+	}
+#endif
+	parent_[index] = parentIndex;
+	// ローカル行列は変わらないので、親との掛け算だけやり直す
+	dirty_[index] |= kWorldDirty;
+	// 親が後ろにいる時だけ並べ直しが要る
+	if(parentIndex > static_cast<int32_t>(index)){
+		isOrderDirty_ = true;
+	}
+}
+
+TransformHierarchy::Handle TransformHierarchy::GetParent(Handle handle) const{
+	int32_t parentIndex = parent_[GetIndex(handle)];
+	return parentIndex < 0 ? kNone : handle_[parentIndex];
+}
+
+void TransformHierarchy::SetScale(Handle handle,const Vector3& scale){
+	uint32_t index = GetIndex(handle);
+	scaleX_[index] = scale.x;
+	scaleY_[index] = scale.y;
+	scaleZ_[index] = scale.z;
+	MarkLocalDirty(index);
+}
+
+void TransformHierarchy::SetRotation(Handle handle,const Vector3& rotation){
+	uint32_t index = GetIndex(handle);
+	rotationX_[index] = rotation.x;
+	rotationY_[index] = rotation.y;
+	rotationZ_[index] = rotation.z;
+	MarkLocalDirty(index);
+}
+
+void TransformHierarchy::SetTranslation(Handle handle,const Vector3& translation){
+	uint32_t index = GetIndex(handle);
+	translationX_[index] = translation.x;
+	translationY_[index] = translation.y;
+	translationZ_[index] = translation.z;
+	MarkLocalDirty(index);
+}
+
+Vector3 TransformHierarchy::GetScale(Handle handle) const{
+	uint32_t index = GetIndex(handle);
+	return {scaleX_[index], scaleY_[index], scaleZ_[index]};
+}
+
+Vector3 TransformHierarchy::GetRotation(Handle handle) const{
+	uint32_t index = GetIndex(handle);
+	return {rotationX_[index], rotationY_[index], rotationZ_[index]};
+}
+
+Vector3 TransformHierarchy::GetTranslation(Handle handle) const{
+	uint32_t index = GetIndex(handle);
+	return {translationX_[index], translationY_[index], translationZ_[index]};
+}
+
+void TransformHierarchy::Update(Path path){
+	if(isOrderDirty_){
+		Reorder();
+	}
+	uint32_t count = GetCount();
+
+	// 親の印を子へ流す (親が先に並んでいるので前から1回で足りる)
+	for(uint32_t i = 0; i < count; ++i){
+		int32_t parent = parent_[i];
+		if(parent >= 0 && dirty_[parent] != 0){
+			dirty_[i] |= kWorldDirty;
+		}
+	}
+
+	if(path == Path::kSimd){
+		ComposeLocalSimd(0,count);
+	}
+	else{
+		ComposeLocalScalar(0,count);
+	}
+
+	updatedCount_ = 0;
+	for(uint32_t i = 0; i < count; ++i){
+		if(dirty_[i] == 0){
+			continue;
+		}
+		int32_t parent = parent_[i];
+		if(parent < 0){
+			world_[i] = local_[i];
+		}
+		else if(path == Path::kSimd){
+			world_[i] = MultiplyMatrix(local_[i],world_[parent]);
+		}
+		else{
+			MultiplyScalar(local_[i],world_[parent],world_[i]);
+		}
+		++updatedCount_;
+	}
+	std::fill(dirty_.begin(),dirty_.end(),uint8_t(0));
+}
+
+uint32_t TransformHierarchy::GetIndex(Handle handle) const{
+	assert(handle < handleToIndex_.size() && handleToIndex_[handle] != kNone);
+	return handleToIndex_[handle];
+}
+
+void TransformHierarchy::MarkLocalDirty(uint32_t index){
+	dirty_[index] |= kLocalDirty;
+}
+
+void TransformHierarchy::Reorder(){
+	uint32_t count = GetCount();
+	// 深さは親をたどって数える (途中で分かった深さは使い回す)
+	std::vector<int32_t> depth(count,-1);
+	std::vector<uint32_t> chain;
+	for(uint32_t i = 0; i < count; ++i){
+		uint32_t node = i;
+		while(depth[node] < 0 && parent_[node] >= 0){
+			chain.push_back(node);
+			node = static_cast<uint32_t>(parent_[node]);
+		}
+		if(depth[node] < 0){
+			depth[node] = 0;
+		}
+		while(!chain.empty()){
+			depth[chain.back()] = depth[node] + 1;
+			node = chain.back();
+			chain.pop_back();
+		}
+	}
+
+	// 同じ深さの中では元の並びを保つ (触っていない所のメモリの並びを変えない)
+	std::vector<uint32_t> order(count);
+	for(uint32_t i = 0; i < count; ++i){
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(),order.end(),[&depth](uint32_t a,uint32_t b){ return depth[a] < depth[b]; });
+	Permute(order);
+	isOrderDirty_ = false;
+}
+
+void TransformHierarchy::Permute(const std::vector<uint32_t>& order){
+	uint32_t newCount = static_cast<uint32_t>(order.size());
+	// 古い番号 -> 新しい番号 (消えたものは -1)
+	std::vector<int32_t> remap(GetCount(),-1);
+	for(uint32_t i = 0; i < newCount; ++i){
+		remap[order[i]] = static_cast<int32_t>(i);
+	}
+
+	auto permute = [&order,newCount](auto& values){
+		std::remove_reference_t<decltype(values)> sorted(newCount);
+		for(uint32_t i = 0; i < newCount; ++i){
+			sorted[i] = values[order[i]];
+		}
+		values.swap(sorted);
+	};
+	for(std::vector<float>* values : {&scaleX_, &scaleY_, &scaleZ_, &rotationX_, &rotationY_, &rotationZ_, &translationX_, &translationY_, &translationZ_}){
+		permute(*values);
+	}
+	permute(parent_);
+	permute(dirty_);
+	permute(handle_);
+	permute(local_);
+	permute(world_);
+
+	for(uint32_t i = 0; i < newCount; ++i){
+		if(parent_[i] >= 0){
+			parent_[i] = remap[parent_[i]];
+		}
+		handleToIndex_[handle_[i]] = i;
+	}
+}
+
+void TransformHierarchy::ComposeLocalScalar(uint32_t begin,uint32_t end){
+	for(uint32_t i = begin; i < end; ++i){
+		if((dirty_[i] & kLocalDirty) != 0){
+			local_[i] = ComposeAffineMatrix({scaleX_[i], scaleY_[i], scaleZ_[i]},{rotationX_[i], rotationY_[i], rotationZ_[i]},
+			                                {translationX_[i], translationY_[i], translationZ_[i]});
+		}
+	}
+}
+
+void TransformHierarchy::ComposeLocalSimd(uint32_t begin,uint32_t end){
+	const AffineComponents components = {
+	    scaleX_.data(),
+	    scaleY_.data(),
+	    scaleZ_.data(),
+	    rotationX_.data(),
+	    rotationY_.data(),
+	    rotationZ_.data(),
+	    translationX_.data(),
+	    translationY_.data(),
+	    translationZ_.data(),
+	};
+	uint32_t i = begin;
+	for(; i + 4 <= end; i += 4){
+		// 4 個とも変わっていなければ飛ばす (変わっていない物を作り直しても同じ値になるので、1 個でも変わっていれば 4 個作る)
+		uint32_t flags;
+		std::memcpy(&flags,&dirty_[i],sizeof(flags));
+		if((flags & 0x01010101u * kLocalDirty) != 0){
+			ComposeAffineMatrices(components,i,4,&local_[i]);
+		}
+	}
+	// 4 個に満たない残り
+	ComposeLocalScalar(i,end);
+}
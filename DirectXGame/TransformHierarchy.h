@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+#include <vector>
+
+using namespace KamataEngine;
+
+// ==========================================
+// トランスフォームの親子関係をまとめて持つ入れ物
+// ・スケール・回転・平行移動は成分ごとの配列、行列は行列だけの配列に持つ
+// ・並びは親が必ず子より前 (深さ順)。先頭から1回なめるだけで全てのワールド行列が決まる
+// ・値を変えたものには印を付け、Update でその子孫も含めて作り直す (変わっていない物は触らない)
+// ・ローカル行列は SimdMath で 4 個ずつ作る (掛け方は MakeAffineMatrix と同じ S * Rz * Rx * Ry * T)
+// ・ワールド行列は ローカル * 親のワールド (WorldTransform の parent_ と同じ向き)
+// ・D3D を使わないので AssetCooker でも動く。GPU への転送は使う側で行う
+// ==========================================
+class TransformHierarchy{
+public:
+	using Handle = uint32_t;
+	static inline const Handle kNone = UINT32_MAX;
+
+	enum class Path{
+		kSimd,   // SimdMath の 4 個ずつの計算 (SSE2 が使えない環境ではスカラーと同じ)
+		kScalar, // 1個ずつ (結果を比べる時用)
+	};
+
+	// parent の子として作る (parent は作成済みのもの)
+	Handle Create(Handle parent = kNone,const Vector3& scale = {1.0f, 1.0f, 1.0f},const Vector3& rotation = {},const Vector3& translation = {});
+	// 子孫もまとめて消す (並びを詰め直すので、たくさん消す時は Clear の方が速い)
+	void Destroy(Handle handle);
+	void Clear();
+
+	// 親を付け替える (自分の子孫は親にできない)。次の Update で並べ直す
+	void SetParent(Handle handle,Handle parent);
+	Handle GetParent(Handle handle) const;
+
+	void SetScale(Handle handle,const Vector3& scale);
+	void SetRotation(Handle handle,const Vector3& rotation);
+	void SetTranslation(Handle handle,const Vector3& translation);
+	Vector3 GetScale(Handle handle) const;
+	Vector3 GetRotation(Handle handle) const;
+	Vector3 GetTranslation(Handle handle) const;
+
+	// 値を変えたものとその子孫の行列を作り直す
+	void Update(Path path = Path::kSimd);
+
+	// Update 後のワールド行列
+	const Matrix4x4& GetWorldMatrix(Handle handle) const{ return world_[handleToIndex_[handle]]; }
+
+	uint32_t GetCount() const{ return static_cast<uint32_t>(handle_.size()); }
+	// 直前の Update で作り直したワールド行列の数
+	uint32_t GetUpdatedCount() const{ return updatedCount_; }
+
+private:
+	enum DirtyFlag : uint8_t{
+		kLocalDirty = 1, // 自分の値が変わった (ローカル行列から作り直す)
+		kWorldDirty = 2, // 祖先が変わった (親との掛け算だけやり直す)
+	};
+
+	uint32_t GetIndex(Handle handle) const;
+	void MarkLocalDirty(uint32_t index);
+	// 深さ順に並べ直す
+	void Reorder();
+	// 並びを order の通りに入れ替える
+	void Permute(const std::vector<uint32_t>& order);
+	void ComposeLocalScalar(uint32_t begin,uint32_t end);
+	void ComposeLocalSimd(uint32_t begin,uint32_t end);
+
+	// 成分ごとの配列 (添字は並びの番号。4 の倍数まで余りを持つ)
+	std::vector<float> scaleX_, scaleY_, scaleZ_;
+	std::vector<float> rotationX_, rotationY_, rotationZ_;
+	std::vector<float> translationX_, translationY_, translationZ_;
+	std::vector<int32_t> parent_; // 親の並びの番号 (親がなければ -1)
+	std::vector<uint8_t> dirty_;
+	std::vector<Handle> handle_;
+	std::vector<Matrix4x4> local_;
+	std::vector<Matrix4x4> world_;
+
+	// ハンドル -> 並びの番号 (消したものは kNone)
+	std::vector<uint32_t> handleToIndex_;
+	std::vector<Handle> freeHandles_;
+
+	bool isOrderDirty_ = false;
+	uint32_t updatedCount_ = 0;
+};
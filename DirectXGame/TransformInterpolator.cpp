@@ -0,0 +1,100 @@
+#include "TransformInterpolator.h"
+#include "Math.h"
+
+TransformInterpolator* TransformInterpolator::GetInstance(){
+	static TransformInterpolator instance;
+	return &instance;
+}
+
+void TransformInterpolator::Register(WorldTransform* worldTransform){
+	// 登録した瞬間は前回＝今回 (原点から飛んでくるのを防ぐ)
+	entries_.push_back({worldTransform, worldTransform->scale_, worldTransform->rotation_, worldTransform->translation_, {}});
+}
+
+void TransformInterpolator::Unregister(WorldTransform* worldTransform){
+	for(size_t i = 0; i < entries_.size(); ++i){
+		if(entries_[i].worldTransform == worldTransform){
+			// 順序は不要なので末尾と入れ替えて削除
+			entries_[i] = entries_.back();
+			entries_.pop_back();
+			return;
+		}
+	}
+}
+
+void TransformInterpolator::RegisterCamera(Camera* camera){
+	cameraEntries_.push_back({camera, camera->rotation_, camera->translation_, camera->rotation_, camera->translation_});
+}
+
+void TransformInterpolator::UnregisterCamera(Camera* camera){
+	for(size_t i = 0; i < cameraEntries_.size(); ++i){
+		if(cameraEntries_[i].camera == camera){
+			cameraEntries_[i] = cameraEntries_.back();
+			cameraEntries_.pop_back();
+			return;
+		}
+	}
+}
+
+void TransformInterpolator::SaveState(){
+	for(Entry& entry : entries_){
+		entry.prevScale = entry.worldTransform->scale_;
+		entry.prevRotation = entry.worldTransform->rotation_;
+		entry.prevTranslation = entry.worldTransform->translation_;
+	}
+	for(CameraEntry& entry : cameraEntries_){
+		entry.prevRotation = entry.camera->rotation_;
+		entry.prevTranslation = entry.camera->translation_;
+	}
+}
+
+void TransformInterpolator::Snap(){
+	// 前回＝今回にするだけなので、保存と同じ処理でよい
+	SaveState();
+}
+
+void TransformInterpolator::Interpolate(float alpha){
+	alpha_ = alpha;
+
+	for(Entry& entry : entries_){
+		WorldTransform& worldTransform = *entry.worldTransform;
+		Vector3 scale = Lerp(entry.prevScale,worldTransform.scale_,alpha);
+		Vector3 rotation = Lerp(entry.prevRotation,worldTransform.rotation_,alpha);
+		Vector3 translation = Lerp(entry.prevTranslation,worldTransform.translation_,alpha);
+		if(!entry.tracker.Update(scale,rotation,translation)){
+			continue; // 止まっている (GPU には同じ行列が入っている)
+		}
+		worldTransform.matWorld_ = MakeAffineMatrix(scale,rotation,translation);
+		worldTransform.TransferMatrix();
+	}
+
+	for(CameraEntry& entry : cameraEntries_){
+		Camera& camera = *entry.camera;
+		// シミュレーション側の値を退避してから補間値で行列を作る
+		entry.rotation = camera.rotation_;
+		entry.translation = camera.translation_;
+		camera.rotation_ = Lerp(entry.prevRotation,entry.rotation,alpha);
+		camera.translation_ = Lerp(entry.prevTranslation,entry.translation,alpha);
+		camera.UpdateMatrix();
+	}
+
+	isInterpolated_ = true;
+}
+
+void TransformInterpolator::Restore(){
+	if(!isInterpolated_){
+		return;
+	}
+
+	// GPUはPostDrawで完了しているので、転送はせずCPU側の行列だけ戻す
+	for(Entry& entry : entries_){
+		WorldTransform& worldTransform = *entry.worldTransform;
+		worldTransform.matWorld_ = MakeAffineMatrix(worldTransform.scale_,worldTransform.rotation_,worldTransform.translation_);
+	}
+	for(CameraEntry& entry : cameraEntries_){
+		entry.camera->rotation_ = entry.rotation;
+		entry.camera->translation_ = entry.translation;
+	}
+
+	isInterpolated_ = false;
+}
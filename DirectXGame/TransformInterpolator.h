@@ -0,0 +1,61 @@
+#pragma once
+#include "KamataEngine.h"
+#include "TransformChangeTracker.h"
+#include <vector>
+
+using namespace KamataEngine;
+
+// ==========================================
+// 描画用トランスフォーム補間
+// 直前2ティックの状態を補間して、更新レートより高いフレームレートで滑らかに描画する
+// ==========================================
+class TransformInterpolator{
+public:
+	static TransformInterpolator* GetInstance();
+
+	// 補間対象の登録・解除 (オブジェクトの初期化・破棄時に呼ぶ)
+	void Register(WorldTransform* worldTransform);
+	void Unregister(WorldTransform* worldTransform);
+	void RegisterCamera(Camera* camera);
+	void UnregisterCamera(Camera* camera);
+
+	// ティック開始前に現在の状態を「前回の状態」として保存
+	void SaveState();
+
+	// 今の状態を「前回の状態」にも入れ直す (ティック中にワープさせたとき用。前の位置から補間で滑ってこない)
+	void Snap();
+
+	// 描画前: 前回と今回の状態を補間して行列を転送 (補間した値が前回送ったものと同じなら送らない)
+	// 登録したトランスフォームの転送はここで行うので、更新側は行列を作るだけでよい
+	void Interpolate(float alpha);
+
+	// 描画後: 行列をシミュレーション側の値に戻す
+	void Restore();
+
+	// 今回の描画で使っている補間係数 (解析的に位置を求めるオブジェクト用)
+	float GetAlpha() const{ return alpha_; }
+
+private:
+	TransformInterpolator() = default;
+
+	struct Entry{
+		WorldTransform* worldTransform;
+		Vector3 prevScale;
+		Vector3 prevRotation;
+		Vector3 prevTranslation;
+		TransformChangeTracker tracker;
+	};
+
+	struct CameraEntry{
+		Camera* camera;
+		Vector3 prevRotation;
+		Vector3 prevTranslation;
+		Vector3 rotation;
+		Vector3 translation;
+	};
+
+	std::vector<Entry> entries_;
+	std::vector<CameraEntry> cameraEntries_;
+	bool isInterpolated_ = false;
+	float alpha_ = 1.0f;
+};
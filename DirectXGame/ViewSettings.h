@@ -0,0 +1,18 @@
+#pragma once
+#include <math/Vector3.h>
+
+// ==========================================
+// ゲーム中の見え方の既定値
+// CameraController と MeshModel が使い、AssetCooker lod は同じ値でゲーム中に描かれる三角形を見積もる
+// (D3D を使わないので AssetCooker からも読める)
+// ==========================================
+struct ViewSettings{
+	// 追従対象から見たカメラの位置 (敵・ビーム・エフェクトはほぼこの距離で描かれる)
+	static inline const KamataEngine::Vector3 kCameraTargetOffset = {0.0f, 0.0f, -15.0f};
+
+	// LOD を選ぶ時に許す画面上のずれ (ピクセル)
+	static inline const float kLodErrorThreshold = 1.0f;
+	// エフェクト用の球 (ビーム・ボスのパーティクル・壁のヒット・ヒットエフェクト) に許すずれ
+	// 小さく、速く動き、すぐ消えるので粗くてよい (ビームの大きさ 0.5 でも 60 三角形の段まで落ちる値)
+	static inline const float kEffectLodErrorThreshold = 8.0f;
+};
@@ -0,0 +1,93 @@
+#include "VirtualFileSystem.h"
+#include "Lz4.h"
+#include <fstream>
+
+void FileView::Close(){
+	data_ = nullptr;
+	size_ = 0;
+	file_.reset();
+	buffer_.clear();
+	buffer_.shrink_to_fit();
+}
+
+VirtualFileSystem* VirtualFileSystem::GetInstance(){
+	static VirtualFileSystem instance;
+	return &instance;
+}
+
+bool VirtualFileSystem::Mount(const std::string& packPath){
+	if(!pack_.Open(packPath)){
+		return false;
+	}
+	pack_.Prefetch();
+	return true;
+}
+
+void VirtualFileSystem::Unmount(){
+	pack_.Close();
+}
+
+bool VirtualFileSystem::IsPacked(const std::string& path) const{
+	PackFile::Item item;
+	return pack_.IsOpen() && pack_.Find(path,item);
+}
+
+bool VirtualFileSystem::Open(const std::string& path,FileView& view){
+	view.Close();
+	Trace(path);
+
+	PackFile::Item item;
+	if(pack_.IsOpen() && pack_.Find(path,item)){
+		if(!item.isCompressed){
+			view.data_ = item.stored.data();
+			view.size_ = item.stored.size();
+			++packedOpenCount_;
+			return true;
+		}
+		view.buffer_.resize(static_cast<size_t>(item.size));
+		if(!Lz4::Decompress(item.stored,view.buffer_)){
+			view.Close();
+			return false;
+		}
+		view.data_ = view.buffer_.data();
+		view.size_ = view.buffer_.size();
+		++unpackedOpenCount_;
+		return true;
+	}
+
+	view.file_ = std::make_unique<MappedFile>();
+	if(!view.file_->Open(path)){
+		view.Close();
+		return false;
+	}
+	view.data_ = view.file_->GetData();
+	view.size_ = view.file_->GetSize();
+	++looseOpenCount_;
+	return true;
+}
+
+void VirtualFileSystem::StartTrace(){
+	std::lock_guard<std::mutex> lock(traceMutex_);
+	isTracing_ = true;
+	trace_.clear();
+	traced_.clear();
+}
+
+bool VirtualFileSystem::SaveTrace(const std::string& path){
+	std::lock_guard<std::mutex> lock(traceMutex_);
+	std::ofstream file(path,std::ios::trunc);
+	if(!file.is_open()){
+		return false;
+	}
+	for(const std::string& tracedPath : trace_){
+		file << tracedPath << '\n';
+	}
+	return file.good();
+}
+
+void VirtualFileSystem::Trace(const std::string& path){
+	std::lock_guard<std::mutex> lock(traceMutex_);
+	if(isTracing_ && traced_.insert(PackFile::NormalizePath(path)).second){
+		trace_.push_back(path);
+	}
+}
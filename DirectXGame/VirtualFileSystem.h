@@ -0,0 +1,86 @@
+#pragma once
+#include "MappedFile.h"
+#include "PackFile.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// ==========================================
+// 開いたファイルの中身 (読み取り専用)
+// パックの圧縮していないエントリならパックのマップをそのまま指す (写さない)
+// 圧縮したエントリなら展開したもの、パックに無ければそのファイルをマップしたものを持つ
+// ==========================================
+class FileView{
+public:
+	FileView() = default;
+	FileView(const FileView&) = delete;
+	FileView& operator=(const FileView&) = delete;
+
+	void Close();
+
+	bool IsOpen() const{ return data_ != nullptr; }
+	const std::byte* GetData() const{ return data_; }
+	size_t GetSize() const{ return size_; }
+
+private:
+	friend class VirtualFileSystem;
+
+	const std::byte* data_ = nullptr;
+	size_t size_ = 0;
+	std::unique_ptr<MappedFile> file_; // パックに無かったもの
+	std::vector<std::byte> buffer_;    // 展開したもの
+};
+
+// ==========================================
+// ゲームのファイル読み込みの窓口
+// ・パックを Mount していれば、まずパックから探す (無ければ Resources/ のファイルを読む)
+// ・StartTrace の後は、初めて開いたファイルを順に記録する
+//   (SaveTrace で書き出したものを AssetCooker pack が読み、パックの並びに使う)
+// パスは作業フォルダからの相対 ("Resources/player/player.obj")。複数スレッドから呼んでよい
+// テクスチャと音声はエンジンがパスを受け取って自分で読むので、ここを通らない
+// ==========================================
+class VirtualFileSystem{
+public:
+	static VirtualFileSystem* GetInstance();
+
+	// 目次と記録順の区間を先読みさせる。ファイルが無ければ false (そのままファイルから読む)
+	bool Mount(const std::string& packPath);
+	void Unmount();
+	bool IsMounted() const{ return pack_.IsOpen(); }
+	// パックに入っているか (入っていれば、クック済みかどうかを時刻で比べずにそのまま使う)
+	bool IsPacked(const std::string& path) const;
+
+	bool Open(const std::string& path,FileView& view);
+
+	void StartTrace();
+	bool SaveTrace(const std::string& path);
+
+	// --- 統計 ---
+	uint32_t GetPackedOpenCount() const{ return packedOpenCount_; }   // パックをそのまま渡した数
+	uint32_t GetUnpackedOpenCount() const{ return unpackedOpenCount_; } // 展開して渡した数
+	uint32_t GetLooseOpenCount() const{ return looseOpenCount_; }       // パックに無くファイルを開いた数
+
+private:
+	VirtualFileSystem() = default;
+	~VirtualFileSystem() = default;
+	VirtualFileSystem(const VirtualFileSystem&) = delete;
+	VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+	void Trace(const std::string& path);
+
+	PackFile pack_;
+
+	std::mutex traceMutex_;
+	bool isTracing_ = false;
+	std::vector<std::string> trace_;
+	std::unordered_set<std::string> traced_;
+
+	std::atomic<uint32_t> packedOpenCount_ = 0;
+	std::atomic<uint32_t> unpackedOpenCount_ = 0;
+	std::atomic<uint32_t> looseOpenCount_ = 0;
+};
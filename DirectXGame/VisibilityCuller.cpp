@@ -0,0 +1,165 @@
+#include "VisibilityCuller.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define VISIBILITY_CULLER_SSE2
+#endif
+
+namespace{
+
+// 4個ずつ読むので、最後の形の後ろに 3 個分の余りを置く
+const uint32_t kPadding = 3;
+
+#ifdef VISIBILITY_CULLER_SSE2
+// 外側のレーンのビット (movemask) から、4 個分の見えるフラグ (1 バイトずつ) を引く表
+constexpr std::array<uint32_t,16> MakeVisibleFlags(){
+	std::array<uint32_t,16> table = {};
+	for(uint32_t mask = 0; mask < 16; ++mask){
+		for(uint32_t lane = 0; lane < 4; ++lane){
+			if((mask >> lane & 1) == 0){
+				table[mask] |= 1u << (lane * 8);
+			}
+		}
+	}
+	return table;
+}
+constexpr std::array<uint32_t,16> kVisibleFlags = MakeVisibleFlags();
+#endif
+
+} // namespace
+
+void VisibilityCuller::Begin(const Frustum& frustum){
+	frustum_ = frustum;
+	count_ = 0;
+	culledEnd_ = 0;
+	visible_.clear();
+}
+
+uint32_t VisibilityCuller::AddSphere(const Vector3& center,float radius){
+	return Add(center,{0.0f, 0.0f, 0.0f},radius);
+}
+
+uint32_t VisibilityCuller::AddBox(const Vector3& center,const Vector3& extent){
+	return Add(center,extent,0.0f);
+}
+
+uint32_t VisibilityCuller::Add(const Vector3& center,const Vector3& extent,float radius){
+	if(centerX_.size() < count_ + 1 + kPadding){
+		size_t size = std::max<size_t>(centerX_.size() * 2,count_ + 1 + kPadding);
+		for(std::vector<float>* values : {&centerX_, &centerY_, &centerZ_, &extentX_, &extentY_, &extentZ_, &radius_}){
+			values->resize(size,0.0f);
+		}
+		visibleFlags_.resize(size,0);
+	}
+	uint32_t index = count_++;
+	centerX_[index] = center.x;
+	centerY_[index] = center.y;
+	centerZ_[index] = center.z;
+	extentX_[index] = extent.x;
+	extentY_[index] = extent.y;
+	extentZ_[index] = extent.z;
+	radius_[index] = radius;
+	return index;
+}
+
+void VisibilityCuller::Cull(Path path){
+	if(culledEnd_ == count_){
+		return;
+	}
+#ifdef VISIBILITY_CULLER_SSE2
+	if(path == Path::kSimd){
+		CullSimd(culledEnd_,count_);
+	}
+	else{
+		CullScalar(culledEnd_,count_);
+	}
+#else
+	(void)path;
+	CullScalar(culledEnd_,count_);
+#endif
+	// 見えるものの番号を詰める (見える・見えないは半々になりやすいので、分岐せずに書いて進める数だけ変える)
+	size_t base = visible_.size();
+	visible_.resize(base + (count_ - culledEnd_));
+	uint32_t* out = visible_.data() + base;
+	size_t visibleCount = 0;
+	for(uint32_t i = culledEnd_; i < count_; ++i){
+		out[visibleCount] = i;
+		visibleCount += visibleFlags_[i];
+	}
+	visible_.resize(base + visibleCount);
+	culledEnd_ = count_;
+}
+
+void VisibilityCuller::CullScalar(uint32_t begin,uint32_t end){
+	for(uint32_t i = begin; i < end; ++i){
+		bool isOutside = false;
+		for(size_t p = 0; p < Frustum::kPlaneCount; ++p){
+			const Frustum::Plane& plane = frustum_.GetPlane(p);
+			// SIMD 版と同じ順に足す (丸めまで同じ結果にする)
+			float distance = plane.normal.x * centerX_[i] + plane.normal.y * centerY_[i] + plane.normal.z * centerZ_[i] + plane.distance;
+			float reach = radius_[i] + (std::abs(plane.normal.x) * extentX_[i] + std::abs(plane.normal.y) * extentY_[i] + std::abs(plane.normal.z) * extentZ_[i]);
+			isOutside |= distance < -reach;
+		}
+		visibleFlags_[i] = isOutside ? 0 : 1;
+	}
+}
+
+#ifdef VISIBILITY_CULLER_SSE2
+void VisibilityCuller::CullSimd(uint32_t begin,uint32_t end){
+	// 面の成分を 4 つ並べておく
+	struct PlaneLanes{
+		__m128 normalX;
+		__m128 normalY;
+		__m128 normalZ;
+		__m128 absX;
+		__m128 absY;
+		__m128 absZ;
+		__m128 distance;
+	};
+	PlaneLanes planes[Frustum::kPlaneCount];
+	for(size_t p = 0; p < Frustum::kPlaneCount; ++p){
+		const Frustum::Plane& plane = frustum_.GetPlane(p);
+		planes[p] = {
+		    _mm_set1_ps(plane.normal.x),
+		    _mm_set1_ps(plane.normal.y),
+		    _mm_set1_ps(plane.normal.z),
+		    _mm_set1_ps(std::abs(plane.normal.x)),
+		    _mm_set1_ps(std::abs(plane.normal.y)),
+		    _mm_set1_ps(std::abs(plane.normal.z)),
+		    _mm_set1_ps(plane.distance),
+		};
+	}
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+
+	for(uint32_t i = begin; i < end; i += 4){
+		__m128 centerX = _mm_loadu_ps(&centerX_[i]);
+		__m128 centerY = _mm_loadu_ps(&centerY_[i]);
+		__m128 centerZ = _mm_loadu_ps(&centerZ_[i]);
+		__m128 extentX = _mm_loadu_ps(&extentX_[i]);
+		__m128 extentY = _mm_loadu_ps(&extentY_[i]);
+		__m128 extentZ = _mm_loadu_ps(&extentZ_[i]);
+		__m128 radius = _mm_loadu_ps(&radius_[i]);
+
+		__m128 isOutside = _mm_setzero_ps();
+		for(const PlaneLanes& plane : planes){
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.normalX,centerX),_mm_mul_ps(plane.normalY,centerY)),_mm_mul_ps(plane.normalZ,centerZ)),
+			                             plane.distance);
+			__m128 reach = _mm_add_ps(radius,_mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.absX,extentX),_mm_mul_ps(plane.absY,extentY)),_mm_mul_ps(plane.absZ,extentZ)));
+			isOutside = _mm_or_ps(isOutside,_mm_cmplt_ps(distance,_mm_xor_ps(reach,signBit)));
+		}
+
+		// 4 個分の 0 / 1 をまとめて書く (end より後ろは余りの所。次の Cull で書き直される)
+		int mask = _mm_movemask_ps(isOutside);
+		uint32_t flags = kVisibleFlags[mask];
+		std::memcpy(&visibleFlags_[i],&flags,sizeof(flags));
+	}
+}
+#else
+void VisibilityCuller::CullSimd(uint32_t begin,uint32_t end){
+	CullScalar(begin,end);
+}
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#include "Frustum.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ==========================================
+// 描く物の見える・見えないをまとめて判定する
+// ・Begin で視錐台を決め、AddSphere / AddBox で囲む形を積み、Cull でまとめて判定する
+// ・形は成分ごとの配列 (x だけ、y だけ…) に持ち、4個ずつ SIMD で 6 枚の面と比べる
+//   球は 半径、箱は 各軸の半分の大きさ を持ち、どちらも同じ式で判定する
+//   (面までの距離 < -(半径 + |nx| ex + |ny| ey + |nz| ez) なら外)
+// ・見えるものの番号は積んだ順に詰めて返す
+// ・D3D を使わないので AssetCooker でも動く
+// ==========================================
+class VisibilityCuller{
+public:
+	enum class Path{
+		kSimd,   // SSE2 (使えない環境ではスカラーと同じ)
+		kScalar, // 1個ずつ (結果を比べる時用)
+	};
+
+	// 積んだ形を捨てて視錐台を差し替える (配列の大きさは残す)
+	void Begin(const Frustum& frustum);
+
+	// 形を積んで番号を返す (Begin からの通し番号)
+	uint32_t AddSphere(const Vector3& center,float radius);
+	uint32_t AddBox(const Vector3& center,const Vector3& extent);
+
+	// 前回の Cull より後に積んだ形を判定する
+	// (種類ごとに 積む → Cull → 見えるものだけ描く を繰り返してよい)
+	void Cull(Path path = Path::kSimd);
+
+	bool IsVisible(uint32_t index) const{ return visibleFlags_[index] != 0; }
+	// 見える形の番号 (小さい順)
+	std::span<const uint32_t> GetVisible() const{ return visible_; }
+
+	// Begin からの数
+	uint32_t GetTestedCount() const{ return culledEnd_; }
+	uint32_t GetVisibleCount() const{ return static_cast<uint32_t>(visible_.size()); }
+	uint32_t GetCulledCount() const{ return GetTestedCount() - GetVisibleCount(); }
+
+private:
+	uint32_t Add(const Vector3& center,const Vector3& extent,float radius);
+	void CullScalar(uint32_t begin,uint32_t end);
+	void CullSimd(uint32_t begin,uint32_t end);
+
+	Frustum frustum_;
+	uint32_t count_ = 0;
+	// [0, culledEnd_) は判定済み
+	uint32_t culledEnd_ = 0;
+
+	// 形 (成分ごと。4 の倍数まで 0 で埋めて確保する)
+	std::vector<float> centerX_;
+	std::vector<float> centerY_;
+	std::vector<float> centerZ_;
+	std::vector<float> extentX_;
+	std::vector<float> extentY_;
+	std::vector<float> extentZ_;
+	std::vector<float> radius_;
+
+	std::vector<uint8_t> visibleFlags_;
+	std::vector<uint32_t> visible_;
+};
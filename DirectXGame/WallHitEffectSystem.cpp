@@ -1,7 +1,7 @@
 #include "WallHitEffectSystem.h"
 #include"Math.h"
 
-void WallHitEffectSystem::Initialize(Model* model){
+void WallHitEffectSystem::Initialize(const ModelHandle& model){
 	model_ = model;
 }
 
@@ -36,10 +36,37 @@ void WallHitEffectSystem::Update(float deltaTime){
 	}
 }
 
-void WallHitEffectSystem::Draw(Camera* camera){
-	// シンプルに描画のみ行う
+void WallHitEffectSystem::Clear(){
 	for(WallHitParticle* p : particles_){
-		model_->Draw(p->worldTransform,*camera,&p->objectColor);
+		delete p;
+	}
+	particles_.clear();
+}
+
+void WallHitEffectSystem::ReleaseModel(){
+	Clear();
+	model_.Reset();
+}
+
+void WallHitEffectSystem::Draw(Camera* camera,VisibilityCuller& culler){
+	MeshModel* model = model_.Get();
+	if(!model) return;
+
+	// 画面に入る粒だけ描く
+	uint32_t first = culler.GetTestedCount();
+	for(WallHitParticle* p : particles_){
+		Vector3 center;
+		float radius;
+		model->GetWorldBoundingSphere(p->worldTransform.matWorld_,center,radius);
+		culler.AddSphere(center,radius);
+	}
+	culler.Cull();
+
+	uint32_t index = first;
+	for(WallHitParticle* p : particles_){
+		if(culler.IsVisible(index++)){
+			model->Draw(p->worldTransform,*camera,&p->objectColor);
+		}
 	}
 }
 
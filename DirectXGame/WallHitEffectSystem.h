@@ -1,5 +1,6 @@
 #pragma once
 #include "KamataEngine.h"
+#include "AssetCache.h"
 #include "ParticleManager.h" // EffectSystemBaseを使うために必要ならインクルード
 #include <list>
 
@@ -17,17 +18,23 @@ struct WallHitParticle{
 class WallHitEffectSystem : public EffectSystemBase{
 public:
 	// EffectSystemBaseの仮想関数に合わせる必要があるため override を推奨
-	void Initialize(Model* model); // 必要に応じて引数調整
+	// (ハンドルを持つので、このシステムが使っている間はキャッシュに捨てられない)
+	void Initialize(const ModelHandle& model);
 
 	// ★修正: Updateに (float deltaTime) を追加
 	void Update(float deltaTime) override;
 
-	void Draw(Camera* camera) override;
+	void Draw(Camera* camera,VisibilityCuller& culler) override;
 
 	// 発生させる関数
 	void Spawn(const Vector3& position);
 
+	// 全て消す (リトライ用)
+	void Clear();
+	// 粒を消してモデルの参照を外す (シーンの終わりに呼ぶ)
+	void ReleaseModel();
+
 private:
 	std::list<WallHitParticle*> particles_;
-	Model* model_ = nullptr;
+	ModelHandle model_;
 };
\ No newline at end of file
@@ -1,20 +1,29 @@
 #include "endScene.h"
+#include "FixedTimestep.h"
 #include "Math.h"
 #include <numbers>
 
 EndScene::~EndScene(){
-	delete modelPlayer_;
-	delete modelTitle_;
 	delete fade_;
 	if(Audio::GetInstance()->IsPlaying(bgmHandle_)){
 		Audio::GetInstance()->StopWave(bgmHandle_);
 	}
 }
 
+std::vector<AssetRef> EndScene::PreloadAssets(){
+	AssetCache* assetCache = AssetCache::GetInstance();
+	return {
+	    assetCache->LoadModelAsync("endFont",true),
+	    assetCache->LoadModelAsync("player"),
+	    assetCache->LoadSoundAsync("BGM/endScene.wav"),
+	    assetCache->LoadSoundAsync("SE/enter.wav"),
+	};
+}
+
 void EndScene::Initialize(){
 
-	modelTitle_ = Model::CreateFromOBJ("endFont",true);
-	modelPlayer_ = Model::CreateFromOBJ("player");
+	modelTitle_ = AssetCache::GetInstance()->LoadModel("endFont",true);
+	modelPlayer_ = AssetCache::GetInstance()->LoadModel("player");
 
 	// カメラ初期化
 	camera_.Initialize();
@@ -42,8 +51,8 @@ void EndScene::Initialize(){
 
 	fade_->Start(Fade::Status::FadeIn,1.0f);
 
-	bgmDataHandle_ = Audio::GetInstance()->LoadWave("BGM/endScene.wav");
-	seDataHandle_ = Audio::GetInstance()->LoadWave("SE/enter.wav");
+	bgmDataHandle_ = AssetCache::GetInstance()->LoadSound("BGM/endScene.wav");
+	seDataHandle_ = AssetCache::GetInstance()->LoadSound("SE/enter.wav");
 
 }
 
@@ -73,7 +82,7 @@ void EndScene::Update(){
 		break;
 	}
 
-	counter_ += 1.0f / 60.0f;
+	counter_ += FixedTimestep::kDeltaTime;
 	counter_ = std::fmod(counter_,kTimeTitleMove);
 
 	float angle = counter_ / kTimeTitleMove * 2.0f * std::numbers::pi_v<float>;
@@ -86,7 +95,7 @@ void EndScene::Update(){
 	WorldTransformUpdate(worldTransformTitle_);
 
 	// アフィン変換～DirectXに転送（プレイヤー座標）
-	WorldTransformUpdate(worldTransformPlayer_);
+	WorldTransformUpdate(worldTransformPlayer_,playerTransformTracker_);
 }
 
 void EndScene::Draw(){
@@ -107,14 +116,14 @@ void EndScene::Draw(){
 
 void EndScene::PlayBgm(){
 	if(!isPlayBgm_){
-		bgmHandle_ = Audio::GetInstance()->PlayWave(bgmDataHandle_,true,0.2f);
+		bgmHandle_ = Audio::GetInstance()->PlayWave(bgmDataHandle_.Get(),true,0.2f);
 		isPlayBgm_ = true;
 	}
 }
 
 void EndScene::PlaySe(){
 	if(!isPlaySe_){
-		seHandle_ = Audio::GetInstance()->PlayWave(seDataHandle_,false,0.3f);
+		seHandle_ = Audio::GetInstance()->PlayWave(seDataHandle_.Get(),false,0.3f);
 		isPlaySe_ = true;
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
+#include "AssetCache.h"
 #include "Fade.h"
 #include "KamataEngine.h"
+#include "TransformChangeTracker.h"
 
 using namespace KamataEngine;
 
@@ -14,6 +16,10 @@ public:
 
 	~EndScene();
 
+	// このシーンで使うアセットの読み込みをワーカーで先に始めておく
+	// 返したハンドルは Initialize が終わるまで持っておく (参照が無いと予算を超えた時に捨てられる)
+	static std::vector<AssetRef> PreloadAssets();
+
 	void Initialize();
 
 	void Update();
@@ -31,9 +37,10 @@ private:
 	Camera camera_;
 	WorldTransform worldTransformTitle_;
 	WorldTransform worldTransformPlayer_;
+	TransformChangeTracker playerTransformTracker_; // プレイヤーは動かないので転送は最初の1回だけ
 
-	Model* modelPlayer_ = nullptr;
-	Model* modelTitle_ = nullptr;
+	ModelHandle modelPlayer_;
+	ModelHandle modelTitle_;
 
 	float counter_ = 0.0f;
 	bool finished_ = false;
@@ -42,11 +49,11 @@ private:
 
 	Phase phase_ = Phase::kFadeIn;
 
-	uint32_t bgmDataHandle_;
+	SoundHandle bgmDataHandle_;
 	uint32_t bgmHandle_;
 	bool isPlayBgm_ = false;
 
-	uint32_t seDataHandle_;
+	SoundHandle seDataHandle_;
 	uint32_t seHandle_;
 	bool isPlaySe_ = false;
 
@@ -5,6 +5,17 @@
 #include "endScene.h"
 #include <Windows.h>
 #include "ParticleManager.h"
+#include "FixedTimestep.h"
+#include "TransformInterpolator.h"
+#include "AssetCache.h"
+#include "JobSystem.h"
+#include "MeshModel.h"
+#include "VirtualFileSystem.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 using namespace KamataEngine;
 
@@ -13,6 +24,9 @@ RuleScene* ruleScene = nullptr;
 GameScene* gameScene = nullptr;
 EndScene* endScene = nullptr;
 
+// 次のシーンのために先読みしているアセット (そのシーンの Initialize が自分のハンドルを取るまで参照を持っておく)
+std::vector<AssetRef> preloadedAssets;
+
 
 enum class Scene {
 	kUnknown = 0,
@@ -35,6 +49,9 @@ void ChangeScene() {
 			titleScene = nullptr;
 			ruleScene = new RuleScene;
 			ruleScene->Initialize();
+			// ルール画面を出している間にゲームシーンのアセットを読んでおく
+			preloadedAssets = GameScene::PreloadAssets();
+			AssetCache::GetInstance()->Report("title -> rule");
 		}
 		break;
 
@@ -46,6 +63,10 @@ void ChangeScene() {
 			ruleScene = nullptr;
 			gameScene = new GameScene;
 			gameScene->Initialize();
+			// 一番重いエンディングの文字モデルはプレイ中に読んでおく
+			// (ゲームシーンの分はもう GameScene が持っているので入れ替えてよい)
+			preloadedAssets = EndScene::PreloadAssets();
+			AssetCache::GetInstance()->Report("rule -> game");
 		}
 		break;
 
@@ -58,21 +79,23 @@ void ChangeScene() {
 			// (GameScene.h に IsClear() を作っておく必要があります)
 			bool isGameClear = gameScene->IsClear();
 
-			// 2. 古いシーンを削除
-			delete gameScene;
-			gameScene = nullptr;
-
-			// 3. 結果によって行き先を変える
+			// 2. 結果によって行き先を変える
 			if(isGameClear){
+				// 古いシーンを削除
+				delete gameScene;
+				gameScene = nullptr;
+
 				// クリアした → エンディングへ
 				scene = Scene::kEnd;
 				endScene = new EndScene;
 				endScene->Initialize();
+				preloadedAssets.clear();
+				AssetCache::GetInstance()->Report("game -> end");
 			} else{
 				// 死んで終わった → もう一度ゲームシーンへ (リトライ)
+				// シーンは作り直さず、初期状態に戻すだけ
 				scene = Scene::kGame;
-				gameScene = new GameScene;
-				gameScene->Initialize();
+				gameScene->Reset();
 			}
 		}
 		break;
@@ -83,6 +106,7 @@ void ChangeScene() {
 			endScene = nullptr;
 			titleScene = new TitleScene;
 			titleScene->Initialize();
+			AssetCache::GetInstance()->Report("end -> title");
 		}
 
 		break;
@@ -123,8 +147,40 @@ void DrawScene() {
 	}
 }
 
+// コマンドラインの "-headless <ティック数>" を読む (無ければ 0)
+uint32_t ParseHeadlessTicks(const char* commandLine) {
+	const char* option = std::strstr(commandLine, "-headless");
+	if (!option) {
+		return 0;
+	}
+	return static_cast<uint32_t>(std::strtoul(option + std::strlen("-headless"), nullptr, 10));
+}
+
+// 描画せずに tickCount ティックだけ進める (実時間は待たない。早送りでの動作確認・計測用)
+// ウィンドウのメッセージと入力は毎ティック処理し、ワーカーが読み終えたアセットも毎ティック仕上げる
+// (ルール画面は読み込みが終わるまで進まないため)
+void RunHeadless(FixedTimestep& fixedTimestep, uint32_t tickCount) {
+	TransformInterpolator* transformInterpolator = TransformInterpolator::GetInstance();
+	auto start = std::chrono::steady_clock::now();
+	uint32_t tick = 0;
+	for (; tick < tickCount; ++tick) {
+		if (KamataEngine::Update()) {
+			break;
+		}
+		AssetCache::GetInstance()->Update();
+		fixedTimestep.AdvanceTick();
+		transformInterpolator->SaveState();
+		ChangeScene();
+		UpdateScene();
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::string message = "[Headless] " + std::to_string(tick) + " ticks (" + std::to_string(tick * FixedTimestep::kDeltaTime) + " s of game time) in " +
+	                      std::to_string(elapsed.count()) + " ms\n";
+	OutputDebugStringA(message.c_str());
+}
+
 // Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
+int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR commandLine, _In_ int) {
 
 	// エンジンの初期化
 	KamataEngine::Initialize(L"LE2C_03_アンドウ_カナデ_AL4");
@@ -142,12 +198,36 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 
 	ParticleManager::GetInstance()->Initialize();
 
+	// アセット読み込み用のワーカー
+	JobSystem::GetInstance()->Initialize();
+
+#ifdef _DEBUG
+	// 読み込んだ順を記録する (AssetCooker pack がこの順にパックへ並べる)
+	VirtualFileSystem::GetInstance()->StartTrace();
+#else
+	// パックがあれば、モデルとマップはそこから読む (無ければ Resources/ から)
+	VirtualFileSystem::GetInstance()->Mount("Resources.kpak");
+#endif
+
 	scene = Scene::kTitle;
 	titleScene = new TitleScene;
 	titleScene->Initialize();
+	// 読み込み回数とメモリ量はシーンを切り替えるたびにデバッグ出力へ書く (2周目以降は loads が増えないのが正しい)
+	AssetCache::GetInstance()->Report("start -> title");
+
+	// 固定タイムステップ (ゲームロジックは60Hz、描画は表示側のレートで回す)
+	FixedTimestep fixedTimestep;
+	fixedTimestep.Initialize();
+	TransformInterpolator* transformInterpolator = TransformInterpolator::GetInstance();
+
+	// -headless <ティック数> なら描画せずにその分だけ進めて終わる
+	uint32_t headlessTicks = ParseHeadlessTicks(commandLine);
+	if (headlessTicks > 0) {
+		RunHeadless(fixedTimestep, headlessTicks);
+	}
 
 	// メインループ
-	while (true) {
+	while (headlessTicks == 0) {
 		// エンジンの更新
 		if (KamataEngine::Update()) {
 			break;
@@ -156,10 +236,18 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		// ImGui受付開始
 		imguiManager->Begin();
 
-		// シーン切り替え
-		ChangeScene();
-		// シーン更新
-		UpdateScene();
+		// ワーカーが読み終えたアセットを GPU に送る
+		AssetCache::GetInstance()->Update();
+
+		// 溜まった時間の分だけ固定ステップで更新する
+		fixedTimestep.BeginFrame();
+		while (fixedTimestep.Step()) {
+			transformInterpolator->SaveState();
+			// シーン切り替え
+			ChangeScene();
+			// シーン更新
+			UpdateScene();
+		}
 
 		// ImGui受付終了
 		imguiManager->End();
@@ -167,7 +255,11 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		// 描画開始
 		dxCommon->PreDraw();
 
-		// シーンの描画
+		// 前回と今回のティックの間を補間
+		transformInterpolator->Interpolate(fixedTimestep.GetAlpha());
+
+		// シーンの描画 (LOD で減った三角形はフレームごとに数え直す)
+		MeshModel::ResetDrawCounts();
 		DrawScene();
 
 		// 軸表示の描画
@@ -182,11 +274,20 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 
 		// 描画終了
 		dxCommon->PostDraw();
+
+		// 補間した行列をシミュレーション側の値に戻す
+		transformInterpolator->Restore();
 	}
 
 	delete titleScene;
 	delete gameScene;
+	preloadedAssets.clear();
 	ParticleManager::GetInstance()->Shutdown();
+	JobSystem::GetInstance()->Shutdown();
+	AssetCache::GetInstance()->Shutdown();
+#ifdef _DEBUG
+	VirtualFileSystem::GetInstance()->SaveTrace("Resources/load_trace.txt");
+#endif
 
 	// エンジンの終了処理
 	KamataEngine::Finalize();
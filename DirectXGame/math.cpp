@@ -1,141 +1,46 @@
 #include "Math.h"
 #include <assert.h>
-#include <cmath>
-#include <numbers>
-
-// 単項演算子
-Vector3 operator+(const Vector3& v){ return v; }
-Vector3 operator-(const Vector3& v){ return Vector3(-v.x,-v.y,-v.z); }
-
-// 複合代入演算子 (*=, +=, -=, /=) を先に実装するのが一般的です
-// (これらを使って通常の演算子 +, * を実装するため)
-
-Vector3& operator*=(Vector3& v,float s){
-	v.x *= s;
-	v.y *= s;
-	v.z *= s;
-	return v;
-}
-
-Vector3& operator+=(Vector3& lhv,const Vector3& rhv){
-	lhv.x += rhv.x;
-	lhv.y += rhv.y;
-	lhv.z += rhv.z;
-	return lhv;
-}
-
-Vector3& operator-=(Vector3& lhv,const Vector3& rhv){
-	lhv.x -= rhv.x;
-	lhv.y -= rhv.y;
-	lhv.z -= rhv.z;
-	return lhv;
-}
-
-Vector3& operator/=(Vector3& v,float s){
-	v.x /= s;
-	v.y /= s;
-	v.z /= s;
-	return v;
-}
-
-// 二項演算子 (内部で複合代入演算子を使用)
-
-const Vector3 operator*(const Vector3& v1,const float f){
-	Vector3 temp(v1);
-	return temp *= f;
-}
-
-const Vector3 operator+(const Vector3& v1,const Vector3& v2){
-	Vector3 temp(v1);
-	return temp += v2;
-}
-
-// 線形補間
-Vector3 Lerp(const Vector3& v1,const Vector3& v2,float t){
-	return Vector3(Lerp(v1.x,v2.x,t),Lerp(v1.y,v2.y,t),Lerp(v1.z,v2.z,t));
-}
-
 
 // --- 行列・変換関連 ---
-
-Matrix4x4 MakeIdentityMatrix(){
-	static const Matrix4x4 result{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-								  0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
-	return result;
-}
-
-Matrix4x4 MakeScaleMatrix(const Vector3& scale){
-	Matrix4x4 result{scale.x, 0.0f, 0.0f, 0.0f, 0.0f, scale.y, 0.0f, 0.0f,
-					 0.0f, 0.0f, scale.z, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
-	return result;
-}
+// (ベクトルの演算子、単位・スケール・平行移動の行列は ConstexprMath.h に constexpr で書いてある)
 
 Matrix4x4 MakeRotateXMatrix(float theta){
-	float sin = std::sin(theta);
-	float cos = std::cos(theta);
+	float sin, cos;
+	SinCos(theta,sin,cos);
 	Matrix4x4 result{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, cos, sin, 0.0f,
 					 0.0f, -sin, cos, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
 	return result;
 }
 
 Matrix4x4 MakeRotateYMatrix(float theta){
-	float sin = std::sin(theta);
-	float cos = std::cos(theta);
+	float sin, cos;
+	SinCos(theta,sin,cos);
 	Matrix4x4 result{cos, 0.0f, -sin, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
 					 sin, 0.0f, cos, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
 	return result;
 }
 
 Matrix4x4 MakeRotateZMatrix(float theta){
-	float sin = std::sin(theta);
-	float cos = std::cos(theta);
+	float sin, cos;
+	SinCos(theta,sin,cos);
 	Matrix4x4 result{cos, sin, 0.0f, 0.0f, -sin, cos, 0.0f, 0.0f,
 					 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
 	return result;
 }
 
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate){
-	Matrix4x4 result{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-					 0.0f, 0.0f, 1.0f, 0.0f, translate.x, translate.y, translate.z, 1.0f};
-	return result;
-}
-
 Matrix4x4 MakeAffineMatrix(const Vector3& scale,const Vector3& rot,
 	const Vector3& translate){
-	// スケーリング行列の作成
-	Matrix4x4 matScale = MakeScaleMatrix(scale);
-
-	Matrix4x4 matRotX = MakeRotateXMatrix(rot.x);
-	Matrix4x4 matRotY = MakeRotateYMatrix(rot.y);
-	Matrix4x4 matRotZ = MakeRotateZMatrix(rot.z);
-	// 回転行列の合成
-	Matrix4x4 matRot = matRotZ * matRotX * matRotY;
-
-	// 平行移動行列の作成
-	Matrix4x4 matTrans = MakeTranslateMatrix(translate);
-
-	// スケーリング、回転、平行移動の合成
-	Matrix4x4 matTransform = matScale * matRot * matTrans;
-
-	return matTransform;
+	// S * Rz * Rx * Ry * T を展開した式で直接作る (5 つの行列を作って掛けた時と同じ値になる)
+	return ComposeAffineMatrix(scale,rot,translate);
 }
 
 Matrix4x4& operator*=(Matrix4x4& lhm,const Matrix4x4& rhm){
-	Matrix4x4 result{};
-	for(size_t i = 0; i < 4; i++){
-		for(size_t j = 0; j < 4; j++){
-			for(size_t k = 0; k < 4; k++){
-				result.m[i][j] += lhm.m[i][k] * rhm.m[k][j];
-			}
-		}
-	}
-	lhm = result;
+	lhm = MultiplyMatrix(lhm,rhm);
 	return lhm;
 }
 
 Matrix4x4 operator*(const Matrix4x4& m1,const Matrix4x4& m2){
-	Matrix4x4 result = m1;
-	return result *= m2;
+	return MultiplyMatrix(m1,m2);
 }
 
 // ワールドトランスフォーム更新
@@ -148,43 +53,27 @@ void WorldTransformUpdate(WorldTransform& worldTransform){
 	worldTransform.TransferMatrix();
 }
 
-// --- イージング・計算関数 ---
-
-float Lerp(float x1,float x2,float t){ return (1.0f - t) * x1 + t * x2; }
-
-float EaseIn(float x1,float x2,float t){
-	float easedT = t * t;
-	return Lerp(x1,x2,easedT);
+bool WorldTransformUpdate(WorldTransform& worldTransform,TransformChangeTracker& tracker){
+	// 動いていない物 (背景など) は毎フレームの計算も転送もしない
+	if(!tracker.Update(worldTransform.scale_,worldTransform.rotation_,worldTransform.translation_)){
+		return false;
+	}
+	WorldTransformUpdate(worldTransform);
+	return true;
 }
 
-float EaseOut(float x1,float x2,float t){
-	float easedT = 1.0f - std::powf(1.0f - t,3.0f);
-	return Lerp(x1,x2,easedT);
-}
+// --- イージング・計算関数 ---
 
-float EaseInOut(float x1,float x2,float t){
-	float easedT = -(std::cosf(std::numbers::pi_v<float> *t) - 1.0f) / 2.0f;
-	return Lerp(x1,x2,easedT);
-}
+// (Lerp と EaseIn / EaseOut / EaseInOut は ConstexprMath.h にある)
 
 float NormalizeAngle(float angle){
-	while(angle > std::numbers::pi_v<float>)
-		angle -= std::numbers::pi_v<float> *2.0f;
-	while(angle < -std::numbers::pi_v<float>)
-		angle += std::numbers::pi_v<float> *2.0f;
-	return angle;
+	// 2π の倍数を一度に引く (大きな角度でもループしない)
+	return WrapAngle(angle);
 }
 
 float EaseInOutAngle(float from,float to,float t){
 	float delta = NormalizeAngle(to - from);
-	float easedT = -(std::cosf(std::numbers::pi_v<float> *t) - 1.0f) / 2.0f;
-	return from + delta * easedT;
-}
-
-bool IsCollision(const AABB& aabb1,const AABB& aabb2){
-	return (aabb1.min.x <= aabb2.max.x && aabb1.max.x >= aabb2.min.x) && // x軸
-		(aabb1.min.y <= aabb2.max.y && aabb1.max.y >= aabb2.min.y) && // y軸
-		(aabb1.min.z <= aabb2.max.z && aabb1.max.z >= aabb2.min.z);   // z軸
+	return from + delta * EaseInOutCurve(t);
 }
 
 Vector3 Transform(const Vector3& vector,const Matrix4x4& matrix){
@@ -0,0 +1,655 @@
+// ==========================================
+// AssetCooker の確かめ・計測 (アセット)
+// クックした形式 (.kmesh・.cooked.dds・アトラス) が元と合うかと、読み込み・変換の速さを出す
+// ==========================================
+#include "Commands.h"
+#include "ContentDeduplicator.h"
+#include "CookedMesh.h"
+#include "CookedTexture.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include "ObjParser.h"
+#include "PngLoader.h"
+#include "TextureAtlas.h"
+#include "TextureCompressor.h"
+#include "ToolCommon.h"
+#include "ViewSettings.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+int Bench(){
+	const int kWarmRuns = 5;
+
+	std::printf("%-14s %12s %12s %12s %12s\n","model","obj cold ms","obj warm ms","kmesh cold","kmesh warm");
+	for(const std::string& name : FindModels()){
+		// OBJ (解析あり)
+		double objCold = 0.0;
+		double objWarm = 1e9;
+		for(int run = 0; run <= kWarmRuns; ++run){
+			auto start = std::chrono::steady_clock::now();
+			MeshData meshData;
+			ObjLoader::Load(name,false,meshData);
+			double ms = ElapsedMs(start);
+			if(run == 0){
+				objCold = ms;
+			}
+			else{
+				objWarm = std::min(objWarm,ms);
+			}
+		}
+
+		// クック済み (マップして全ページに触れるまで)
+		std::string path = CookedMesh::GetPath(name,false);
+		double cookedCold = 0.0;
+		double cookedWarm = 1e9;
+		bool hasCooked = true;
+		for(int run = 0; run <= kWarmRuns && hasCooked; ++run){
+			auto start = std::chrono::steady_clock::now();
+			CookedMesh cookedMesh;
+			hasCooked = cookedMesh.Open(path);
+			uint32_t checksum = 0;
+			for(uint32_t index : cookedMesh.GetIndices()){
+				checksum += index;
+			}
+			for(const MeshData::Vertex& vertex : cookedMesh.GetVertices()){
+				checksum += static_cast<uint32_t>(vertex.pos.x);
+			}
+			double ms = ElapsedMs(start);
+			(void)checksum;
+			if(run == 0){
+				cookedCold = ms;
+			}
+			else{
+				cookedWarm = std::min(cookedWarm,ms);
+			}
+		}
+
+		if(hasCooked){
+			std::printf("%-14s %12.3f %12.3f %12.3f %12.3f\n",name.c_str(),objCold,objWarm,cookedCold,cookedWarm);
+		}
+		else{
+			std::printf("%-14s %12.3f %12.3f %12s %12s\n",name.c_str(),objCold,objWarm,"(not cooked)","");
+		}
+	}
+	// (1回目は OS のファイルキャッシュに載っている場合もあるので、厳密なコールドではない)
+	return 0;
+}
+
+namespace{
+
+// 三角形を展開した時に同じ頂点が並ぶか (重複の除き方の違いは問わない)
+bool IsSameMesh(const MeshData& expected,const MeshData& actual,std::string& message){
+	if(expected.subMeshes.size() != actual.subMeshes.size()){
+		message = "submesh count";
+		return false;
+	}
+	if(expected.materials.size() != actual.materials.size()){
+		message = "material count";
+		return false;
+	}
+	for(size_t i = 0; i < expected.materials.size(); ++i){
+		const MeshData::MaterialData& a = expected.materials[i];
+		const MeshData::MaterialData& b = actual.materials[i];
+		if(a.name != b.name || a.textureFilename != b.textureFilename || a.alpha != b.alpha ||
+		   std::memcmp(&a.ambient,&b.ambient,sizeof(a.ambient)) != 0 || std::memcmp(&a.diffuse,&b.diffuse,sizeof(a.diffuse)) != 0 ||
+		   std::memcmp(&a.specular,&b.specular,sizeof(a.specular)) != 0){
+			message = "material " + a.name;
+			return false;
+		}
+	}
+	for(size_t i = 0; i < expected.subMeshes.size(); ++i){
+		const MeshData::SubMesh& a = expected.subMeshes[i];
+		const MeshData::SubMesh& b = actual.subMeshes[i];
+		if(a.name != b.name || a.materialIndex != b.materialIndex || a.indexCount != b.indexCount){
+			message = "submesh " + a.name;
+			return false;
+		}
+		for(uint32_t j = 0; j < a.indexCount; ++j){
+			const MeshData::Vertex& va = expected.vertices[a.vertexOffset + expected.indices[a.indexOffset + j]];
+			const MeshData::Vertex& vb = actual.vertices[b.vertexOffset + actual.indices[b.indexOffset + j]];
+			if(std::memcmp(&va,&vb,sizeof(va)) != 0){
+				message = "vertex at index " + std::to_string(j);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// 全モデルを読んだ時間の最小値 (ms)
+template<typename Function>
+double MeasureMs(const std::vector<std::string>& names,const Function& load){
+	const int kRuns = 5;
+	double best = 1e9;
+	for(int run = 0; run < kRuns; ++run){
+		auto start = std::chrono::steady_clock::now();
+		for(const std::string& name : names){
+			MeshData meshData;
+			load(name,meshData);
+		}
+		best = std::min(best,ElapsedMs(start));
+	}
+	return best;
+}
+
+} // namespace
+
+int Parse(){
+	std::vector<std::string> names = FindModels();
+	int failed = 0;
+	size_t totalBytes = 0;
+
+	// 結果の突き合わせ
+	for(const std::string& name : names){
+		totalBytes += std::filesystem::file_size("Resources/" + name + "/" + name + ".obj");
+		for(bool smoothing : {false, true}){
+			MeshData expected;
+			MeshData actual;
+			ObjLoader::Load(name,smoothing,expected);
+			std::string message;
+			if(!ObjParser::Load(name,smoothing,actual,0) || !IsSameMesh(expected,actual,message)){
+				std::printf("MISMATCH %-14s smoothing=%d %s\n",name.c_str(),smoothing,message.c_str());
+				++failed;
+				continue;
+			}
+			if(!smoothing){
+				std::printf("ok       %-14s vertices %6zu -> %6zu\n",name.c_str(),expected.vertices.size(),actual.vertices.size());
+			}
+		}
+	}
+
+	// 速度 (ファイルキャッシュに載った状態で、全モデルを続けて読む)
+	uint32_t numThreads = std::max(1u,std::thread::hardware_concurrency());
+	double megabytes = static_cast<double>(totalBytes) / (1024.0 * 1024.0);
+	double loaderMs = MeasureMs(names,[](const std::string& name,MeshData& meshData){ ObjLoader::Load(name,false,meshData); });
+	double serialMs = MeasureMs(names,[](const std::string& name,MeshData& meshData){ ObjParser::Load(name,false,meshData,1); });
+	double parallelMs = MeasureMs(names,[](const std::string& name,MeshData& meshData){ ObjParser::Load(name,false,meshData,0); });
+	std::printf("%.2f MB of OBJ\n",megabytes);
+	std::printf("ObjLoader             %8.2f ms %8.1f MB/s\n",loaderMs,megabytes / (loaderMs / 1000.0));
+	std::printf("ObjParser (1 thread)  %8.2f ms %8.1f MB/s\n",serialMs,megabytes / (serialMs / 1000.0));
+	std::printf("ObjParser (%u threads) %8.2f ms %8.1f MB/s\n",numThreads,parallelMs,megabytes / (parallelMs / 1000.0));
+	return failed == 0 ? 0 : 1;
+}
+
+namespace{
+
+// 三角形の集合 (頂点の中身で表し、巻き順を保ったまま最小の頂点が先頭に来るよう回す)
+std::vector<std::string> CollectTriangles(const MeshData& meshData){
+	std::vector<std::string> triangles;
+	for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+		for(uint32_t i = 0; i + 2 < subMesh.indexCount; i += 3){
+			std::array<std::string,3> corners;
+			for(uint32_t k = 0; k < 3; ++k){
+				const MeshData::Vertex& vertex = meshData.vertices[subMesh.vertexOffset + meshData.indices[subMesh.indexOffset + i + k]];
+				corners[k].assign(reinterpret_cast<const char*>(&vertex),sizeof(vertex));
+			}
+			size_t first = std::min_element(corners.begin(),corners.end()) - corners.begin();
+			std::string triangle = subMesh.name + "|";
+			for(size_t k = 0; k < 3; ++k){
+				triangle += corners[(first + k) % 3];
+			}
+			triangles.push_back(std::move(triangle));
+		}
+	}
+	std::sort(triangles.begin(),triangles.end());
+	return triangles;
+}
+
+} // namespace
+
+int Optimize(){
+	int failed = 0;
+	std::printf("%-14s %9s %16s %16s %8s\n","model","triangles","ACMR before/after","ATVR before/after","geometry");
+	for(const std::string& name : FindModels()){
+		// クックと同じく、重複を除いた状態から並べ替える
+		MeshData meshData;
+		if(!ObjParser::Load(name,false,meshData)){
+			std::printf("FAILED  %s (load)\n",name.c_str());
+			++failed;
+			continue;
+		}
+		CookedMesh::WeldVertices(meshData);
+		std::vector<std::string> before = CollectTriangles(meshData);
+		MeshOptimizer::CacheStats statsBefore = MeshOptimizer::AnalyzeVertexCache(meshData);
+
+		MeshOptimizer::Optimize(meshData);
+		MeshOptimizer::CacheStats statsAfter = MeshOptimizer::AnalyzeVertexCache(meshData);
+		bool isSame = before == CollectTriangles(meshData);
+		if(!isSame){
+			++failed;
+		}
+		std::printf("%-14s %9zu %7.3f / %6.3f %7.3f / %6.3f %8s\n",name.c_str(),before.size(),statsBefore.acmr,statsAfter.acmr,statsBefore.atvr,statsAfter.atvr,
+		            isSame ? "same" : "CHANGED");
+	}
+	return failed == 0 ? 0 : 1;
+}
+
+namespace{
+
+// LOD の段の三角形数
+uint32_t CountTriangles(const MeshData& meshData,size_t lod){
+	uint32_t count = 0;
+	if(lod == 0){
+		for(const MeshData::SubMesh& subMesh : meshData.subMeshes){
+			count += subMesh.indexCount / 3;
+		}
+	}
+	else{
+		for(const MeshData::IndexRange& range : meshData.lods[lod - 1].subMeshes){
+			count += range.count / 3;
+		}
+	}
+	return count;
+}
+
+} // namespace
+
+int Lod(){
+	// MeshModel::SelectLod と同じ見積もり (カメラは KamataEngine の既定の縦 45 度・高さ 720 で、CameraController と同じ距離から見る)
+	const float kFovAngleY = 45.0f * 3.14159265f / 180.0f;
+	const float kWindowHeight = 720.0f;
+	const float kDistance = -ViewSettings::kCameraTargetOffset.z;
+	const float kScales[] = {1.0f, 0.5f, 0.15f, 0.1f};
+	// ゲーム中のエフェクト (どれも sphere を ViewSettings::kEffectLodErrorThreshold で描く)
+	struct Effect{
+		const char* name;
+		float scale;
+	};
+	const Effect kEffects[] = {
+	    {"boss particles", 0.1f}, // BossEffectSystem
+	    {"wall hits", 0.15f},     // WallHitEffectSystem
+	    {"beams", 0.5f},          // GameScene::Draw
+	};
+	const char* kEffectModel = "sphere";
+	const double kEffectTarget = 0.9;
+
+	// 画面上のずれが threshold に収まる一番粗い段の三角形数
+	auto countDrawn = [&](const MeshData& meshData,float radius,float scale,float threshold){
+		float radiusPixels = radius * scale / std::tan(kFovAngleY * 0.5f) * (kWindowHeight * 0.5f) / kDistance;
+		size_t selected = 0;
+		for(size_t i = 0; i < meshData.lods.size() && meshData.lods[i].error * radiusPixels <= threshold; ++i){
+			selected = i + 1;
+		}
+		return CountTriangles(meshData,selected);
+	};
+
+	int failed = 0;
+	bool isEffectFound = false;
+	std::string effectLines;
+	uint64_t fullTriangles = 0;
+	uint64_t drawnTriangles[std::size(kScales)] = {};
+	char header[96];
+	std::snprintf(header,sizeof(header),"drawn at distance %.0f (%.0f px), scale 1 / 0.5 / 0.15 / 0.1",kDistance,ViewSettings::kLodErrorThreshold);
+	std::printf("%-14s %-100s %s\n","model","triangles (error / radius)",header);
+	for(const std::string& name : FindModels()){
+		MeshData meshData;
+		if(!ObjParser::Load(name,false,meshData)){
+			std::printf("FAILED  %s (load)\n",name.c_str());
+			++failed;
+			continue;
+		}
+		CookedMesh::WeldVertices(meshData);
+		MeshOptimizer::Optimize(meshData);
+		MeshSimplifier::GenerateLods(meshData);
+
+		// 範囲とインデックスが元のメッシュの頂点に収まっているか
+		for(const MeshData::Lod& lod : meshData.lods){
+			for(size_t s = 0; s < lod.subMeshes.size(); ++s){
+				const MeshData::IndexRange& range = lod.subMeshes[s];
+				const MeshData::SubMesh& subMesh = meshData.subMeshes[s];
+				bool isValid = range.count % 3 == 0 && range.offset + range.count <= meshData.indices.size();
+				for(uint32_t i = 0; isValid && i < range.count; ++i){
+					isValid = meshData.indices[range.offset + i] < subMesh.vertexCount;
+				}
+				if(!isValid){
+					std::printf("FAILED  %s (lod range)\n",name.c_str());
+					++failed;
+				}
+			}
+		}
+
+		std::string chain = std::to_string(CountTriangles(meshData,0));
+		for(size_t i = 0; i < meshData.lods.size(); ++i){
+			char text[64];
+			std::snprintf(text,sizeof(text)," > %u (%.3f)",CountTriangles(meshData,i + 1),meshData.lods[i].error);
+			chain += text;
+		}
+
+		Vector3 center;
+		float radius = 0.0f;
+		MeshSimplifier::GetBoundingSphere(meshData.vertices,center,radius);
+		std::string drawn;
+		uint32_t full = CountTriangles(meshData,0);
+		fullTriangles += full * std::size(kScales);
+		for(size_t k = 0; k < std::size(kScales); ++k){
+			uint32_t count = countDrawn(meshData,radius,kScales[k],ViewSettings::kLodErrorThreshold);
+			drawnTriangles[k] += count;
+			drawn += (k == 0 ? "" : " / ") + std::to_string(count);
+		}
+		std::printf("%-14s %-100s %s\n",name.c_str(),chain.c_str(),drawn.c_str());
+
+		if(name == kEffectModel){
+			isEffectFound = true;
+			effectLines.clear();
+			for(const Effect& effect : kEffects){
+				uint32_t count = countDrawn(meshData,radius,effect.scale,ViewSettings::kEffectLodErrorThreshold);
+				double fewer = 1.0 - static_cast<double>(count) / full;
+				bool isReached = fewer > kEffectTarget;
+				if(!isReached){
+					++failed;
+				}
+				char line[160];
+				std::snprintf(line,sizeof(line),"  %-16s scale %.2f  %u -> %u triangles (%.1f%% fewer)%s\n",effect.name,effect.scale,full,count,100.0 * fewer,isReached ? "" : " UNDER 90%");
+				effectLines += line;
+			}
+		}
+	}
+
+	uint64_t drawnTotal = 0;
+	for(size_t k = 0; k < std::size(kScales); ++k){
+		drawnTotal += drawnTriangles[k];
+	}
+	if(fullTriangles > 0){
+		std::printf("all models at every scale: %llu -> %llu triangles (%.1f%% fewer)\n",static_cast<unsigned long long>(fullTriangles),
+		            static_cast<unsigned long long>(drawnTotal),100.0 * (1.0 - static_cast<double>(drawnTotal) / static_cast<double>(fullTriangles)));
+	}
+	if(isEffectFound){
+		std::printf("effects in game (%s at distance %.0f, %.0f px):\n%s",kEffectModel,kDistance,ViewSettings::kEffectLodErrorThreshold,effectLines.c_str());
+	}
+	else{
+		std::printf("FAILED  %s not found\n",kEffectModel);
+		++failed;
+	}
+	return failed == 0 ? 0 : 1;
+}
+
+namespace{
+
+// ミップの作り方 (sRGB を線形で平均しているか、透明な画素の色が混ざらないか)
+bool CheckMips(){
+	ImageData checker;
+	checker.width = 2;
+	checker.height = 2;
+	checker.pixels = {0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 255};
+	std::vector<ImageData> mips = CookedTexture::GenerateMips(checker,1);
+	// 白黒の平均は線形で 0.5、sRGB で 188 (そのまま平均すると 128 になって暗い)
+	bool isGammaCorrect = mips.size() == 2 && std::abs(mips[1].pixels[0] - 188) <= 1;
+
+	ImageData edge = checker;
+	edge.pixels = {255, 0, 0, 255, 0, 255, 0, 0, 255, 0, 0, 255, 0, 255, 0, 0};
+	mips = CookedTexture::GenerateMips(edge,1);
+	// 透明な緑は混ざらず、α だけが半分になる
+	bool isAlphaWeighted = mips.size() == 2 && mips[1].pixels[0] == 255 && mips[1].pixels[1] == 0 && std::abs(mips[1].pixels[3] - 128) <= 1;
+
+	std::printf("mips: gamma-correct average %s, alpha-weighted color %s\n",isGammaCorrect ? "ok" : "FAILED",isAlphaWeighted ? "ok" : "FAILED");
+	return isGammaCorrect && isAlphaWeighted;
+}
+
+} // namespace
+
+int Texture(){
+	// 壊れていないかを見るための下限 (細かい模様やノイズの多い画像は 30dB を下回ることがある)
+	const double kMinPsnr = 20.0;
+	const TextureCompressor::Format kFormats[] = {TextureCompressor::Format::kBC1, TextureCompressor::Format::kBC3, TextureCompressor::Format::kBC7};
+	uint32_t numThreads = std::max(1u,std::thread::hardware_concurrency());
+
+	int failed = CheckMips() ? 0 : 1;
+	size_t totalRaw = 0;
+	size_t totalCooked = 0;
+	double megapixels = 0.0;
+	double formatMs[std::size(kFormats)][2] = {};
+	std::printf("%-32s %11s %-23s %-23s %-23s %s\n","texture","size","BC1 dB (rgb/alpha)","BC3 dB (rgb/alpha)","BC7 dB (rgb/alpha)","VRAM");
+	for(const std::string& name : FindTextures()){
+		ImageData image;
+		if(!name.ends_with(".png") || !PngLoader::Load("Resources/" + name,image)){
+			std::printf("%-32s (skipped)\n",name.c_str());
+			continue;
+		}
+		std::string line;
+		char text[128];
+		TextureCompressor::Format chosen = CookedTexture::ChooseFormat(image);
+		for(size_t f = 0; f < std::size(kFormats); ++f){
+			auto start = std::chrono::steady_clock::now();
+			std::vector<uint8_t> blocks = TextureCompressor::Compress(image,kFormats[f],1);
+			formatMs[f][0] += ElapsedMs(start);
+			start = std::chrono::steady_clock::now();
+			TextureCompressor::Compress(image,kFormats[f],numThreads);
+			formatMs[f][1] += ElapsedMs(start);
+
+			ImageData decoded = TextureCompressor::Decompress(blocks,image.width,image.height,kFormats[f]);
+			double psnr = TextureCompressor::ComputePsnr(image,decoded);
+			double alphaPsnr = TextureCompressor::ComputePsnr(image,decoded,true);
+			bool isChosen = kFormats[f] == chosen;
+			if(isChosen && psnr < kMinPsnr){
+				++failed;
+			}
+			std::snprintf(text,sizeof(text),"%c%6.2f / %6.2f%s",isChosen ? '*' : ' ',psnr,alphaPsnr,isChosen && psnr < kMinPsnr ? " LOW  " : "      ");
+			line += text;
+			line += " ";
+		}
+		megapixels += image.width * image.height / 1e6;
+
+		// 書いて読み戻す (VRAM は今の非圧縮・ミップなしと、クック後の全段)
+		std::string path = "Resources/" + CookedTexture::GetCookedName(name);
+		TextureCompressor::Format format;
+		std::vector<ImageData> mips;
+		if(!CookedTexture::Write(image,chosen,path,numThreads) || !CookedTexture::Read(path,format,mips) || format != chosen || mips.empty() ||
+		   mips.back().width != 1 || mips.back().height != 1){
+			std::printf("FAILED  %s (write/read)\n",path.c_str());
+			++failed;
+			continue;
+		}
+		size_t raw = image.pixels.size();
+		size_t cooked = 0;
+		for(const ImageData& mip : mips){
+			cooked += TextureCompressor::GetCompressedSize(mip.width,mip.height,format);
+		}
+		totalRaw += raw;
+		totalCooked += cooked;
+		std::printf("%-32s %5ux%-5u %s %7.1f KB -> %7.1f KB (%zu mips)\n",name.c_str(),image.width,image.height,line.c_str(),raw / 1024.0,cooked / 1024.0,mips.size());
+	}
+	std::printf("(* = format used when cooking)\n");
+	for(size_t f = 0; f < std::size(kFormats); ++f){
+		std::printf("%s encode: %7.2f Mpixel/s (1 thread) %7.2f Mpixel/s (%u threads)\n",TextureCompressor::GetName(kFormats[f]),megapixels / (formatMs[f][0] / 1000.0),
+		            megapixels / (formatMs[f][1] / 1000.0),numThreads);
+	}
+	if(totalCooked > 0){
+		std::printf("VRAM: %.1f MB -> %.1f MB with full mip chains (%.1fx smaller)\n",totalRaw / (1024.0 * 1024.0),totalCooked / (1024.0 * 1024.0),
+		            static_cast<double>(totalRaw) / static_cast<double>(totalCooked));
+	}
+	return failed == 0 ? 0 : 1;
+}
+
+namespace{
+
+// ページごとの使用率 (余白と空きを除いた割合)
+void PrintAtlas(const TextureAtlas::Result& result){
+	for(uint32_t i = 0; i < result.pages.size(); ++i){
+		const TextureAtlas::Page& page = result.pages[i];
+		uint32_t count = 0;
+		for(const auto& [fileName,region] : result.regions){
+			count += region.page == i ? 1 : 0;
+		}
+		std::printf("atlas   Resources/%-32s %s %5ux%-5u %2u textures, occupancy %5.1f%%\n",page.fileName.c_str(),TextureCompressor::GetName(page.format),page.width,
+		            page.height,count,100.0 * static_cast<double>(page.usedPixels) / (static_cast<double>(page.width) * page.height));
+	}
+	for(const TextureAtlas::Skipped& skipped : result.skipped){
+		std::printf("atlas   (not packed) Resources/%s: %s\n",skipped.fileName.c_str(),skipped.reason.c_str());
+	}
+}
+
+} // namespace
+
+// アトラスを作り、マニフェストとページを読み戻して、UV を変換して読んだ画素が元の画像と合うか確かめる
+int Atlas(){
+	const double kMinPsnr = 20.0;
+
+	std::vector<TextureAtlas::Source> sources;
+	for(const std::string& name : FindModels()){
+		MeshData meshData;
+		if(ObjParser::Load(name,false,meshData,0)){
+			TextureAtlas::AddSources(meshData,sources);
+		}
+	}
+	TextureAtlas::Result result;
+	auto start = std::chrono::steady_clock::now();
+	if(!TextureAtlas::Build(sources,result)){
+		std::printf("FAILED  %s (build)\n",TextureAtlas::GetManifestPath().c_str());
+		return 1;
+	}
+	double buildMs = ElapsedMs(start);
+	PrintAtlas(result);
+
+	std::vector<TextureAtlas::Page> pages;
+	std::unordered_map<std::string,TextureAtlas::Region> regions;
+	if(!TextureAtlas::ReadManifest(TextureAtlas::GetManifestPath(),pages,regions) || pages.size() != result.pages.size() || regions.size() != result.regions.size()){
+		std::printf("FAILED  %s (read)\n",TextureAtlas::GetManifestPath().c_str());
+		return 1;
+	}
+
+	int failed = 0;
+	std::vector<std::vector<ImageData>> pageMips(pages.size());
+	for(size_t i = 0; i < pages.size(); ++i){
+		TextureCompressor::Format format;
+		if(!CookedTexture::Read("Resources/" + pages[i].fileName,format,pageMips[i]) || format != pages[i].format || pageMips[i].size() != TextureAtlas::kMipLevels){
+			std::printf("FAILED  Resources/%s (read)\n",pages[i].fileName.c_str());
+			return 1;
+		}
+	}
+
+	std::vector<std::string> names;
+	for(const auto& [fileName,region] : regions){
+		names.push_back(fileName);
+	}
+	std::sort(names.begin(),names.end());
+	for(const std::string& fileName : names){
+		const TextureAtlas::Region& region = regions[fileName];
+		ImageData image;
+		PngLoader::Load("Resources/" + fileName,image);
+
+		// 元の各画素の中心の UV を、シェーダーと同じく uv * scale + offset にして一番上の段から読む
+		const ImageData& page = pageMips[region.page][0];
+		ImageData sampled = image;
+		for(uint32_t y = 0; y < image.height; ++y){
+			for(uint32_t x = 0; x < image.width; ++x){
+				float u = (static_cast<float>(x) + 0.5f) / static_cast<float>(image.width) * region.uvScale[0] + region.uvOffset[0];
+				float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(image.height) * region.uvScale[1] + region.uvOffset[1];
+				uint32_t pageX = std::min(static_cast<uint32_t>(u * static_cast<float>(page.width)),page.width - 1);
+				uint32_t pageY = std::min(static_cast<uint32_t>(v * static_cast<float>(page.height)),page.height - 1);
+				std::copy(page.GetPixel(pageX,pageY),page.GetPixel(pageX,pageY) + 4,sampled.GetPixel(x,y));
+			}
+		}
+		double psnr = TextureCompressor::ComputePsnr(image,sampled);
+		double alphaPsnr = TextureCompressor::ComputePsnr(image,sampled,true);
+
+		// 一番下の段でも、区画の中心が隣の画像と混ざっていないか
+		const ImageData& lastMip = pageMips[region.page].back();
+		float centerU = 0.5f * region.uvScale[0] + region.uvOffset[0];
+		float centerV = 0.5f * region.uvScale[1] + region.uvOffset[1];
+		const uint8_t* center = lastMip.GetPixel(std::min(static_cast<uint32_t>(centerU * static_cast<float>(lastMip.width)),lastMip.width - 1),
+		                                         std::min(static_cast<uint32_t>(centerV * static_cast<float>(lastMip.height)),lastMip.height - 1));
+		bool isIsolated = true;
+		if(image.width == 1 && image.height == 1){
+			for(int c = 0; c < 4; ++c){
+				isIsolated = isIsolated && std::abs(center[c] - image.pixels[c]) <= 8;
+			}
+		}
+
+		bool isOk = psnr >= kMinPsnr && isIsolated;
+		failed += isOk ? 0 : 1;
+		std::printf("%-32s page %u at %4u,%-4u %4ux%-4u %6.2f / %6.2f dB%s%s\n",fileName.c_str(),region.page,region.x,region.y,region.width,region.height,psnr,alphaPsnr,
+		            isIsolated ? "" : " (bleeds at last mip)",isOk ? "" : " FAILED");
+	}
+
+	// マテリアルが使うテクスチャの種類 (= 描く時に切り替わり得るテクスチャ) の数
+	size_t bindings = pages.size() + result.skipped.size();
+	std::printf("%zu textures -> %zu (%zu atlas pages + %zu not packed), built in %.1f ms\n",sources.size(),bindings,pages.size(),result.skipped.size(),buildMs);
+	return failed == 0 ? 0 : 1;
+}
+
+namespace{
+
+// 読み込んだ時の大きさ (RGBA 各8ビット、ミップなし。PNG 以外はファイルの大きさ)
+uint64_t GetUploadBytes(const std::string& fileName){
+	ImageData image;
+	if(fileName.ends_with(".png") && PngLoader::Load("Resources/" + fileName,image)){
+		return image.pixels.size();
+	}
+	std::error_code errorCode;
+	uint64_t size = std::filesystem::file_size("Resources/" + fileName,errorCode);
+	return errorCode ? 0 : size;
+}
+
+} // namespace
+
+// 中身が同じテクスチャと値が同じマテリアルをまとめると、読み込み (アップロード) がいくつ減るか
+int Dedup(){
+	ContentDeduplicator* deduplicator = ContentDeduplicator::GetInstance();
+	const float kUvScale[2] = {1.0f, 1.0f};
+	const float kUvOffset[2] = {0.0f, 0.0f};
+
+	// モデルのマテリアルが読むテクスチャ (名前ごとに1回アップロードされていた)
+	std::vector<std::string> modelTextures;
+	uint32_t materialCount = 0;
+	std::unordered_map<ContentDeduplicator::MaterialKey,std::string,ContentDeduplicator::MaterialKeyHash> uniqueMaterials;
+	auto start = std::chrono::steady_clock::now();
+	for(const std::string& name : FindModels()){
+		MeshData meshData;
+		if(!ObjParser::Load(name,false,meshData,0)){
+			continue;
+		}
+		for(const MeshData::MaterialData& material : meshData.materials){
+			std::string texture = "white1x1.png";
+			if(!material.textureFilename.empty()){
+				std::string fileName = name + "/" + material.textureFilename;
+				if(std::find(modelTextures.begin(),modelTextures.end(),fileName) == modelTextures.end()){
+					modelTextures.push_back(fileName);
+				}
+				texture = deduplicator->GetCanonicalTexture(fileName);
+			}
+			++materialCount;
+			uniqueMaterials.emplace(ContentDeduplicator::MakeMaterialKey(material,texture,kUvScale,kUvOffset),name + "/" + material.name);
+		}
+	}
+	double modelMs = ElapsedMs(start);
+
+	std::unordered_map<std::string,std::vector<std::string>> groups; // まとめ先 → 名前
+	for(const std::string& fileName : modelTextures){
+		groups[deduplicator->GetCanonicalTexture(fileName)].push_back(fileName);
+	}
+	uint64_t savedBytes = 0;
+	for(const auto& [canonicalName,names] : groups){
+		if(names.size() > 1){
+			uint64_t bytes = GetUploadBytes(canonicalName);
+			savedBytes += bytes * (names.size() - 1);
+			std::printf("%-32s x%zu (%llu bytes each)\n",canonicalName.c_str(),names.size(),static_cast<unsigned long long>(bytes));
+		}
+	}
+	std::printf("model textures: %zu uploads -> %zu, %llu bytes saved (%u files hashed, %.2f ms)\n",modelTextures.size(),groups.size(),
+	            static_cast<unsigned long long>(savedBytes),deduplicator->GetHashedCount(),modelMs);
+	std::printf("model materials: %u -> %zu\n",materialCount,uniqueMaterials.size());
+
+	// Resources/ 以下の全ての画像 (スプライトなど、AssetCache から名前で読むもの)
+	std::vector<std::string> textures = FindTextures();
+	std::unordered_map<std::string,uint32_t> copies;
+	for(const std::string& fileName : textures){
+		++copies[deduplicator->GetCanonicalTexture(fileName)];
+	}
+	uint64_t allSavedBytes = 0;
+	for(const auto& [canonicalName,count] : copies){
+		allSavedBytes += GetUploadBytes(canonicalName) * (count - 1);
+	}
+	std::printf("all textures: %zu files -> %zu unique, %.1f KB of uploads saved (%.1f KB of files not read)\n",textures.size(),copies.size(),
+	            allSavedBytes / 1024.0,deduplicator->GetDuplicateBytes() / 1024.0);
+	return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// ==========================================
+// AssetCooker の確かめ・計測のコマンド (main.cpp から呼ぶ。成功なら 0)
+// クックそのもの (build / cook / pack) は main.cpp にある
+// ==========================================
+
+// AssetChecks.cpp … クックした形式が元と合うかと、読み込み・変換の速さ
+int Bench();
+int Parse();
+int Optimize();
+int Lod();
+int Texture();
+int Atlas();
+int Dedup();
+
+// RenderBenchmarks.cpp … 描画コマンド・カリング・定数バッファへの転送の数と時間
+int Instancing();
+int TileWindow();
+int Culling();
+int Uploads();
+
+// MathBenchmarks.cpp … 行列・近似関数・コンパイル時の表を以前の書き方と比べる
+int Hierarchy();
+int MatrixMath();
+int Kernels();
+int Tables();
+
+// GameplayBenchmarks.cpp … GameScene のティックの処理のヒープ確保の数と時間を、以前の書き方と比べる
+int Beams();
+int Entities();
+int Retry();
@@ -0,0 +1,393 @@
+#include "CookPipeline.h"
+#include "ContentDeduplicator.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace{
+
+// キャッシュの書式やキーの作り方を変えたら上げる (全ジョブが作り直しになる)
+const uint32_t kPipelineVersion = 1;
+
+// 書き終えてから置き換える (途中で止まっても前回のものが残る)
+bool WriteText(const std::filesystem::path& path,const std::string& text){
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+	{
+		std::ofstream file(temporaryPath,std::ios::binary | std::ios::trunc);
+		if(!file.is_open()){
+			return false;
+		}
+		file.write(text.data(),static_cast<std::streamsize>(text.size()));
+		if(!file.good()){
+			return false;
+		}
+	}
+	std::error_code errorCode;
+	std::filesystem::rename(temporaryPath,path,errorCode);
+	return !errorCode;
+}
+
+void AppendKey(std::string& buffer,const std::string& text){
+	buffer += text;
+	buffer.push_back('\0');
+}
+
+void AppendKey(std::string& buffer,uint64_t value){
+	char bytes[sizeof(value)];
+	std::memcpy(bytes,&value,sizeof(value));
+	buffer.append(bytes,sizeof(bytes));
+}
+
+} // namespace
+
+CookPipeline::CookPipeline(const std::string& cacheDirectory)
+	: cacheDirectory_(cacheDirectory){
+}
+
+void CookPipeline::Load(){
+	const std::filesystem::path directory(cacheDirectory_);
+	std::ifstream filesFile(directory / "files.txt");
+	std::string line;
+	uint32_t version = 0;
+	if(!(filesFile >> version) || version != kPipelineVersion){
+		return;
+	}
+	std::getline(filesFile,line);
+	while(std::getline(filesFile,line)){
+		std::istringstream stream(line);
+		std::string path;
+		FileState state;
+		if(stream >> std::quoted(path) >> state.size >> state.time >> state.hash){
+			files_[path] = state;
+		}
+	}
+
+	std::ifstream dependenciesFile(directory / "dependencies.txt");
+	while(std::getline(dependenciesFile,line)){
+		std::istringstream stream(line);
+		std::string path;
+		Dependencies dependencies;
+		if(!(stream >> std::quoted(path) >> dependencies.hash)){
+			continue;
+		}
+		std::string dependency;
+		while(stream >> std::quoted(dependency)){
+			dependencies.paths.push_back(dependency);
+		}
+		dependencies_[path] = std::move(dependencies);
+	}
+
+	std::ifstream jobsFile(directory / "jobs.txt");
+	while(std::getline(jobsFile,line)){
+		std::istringstream stream(line);
+		std::string id;
+		JobRecord record;
+		if(!(stream >> std::quoted(id) >> record.key)){
+			continue;
+		}
+		Output output;
+		while(stream >> std::quoted(output.path) >> output.hash){
+			record.outputs.push_back(output);
+		}
+		jobs_[id] = std::move(record);
+	}
+}
+
+bool CookPipeline::Save(){
+	std::error_code errorCode;
+	const std::filesystem::path directory(cacheDirectory_);
+	std::filesystem::create_directories(directory,errorCode);
+
+	// 今回見なかったファイル (消えたものなど) は書かない
+	std::ostringstream files;
+	files << kPipelineVersion << '\n';
+	for(const auto& [path,state] : files_){
+		if(state.used){
+			files << std::quoted(path) << ' ' << state.size << ' ' << state.time << ' ' << state.hash << '\n';
+		}
+	}
+
+	std::ostringstream dependencies;
+	for(const auto& [path,entry] : dependencies_){
+		dependencies << std::quoted(path) << ' ' << entry.hash;
+		for(const std::string& dependency : entry.paths){
+			dependencies << ' ' << std::quoted(dependency);
+		}
+		dependencies << '\n';
+	}
+
+	std::ostringstream jobs;
+	for(const auto& [id,record] : jobs_){
+		jobs << std::quoted(id) << ' ' << record.key;
+		for(const Output& output : record.outputs){
+			jobs << ' ' << std::quoted(output.path) << ' ' << output.hash;
+		}
+		jobs << '\n';
+	}
+
+	return WriteText(directory / "files.txt",files.str()) && WriteText(directory / "dependencies.txt",dependencies.str()) &&
+	       WriteText(directory / "jobs.txt",jobs.str());
+}
+
+bool CookPipeline::Stat(const std::string& path,FileState& state){
+	std::error_code errorCode;
+	uint64_t size = std::filesystem::file_size(path,errorCode);
+	if(errorCode){
+		return false;
+	}
+	int64_t time = std::filesystem::last_write_time(path,errorCode).time_since_epoch().count();
+	if(errorCode){
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = files_.find(path);
+		if(it != files_.end() && it->second.size == size && it->second.time == time){
+			it->second.used = true;
+			state = it->second;
+			return true;
+		}
+	}
+
+	// 読むのはロックの外で (他のジョブを止めない)
+	state.size = size;
+	state.time = time;
+	state.hash = ContentDeduplicator::HashFile(path);
+	state.used = true;
+	std::lock_guard<std::mutex> lock(mutex_);
+	files_[path] = state;
+	++hashedFiles_;
+	return true;
+}
+
+uint64_t CookPipeline::GetFileHash(const std::string& path){
+	FileState state;
+	return Stat(path,state) ? state.hash : 0;
+}
+
+std::vector<std::string> CookPipeline::GetDependencies(const std::string& path,const std::function<std::vector<std::string>(const std::string&)>& scan){
+	uint64_t hash = GetFileHash(path);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = dependencies_.find(path);
+		if(it != dependencies_.end() && it->second.hash == hash){
+			return it->second.paths;
+		}
+	}
+	std::vector<std::string> paths = scan(path);
+	std::lock_guard<std::mutex> lock(mutex_);
+	dependencies_[path] = {hash, paths};
+	return paths;
+}
+
+CookPipeline::Stats CookPipeline::Run(const std::vector<Job>& jobs,bool force,uint32_t numThreads,const std::function<void(const Job&,Result,double)>& report){
+	// 重いもの (入力の大きいもの) から始めて、最後に1つだけ残る時間を減らす
+	std::vector<uint64_t> costs(jobs.size(),0);
+	for(size_t i = 0; i < jobs.size(); ++i){
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(const std::string& input : jobs[i].inputs){
+			auto it = files_.find(input);
+			costs[i] += it != files_.end() ? it->second.size : 0;
+		}
+	}
+	std::vector<size_t> order(jobs.size());
+	for(size_t i = 0; i < order.size(); ++i){
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(),order.end(),[&](size_t a,size_t b){ return costs[a] > costs[b]; });
+
+	Stats stats;
+	uint32_t hashedFiles = hashedFiles_;
+	std::mutex reportMutex;
+	ParallelFor(order.size(),numThreads,[&](size_t i){
+		const Job& job = jobs[order[i]];
+		auto start = std::chrono::steady_clock::now();
+		Result result = RunJob(job,force);
+		double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::lock_guard<std::mutex> lock(reportMutex);
+		switch(result){
+		case Result::kUpToDate: ++stats.upToDate; break;
+		case Result::kRestored: ++stats.restored; break;
+		case Result::kCooked: ++stats.cooked; break;
+		case Result::kFailed: ++stats.failed; break;
+		}
+		if(report){
+			report(job,result,ms);
+		}
+	});
+	stats.hashedFiles = hashedFiles_ - hashedFiles;
+	return stats;
+}
+
+CookPipeline::Result CookPipeline::RunJob(const Job& job,bool force){
+	uint64_t key = ComputeKey(job);
+	JobRecord record;
+	bool hasRecord = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = jobs_.find(job.id);
+		if(it != jobs_.end()){
+			record = it->second;
+			hasRecord = true;
+		}
+	}
+
+	if(!force){
+		if(hasRecord && record.key == key && IsUnchanged(record,job)){
+			return Result::kUpToDate;
+		}
+		JobRecord restored;
+		if(Restore(key,restored)){
+			std::lock_guard<std::mutex> lock(mutex_);
+			jobs_[job.id] = std::move(restored);
+			return Result::kRestored;
+		}
+	}
+
+	std::vector<std::string> outputs;
+	JobRecord cooked;
+	if(!job.cook(outputs) || !Store(key,outputs,cooked)){
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.erase(job.id);
+		return Result::kFailed;
+	}
+	std::lock_guard<std::mutex> lock(mutex_);
+	jobs_[job.id] = std::move(cooked);
+	return Result::kCooked;
+}
+
+uint64_t CookPipeline::ComputeKey(const Job& job){
+	std::string buffer;
+	AppendKey(buffer,kPipelineVersion);
+	AppendKey(buffer,job.id);
+	AppendKey(buffer,job.version);
+	for(const std::string& input : job.inputs){
+		// 無いファイルも「無い」という状態としてキーに入れる
+		FileState state;
+		bool exists = Stat(input,state);
+		AppendKey(buffer,input);
+		AppendKey(buffer,exists ? state.size : ~0ull);
+		AppendKey(buffer,exists ? state.hash : 0);
+	}
+	return ContentDeduplicator::HashBytes(reinterpret_cast<const std::byte*>(buffer.data()),buffer.size());
+}
+
+bool CookPipeline::IsUnchanged(const JobRecord& record,const Job& job){
+	std::vector<FileState> outputStates(record.outputs.size());
+	for(size_t i = 0; i < record.outputs.size(); ++i){
+		if(!Stat(record.outputs[i].path,outputStates[i]) || outputStates[i].hash != record.outputs[i].hash){
+			return false;
+		}
+	}
+
+	// 中身が同じまま入力の時刻だけ新しくなった時 (チェックアウトし直した時など) は、
+	// ゲーム側の「クック済みの方が新しいか」の確認に通るよう出力の時刻を進めておく
+	int64_t newestInput = std::numeric_limits<int64_t>::min(); // (時刻は負になることもある)
+	for(const std::string& input : job.inputs){
+		FileState state;
+		if(Stat(input,state)){
+			newestInput = std::max(newestInput,state.time);
+		}
+	}
+	for(size_t i = 0; i < record.outputs.size(); ++i){
+		if(outputStates[i].time >= newestInput){
+			continue;
+		}
+		std::error_code errorCode;
+		std::filesystem::last_write_time(record.outputs[i].path,std::filesystem::file_time_type::clock::now(),errorCode);
+		FileState state;
+		Stat(record.outputs[i].path,state);
+	}
+	return true;
+}
+
+bool CookPipeline::Store(uint64_t key,const std::vector<std::string>& paths,JobRecord& record){
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(cacheDirectory_) / "objects",errorCode);
+	std::filesystem::create_directories(std::filesystem::path(cacheDirectory_) / "keys",errorCode);
+
+	record.key = key;
+	record.outputs.clear();
+	std::ostringstream keyText;
+	for(const std::string& path : paths){
+		FileState state;
+		if(!Stat(path,state)){
+			return false;
+		}
+		// 同じ中身のものが既にあれば写さない (名前が中身のハッシュなので上書きしても同じ)
+		std::string objectPath = GetObjectPath(state.hash);
+		if(!std::filesystem::exists(objectPath,errorCode)){
+			std::string temporaryPath = objectPath + ".tmp" + std::to_string(std::hash<std::string>()(path));
+			if(!std::filesystem::copy_file(path,temporaryPath,std::filesystem::copy_options::overwrite_existing,errorCode)){
+				return false;
+			}
+			std::filesystem::rename(temporaryPath,objectPath,errorCode);
+			if(errorCode){
+				return false;
+			}
+		}
+		record.outputs.push_back({path, state.hash});
+		keyText << std::quoted(path) << ' ' << state.hash << '\n';
+	}
+	return WriteText(GetKeyPath(key),keyText.str());
+}
+
+bool CookPipeline::Restore(uint64_t key,JobRecord& record){
+	std::ifstream file(GetKeyPath(key));
+	if(!file.is_open()){
+		return false;
+	}
+	record.key = key;
+	record.outputs.clear();
+	std::string line;
+	while(std::getline(file,line)){
+		std::istringstream stream(line);
+		Output output;
+		if(stream >> std::quoted(output.path) >> output.hash){
+			record.outputs.push_back(output);
+		}
+	}
+	// 全部揃っている時だけ写す
+	std::error_code errorCode;
+	for(const Output& output : record.outputs){
+		if(!std::filesystem::exists(GetObjectPath(output.hash),errorCode)){
+			return false;
+		}
+	}
+	for(const Output& output : record.outputs){
+		std::filesystem::path path(output.path);
+		if(path.has_parent_path()){
+			std::filesystem::create_directories(path.parent_path(),errorCode);
+		}
+		if(!std::filesystem::copy_file(GetObjectPath(output.hash),path,std::filesystem::copy_options::overwrite_existing,errorCode)){
+			return false;
+		}
+		// 写した時刻が新しいので入力より後になる
+		FileState state;
+		if(!Stat(output.path,state) || state.hash != output.hash){
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string CookPipeline::GetObjectPath(uint64_t hash) const{
+	char name[17];
+	std::snprintf(name,sizeof(name),"%016llx",static_cast<unsigned long long>(hash));
+	return (std::filesystem::path(cacheDirectory_) / "objects" / name).generic_string();
+}
+
+std::string CookPipeline::GetKeyPath(uint64_t key) const{
+	char name[21];
+	std::snprintf(name,sizeof(name),"%016llx.txt",static_cast<unsigned long long>(key));
+	return (std::filesystem::path(cacheDirectory_) / "keys" / name).generic_string();
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ==========================================
+// 差分クック
+// ・ジョブごとに「入力ファイルの中身のハッシュ + ジョブの版」からキーを作り、
+//   前回と同じキーで出力も書いた時のまま残っていれば何もしない
+// ・出力は中身のハッシュを名前にして objects/ に取っておく (キーからも引ける)
+//   入力が以前の状態に戻った時は、クックせずに写すだけで済む
+// ・ファイルのハッシュは大きさか更新時刻が変わった時だけ取り直す
+//   (何も変わっていなければ stat だけで終わる)
+// ・ジョブどうしは元のファイルを読むだけなので、並列に走らせる
+// パスは作業フォルダ (DirectXGame) からの相対
+// ==========================================
+class CookPipeline{
+public:
+	struct Job{
+		std::string id;                  // "model:player" など (前回の結果を探す名前)
+		uint32_t version = 0;            // 出力の形式やクックの仕方を変えたら上げる
+		std::vector<std::string> inputs; // 読むファイル (中身が変われば作り直す)
+		// 出力を書き、書いたファイルを outputs に入れる。失敗なら false
+		std::function<bool(std::vector<std::string>& outputs)> cook;
+	};
+
+	enum class Result{
+		kUpToDate, // 何もしなかった
+		kRestored, // 取っておいた出力を写した
+		kCooked,
+		kFailed,
+	};
+
+	struct Stats{
+		uint32_t upToDate = 0;
+		uint32_t restored = 0;
+		uint32_t cooked = 0;
+		uint32_t failed = 0;
+		uint32_t hashedFiles = 0; // 中身を読んでハッシュを取ったファイルの数
+	};
+
+	explicit CookPipeline(const std::string& cacheDirectory);
+
+	// 前回の状態を読む (無ければ空から始める)
+	void Load();
+	// 今回の状態を書く
+	bool Save();
+
+	// 中身のハッシュ (大きさと更新時刻が覚えている時と同じなら読まない)。無ければ 0
+	uint64_t GetFileHash(const std::string& path);
+	// ファイルから見つけた依存 (OBJ の mtllib など)。中身が前回と同じなら scan を呼ばずに前回のものを返す
+	std::vector<std::string> GetDependencies(const std::string& path,const std::function<std::vector<std::string>(const std::string&)>& scan);
+
+	// force なら全て作り直す。report はジョブが終わるたびに (どれかのスレッドから1つずつ) 呼ぶ
+	Stats Run(const std::vector<Job>& jobs,bool force,uint32_t numThreads,const std::function<void(const Job&,Result,double)>& report);
+
+private:
+	struct FileState{
+		uint64_t size = 0;
+		int64_t time = 0;
+		uint64_t hash = 0;
+		bool used = false; // 今回見たか (見なかったものは保存しない)
+	};
+
+	// 見つけた依存と、その時のファイルの中身
+	struct Dependencies{
+		uint64_t hash = 0;
+		std::vector<std::string> paths;
+	};
+
+	// 出力1つ分
+	struct Output{
+		std::string path;
+		uint64_t hash = 0;
+	};
+
+	// 最後に作った (写した) 時の状態
+	struct JobRecord{
+		uint64_t key = 0;
+		std::vector<Output> outputs;
+	};
+
+	// 無ければ false
+	bool Stat(const std::string& path,FileState& state);
+	Result RunJob(const Job& job,bool force);
+	uint64_t ComputeKey(const Job& job);
+	bool IsUnchanged(const JobRecord& record,const Job& job);
+	bool Store(uint64_t key,const std::vector<std::string>& paths,JobRecord& record);
+	bool Restore(uint64_t key,JobRecord& record);
+	std::string GetObjectPath(uint64_t hash) const;
+	std::string GetKeyPath(uint64_t key) const;
+
+	std::string cacheDirectory_;
+	std::mutex mutex_;
+	std::unordered_map<std::string,FileState> files_;
+	std::unordered_map<std::string,Dependencies> dependencies_;
+	std::unordered_map<std::string,JobRecord> jobs_;
+	uint32_t hashedFiles_ = 0;
+};
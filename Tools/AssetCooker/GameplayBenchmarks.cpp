@@ -0,0 +1,964 @@
+// ==========================================
+// AssetCooker の確かめ・計測 (ゲームプレイ)
+// GameScene の1ティックの処理を、ゲームと同じ EntityWorld で以前の書き方と比べ、ヒープ確保の数と時間を出す (GPU には触らない)
+// ==========================================
+#include "Beam.h"
+#include "CollisionGrid.h"
+#include "Commands.h"
+#include "ConstexprMath.h"
+#include "EnemyState.h"
+#include "EntityWorld.h"
+#include "GameComponents.h"
+#include "HitEffectState.h"
+#include "MapChipField.h"
+#include "RenderResourcePoolBase.h"
+#include "SimdMath.h"
+#include "TileInstances.h"
+#include "ToolCommon.h"
+#include "TransformChangeTracker.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <memory>
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+#include <math/Vector4.h>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace KamataEngine;
+
+namespace{
+
+// 連射するビームの発射 (n 本目の位置と向きは n だけで決め、壁に当たるかは Beam::Initialize がマップから求める)
+// 床の上から右へ撃ち、上下に少し傾けたものは天井や床・坂に当たる。まっすぐのものは寿命で消える
+Beam MakeBeam(uint32_t n,uint32_t tick,const MapChipField& mapChipField){
+	Beam beam;
+	beam.Initialize({8.0f, 1.0f + static_cast<float>(n % 5), 0.0f},{0.5f, static_cast<float>(static_cast<int>(n % 5) - 2) * 0.05f, 0.0f},tick,&mapChipField);
+	beam.SetIsEnemy(n % 4 == 3);
+	return beam;
+}
+
+// ビームと敵の当たり判定 (GameScene::CheckAllCollisions のビームの部分と同じ量の計算)
+bool HitsEnemy(const Beam& beam,uint32_t tick,const std::vector<Vector3>& enemies){
+	if(beam.IsEnemy()){
+		return false;
+	}
+	Vector3 position = beam.GetWorldPosition(tick);
+	for(const Vector3& enemy : enemies){
+		float dx = position.x - enemy.x;
+		float dy = position.y - enemy.y;
+		float dz = position.z - enemy.z;
+		float r = beam.GetRadius() + 2.0f;
+		if(dx * dx + dy * dy + dz * dz <= r * r){
+			return true;
+		}
+	}
+	return false;
+}
+
+// ------------------------------------------
+// entities 用: EntityWorld に移す前の敵・ビーム・ヒットエフェクトの写し
+// エンジンの WorldTransform / ObjectColor は D3D を読むので、同じメンバーの代わりを置き、
+// 定数バッファの書き込み先は 256 バイトずつ別に確保する (1 個ずつヒープにあるのも同じ)
+// ------------------------------------------
+
+struct alignas(256) ConstantBufferMemory{
+	Matrix4x4 matrix;
+};
+
+struct ListWorldTransform{
+	Vector3 scale = {1.0f, 1.0f, 1.0f};
+	Vector3 rotation = {};
+	Vector3 translation = {};
+	Matrix4x4 matWorld = {};
+	void* constBuffer = nullptr;
+	ConstantBufferMemory* constMap = nullptr;
+	const ListWorldTransform* parent = nullptr;
+
+	ListWorldTransform(){ constMap = new ConstantBufferMemory(); }
+	~ListWorldTransform(){ delete constMap; }
+	ListWorldTransform(const ListWorldTransform&) = delete;
+	ListWorldTransform& operator=(const ListWorldTransform&) = delete;
+
+	// WorldTransformUpdate (行列を作って定数バッファに書く)
+	void Update(){
+		matWorld = ComposeAffineMatrix(scale,rotation,translation);
+		constMap->matrix = matWorld;
+	}
+};
+
+struct ListObjectColor{
+	void* constBuffer = nullptr;
+	Vector4* constMap = nullptr;
+	Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+
+	ListObjectColor(){ constMap = new Vector4(); }
+	~ListObjectColor(){ delete constMap; }
+	ListObjectColor(const ListObjectColor&) = delete;
+	ListObjectColor& operator=(const ListObjectColor&) = delete;
+
+	void SetColor(const Vector4& value){
+		color = value;
+		*constMap = value;
+	}
+};
+
+// TransformInterpolator (登録したトランスフォームを指すだけの配列)
+struct ListInterpolator{
+	struct Entry{
+		ListWorldTransform* worldTransform;
+		Vector3 prevScale;
+		Vector3 prevRotation;
+		Vector3 prevTranslation;
+	};
+	std::vector<Entry> entries;
+
+	void Register(ListWorldTransform* worldTransform){
+		entries.push_back({worldTransform, worldTransform->scale, worldTransform->rotation, worldTransform->translation});
+	}
+	void Unregister(ListWorldTransform* worldTransform){
+		for(size_t i = 0; i < entries.size(); ++i){
+			if(entries[i].worldTransform == worldTransform){
+				entries[i] = entries.back();
+				entries.pop_back();
+				return;
+			}
+		}
+	}
+	void SaveState(){
+		for(Entry& entry : entries){
+			entry.prevScale = entry.worldTransform->scale;
+			entry.prevRotation = entry.worldTransform->rotation;
+			entry.prevTranslation = entry.worldTransform->translation;
+		}
+	}
+	// 描画前に補間した行列を作って送る
+	void Interpolate(float alpha){
+		for(Entry& entry : entries){
+			ListWorldTransform& worldTransform = *entry.worldTransform;
+			worldTransform.constMap->matrix = ComposeAffineMatrix(Lerp(entry.prevScale,worldTransform.scale,alpha),Lerp(entry.prevRotation,worldTransform.rotation,alpha),
+			                                                      Lerp(entry.prevTranslation,worldTransform.translation,alpha));
+		}
+	}
+};
+
+// 敵・ヒットエフェクトの動き (Enemy.cpp / HitEffect.cpp と同じ定数)
+const float kDeltaTime = 1.0f / 60.0f;
+const float kDefeatedTime = 0.6f;
+const float kDefeatedAngleEnd = -60.0f * (3.1415f / 180.0f);
+const uint32_t kSpreadTime = 10;
+const uint32_t kFadeTime = 20;
+
+// 以前の Enemy (トランスフォーム・モデル・色などを1つのオブジェクトに持つ)
+struct ListEnemy{
+	ListWorldTransform worldTransform;
+	void* model = nullptr;
+	void* camera = nullptr;
+	Vector3 velocity = {};
+	float walkTimer = 0.0f;
+	bool isDead = false;
+	EnemyBehavior behavior = EnemyBehavior::kWalk;
+	EnemyBehavior behaviorRequest = EnemyBehavior::kUnknown;
+	float counter = 0.0f;
+	bool isCollisionDisabled = false;
+	void* gameScene = nullptr;
+	int hp = 9999;
+	int type = 0;
+	ListObjectColor objectColor;
+	int fireTimer = 120;
+
+	void Update(){
+		if(behaviorRequest != EnemyBehavior::kUnknown){
+			behavior = behaviorRequest;
+			counter = 0.0f;
+			behaviorRequest = EnemyBehavior::kUnknown;
+		}
+		if(behavior == EnemyBehavior::kDefeated){
+			counter += kDeltaTime;
+			worldTransform.rotation.y += 0.3f;
+			worldTransform.rotation.x = EaseOut(0.0f,kDefeatedAngleEnd,counter / kDefeatedTime);
+			if(counter >= kDefeatedTime){
+				isDead = true;
+			}
+		}
+		worldTransform.Update();
+	}
+	void OnCollision(){
+		if(behavior == EnemyBehavior::kDefeated){
+			return;
+		}
+		hp = 0;
+		behaviorRequest = EnemyBehavior::kDefeated;
+		isCollisionDisabled = true;
+	}
+	// ワールド行列の平行移動成分
+	Vector3 GetWorldPosition() const{ return {worldTransform.matWorld.m[3][0], worldTransform.matWorld.m[3][1], worldTransform.matWorld.m[3][2]}; }
+};
+
+// 以前の Beam (位置は解析的に求めるが、描画用のトランスフォームと色を持つ)
+struct ListBeam{
+	ListWorldTransform worldTransform;
+	void* model = nullptr;
+	ListObjectColor objectColor;
+	Beam beam;
+};
+
+// 以前の HitEffect (楕円 2 つと円の 3 つのトランスフォームを毎ティック更新する)
+struct ListHitEffect{
+	std::array<ListWorldTransform,2> ellipseWorldTransforms;
+	ListWorldTransform circleWorldTransform;
+	int phase = 0; // 0: 拡大 1: フェード 2: 消滅
+	uint32_t counter = 0;
+	ListObjectColor objectColor;
+
+	void Update(){
+		if(phase == 2){
+			return;
+		}
+		if(phase == 0){
+			++counter;
+			float scale = 0.5f + static_cast<float>(counter) / kSpreadTime * 0.5f;
+			for(ListWorldTransform& worldTransform : ellipseWorldTransforms){
+				worldTransform.scale = {0.1f, scale * 2.0f, 1.0f};
+			}
+			circleWorldTransform.scale = {scale, scale, 1.0f};
+			if(counter >= kSpreadTime){
+				phase = 1;
+				counter = 0;
+			}
+		}
+		else{
+			++counter;
+			objectColor.SetColor({1.0f, 1.0f, 1.0f, 1.0f - static_cast<float>(counter) / kFadeTime});
+			if(++counter >= kFadeTime){
+				phase = 2;
+			}
+		}
+		for(ListWorldTransform& worldTransform : ellipseWorldTransforms){
+			worldTransform.Update();
+		}
+		circleWorldTransform.Update();
+	}
+};
+
+// RenderResourcePool の中身 (RenderResourcePoolBase) をそのまま動かすための Traits
+// 定数バッファの書き込み先は ListWorldTransform と同じく 1 つずつ別に確保する
+struct PooledTraits{
+	struct Transform{
+		Vector3 scale_ = {1.0f, 1.0f, 1.0f};
+		Vector3 rotation_ = {};
+		Vector3 translation_ = {};
+		Matrix4x4 matWorld_ = {};
+		std::unique_ptr<ConstantBufferMemory> constMap;
+	};
+	struct Color{
+		Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+		std::unique_ptr<Vector4> constMap;
+	};
+
+	static void Initialize(Transform& transform){ transform.constMap = std::make_unique<ConstantBufferMemory>(); }
+	static void Initialize(Color& color){ color.constMap = std::make_unique<Vector4>(); }
+	// WorldTransformUpdate (行列を作って定数バッファに書く)
+	static void Transfer(Transform& transform){
+		transform.matWorld_ = ComposeAffineMatrix(transform.scale_,transform.rotation_,transform.translation_);
+		transform.constMap->matrix = transform.matWorld_;
+	}
+};
+
+// ------------------------------------------
+// retry 用: GameScene::Initialize のうち、作り直すたびに CPU でやり直す部分
+// (モデル・テクスチャは AssetCache が持ったままなので読み直さない。GPU への転送は含めない)
+// マップの読み込み・ブロックの並び・敵の生成・初期配置の保存・ビームの予定の確保
+// ------------------------------------------
+struct RetryScene{
+	struct BeamEvent{
+		uint32_t tick;
+		Entity entity;
+		bool operator>(const BeamEvent& other) const{ return tick > other.tick; }
+	};
+	using BeamEvents = std::priority_queue<BeamEvent,std::vector<BeamEvent>,std::greater<BeamEvent>>;
+
+	MapChipField mapChipField;
+	TileInstances blocks;
+	EntityWorld world;
+	BeamEvents beamEvents;
+	uint32_t enemyCount = 0;
+
+	void Initialize(){
+		mapChipField.LoadMapChipCsv("Resources/MapChip2.csv");
+
+		// GenerateBlocks
+		blocks.Build(mapChipField.GetNumBlockHorizontal(),mapChipField.GetNumBlockVirtical(),
+		             [&](uint32_t column,uint32_t row){ return mapChipField.GetMapChipTypeByIndex(column,row) == MapChipType::kBlock; });
+
+		// GenerateEnemies (Enemy::Create と同じコンポーネント。マップの敵はどちらも kBoss で作られる)
+		for(uint32_t i = 0; i < mapChipField.GetNumBlockVirtical(); ++i){
+			for(uint32_t j = 0; j < mapChipField.GetNumBlockHorizontal(); ++j){
+				MapChipType type = mapChipField.GetMapChipTypeByIndex(j,i);
+				if(type != MapChipType::kZako && type != MapChipType::kBoss){
+					continue;
+				}
+				float scale = type == MapChipType::kBoss ? 3.0f : 1.2f;
+				TransformComponent transform{{scale, scale, scale}, {0.0f, 4.712389f, 0.0f}, mapChipField.GetMapChipPositionByIndex(j,i)};
+				EnemyState state;
+				state.type = EnemyType::kBoss;
+				state.hp = 10;
+				world.Create(transform,PrevTransformComponent{transform.rotation, transform.translation},ColorComponent{{1.0f, 0.0f, 0.0f, 1.0f}},state);
+				++enemyCount;
+			}
+		}
+		world.SaveSnapshot();
+
+		std::vector<BeamEvent> beamEventContainer;
+		beamEventContainer.reserve(256);
+		beamEvents = BeamEvents(std::greater<BeamEvent>(),std::move(beamEventContainer));
+	}
+};
+
+} // namespace
+
+// 連射し続けた時の1ティックあたりのヒープ確保の数と時間を、以前の new Beam + std::list と EntityWorld で比べる
+// 定常状態 (温めた後) で EntityWorld の側が 1 回も確保しないことを確かめる
+int Beams(){
+	const uint32_t kShotsPerTick = 4;       // プレイヤーとボス数体が撃ち続ける
+	const uint32_t kWarmupTicks = 600;      // 最初の 10 秒は容量を広げるので数えない
+	const uint32_t kMeasureTicks = 3600;    // その後の 1 分を測る
+	const std::vector<Vector3> enemies = {{14.0f, 1.0f, 0.0f}, {30.0f, 8.0f, 0.0f}, {60.0f, 10.0f, 0.0f}, {80.0f, 6.0f, 0.0f}};
+	// 壁への着弾はゲームと同じマップで求める
+	MapChipField mapChipField;
+	mapChipField.LoadMapChipCsv("Resources/MapChip2.csv");
+
+	struct Result{
+		uint64_t allocations;
+		double ms;
+		uint32_t liveBeams;
+		uint32_t wallHits;
+		uint32_t enemyHits;
+	};
+
+	// --- 以前の書き方: 1 本ごとに new し、std::list に入れ、消えたら remove_if して delete ---
+	// (ゲームではさらに WorldTransform と ObjectColor の定数バッファを 1 本ごとに 2 つ作っていた。GPU なのでここでは数えない)
+	auto runList = [&]() -> Result{
+		struct Event{
+			uint32_t tick;
+			Beam* beam;
+			bool operator>(const Event& other) const{ return tick > other.tick; }
+		};
+		std::list<Beam*> beams;
+		std::priority_queue<Event,std::vector<Event>,std::greater<Event>> events;
+		std::vector<Beam*> finishedBeams;
+		Result result = {};
+		uint64_t startAllocations = 0;
+		auto start = std::chrono::steady_clock::now();
+		uint32_t n = 0;
+		for(uint32_t tick = 0; tick < kWarmupTicks + kMeasureTicks; ++tick){
+			if(tick == kWarmupTicks){
+				startAllocations = GetAllocationCount();
+				start = std::chrono::steady_clock::now();
+				result = {};
+			}
+			// ProcessBeamEvents
+			while(!events.empty() && events.top().tick <= tick){
+				Beam* beam = events.top().beam;
+				events.pop();
+				if(!beam->IsDead()){
+					result.wallHits += beam->IsWallHitEvent();
+					beam->OnCollision();
+				}
+				finishedBeams.push_back(beam);
+			}
+			beams.remove_if([](Beam* beam){ return beam->IsDead(); });
+			for(Beam* beam : finishedBeams){
+				delete beam;
+			}
+			finishedBeams.clear();
+			// FireBeam
+			for(uint32_t i = 0; i < kShotsPerTick; ++i){
+				Beam* beam = new Beam(MakeBeam(n++,tick,mapChipField));
+				beams.push_back(beam);
+				events.push({beam->GetEventTick(), beam});
+			}
+			// CheckAllCollisions (当たったビームはイベントの時に delete する)
+			for(Beam* beam : beams){
+				if(!beam->IsDead() && HitsEnemy(*beam,tick,enemies)){
+					beam->OnCollision();
+					++result.enemyHits;
+				}
+			}
+		}
+		result.ms = ElapsedMs(start);
+		result.allocations = GetAllocationCount() - startAllocations;
+		for(Beam* beam : beams){
+			result.liveBeams += !beam->IsDead();
+		}
+		// 後始末 (どのビームもイベントが1つだけ残っている)
+		while(!events.empty()){
+			delete events.top().beam;
+			events.pop();
+		}
+		return result;
+	};
+
+	// --- 今の書き方: GameScene と同じく EntityWorld に遅延生成し、イベントはエンティティで持つ ---
+	auto runWorld = [&]() -> Result{
+		struct Event{
+			uint32_t tick;
+			Entity entity;
+			bool operator>(const Event& other) const{ return tick > other.tick; }
+		};
+		EntityWorld world;
+		std::vector<Event> eventContainer;
+		eventContainer.reserve(256);
+		std::priority_queue<Event,std::vector<Event>,std::greater<Event>> events(std::greater<Event>(),std::move(eventContainer));
+		Result result = {};
+		uint64_t startAllocations = 0;
+		auto start = std::chrono::steady_clock::now();
+		uint32_t n = 0;
+		for(uint32_t tick = 0; tick < kWarmupTicks + kMeasureTicks; ++tick){
+			if(tick == kWarmupTicks){
+				startAllocations = GetAllocationCount();
+				start = std::chrono::steady_clock::now();
+				result = {};
+			}
+			// ProcessBeamEvents
+			while(!events.empty() && events.top().tick <= tick){
+				Beam* beam = world.Get<Beam>(events.top().entity);
+				events.pop();
+				if(!beam){
+					continue;
+				}
+				if(!beam->IsDead()){
+					result.wallHits += beam->IsWallHitEvent();
+				}
+				beam->OnCollision();
+			}
+			// ReapEntities
+			world.ForEach<Beam>([&](Entity entity,Beam& beam){
+				if(beam.IsDead()){
+					world.DeferDestroy(entity);
+				}
+			});
+			world.Flush();
+			// FireBeam
+			for(uint32_t i = 0; i < kShotsPerTick; ++i){
+				Beam beam = MakeBeam(n++,tick,mapChipField);
+				Entity entity = world.DeferCreate(beam);
+				events.push({beam.GetEventTick(), entity});
+			}
+			world.Flush();
+			// CheckAllCollisions
+			world.ForEach<Beam>([&](Entity,Beam& beam){
+				if(!beam.IsDead() && HitsEnemy(beam,tick,enemies)){
+					beam.OnCollision();
+					++result.enemyHits;
+				}
+			});
+		}
+		result.ms = ElapsedMs(start);
+		result.allocations = GetAllocationCount() - startAllocations;
+		world.ForEach<Beam>([&](Entity,Beam& beam){ result.liveBeams += !beam.IsDead(); });
+		return result;
+	};
+
+	Result list = runList();
+	Result entityWorld = runWorld();
+
+	std::printf("sustained fire: %u shots/tick, %u ticks measured after %u warm-up ticks\n",kShotsPerTick,kMeasureTicks,kWarmupTicks);
+	std::printf("%-28s %14s %12s %10s %10s %10s\n","","allocs/tick","us/tick","live","wall hits","enemy hits");
+	auto print = [&](const char* name,const Result& result){
+		std::printf("%-28s %14.2f %12.3f %10u %10u %10u\n",name,static_cast<double>(result.allocations) / kMeasureTicks,result.ms * 1000.0 / kMeasureTicks,result.liveBeams,result.wallHits,result.enemyHits);
+	};
+	print("new Beam + std::list",list);
+	print("EntityWorld",entityWorld);
+	std::printf("(the list path also created 2 GPU constant buffers per shot: %u per tick)\n",kShotsPerTick * 2);
+
+	bool isMatched = list.liveBeams == entityWorld.liveBeams && list.wallHits == entityWorld.wallHits && list.enemyHits == entityWorld.enemyHits;
+	if(!isMatched){
+		std::printf("FAILED: the two paths disagree on the beams\n");
+	}
+	if(entityWorld.allocations != 0){
+		std::printf("FAILED: EntityWorld allocated %llu times in steady state\n",static_cast<unsigned long long>(entityWorld.allocations));
+	}
+	return isMatched && entityWorld.allocations == 0 ? 0 : 1;
+}
+
+// 敵・ビーム・ヒットエフェクトを数を変えて動かし、1ティック (+ 描画の準備 1 回) の時間を以前の std::list<T*> と EntityWorld で比べる
+// 敵は 10 列 x 4k 行に並べ、各行にビームを撃ち続ける (k 倍すると敵もビームも k 倍)。倒れた敵は同じ場所に出し直す
+// GPU への描画は含めない (どちらも同じ数の描画コマンドになる)
+int Entities(){
+	const uint32_t kScales[] = {1, 4, 10};
+	const uint32_t kWarmupTicks = 240;
+	const uint32_t kMeasureTicks = 600;
+	const float kEnemyRadius = 1.5f;
+	const float kBeamRadius = 0.5f;
+	const Vector3 kEnemyScale = {kEnemyRadius, kEnemyRadius, kEnemyRadius};
+	const Vector3 kEnemyRotation = {0.0f, 4.712389f, 0.0f};
+	// プレイヤーの箱 (敵からは離れていて、体当たりは起きない)
+	const Vector3 kPlayerMin = {-12.0f, -2.0f, -1.0f};
+	const Vector3 kPlayerMax = {-10.0f, 2.0f, 1.0f};
+	const float kEnemyHalfSize = 0.4f;
+
+	struct Result{
+		uint32_t enemies;
+		double us;
+		double collisionUs; // うちビーム x 敵 の当たり判定
+		uint32_t hits;
+		uint32_t respawns;
+		uint32_t liveBeams;
+		uint32_t liveEffects;
+	};
+
+	auto enemyPosition = [](uint32_t index){ return Vector3{20.0f + 6.0f * (index % 10), 6.0f * (index / 10), 0.0f}; };
+	// (マップの外なので壁には当たらず、寿命で消える)
+	auto makeBeam = [](uint32_t n,uint32_t rows,uint32_t tick){
+		Beam beam;
+		beam.Initialize({0.0f, 6.0f * (n % rows), 0.0f},{0.5f, 0.0f, 0.0f},tick,nullptr);
+		return beam;
+	};
+	auto overlapsPlayer = [&](const Vector3& position){
+		return position.x + kEnemyHalfSize >= kPlayerMin.x && position.x - kEnemyHalfSize <= kPlayerMax.x && position.y + kEnemyHalfSize >= kPlayerMin.y &&
+		       position.y - kEnemyHalfSize <= kPlayerMax.y && position.z + kEnemyHalfSize >= kPlayerMin.z && position.z - kEnemyHalfSize <= kPlayerMax.z;
+	};
+	auto isHit = [&](const Vector3& beamPosition,const Vector3& enemyPosition){
+		float dx = beamPosition.x - enemyPosition.x;
+		float dy = beamPosition.y - enemyPosition.y;
+		float dz = beamPosition.z - enemyPosition.z;
+		float r = kBeamRadius + kEnemyRadius;
+		return dx * dx + dy * dy + dz * dz <= r * r;
+	};
+
+	// --- 以前の書き方: std::list<T*> に 1 個ずつ new したオブジェクト ---
+	auto runList = [&](uint32_t scale) -> Result{
+		const uint32_t rows = 4 * scale;
+		const uint32_t enemyCount = 10 * rows;
+		ListInterpolator interpolator;
+		std::list<ListEnemy*> enemies;
+		std::list<ListBeam*> beams;
+		std::list<ListHitEffect*> effects;
+		std::vector<uint32_t> enemySlots; // 出し直す場所 (敵ごと)
+		auto spawnEnemy = [&](uint32_t index){
+			ListEnemy* enemy = new ListEnemy();
+			enemy->worldTransform.translation = enemyPosition(index);
+			enemy->worldTransform.rotation = kEnemyRotation;
+			enemy->worldTransform.scale = kEnemyScale;
+			enemy->objectColor.SetColor({0.5f, 1.0f, 0.5f, 1.0f});
+			enemy->walkTimer = static_cast<float>(index); // (出し直す場所を覚えておく)
+			enemy->worldTransform.Update();
+			interpolator.Register(&enemy->worldTransform);
+			enemies.push_back(enemy);
+		};
+		for(uint32_t i = 0; i < enemyCount; ++i){
+			spawnEnemy(i);
+		}
+
+		Result result = {enemyCount, 0.0, 0.0, 0, 0, 0, 0};
+		auto start = std::chrono::steady_clock::now();
+		uint32_t n = 0;
+		for(uint32_t tick = 0; tick < kWarmupTicks + kMeasureTicks; ++tick){
+			if(tick == kWarmupTicks){
+				start = std::chrono::steady_clock::now();
+				result = {enemyCount, 0.0, 0.0, 0, 0, 0, 0};
+			}
+			interpolator.SaveState();
+			// 更新
+			for(ListEnemy* enemy : enemies){
+				enemy->Update();
+			}
+			for(ListHitEffect* effect : effects){
+				effect->Update();
+			}
+			for(uint32_t i = 0; i < scale; ++i){
+				ListBeam* beam = new ListBeam();
+				beam->beam = makeBeam(n++,rows,tick);
+				beam->worldTransform.scale = {0.5f, 0.5f, 0.5f};
+				beam->objectColor.SetColor({1.0f, 1.0f, 0.0f, 1.0f});
+				beams.push_back(beam);
+			}
+			// 当たり判定
+			for(ListEnemy* enemy : enemies){
+				if(!enemy->isCollisionDisabled && overlapsPlayer(enemy->GetWorldPosition())){
+					enemy->OnCollision();
+				}
+			}
+			auto collisionStart = std::chrono::steady_clock::now();
+			for(ListBeam* beam : beams){
+				if(beam->beam.IsDead()){
+					continue;
+				}
+				Vector3 position = beam->beam.GetWorldPosition(tick);
+				for(ListEnemy* enemy : enemies){
+					Vector3 enemyPosition = enemy->GetWorldPosition();
+					if(isHit(position,enemyPosition)){
+						beam->beam.OnCollision();
+						enemy->OnCollision();
+						ListHitEffect* effect = new ListHitEffect();
+						for(ListWorldTransform& worldTransform : effect->ellipseWorldTransforms){
+							worldTransform.translation = {enemyPosition.x, enemyPosition.y, -1.0f};
+						}
+						effect->circleWorldTransform.translation = {enemyPosition.x, enemyPosition.y, -1.0f};
+						effects.push_back(effect);
+						++result.hits;
+						break;
+					}
+				}
+			}
+			result.collisionUs += ElapsedMs(collisionStart);
+			// 寿命切れ
+			for(ListBeam* beam : beams){
+				if(tick + 1 >= beam->beam.GetEventTick()){
+					beam->beam.OnCollision();
+				}
+			}
+			// 消えたものを消す (敵は同じ場所に出し直す)
+			std::vector<uint32_t> respawns;
+			enemies.remove_if([&](ListEnemy* enemy){
+				if(!enemy->isDead){
+					return false;
+				}
+				respawns.push_back(static_cast<uint32_t>(enemy->walkTimer));
+				interpolator.Unregister(&enemy->worldTransform);
+				delete enemy;
+				return true;
+			});
+			for(uint32_t index : respawns){
+				spawnEnemy(index);
+				++result.respawns;
+			}
+			beams.remove_if([](ListBeam* beam){
+				if(!beam->beam.IsDead()){
+					return false;
+				}
+				delete beam;
+				return true;
+			});
+			effects.remove_if([](ListHitEffect* effect){
+				if(effect->phase != 2){
+					return false;
+				}
+				delete effect;
+				return true;
+			});
+
+			// 描画の準備 (敵は補間して送り、ビームは描く時に行列を作って送る)
+			interpolator.Interpolate(0.5f);
+			for(ListBeam* beam : beams){
+				ListWorldTransform& worldTransform = beam->worldTransform;
+				worldTransform.translation = beam->beam.GetRenderPosition(tick,0.5f);
+				worldTransform.Update();
+			}
+		}
+		result.us = ElapsedMs(start) * 1000.0 / kMeasureTicks;
+		result.collisionUs *= 1000.0 / kMeasureTicks;
+		result.liveBeams = static_cast<uint32_t>(beams.size());
+		result.liveEffects = static_cast<uint32_t>(effects.size());
+		for(ListEnemy* enemy : enemies){
+			delete enemy;
+		}
+		for(ListBeam* beam : beams){
+			delete beam;
+		}
+		for(ListHitEffect* effect : effects){
+			delete effect;
+		}
+		return result;
+	};
+
+	// --- 今の書き方: GameScene と同じく EntityWorld のコンポーネントを ForEach で回し、描画は RenderResourcePool から借りる ---
+	// useGrid: ビーム x 敵 を CollisionGrid で絞る (GameScene と同じ)。false は総当たり
+	auto runWorld = [&](uint32_t scale,bool useGrid) -> Result{
+		const uint32_t rows = 4 * scale;
+		const uint32_t enemyCount = 10 * rows;
+		EntityWorld world;
+		RenderResourcePoolBase<PooledTraits> pool;
+		CollisionGrid enemyGrid;
+		struct GridEnemy{
+			EnemyState* state;
+			TransformComponent* transform;
+		};
+		std::vector<GridEnemy> gridEnemies;
+		auto spawnEnemy = [&](uint32_t index){
+			TransformComponent transform{kEnemyScale, kEnemyRotation, enemyPosition(index)};
+			EnemyState state;
+			state.fireTimer = static_cast<int>(index); // (出し直す場所を覚えておく)
+			world.Create(transform,PrevTransformComponent{transform.rotation, transform.translation},ColorComponent{{0.5f, 1.0f, 0.5f, 1.0f}},state);
+		};
+		for(uint32_t i = 0; i < enemyCount; ++i){
+			spawnEnemy(i);
+		}
+
+		Result result = {enemyCount, 0.0, 0.0, 0, 0, 0, 0};
+		auto start = std::chrono::steady_clock::now();
+		uint32_t n = 0;
+		std::vector<uint32_t> respawns;
+		for(uint32_t tick = 0; tick < kWarmupTicks + kMeasureTicks; ++tick){
+			if(tick == kWarmupTicks){
+				start = std::chrono::steady_clock::now();
+				result = {enemyCount, 0.0, 0.0, 0, 0, 0, 0};
+			}
+			// 更新 (Enemy::UpdateAll / HitEffect::UpdateAll)
+			world.ForEach<TransformComponent,PrevTransformComponent,EnemyState>([](Entity,TransformComponent& transform,PrevTransformComponent& prevTransform,EnemyState& state){
+				prevTransform.rotation = transform.rotation;
+				prevTransform.translation = transform.translation;
+				if(state.behaviorRequest != EnemyBehavior::kUnknown){
+					state.behavior = state.behaviorRequest;
+					state.counter = 0.0f;
+					state.behaviorRequest = EnemyBehavior::kUnknown;
+				}
+				if(state.behavior == EnemyBehavior::kDefeated){
+					state.counter += kDeltaTime;
+					transform.rotation.y += 0.3f;
+					transform.rotation.x = EaseOut(0.0f,kDefeatedAngleEnd,state.counter / kDefeatedTime);
+					if(state.counter >= kDefeatedTime){
+						state.isDead = true;
+					}
+				}
+			});
+			world.ForEach<HitEffectState>([](Entity,HitEffectState& state){
+				if(state.phase == HitEffectPhase::kSpread){
+					++state.counter;
+					state.scale = 0.5f + static_cast<float>(state.counter) / kSpreadTime * 0.5f;
+					if(state.counter >= kSpreadTime){
+						state.phase = HitEffectPhase::kFade;
+						state.counter = 0;
+					}
+				}
+				else if(state.phase == HitEffectPhase::kFade){
+					++state.counter;
+					state.alpha = 1.0f - static_cast<float>(state.counter) / kFadeTime;
+					if(++state.counter >= kFadeTime){
+						state.phase = HitEffectPhase::kDead;
+					}
+				}
+			});
+			for(uint32_t i = 0; i < scale; ++i){
+				world.DeferCreate(makeBeam(n++,rows,tick));
+			}
+			world.Flush();
+			// 当たり判定 (CheckAllCollisions)
+			world.ForEach<EnemyState,TransformComponent>([&](Entity,EnemyState& state,TransformComponent& transform){
+				if(!state.isCollisionDisabled && overlapsPlayer(transform.translation) && state.behavior != EnemyBehavior::kDefeated){
+					state.hp = 0;
+					state.behaviorRequest = EnemyBehavior::kDefeated;
+					state.isCollisionDisabled = true;
+				}
+			});
+			auto collisionStart = std::chrono::steady_clock::now();
+			auto onHit = [&](Beam& beam,EnemyState& state,const TransformComponent& transform){
+				beam.OnCollision();
+				if(state.behavior != EnemyBehavior::kDefeated){
+					state.hp = 0;
+					state.behaviorRequest = EnemyBehavior::kDefeated;
+					state.isCollisionDisabled = true;
+				}
+				HitEffectState effect;
+				effect.position = {transform.translation.x, transform.translation.y, -1.0f};
+				world.DeferCreate(effect);
+				++result.hits;
+			};
+			if(useGrid){
+				enemyGrid.Clear();
+				gridEnemies.clear();
+				world.ForEach<EnemyState,TransformComponent>([&](Entity,EnemyState& state,TransformComponent& transform){
+					enemyGrid.Add(transform.translation,kEnemyRadius);
+					gridEnemies.push_back({&state, &transform});
+				});
+				enemyGrid.Build(MapChipField::kBlockWidth);
+				world.ForEach<Beam>([&](Entity,Beam& beam){
+					if(beam.IsDead()){
+						return;
+					}
+					uint32_t index = enemyGrid.FindFirst(beam.GetWorldPosition(tick),kBeamRadius);
+					if(index != CollisionGrid::kNone){
+						onHit(beam,*gridEnemies[index].state,*gridEnemies[index].transform);
+					}
+				});
+			}
+			else{
+				world.ForEach<Beam>([&](Entity,Beam& beam){
+					if(beam.IsDead()){
+						return;
+					}
+					Vector3 position = beam.GetWorldPosition(tick);
+					world.ForEach<EnemyState,TransformComponent>([&](Entity,EnemyState& state,TransformComponent& transform){
+						if(beam.IsDead() || !isHit(position,transform.translation)){
+							return;
+						}
+						onHit(beam,state,transform);
+					});
+				});
+			}
+			world.Flush();
+			result.collisionUs += ElapsedMs(collisionStart);
+			// 寿命切れと、消えたものを消す (ReapEntities。敵は同じ場所に出し直す)
+			respawns.clear();
+			world.ForEach<EnemyState>([&](Entity entity,EnemyState& state){
+				if(state.isDead){
+					respawns.push_back(static_cast<uint32_t>(state.fireTimer));
+					world.DeferDestroy(entity);
+				}
+			});
+			world.ForEach<HitEffectState>([&](Entity entity,HitEffectState& state){
+				if(state.phase == HitEffectPhase::kDead){
+					world.DeferDestroy(entity);
+				}
+			});
+			world.ForEach<Beam>([&](Entity entity,Beam& beam){
+				if(beam.IsDead() || tick + 1 >= beam.GetEventTick()){
+					world.DeferDestroy(entity);
+				}
+			});
+			world.Flush();
+			for(uint32_t index : respawns){
+				spawnEnemy(index);
+				++result.respawns;
+			}
+
+			// 描画の準備 (Enemy::DrawAll / HitEffect::DrawAll / ビーム。止まっているものは追跡で送らない)
+			pool.Reset();
+			world.ForEach<TransformComponent,PrevTransformComponent,ColorComponent>([&](Entity,TransformComponent& transform,PrevTransformComponent& prevTransform,ColorComponent&){
+				pool.AcquireTransform(transform.scale,Lerp(prevTransform.rotation,transform.rotation,0.5f),Lerp(prevTransform.translation,transform.translation,0.5f));
+			});
+			world.ForEach<HitEffectState>([&](Entity,HitEffectState& state){
+				for(float rotation : state.ellipseRotations){
+					pool.AcquireTransform({0.1f, state.scale * 2.0f, 1.0f},{0.0f, 0.0f, rotation},state.position);
+				}
+				pool.AcquireTransform({state.scale, state.scale, 1.0f},{},state.position);
+			});
+			world.ForEach<Beam>([&](Entity,Beam& beam){
+				pool.AcquireTransform({0.5f, 0.5f, 0.5f},{},beam.GetRenderPosition(tick,0.5f));
+			});
+		}
+		result.us = ElapsedMs(start) * 1000.0 / kMeasureTicks;
+		result.collisionUs *= 1000.0 / kMeasureTicks;
+		result.liveBeams = world.Count<Beam>();
+		result.liveEffects = world.Count<HitEffectState>();
+		return result;
+	};
+
+	std::printf("%u ticks after %u warm-up ticks, each with one frame of draw preparation (no GPU)\n",kMeasureTicks,kWarmupTicks);
+	std::printf("us/tick: total (of which beam x enemy collision). EntityWorld runs all pairs, +grid runs CollisionGrid as GameScene does\n");
+	std::printf("%8s %8s %8s %8s %8s | %22s %22s %22s\n","enemies","beams","effects","hits","respawns","std::list","EntityWorld","EntityWorld+grid");
+	bool isAllMatched = true;
+	std::vector<Result> listResults;
+	std::vector<Result> gridResults;
+	for(uint32_t scale : kScales){
+		Result list = runList(scale);
+		Result allPairs = runWorld(scale,false);
+		Result grid = runWorld(scale,true);
+		listResults.push_back(list);
+		gridResults.push_back(grid);
+		std::printf("%8u %8u %8u %8u %8u | %10.1f (%9.1f) %10.1f (%9.1f) %10.1f (%9.1f)\n",list.enemies,list.liveBeams,list.liveEffects,list.hits,list.respawns,list.us,list.collisionUs,
+		            allPairs.us,allPairs.collisionUs,grid.us,grid.collisionUs);
+		for(const Result& result : {allPairs, grid}){
+			if(list.hits != result.hits || list.respawns != result.respawns || list.liveBeams != result.liveBeams || list.liveEffects != result.liveEffects){
+				std::printf("FAILED: EntityWorld disagrees (hits %u, respawns %u, beams %u, effects %u)\n",result.hits,result.respawns,result.liveBeams,result.liveEffects);
+				isAllMatched = false;
+			}
+		}
+	}
+	// 目標: 数を増やしても、std::list の 1x 以下の時間で回るか
+	for(size_t i = 1; i < gridResults.size(); ++i){
+		std::printf("EntityWorld+grid with %ux the entities: %.1f us/tick (%.1f collision), std::list at 1x: %.1f us/tick -> %.1fx the 1x cost\n",kScales[i],gridResults[i].us,gridResults[i].collisionUs,
+		            listResults[0].us,gridResults[i].us / listResults[0].us);
+	}
+	return isAllMatched ? 0 : 1;
+}
+
+// 死んだ後のリトライにかかる CPU の時間を、シーンを作り直す以前の書き方と GameScene::Reset (EntityWorld の初期配置に戻す) で比べる
+// 毎回、敵を半分倒してビームを撃った状態からリトライする
+// (どちらもゲームと同じ MapChipField・TileInstances・EntityWorld を動かす。モデル・テクスチャはどちらもキャッシュから取るので測らない
+//  プレイヤー・カメラ・エフェクトを戻す部分は D3D を使うのでここでは動かせない)
+int Retry(){
+	const uint32_t kRetries = 200;
+
+	// 遊んだ後の状態にする (敵を半分倒し、ビームを 64 本撃つ)
+	auto play = [](RetryScene& scene){
+		uint32_t index = 0;
+		scene.world.ForEach<EnemyState>([&](Entity entity,EnemyState&){
+			if(index++ % 2 == 0){
+				scene.world.DeferDestroy(entity);
+			}
+		});
+		for(uint32_t i = 0; i < 64; ++i){
+			Beam beam;
+			beam.Initialize({static_cast<float>(i), 2.0f, 0.0f},{0.5f, 0.0f, 0.0f},i,&scene.mapChipField);
+			scene.beamEvents.push({beam.GetEventTick(), scene.world.DeferCreate(beam)});
+		}
+		scene.world.Flush();
+	};
+
+	// 以前の書き方: シーンを消して作り直す
+	double rebuildMs = 0.0;
+	double rebuildMinMs = 1e9;
+	uint64_t rebuildAllocations = 0;
+	auto scene = std::make_unique<RetryScene>();
+	scene->Initialize();
+	const uint32_t enemyCount = scene->enemyCount;
+	for(uint32_t retry = 0; retry < kRetries; ++retry){
+		play(*scene);
+		uint64_t startAllocations = GetAllocationCount();
+		auto start = std::chrono::steady_clock::now();
+		scene.reset();
+		scene = std::make_unique<RetryScene>();
+		scene->Initialize();
+		double ms = ElapsedMs(start);
+		rebuildAllocations += GetAllocationCount() - startAllocations;
+		rebuildMs += ms;
+		rebuildMinMs = std::min(rebuildMinMs,ms);
+	}
+
+	// GameScene::Reset: 作ったものは使い回し、EntityWorld を保存した初期配置に戻す
+	double resetMs = 0.0;
+	double resetMinMs = 1e9;
+	uint64_t resetAllocations = 0;
+	bool isMatched = true;
+	RetryScene& resetScene = *scene;
+	for(uint32_t retry = 0; retry < kRetries; ++retry){
+		play(resetScene);
+		uint64_t startAllocations = GetAllocationCount();
+		auto start = std::chrono::steady_clock::now();
+		resetScene.world.RestoreSnapshot();
+		while(!resetScene.beamEvents.empty()){
+			resetScene.beamEvents.pop();
+		}
+		double ms = ElapsedMs(start);
+		resetAllocations += GetAllocationCount() - startAllocations;
+		resetMs += ms;
+		resetMinMs = std::min(resetMinMs,ms);
+
+		// 作り直したシーンと同じ状態に戻っているか
+		if(resetScene.world.Count<EnemyState>() != enemyCount || resetScene.world.Count<Beam>() != 0){
+			isMatched = false;
+		}
+	}
+	RetryScene fresh;
+	fresh.Initialize();
+	std::vector<Vector3> expected;
+	std::vector<Vector3> restored;
+	fresh.world.ForEach<TransformComponent>([&](Entity,TransformComponent& transform){ expected.push_back(transform.translation); });
+	resetScene.world.ForEach<TransformComponent>([&](Entity,TransformComponent& transform){ restored.push_back(transform.translation); });
+	auto isLess = [](const Vector3& a,const Vector3& b){ return a.x != b.x ? a.x < b.x : a.y < b.y; };
+	std::sort(expected.begin(),expected.end(),isLess);
+	std::sort(restored.begin(),restored.end(),isLess);
+	isMatched = isMatched && expected.size() == restored.size();
+	for(size_t i = 0; isMatched && i < expected.size(); ++i){
+		isMatched = expected[i].x == restored[i].x && expected[i].y == restored[i].y && expected[i].z == restored[i].z;
+	}
+
+	std::printf("scene: %ux%u map, %u blocks, %u enemies, %u retries (models and textures stay in AssetCache on both paths)\n",fresh.mapChipField.GetNumBlockHorizontal(),
+	            fresh.mapChipField.GetNumBlockVirtical(),fresh.blocks.GetCount(),enemyCount,kRetries);
+	std::printf("%-38s %12s %12s %16s\n","","mean us","min us","heap allocs");
+	std::printf("%-38s %12.2f %12.2f %16.1f\n","rebuild (delete + Initialize, CPU part)",rebuildMs * 1000.0 / kRetries,rebuildMinMs * 1000.0,static_cast<double>(rebuildAllocations) / kRetries);
+	std::printf("%-38s %12.2f %12.2f %16.1f\n","GameScene::Reset (RestoreSnapshot)",resetMs * 1000.0 / kRetries,resetMinMs * 1000.0,static_cast<double>(resetAllocations) / kRetries);
+	std::printf("(the rebuild also recreates the scene's constant buffers and the tile instance buffer on the GPU, which is not measured here)\n");
+	if(!isMatched){
+		std::printf("FAILED: the reset scene does not match a freshly built one\n");
+	}
+	return isMatched ? 0 : 1;
+}
@@ -0,0 +1,804 @@
+// ==========================================
+// AssetCooker の確かめ・計測 (数学)
+// TransformHierarchy・SimdMath・MathKernels・ConstexprMath を math.cpp の以前の書き方と比べ、結果の差と時間を出す
+// ==========================================
+#include "Commands.h"
+#include "ConstexprMath.h"
+#include "MathKernels.h"
+#include "SimdMath.h"
+#include "ToolCommon.h"
+#include "TransformHierarchy.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace{
+
+// math.cpp の MakeAffineMatrix / operator*= と同じ計算 (ツールは math.cpp をリンクしないので写しを置く)
+Matrix4x4 MultiplyReference(const Matrix4x4& lhm,const Matrix4x4& rhm){
+	Matrix4x4 result{};
+	for(size_t i = 0; i < 4; i++){
+		for(size_t j = 0; j < 4; j++){
+			for(size_t k = 0; k < 4; k++){
+				result.m[i][j] += lhm.m[i][k] * rhm.m[k][j];
+			}
+		}
+	}
+	return result;
+}
+
+Matrix4x4 MakeAffineMatrixReference(const Vector3& scale,const Vector3& rot,const Vector3& translate){
+	Matrix4x4 matScale{scale.x, 0.0f, 0.0f, 0.0f, 0.0f, scale.y, 0.0f, 0.0f, 0.0f, 0.0f, scale.z, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	float sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos(rot.x,sinX,cosX);
+	Matrix4x4 matRotX{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, cosX, sinX, 0.0f, 0.0f, -sinX, cosX, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	SinCos(rot.y,sinY,cosY);
+	Matrix4x4 matRotY{cosY, 0.0f, -sinY, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, sinY, 0.0f, cosY, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	SinCos(rot.z,sinZ,cosZ);
+	Matrix4x4 matRotZ{cosZ, sinZ, 0.0f, 0.0f, -sinZ, cosZ, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	Matrix4x4 matRot = MultiplyReference(MultiplyReference(matRotZ,matRotX),matRotY);
+	Matrix4x4 matTrans{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, translate.x, translate.y, translate.z, 1.0f};
+	return MultiplyReference(MultiplyReference(matScale,matRot),matTrans);
+}
+
+// 2つの行列の成分の差の最大
+float MaxDifference(const Matrix4x4& a,const Matrix4x4& b){
+	float difference = 0.0f;
+	for(size_t i = 0; i < 4; ++i){
+		for(size_t j = 0; j < 4; ++j){
+			difference = std::max(difference,std::abs(a.m[i][j] - b.m[i][j]));
+		}
+	}
+	return difference;
+}
+
+} // namespace
+
+// 10 万個のトランスフォームの木 (根 1000 個、深さ 8 前後) のワールド行列を作る時間を比べる
+// これまでの書き方 (1個ずつ MakeAffineMatrix して親を掛ける) と、TransformHierarchy のスカラー・SIMD
+int Hierarchy(){
+	const uint32_t kNodeCount = 100000;
+	const uint32_t kRootCount = 1000;
+	const uint32_t kFrameCount = 50;
+	const uint32_t kMovingPerFrame = kNodeCount / 100; // 一部だけ動く時に動かす数
+
+	// これまでの書き方 (WorldTransform と同じく 1 個ずつ値と行列を持つ)
+	struct Node{
+		Vector3 scale;
+		Vector3 rotation;
+		Vector3 translation;
+		int32_t parent;
+		Matrix4x4 matWorld;
+	};
+	std::mt19937 random(2024);
+	std::uniform_real_distribution<float> angle(-3.14f,3.14f);
+	std::uniform_real_distribution<float> offset(-2.0f,2.0f);
+	std::uniform_real_distribution<float> scale(0.8f,1.2f);
+	std::vector<Node> nodes(kNodeCount);
+	for(uint32_t i = 0; i < kNodeCount; ++i){
+		Node& node = nodes[i];
+		node.scale = {scale(random), scale(random), scale(random)};
+		node.rotation = {angle(random), angle(random), angle(random)};
+		node.translation = {offset(random), offset(random), offset(random)};
+		// 親は自分より前の後ろ半分から選ぶ (根から 8 段くらいになる)
+		node.parent = i < kRootCount ? -1 : static_cast<int32_t>(std::uniform_int_distribution<uint32_t>(i / 2,i - 1)(random));
+	}
+	auto updateReference = [&nodes](){
+		for(Node& node : nodes){
+			node.matWorld = MakeAffineMatrixReference(node.scale,node.rotation,node.translation);
+			if(node.parent >= 0){
+				node.matWorld = MultiplyReference(node.matWorld,nodes[node.parent].matWorld);
+			}
+		}
+	};
+
+	TransformHierarchy scalarHierarchy;
+	TransformHierarchy simdHierarchy;
+	std::vector<TransformHierarchy::Handle> handles(kNodeCount);
+	for(uint32_t i = 0; i < kNodeCount; ++i){
+		const Node& node = nodes[i];
+		TransformHierarchy::Handle parent = node.parent < 0 ? TransformHierarchy::kNone : handles[node.parent];
+		handles[i] = scalarHierarchy.Create(parent,node.scale,node.rotation,node.translation);
+		simdHierarchy.Create(parent,node.scale,node.rotation,node.translation);
+	}
+
+	// 全て動く時: 毎フレーム全部の回転を変える
+	auto spin = [&](uint32_t frame,uint32_t index){
+		nodes[index].rotation.y += 0.01f * static_cast<float>((frame + index) % 7);
+		scalarHierarchy.SetRotation(handles[index],nodes[index].rotation);
+		simdHierarchy.SetRotation(handles[index],nodes[index].rotation);
+	};
+	double referenceMs = 0.0;
+	double scalarMs = 0.0;
+	double simdMs = 0.0;
+	for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+		for(uint32_t i = 0; i < kNodeCount; ++i){
+			spin(frame,i);
+		}
+		auto start = std::chrono::steady_clock::now();
+		updateReference();
+		referenceMs += ElapsedMs(start);
+		start = std::chrono::steady_clock::now();
+		scalarHierarchy.Update(TransformHierarchy::Path::kScalar);
+		scalarMs += ElapsedMs(start);
+		start = std::chrono::steady_clock::now();
+		simdHierarchy.Update(TransformHierarchy::Path::kSimd);
+		simdMs += ElapsedMs(start);
+	}
+	uint32_t fullUpdatedCount = simdHierarchy.GetUpdatedCount();
+
+	// 結果の比べ方: SIMD とスカラーは完全に同じ、これまでの書き方とは差の最大を出す
+	uint32_t simdMismatchCount = 0;
+	float maxDifference = 0.0f;
+	auto compare = [&](){
+		simdMismatchCount = 0;
+		maxDifference = 0.0f;
+		for(uint32_t i = 0; i < kNodeCount; ++i){
+			const Matrix4x4& simd = simdHierarchy.GetWorldMatrix(handles[i]);
+			simdMismatchCount += MaxDifference(simd,scalarHierarchy.GetWorldMatrix(handles[i])) == 0.0f ? 0 : 1;
+			maxDifference = std::max(maxDifference,MaxDifference(simd,nodes[i].matWorld));
+		}
+	};
+	compare();
+	uint32_t fullSimdMismatchCount = simdMismatchCount;
+	float fullMaxDifference = maxDifference;
+
+	// 一部だけ動く時: 毎フレーム 1% の回転を変える (子孫も作り直しになる)
+	// これまでの書き方はどれが変わったか分からないので全部作る
+	double partialScalarMs = 0.0;
+	double partialSimdMs = 0.0;
+	uint64_t partialUpdatedCount = 0;
+	std::uniform_int_distribution<uint32_t> pick(0,kNodeCount - 1);
+	for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+		for(uint32_t i = 0; i < kMovingPerFrame; ++i){
+			spin(frame,pick(random));
+		}
+		auto start = std::chrono::steady_clock::now();
+		scalarHierarchy.Update(TransformHierarchy::Path::kScalar);
+		partialScalarMs += ElapsedMs(start);
+		start = std::chrono::steady_clock::now();
+		simdHierarchy.Update(TransformHierarchy::Path::kSimd);
+		partialSimdMs += ElapsedMs(start);
+		partialUpdatedCount += simdHierarchy.GetUpdatedCount();
+	}
+	updateReference();
+	compare();
+	uint32_t partialSimdMismatchCount = simdMismatchCount;
+	float partialMaxDifference = maxDifference;
+
+	// 親の付け替え (並べ直しが起きる) と、子孫ごとの削除のあとも合っているか
+	std::vector<uint8_t> isAlive(kNodeCount,1);
+	for(uint32_t i = 0; i < 200; ++i){
+		uint32_t child = pick(random);
+		uint32_t parent = pick(random);
+		// 自分の子孫は親にできない
+		bool isDescendant = false;
+		for(int32_t p = static_cast<int32_t>(parent); p >= 0; p = nodes[p].parent){
+			isDescendant |= p == static_cast<int32_t>(child);
+		}
+		if(isDescendant){
+			continue;
+		}
+		nodes[child].parent = static_cast<int32_t>(parent);
+		scalarHierarchy.SetParent(handles[child],handles[parent]);
+		simdHierarchy.SetParent(handles[child],handles[parent]);
+	}
+	for(uint32_t i = 0; i < 3; ++i){
+		uint32_t root = pick(random);
+		if(!isAlive[root]){
+			continue;
+		}
+		scalarHierarchy.Destroy(handles[root]);
+		simdHierarchy.Destroy(handles[root]);
+		// 子孫を探す (親が後ろにいることもあるので、変わらなくなるまで繰り返す)
+		isAlive[root] = 0;
+		for(bool isChanged = true; isChanged;){
+			isChanged = false;
+			for(uint32_t n = 0; n < kNodeCount; ++n){
+				if(isAlive[n] && nodes[n].parent >= 0 && !isAlive[nodes[n].parent]){
+					isAlive[n] = 0;
+					isChanged = true;
+				}
+			}
+		}
+	}
+	scalarHierarchy.Update(TransformHierarchy::Path::kScalar);
+	simdHierarchy.Update(TransformHierarchy::Path::kSimd);
+	// 付け替えたものが親より前にいることがあるので、親から順に作る
+	std::vector<uint8_t> isDone(kNodeCount,0);
+	for(bool isChanged = true; isChanged;){
+		isChanged = false;
+		for(uint32_t n = 0; n < kNodeCount; ++n){
+			Node& node = nodes[n];
+			if(!isAlive[n] || isDone[n] || (node.parent >= 0 && !isDone[node.parent])){
+				continue;
+			}
+			node.matWorld = MakeAffineMatrixReference(node.scale,node.rotation,node.translation);
+			if(node.parent >= 0){
+				node.matWorld = MultiplyReference(node.matWorld,nodes[node.parent].matWorld);
+			}
+			isDone[n] = 1;
+			isChanged = true;
+		}
+	}
+	uint32_t aliveCount = 0;
+	uint32_t editMismatchCount = 0;
+	uint32_t parentMismatchCount = 0;
+	float editMaxDifference = 0.0f;
+	for(uint32_t i = 0; i < kNodeCount; ++i){
+		if(!isAlive[i]){
+			continue;
+		}
+		++aliveCount;
+		const Matrix4x4& simd = simdHierarchy.GetWorldMatrix(handles[i]);
+		editMismatchCount += MaxDifference(simd,scalarHierarchy.GetWorldMatrix(handles[i])) == 0.0f ? 0 : 1;
+		editMaxDifference = std::max(editMaxDifference,MaxDifference(simd,nodes[i].matWorld));
+		TransformHierarchy::Handle parent = nodes[i].parent < 0 ? TransformHierarchy::kNone : handles[nodes[i].parent];
+		parentMismatchCount += simdHierarchy.GetParent(handles[i]) == parent ? 0 : 1;
+	}
+
+	// 丸めの違いだけなら値の大きさに比べて十分小さい
+	const float kTolerance = 1e-3f;
+	bool isMatched = fullSimdMismatchCount == 0 && partialSimdMismatchCount == 0 && editMismatchCount == 0 && parentMismatchCount == 0 &&
+	                 fullMaxDifference <= kTolerance && partialMaxDifference <= kTolerance && editMaxDifference <= kTolerance &&
+	                 aliveCount == simdHierarchy.GetCount();
+
+	std::printf("%u transforms (%u roots)\n",kNodeCount,kRootCount);
+	std::printf("all moving (%u updated per frame):\n",fullUpdatedCount);
+	std::printf("  per object (MakeAffineMatrix) %7.3f ms/frame\n",referenceMs / kFrameCount);
+	std::printf("  hierarchy scalar              %7.3f ms/frame (%.2fx)\n",scalarMs / kFrameCount,referenceMs / scalarMs);
+	std::printf("  hierarchy SIMD                %7.3f ms/frame (%.2fx)\n",simdMs / kFrameCount,referenceMs / simdMs);
+	std::printf("  max difference from per object %g, SIMD/scalar mismatches %u\n",fullMaxDifference,fullSimdMismatchCount);
+	std::printf("%u of %u moving (%.0f updated per frame with their descendants):\n",kMovingPerFrame,kNodeCount,static_cast<double>(partialUpdatedCount) / kFrameCount);
+	std::printf("  per object (MakeAffineMatrix) %7.3f ms/frame (everything, as before)\n",referenceMs / kFrameCount);
+	std::printf("  hierarchy scalar              %7.3f ms/frame (%.2fx)\n",partialScalarMs / kFrameCount,referenceMs / partialScalarMs);
+	std::printf("  hierarchy SIMD                %7.3f ms/frame (%.2fx)\n",partialSimdMs / kFrameCount,referenceMs / partialSimdMs);
+	std::printf("  max difference from per object %g, SIMD/scalar mismatches %u\n",partialMaxDifference,partialSimdMismatchCount);
+	std::printf("after reparenting and destroying subtrees (%u left): max difference %g, SIMD/scalar mismatches %u, parent mismatches %u\n",aliveCount,editMaxDifference,
+	            editMismatchCount,parentMismatchCount);
+	std::printf("%s\n",isMatched ? "hierarchy matches per-object MakeAffineMatrix" : "MISMATCH");
+	return isMatched ? 0 : 1;
+}
+
+namespace{
+
+// math.cpp の Transform と同じ計算 (w で割る)
+Vector3 TransformReference(const Vector3& vector,const Matrix4x4& matrix){
+	Vector3 result;
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
+	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
+	result.x /= w;
+	result.y /= w;
+	result.z /= w;
+	return result;
+}
+
+// 2つの float の間にある表せる値の数 (+0 と -0 は同じとみなす)
+uint32_t UlpDistance(float a,float b){
+	auto toOrdered = [](float value){
+		int32_t bits;
+		std::memcpy(&bits,&value,sizeof(bits));
+		return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : static_cast<int64_t>(bits);
+	};
+	int64_t distance = toOrdered(a) - toOrdered(b);
+	return static_cast<uint32_t>(distance < 0 ? -distance : distance);
+}
+
+uint32_t MaxUlp(const Matrix4x4& a,const Matrix4x4& b){
+	uint32_t ulp = 0;
+	for(size_t i = 0; i < 4; ++i){
+		for(size_t j = 0; j < 4; ++j){
+			ulp = std::max(ulp,UlpDistance(a.m[i][j],b.m[i][j]));
+		}
+	}
+	return ulp;
+}
+
+uint32_t MaxUlp(const Vector3& a,const Vector3& b){
+	return std::max({UlpDistance(a.x,b.x), UlpDistance(a.y,b.y), UlpDistance(a.z,b.z)});
+}
+
+} // namespace
+
+// SimdMath の関数ごとに、math.cpp のこれまでの書き方と結果 (ULP の差) と時間を比べる
+// 数は 4 の倍数にしない (1 個ずつ処理する残りも通す)
+int MatrixMath(){
+	const size_t kCount = 100003;
+	const uint32_t kRepeatCount = 20;
+	std::mt19937 random(4096);
+	std::uniform_real_distribution<float> angle(-6.3f,6.3f);
+	std::uniform_real_distribution<float> offset(-100.0f,100.0f);
+	std::uniform_real_distribution<float> scale(0.1f,4.0f);
+	std::vector<Vector3> scales(kCount);
+	std::vector<Vector3> rotations(kCount);
+	std::vector<Vector3> translations(kCount);
+	std::vector<Vector3> points(kCount);
+	for(size_t i = 0; i < kCount; ++i){
+		scales[i] = {scale(random), scale(random), scale(random)};
+		rotations[i] = {angle(random), angle(random), angle(random)};
+		translations[i] = {offset(random), offset(random), offset(random)};
+		points[i] = {offset(random), offset(random), offset(random)};
+	}
+	// 成分ごとの配列 (TransformHierarchy の持ち方)
+	std::vector<float> components[9];
+	for(size_t c = 0; c < 9; ++c){
+		components[c].resize(kCount);
+		const std::vector<Vector3>& source = c < 3 ? scales : c < 6 ? rotations : translations;
+		for(size_t i = 0; i < kCount; ++i){
+			const Vector3& v = source[i];
+			components[c][i] = c % 3 == 0 ? v.x : c % 3 == 1 ? v.y : v.z;
+		}
+	}
+	const AffineComponents affineComponents = {components[0].data(), components[1].data(), components[2].data(), components[3].data(), components[4].data(),
+	                                           components[5].data(), components[6].data(), components[7].data(), components[8].data()};
+
+	// 何回か回した平均 (1 個あたり ns)
+	auto measure = [&](const auto& function){
+		auto start = std::chrono::steady_clock::now();
+		for(uint32_t repeat = 0; repeat < kRepeatCount; ++repeat){
+			function();
+		}
+		return ElapsedMs(start) * 1e6 / (static_cast<double>(kRepeatCount) * kCount);
+	};
+	struct Row{
+		const char* name;
+		double ns;
+		uint32_t maxUlp;
+		bool isReference; // 比べる元 (これまでの書き方)
+	};
+	std::vector<Row> rows;
+	auto compareMatrices = [](const std::vector<Matrix4x4>& expected,const std::vector<Matrix4x4>& actual){
+		uint32_t ulp = 0;
+		for(size_t i = 0; i < expected.size(); ++i){
+			ulp = std::max(ulp,MaxUlp(expected[i],actual[i]));
+		}
+		return ulp;
+	};
+	auto comparePoints = [](const std::vector<Vector3>& expected,const std::vector<Vector3>& actual){
+		uint32_t ulp = 0;
+		for(size_t i = 0; i < expected.size(); ++i){
+			ulp = std::max(ulp,MaxUlp(expected[i],actual[i]));
+		}
+		return ulp;
+	};
+
+	// アフィン行列を作る
+	std::vector<Matrix4x4> expected(kCount);
+	std::vector<Matrix4x4> actual(kCount);
+	rows.push_back({"MakeAffineMatrix (5 matrices)", measure([&](){
+		                for(size_t i = 0; i < kCount; ++i){
+			                expected[i] = MakeAffineMatrixReference(scales[i],rotations[i],translations[i]);
+		                }
+	                }),
+	                0, true});
+	rows.push_back({"ComposeAffineMatrix", measure([&](){
+		                for(size_t i = 0; i < kCount; ++i){
+			                actual[i] = ComposeAffineMatrix(scales[i],rotations[i],translations[i]);
+		                }
+	                }),
+	                compareMatrices(expected,actual), false});
+	rows.push_back({"ComposeAffineMatrices (Vector3)", measure([&](){ ComposeAffineMatrices(scales.data(),rotations.data(),translations.data(),kCount,actual.data()); }),
+	                compareMatrices(expected,actual), false});
+	rows.push_back({"ComposeAffineMatrices (SoA)", measure([&](){ ComposeAffineMatrices(affineComponents,0,kCount,actual.data()); }),compareMatrices(expected,actual), false});
+
+	// 行列の掛け算 (作った行列を 1 つずらして掛ける)
+	std::vector<Matrix4x4> lhs = expected;
+	std::vector<Matrix4x4> rhs(kCount);
+	for(size_t i = 0; i < kCount; ++i){
+		rhs[i] = lhs[(i + 1) % kCount];
+	}
+	rows.push_back({"operator* (triple loop)", measure([&](){
+		                for(size_t i = 0; i < kCount; ++i){
+			                expected[i] = MultiplyReference(lhs[i],rhs[i]);
+		                }
+	                }),
+	                0, true});
+	rows.push_back({"MultiplyMatrix", measure([&](){
+		                for(size_t i = 0; i < kCount; ++i){
+			                actual[i] = MultiplyMatrix(lhs[i],rhs[i]);
+		                }
+	                }),
+	                compareMatrices(expected,actual), false});
+	rows.push_back({"MultiplyMatrices", measure([&](){ MultiplyMatrices(lhs.data(),rhs.data(),kCount,actual.data()); }),compareMatrices(expected,actual), false});
+
+	// 点を動かす (w = 1 のアフィン行列)
+	const Matrix4x4& matrix = lhs[0];
+	std::vector<Vector3> expectedPoints(kCount);
+	std::vector<Vector3> actualPoints(kCount);
+	rows.push_back({"Transform (divides by w)", measure([&](){
+		                for(size_t i = 0; i < kCount; ++i){
+			                expectedPoints[i] = TransformReference(points[i],matrix);
+		                }
+	                }),
+	                0, true});
+	rows.push_back({"TransformAffine", measure([&](){
+		                for(size_t i = 0; i < kCount; ++i){
+			                actualPoints[i] = TransformAffine(points[i],matrix);
+		                }
+	                }),
+	                comparePoints(expectedPoints,actualPoints), false});
+	rows.push_back({"TransformAffinePoints", measure([&](){ TransformAffinePoints(points.data(),kCount,matrix,actualPoints.data()); }),comparePoints(expectedPoints,actualPoints), false});
+	// 同じ配列に書き戻しても合うか
+	actualPoints = points;
+	TransformAffinePoints(actualPoints.data(),kCount,matrix,actualPoints.data());
+	uint32_t inPlaceUlp = comparePoints(expectedPoints,actualPoints);
+
+	bool isMatched = inPlaceUlp == 0;
+	std::printf("%zu elements, %u repeats (reference rows are the current math.cpp code)\n",kCount,kRepeatCount);
+	double referenceNs = 0.0;
+	for(const Row& row : rows){
+		if(row.isReference){
+			referenceNs = row.ns;
+			std::printf("  %-33s %7.2f ns\n",row.name,row.ns);
+			continue;
+		}
+		// 足す順まで同じなので、ビット単位で同じでなければならない
+		isMatched &= row.maxUlp == 0;
+		std::printf("  %-33s %7.2f ns (%.2fx)  max %u ulp%s\n",row.name,row.ns,referenceNs / row.ns,row.maxUlp,row.maxUlp == 0 ? "" : " MISMATCH");
+	}
+	std::printf("  TransformAffinePoints in place: max %u ulp\n",inPlaceUlp);
+	std::printf("%s\n",isMatched ? "SimdMath matches math.cpp" : "MISMATCH");
+	return isMatched ? 0 : 1;
+}
+
+namespace{
+
+// math.cpp の以前の NormalizeAngle (while で 2π ずつ引く)
+float NormalizeAngleLoop(float angle){
+	while(angle > std::numbers::pi_v<float>)
+		angle -= std::numbers::pi_v<float> * 2.0f;
+	while(angle < -std::numbers::pi_v<float>)
+		angle += std::numbers::pi_v<float> * 2.0f;
+	return angle;
+}
+
+} // namespace
+
+// MathKernels の近似の誤差 (double で計算した値との差) と時間を、std の関数と比べる
+// 1 個ずつの版とまとめて計算する版が同じ値を返すかも確かめる
+int Kernels(){
+	const size_t kCount = 100003;
+	const uint32_t kRepeatCount = 20;
+	std::mt19937 random(777);
+	auto makeValues = [&](float min,float max){
+		std::uniform_real_distribution<float> distribution(min,max);
+		std::vector<float> values(kCount);
+		for(float& value : values){
+			value = distribution(random);
+		}
+		return values;
+	};
+	auto measure = [&](const auto& function){
+		auto start = std::chrono::steady_clock::now();
+		for(uint32_t repeat = 0; repeat < kRepeatCount; ++repeat){
+			function();
+		}
+		return ElapsedMs(start) * 1e6 / (static_cast<double>(kRepeatCount) * kCount);
+	};
+	auto isSameBits = [](const std::vector<float>& a,const std::vector<float>& b){ return std::memcmp(a.data(),b.data(),a.size() * sizeof(float)) == 0; };
+	bool isMatched = true;
+	std::vector<float> out0(kCount), out1(kCount), out2(kCount), out3(kCount);
+
+	std::printf("%zu values, %u repeats (errors against double precision)\n",kCount,kRepeatCount);
+
+	// sin / cos (ゲームの角度の範囲と、大きな角度)
+	for(float range : {2.0f * std::numbers::pi_v<float>, 1e4f}){
+		std::vector<float> angles = makeValues(-range,range);
+		SetMathPrecision(MathPrecision::kStandard);
+		double standardNs = measure([&](){ SinCosBatch(angles.data(),kCount,out0.data(),out1.data()); });
+		double standardError = 0.0;
+		for(size_t i = 0; i < kCount; ++i){
+			standardError = std::max({standardError,std::abs(out0[i] - std::sin(static_cast<double>(angles[i]))),std::abs(out1[i] - std::cos(static_cast<double>(angles[i])))});
+		}
+		SetMathPrecision(MathPrecision::kFast);
+		double scalarNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				SinCos(angles[i],out0[i],out1[i]);
+			}
+		});
+		double batchNs = measure([&](){ SinCosBatch(angles.data(),kCount,out2.data(),out3.data()); });
+		double fastError = 0.0;
+		for(size_t i = 0; i < kCount; ++i){
+			fastError = std::max({fastError,std::abs(out0[i] - std::sin(static_cast<double>(angles[i]))),std::abs(out1[i] - std::cos(static_cast<double>(angles[i])))});
+		}
+		bool isSame = isSameBits(out0,out2) && isSameBits(out1,out3);
+		bool isWithin = fastError <= 1e-7;
+		isMatched &= isSame && isWithin;
+		std::printf("SinCos |angle| <= %g\n",range);
+		std::printf("  std::sin + std::cos %6.2f ns  max abs error %.2e\n",standardNs,standardError);
+		std::printf("  fast SinCos         %6.2f ns (%.2fx)  max abs error %.2e%s\n",scalarNs,standardNs / scalarNs,fastError,isWithin ? "" : " OVER 1e-7");
+		std::printf("  fast SinCosBatch    %6.2f ns (%.2fx)  %s\n",batchNs,standardNs / batchNs,isSame ? "same bits as SinCos" : "MISMATCH with SinCos");
+	}
+
+	// 2^x (1 個ずつの版は std::exp2。多項式はまとめて計算する版だけ)
+	// 1 個ずつ Exp2Batch に渡した結果 (4 個に満たない残りの式) が、4 個ずつ計算した結果と同じかも確かめる
+	{
+		std::vector<float> values = makeValues(-20.0f,20.0f);
+		SetMathPrecision(MathPrecision::kStandard);
+		double standardNs = measure([&](){ Exp2Batch(values.data(),kCount,out0.data()); });
+		SetMathPrecision(MathPrecision::kFast);
+		double scalarNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				out0[i] = Exp2(values[i]);
+			}
+		});
+		double singleNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				Exp2Batch(&values[i],1,&out1[i]);
+			}
+		});
+		double batchNs = measure([&](){ Exp2Batch(values.data(),kCount,out2.data()); });
+		double fastError = 0.0;
+		for(size_t i = 0; i < kCount; ++i){
+			double expected = std::exp2(static_cast<double>(values[i]));
+			fastError = std::max(fastError,std::abs(out2[i] - expected) / expected);
+		}
+		float limits[] = {-200.0f, 200.0f, 0.0f};
+		float limitResults[3];
+		Exp2Batch(limits,3,limitResults);
+		bool isSame = isSameBits(out1,out2);
+		bool isWithin = fastError <= 1.2e-7;
+		bool isLimitOk = limitResults[0] == 0.0f && std::isinf(limitResults[1]) && limitResults[2] == 1.0f;
+		bool isStandard = Exp2(1.5f) == std::exp2(1.5f);
+		isMatched &= isSame && isWithin && isLimitOk && isStandard;
+		std::printf("Exp2 |x| <= 20\n");
+		std::printf("  std::exp2           %6.2f ns\n",standardNs);
+		std::printf("  Exp2 (std::exp2)    %6.2f ns (%.2fx)%s\n",scalarNs,standardNs / scalarNs,isStandard ? "" : "  NOT std::exp2");
+		std::printf("  fast Exp2Batch x1   %6.2f ns (%.2fx)  (polynomial one at a time, slower than std)\n",singleNs,standardNs / singleNs);
+		std::printf("  fast Exp2Batch      %6.2f ns (%.2fx)  max relative error %.2e%s, %s%s\n",batchNs,standardNs / batchNs,fastError,isWithin ? "" : " OVER 1.2e-7",
+		            isSame ? "same bits one at a time" : "MISMATCH one at a time",isLimitOk ? "" : ", WRONG limits");
+	}
+
+	// base^exponent (Exp2 と同じく、1 個ずつの版は std::pow)
+	{
+		std::vector<float> bases = makeValues(0.001f,100.0f);
+		std::vector<float> exponents = makeValues(-3.0f,3.0f);
+		SetMathPrecision(MathPrecision::kStandard);
+		double standardNs = measure([&](){ PowBatch(bases.data(),exponents.data(),kCount,out0.data()); });
+		SetMathPrecision(MathPrecision::kFast);
+		double scalarNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				out0[i] = Pow(bases[i],exponents[i]);
+			}
+		});
+		double singleNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				PowBatch(&bases[i],&exponents[i],1,&out1[i]);
+			}
+		});
+		double batchNs = measure([&](){ PowBatch(bases.data(),exponents.data(),kCount,out2.data()); });
+		// 誤差は exponent * log2(base) の大きさに比例して増える
+		double fastError = 0.0;
+		double boundRatio = 0.0;
+		for(size_t i = 0; i < kCount; ++i){
+			double exponent = static_cast<double>(exponents[i]) * std::log2(static_cast<double>(bases[i]));
+			double expected = std::exp2(exponent);
+			double error = std::abs(out2[i] - expected) / expected;
+			fastError = std::max(fastError,error);
+			boundRatio = std::max(boundRatio,error / (2.4e-7 + 1.2e-7 * std::abs(exponent)));
+		}
+		float zeroBase = 0.0f;
+		float zeroExponent = 2.0f;
+		float zeroResult = 1.0f;
+		PowBatch(&zeroBase,&zeroExponent,1,&zeroResult);
+		bool isSame = isSameBits(out1,out2);
+		bool isWithin = boundRatio <= 1.0;
+		bool isStandard = Pow(2.5f,1.5f) == std::pow(2.5f,1.5f);
+		isMatched &= isSame && isWithin && isStandard && zeroResult == 0.0f;
+		std::printf("Pow base (0, 100], |exponent| <= 3\n");
+		std::printf("  std::pow            %6.2f ns\n",standardNs);
+		std::printf("  Pow (std::pow)      %6.2f ns (%.2fx)%s\n",scalarNs,standardNs / scalarNs,isStandard ? "" : "  NOT std::pow");
+		std::printf("  fast PowBatch x1    %6.2f ns (%.2fx)  (polynomial one at a time, slower than std)\n",singleNs,standardNs / singleNs);
+		std::printf("  fast PowBatch       %6.2f ns (%.2fx)  max relative error %.2e (%.2f of the documented bound), %s\n",batchNs,standardNs / batchNs,fastError,
+		            boundRatio,isSame ? "same bits one at a time" : "MISMATCH one at a time");
+	}
+
+	// 角度の折り返し (以前の while のループと比べる)
+	{
+		std::vector<float> angles = makeValues(-50.0f,50.0f);
+		double loopNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				out0[i] = NormalizeAngleLoop(angles[i]);
+			}
+		});
+		double scalarNs = measure([&](){
+			for(size_t i = 0; i < kCount; ++i){
+				out1[i] = WrapAngle(angles[i]);
+			}
+		});
+		double batchNs = measure([&](){ WrapAngleBatch(angles.data(),kCount,out2.data()); });
+		double loopError = 0.0;
+		double wrapError = 0.0;
+		bool isInRange = true;
+		for(size_t i = 0; i < kCount; ++i){
+			double expected = std::remainder(static_cast<double>(angles[i]),2.0 * std::numbers::pi);
+			loopError = std::max(loopError,std::abs(out0[i] - expected));
+			wrapError = std::max(wrapError,std::abs(out1[i] - expected));
+			isInRange &= std::abs(out1[i]) <= std::numbers::pi_v<float> + 1e-6f;
+		}
+		bool isSame = isSameBits(out1,out2);
+		isMatched &= isSame && isInRange && wrapError <= loopError;
+		std::printf("WrapAngle |angle| <= 50\n");
+		std::printf("  while loop          %6.2f ns  max abs error %.2e\n",loopNs,loopError);
+		std::printf("  WrapAngle           %6.2f ns (%.2fx)  max abs error %.2e%s\n",scalarNs,loopNs / scalarNs,wrapError,isInRange ? "" : " OUT OF RANGE");
+		std::printf("  WrapAngleBatch      %6.2f ns (%.2fx)  %s\n",batchNs,loopNs / batchNs,isSame ? "same bits as WrapAngle" : "MISMATCH with WrapAngle");
+	}
+
+	// 使う側: アフィン行列を作る時間 (6 回の sin / cos が std から近似に変わる)
+	{
+		std::vector<Vector3> scales(kCount,{1.0f, 1.0f, 1.0f});
+		std::vector<Vector3> rotations(kCount);
+		std::vector<Vector3> translations(kCount);
+		std::vector<float> angles = makeValues(-6.3f,6.3f);
+		for(size_t i = 0; i < kCount; ++i){
+			rotations[i] = {angles[i], angles[(i + 1) % kCount], angles[(i + 2) % kCount]};
+		}
+		std::vector<Matrix4x4> standard(kCount);
+		std::vector<Matrix4x4> fast(kCount);
+		SetMathPrecision(MathPrecision::kStandard);
+		double standardNs = measure([&](){ ComposeAffineMatrices(scales.data(),rotations.data(),translations.data(),kCount,standard.data()); });
+		SetMathPrecision(MathPrecision::kFast);
+		double fastNs = measure([&](){ ComposeAffineMatrices(scales.data(),rotations.data(),translations.data(),kCount,fast.data()); });
+		float difference = 0.0f;
+		for(size_t i = 0; i < kCount; ++i){
+			difference = std::max(difference,MaxDifference(standard[i],fast[i]));
+		}
+		std::printf("ComposeAffineMatrices\n");
+		std::printf("  kStandard           %6.2f ns\n",standardNs);
+		std::printf("  kFast               %6.2f ns (%.2fx)  max difference %.2e\n",fastNs,standardNs / fastNs,difference);
+	}
+
+	std::printf("%s\n",isMatched ? "MathKernels within the documented error" : "MISMATCH");
+	return isMatched ? 0 : 1;
+}
+
+namespace{
+
+// ConstexprMath の関数がコンパイル時に計算できることを確かめる (できなければビルドが通らない)
+static_assert(((Vector3{1.0f, 2.0f, 3.0f} + Vector3{1.0f, 1.0f, 1.0f}) * 2.0f).z == 8.0f && (-Vector3{1.0f, 2.0f, 3.0f}).x == -1.0f);
+
+static_assert(Lerp(Vector3{0.0f, 0.0f, 0.0f},Vector3{2.0f, 4.0f, 6.0f},0.5f).y == 2.0f);
+
+static_assert(MakeTranslateMatrix({1.0f, 2.0f, 3.0f}).m[3][1] == 2.0f && MakeIdentityMatrix().m[2][2] == 1.0f);
+
+static_assert(MakeCircleDirections<4>(1.0f)[1].y == 1.0f);
+
+// DeathParticles の以前の速度 ({speed, 0, 0} を MakeRotateZMatrix で回す。math.cpp と同じ行列)
+Vector3 RotateZReference(float speed,float angle){
+	float sin, cos;
+	SinCos(angle,sin,cos);
+	Matrix4x4 rotation{cos, sin, 0.0f, 0.0f, -sin, cos, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	return TransformAffine({speed, 0.0f, 0.0f},rotation);
+}
+
+// EaseInOut の曲線を [0, 1] で 256 等分した表 (間は線形補間)
+// std::cos より遅かったのでゲームでは使わない。比べるためにここにだけ残す
+const size_t kEaseInOutTableSize = 256;
+constexpr std::array<float,kEaseInOutTableSize + 1> kEaseInOutTable = []{
+	std::array<float,kEaseInOutTableSize + 1> table{};
+	for(size_t i = 0; i <= kEaseInOutTableSize; ++i){
+		table[i] = static_cast<float>((1.0 - CosConstexpr(3.14159265358979323846 * static_cast<double>(i) / kEaseInOutTableSize)) / 2.0);
+	}
+	return table;
+}();
+
+float EaseInOutTable(float t){
+	if(!(t > 0.0f)){
+		return 0.0f;
+	}
+	if(t >= 1.0f){
+		return 1.0f;
+	}
+	float position = t * kEaseInOutTableSize;
+	size_t index = static_cast<size_t>(position);
+	float fraction = position - static_cast<float>(index);
+	return kEaseInOutTable[index] + (kEaseInOutTable[index + 1] - kEaseInOutTable[index]) * fraction;
+}
+
+} // namespace
+
+// コンパイル時に作る表 (パーティクルの方向) を毎回計算する以前の書き方と比べ、EaseInOut の書き方 (std::cos・Cos・表) を比べる
+int Tables(){
+	const uint32_t kRepeatCount = 20;
+	bool isMatched = true;
+
+	// DeathParticles と同じ 8 方向。1 フレームごとに全部を動かす
+	{
+		const uint32_t kDirectionCount = 8;
+		const uint32_t kFrameCount = 200000;
+		const float kSpeed = 0.05f;
+		const float kAngleUnit = 2.0f * std::numbers::pi_v<float> / kDirectionCount;
+		constexpr std::array<Vector3,kDirectionCount> kVelocities = MakeCircleDirections<kDirectionCount>(0.05f);
+
+		// 表は double で計算して丸めるので、正しい値との差は float の丸め (0.05 の 1 ULP は 3.7e-9) だけ
+		// 以前の書き方は float の角度と近似の SinCos を通るので、少しずれる
+		double tableError = 0.0;
+		float difference = 0.0f;
+		for(uint32_t i = 0; i < kDirectionCount; ++i){
+			double angle = 2.0 * std::numbers::pi * i / kDirectionCount;
+			tableError = std::max({tableError,std::abs(kVelocities[i].x - kSpeed * std::cos(angle)),std::abs(kVelocities[i].y - kSpeed * std::sin(angle))});
+			Vector3 velocity = RotateZReference(kSpeed,kAngleUnit * i);
+			difference = std::max({difference,std::abs(velocity.x - kVelocities[i].x),std::abs(velocity.y - kVelocities[i].y),std::abs(velocity.z - kVelocities[i].z)});
+		}
+
+		std::array<Vector3,kDirectionCount> rotated{};
+		std::array<Vector3,kDirectionCount> table{};
+		auto start = std::chrono::steady_clock::now();
+		for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+			for(uint32_t i = 0; i < kDirectionCount; ++i){
+				rotated[i] += RotateZReference(kSpeed,kAngleUnit * i);
+			}
+		}
+		double rotateNs = ElapsedMs(start) * 1e6 / kFrameCount;
+		start = std::chrono::steady_clock::now();
+		for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+			for(uint32_t i = 0; i < kDirectionCount; ++i){
+				table[i] += kVelocities[i];
+			}
+		}
+		double tableNs = ElapsedMs(start) * 1e6 / kFrameCount;
+		// 同じだけ動いたか (フレーム数ぶん足した位置の差)
+		float drift = 0.0f;
+		for(uint32_t i = 0; i < kDirectionCount; ++i){
+			drift = std::max({drift,std::abs(rotated[i].x - table[i].x),std::abs(rotated[i].y - table[i].y)});
+		}
+		bool isWithin = tableError <= 3.7e-9;
+		isMatched &= isWithin;
+		std::printf("DeathParticles velocities (%u directions, %u frames)\n",kDirectionCount,kFrameCount);
+		std::printf("  MakeRotateZMatrix + TransformAffine %8.2f ns/frame\n",rotateNs);
+		std::printf("  constexpr table                     %8.2f ns/frame (%.2fx)  max error %.2e%s\n",tableNs,rotateNs / tableNs,tableError,isWithin ? "" : " OVER 3.7e-9");
+		std::printf("  difference from the old velocities %.2e, position after %u frames %.2e\n",difference,kFrameCount,drift);
+	}
+
+	// EaseInOut の曲線 (1 - cos(πt)) / 2。ゲームは一番速い std::cos (EaseInOutCurve) を使う
+	{
+		const size_t kCount = 100003;
+		std::mt19937 random(50);
+		std::uniform_real_distribution<float> distribution(0.0f,1.0f);
+		std::vector<float> ts(kCount);
+		for(float& t : ts){
+			t = distribution(random);
+		}
+		ts[0] = 0.0f;
+		ts[1] = 1.0f;
+		std::vector<float> out0(kCount), out1(kCount), out2(kCount);
+		auto measure = [&](const auto& function,std::vector<float>& out){
+			auto start = std::chrono::steady_clock::now();
+			for(uint32_t repeat = 0; repeat < kRepeatCount; ++repeat){
+				for(size_t i = 0; i < kCount; ++i){
+					out[i] = function(ts[i]);
+				}
+			}
+			return ElapsedMs(start) * 1e6 / (static_cast<double>(kRepeatCount) * kCount);
+		};
+		double stdNs = measure([](float t){ return EaseInOutCurve(t); },out0);
+		double cosNs = measure([](float t){ return -(Cos(std::numbers::pi_v<float> * t) - 1.0f) / 2.0f; },out1);
+		double tableNs = measure([](float t){ return EaseInOutTable(t); },out2);
+		double stdError = 0.0;
+		double cosError = 0.0;
+		double tableError = 0.0;
+		for(size_t i = 0; i < kCount; ++i){
+			double expected = (1.0 - std::cos(std::numbers::pi * ts[i])) / 2.0;
+			stdError = std::max(stdError,std::abs(out0[i] - expected));
+			cosError = std::max(cosError,std::abs(out1[i] - expected));
+			tableError = std::max(tableError,std::abs(out2[i] - expected));
+		}
+		bool isWithin = stdError <= 1e-6;
+		isMatched &= isWithin;
+		std::printf("EaseInOut curve (%zu values of t in [0, 1])\n",kCount);
+		std::printf("  std::cos (used)     %6.2f ns          max abs error %.2e%s\n",stdNs,stdError,isWithin ? "" : " OVER 1e-6");
+		std::printf("  fast Cos            %6.2f ns (%.2fx)  max abs error %.2e\n",cosNs,stdNs / cosNs,cosError);
+		std::printf("  table (%zu steps)   %6.2f ns (%.2fx)  max abs error %.2e\n",kEaseInOutTableSize,tableNs,stdNs / tableNs,tableError);
+	}
+
+	std::printf("%s\n",isMatched ? "constexpr tables match the runtime math" : "MISMATCH");
+	return isMatched ? 0 : 1;
+}
@@ -0,0 +1,598 @@
+// ==========================================
+// AssetCooker の確かめ・計測 (描画)
+// 描画コマンドの数・視錐台カリング・定数バッファへの転送を、ゲームと同じクラスで数えて比べる (GPU には触らない)
+// ==========================================
+#include "Commands.h"
+#include "EnemyState.h"
+#include "CookedLevel.h"
+#include "Frustum.h"
+#include "GameComponents.h"
+#include "ObjParser.h"
+#include "RenderResourcePoolBase.h"
+#include "TileInstances.h"
+#include "ToolCommon.h"
+#include "TransformChangeTracker.h"
+#include "VisibilityCuller.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// マップのブロック (セルが 1) を1つずつ描いた場合と、層ごとにインスタンス描画した場合の描画コマンドの数
+// ゲームと同じ TileInstances で並びを作り、数えるだけの出し先に描く
+int Instancing(){
+	// ブロックのメッシュ (MeshModel と同じく、空のメッシュは描かない)
+	MeshData block;
+	if(!ObjParser::Load("block",false,block,0)){
+		std::printf("failed: Resources/block/block.obj\n");
+		return 1;
+	}
+	std::vector<TileDrawRecorder::Range> ranges;
+	for(const MeshData::SubMesh& subMesh : block.subMeshes){
+		if(subMesh.indexCount > 0){
+			ranges.push_back({subMesh.indexCount, subMesh.indexOffset, static_cast<int32_t>(subMesh.vertexOffset)});
+		}
+	}
+	// ブロック1つごとに行列の定数バッファ (256 バイト境界) を使っていた
+	const size_t kWorldTransformBytes = 256;
+
+	bool isAllMatched = true;
+	for(const std::string& name : FindLevels()){
+		CookedLevel::Level level;
+		if(!CookedLevel::ParseCsv("Resources/" + name,level)){
+			std::printf("failed: Resources/%s\n",name.c_str());
+			isAllMatched = false;
+			continue;
+		}
+		auto isSolid = [&](uint32_t column,uint32_t row){ return level.cells[static_cast<size_t>(row) * level.width + column] == 1; };
+
+		auto start = std::chrono::steady_clock::now();
+		TileInstances instances;
+		instances.Build(level.width,level.height,isSolid);
+		double buildMs = ElapsedMs(start);
+
+		CountingTileDrawRecorder perTile;
+		for(uint32_t i = 0; i < instances.GetCount(); ++i){
+			for(size_t r = 0; r < ranges.size(); ++r){
+				perTile.Draw(r,ranges[r],i,1);
+			}
+		}
+		CountingTileDrawRecorder instanced;
+		instances.Record(instanced,ranges);
+
+		// 頂点シェーダーと同じずらし方で、MapChipField::GetMapChipPositionByIndex と同じ位置になるか
+		uint32_t mismatchCount = 0;
+		size_t next = 0;
+		std::span<const TileInstance> tiles = instances.Get();
+		for(uint32_t column = 0; column < level.width; ++column){
+			for(uint32_t row = level.height; row-- > 0;){
+				if(!isSolid(column,row)){
+					continue;
+				}
+				float x = 0.0f;
+				float y = 0.0f;
+				if(next < tiles.size()){
+					TileInstances::GetOffset(tiles[next],1.0f,1.0f,x,y);
+				}
+				if(next >= tiles.size() || x != static_cast<float>(column) || y != static_cast<float>(level.height - 1 - row) || tiles[next].color != TileInstances::kWhite){
+					++mismatchCount;
+				}
+				++next;
+			}
+		}
+		bool isMatched = mismatchCount == 0 && next == tiles.size() && perTile.GetTriangleCount() == instanced.GetTriangleCount();
+		isAllMatched = isAllMatched && isMatched;
+
+		std::printf("Resources/%-20s %3ux%-4u %5u blocks: draw calls %6u -> %u, per-block data %7.1f KB -> %5.1f KB, %7.0f triangles, build %.3f ms%s\n",name.c_str(),
+		            level.width,level.height,instances.GetCount(),perTile.GetDrawCallCount(),instanced.GetDrawCallCount(),
+		            instances.GetCount() * kWorldTransformBytes / 1024.0,instances.GetSizeBytes() / 1024.0,static_cast<double>(instanced.GetTriangleCount()),buildMs,
+		            isMatched ? "" : " MISMATCH");
+	}
+	std::printf("%s\n",isAllMatched ? "instance positions match the per-block transforms" : "MISMATCH");
+	return isAllMatched ? 0 : 1;
+}
+
+namespace{
+
+// Camera と同じ既定値 (視野角 45 度、16:9) で、eye から +z を向いたカメラの視錐台
+Frustum MakeCameraFrustum(const Vector3& eye){
+	const float kFovAngleY = 45.0f * 3.141592654f / 180.0f;
+	const float kAspectRatio = 16.0f / 9.0f;
+	const float kNearZ = 0.1f;
+	const float kFarZ = 1000.0f;
+	Matrix4x4 view = {};
+	view.m[0][0] = view.m[1][1] = view.m[2][2] = view.m[3][3] = 1.0f;
+	view.m[3][0] = -eye.x;
+	view.m[3][1] = -eye.y;
+	view.m[3][2] = -eye.z;
+	Matrix4x4 projection = {};
+	float yScale = 1.0f / std::tan(kFovAngleY * 0.5f);
+	projection.m[0][0] = yScale / kAspectRatio;
+	projection.m[1][1] = yScale;
+	projection.m[2][2] = kFarZ / (kFarZ - kNearZ);
+	projection.m[2][3] = 1.0f;
+	projection.m[3][2] = -kNearZ * kFarZ / (kFarZ - kNearZ);
+	return Frustum::Create(view,projection);
+}
+
+} // namespace
+
+// マップのブロックを、カメラに映る列だけ描く場合と全て描く場合の1フレームの手間
+// MapChip2 を横に繰り返して広げ、カメラ (CameraController と同じく z = -15) を端から端まで動かす
+int TileWindow(){
+	CookedLevel::Level source;
+	if(!CookedLevel::ParseCsv("Resources/MapChip2.csv",source)){
+		std::printf("failed: Resources/MapChip2.csv\n");
+		return 1;
+	}
+	MeshData block;
+	if(!ObjParser::Load("block",false,block,0)){
+		std::printf("failed: Resources/block/block.obj\n");
+		return 1;
+	}
+	std::vector<TileDrawRecorder::Range> ranges;
+	for(const MeshData::SubMesh& subMesh : block.subMeshes){
+		if(subMesh.indexCount > 0){
+			ranges.push_back({subMesh.indexCount, subMesh.indexOffset, static_cast<int32_t>(subMesh.vertexOffset)});
+		}
+	}
+	// GameScene と同じ置き方 (マス (0, 0) が原点、1マス 1、ブロックは 1 の立方体)
+	TileInstances::Layout layout = {{0.0f, 0.0f, 0.0f}, 1.0f, 1.0f, {0.5f, 0.5f, 0.5f}};
+	const int32_t kMargin = 1;
+	const float kCameraZ = -15.0f;
+	const uint32_t kFrameCount = 2000;
+
+	bool isAllCovered = true;
+	for(uint32_t width : {256u, 1024u, 4096u}){
+		auto isSolid = [&](uint32_t column,uint32_t row){ return source.cells[static_cast<size_t>(row) * source.width + column % source.width] == 1; };
+		TileInstances instances;
+		instances.Build(width,source.height,isSolid);
+		float cameraY = (source.height - 1) * 0.5f;
+
+		// 全てのブロックを1つずつ (以前の GameScene)
+		auto start = std::chrono::steady_clock::now();
+		uint64_t perBlockDraws = 0;
+		for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+			CountingTileDrawRecorder recorder;
+			for(uint32_t i = 0; i < instances.GetCount(); ++i){
+				for(size_t r = 0; r < ranges.size(); ++r){
+					recorder.Draw(r,ranges[r],i,1);
+				}
+			}
+			perBlockDraws += recorder.GetDrawCallCount();
+		}
+		double perBlockUs = ElapsedMs(start) * 1000.0 / kFrameCount;
+
+		// 映る列だけ
+		start = std::chrono::steady_clock::now();
+		uint64_t windowInstances = 0;
+		uint64_t windowTiles = 0;
+		uint32_t windowDraws = 0;
+		for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+			float cameraX = static_cast<float>(width - 1) * frame / (kFrameCount - 1);
+			Frustum frustum = MakeCameraFrustum({cameraX, cameraY, kCameraZ});
+			TileInstances::Rect rect = instances.GetVisibleRect(frustum,layout,kMargin);
+			CountingTileDrawRecorder recorder;
+			instances.Record(recorder,ranges,rect);
+			windowInstances += recorder.GetInstanceCount();
+			windowTiles += rect.GetTileCount();
+			windowDraws = std::max(windowDraws,recorder.GetDrawCallCount());
+		}
+		double windowUs = ElapsedMs(start) * 1000.0 / kFrameCount;
+
+		// 総当たりで、視錐台に入るブロックが全て範囲の列に入っているか
+		uint32_t missedCount = 0;
+		for(uint32_t frame = 0; frame < kFrameCount; frame += 97){
+			float cameraX = static_cast<float>(width - 1) * frame / (kFrameCount - 1);
+			Frustum frustum = MakeCameraFrustum({cameraX, cameraY, kCameraZ});
+			TileInstances::Rect rect = instances.GetVisibleRect(frustum,layout,0);
+			for(const TileInstance& tile : instances.Get()){
+				float x = 0.0f;
+				float y = 0.0f;
+				TileInstances::GetOffset(tile,layout.tileWidth,layout.tileHeight,x,y);
+				bool isVisible = frustum.IsBoxVisible({x, y, 0.0f},layout.halfExtent);
+				bool isInRect = tile.x >= rect.left && tile.x < rect.right && tile.y >= rect.bottom && tile.y < rect.top;
+				if(isVisible && !isInRect){
+					++missedCount;
+				}
+			}
+		}
+		isAllCovered = isAllCovered && missedCount == 0;
+
+		std::printf("%4ux%-3u %6u blocks: per-block %6.1f us/frame (%llu draws) -> visible columns %5.2f us/frame (%u draws, %.0f blocks, window %.0f tiles)%s\n",
+		            width,source.height,instances.GetCount(),perBlockUs,static_cast<unsigned long long>(perBlockDraws / kFrameCount),windowUs,windowDraws,
+		            static_cast<double>(windowInstances) / kFrameCount,static_cast<double>(windowTiles) / kFrameCount,missedCount == 0 ? "" : " MISSED");
+	}
+	std::printf("%s\n",isAllCovered ? "every block inside the frustum is inside the window" : "MISSED");
+	return isAllCovered ? 0 : 1;
+}
+
+// 囲む形 10 万個 (半分は球、半分は箱) の視錐台カリング
+// 形はカメラの前後左右に広く撒き、一部だけが画面に入るようにする
+int Culling(){
+	const uint32_t kBoundCount = 100000;
+	const uint32_t kFrameCount = 200;
+	struct Bound{
+		Vector3 center;
+		Vector3 extent; // 箱の時だけ
+		float radius;   // 球の時だけ
+		bool isBox;
+	};
+	std::mt19937 random(12345);
+	std::uniform_real_distribution<float> spreadX(-150.0f,150.0f);
+	std::uniform_real_distribution<float> spreadY(-60.0f,60.0f);
+	std::uniform_real_distribution<float> spreadZ(-50.0f,250.0f);
+	std::uniform_real_distribution<float> size(0.1f,2.0f);
+	std::vector<Bound> bounds(kBoundCount);
+	for(uint32_t i = 0; i < kBoundCount; ++i){
+		Bound& bound = bounds[i];
+		bound.center = {spreadX(random), spreadY(random), spreadZ(random)};
+		bound.isBox = (i & 1) != 0;
+		bound.extent = bound.isBox ? Vector3{size(random), size(random), size(random)} : Vector3{0.0f, 0.0f, 0.0f};
+		bound.radius = bound.isBox ? 0.0f : size(random);
+	}
+	Frustum frustum = MakeCameraFrustum({0.0f, 0.0f, -15.0f});
+
+	// 1個ずつ Frustum で判定 (これまでの書き方)
+	std::vector<uint8_t> expected(kBoundCount);
+	auto start = std::chrono::steady_clock::now();
+	for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+		for(uint32_t i = 0; i < kBoundCount; ++i){
+			const Bound& bound = bounds[i];
+			expected[i] = bound.isBox ? frustum.IsBoxVisible(bound.center,bound.extent) : frustum.IsSphereVisible(bound.center,bound.radius);
+		}
+	}
+	double perObjectMs = ElapsedMs(start) / kFrameCount;
+
+	auto fill = [&](VisibilityCuller& culler){
+		culler.Begin(frustum);
+		for(const Bound& bound : bounds){
+			if(bound.isBox){
+				culler.AddBox(bound.center,bound.extent);
+			}
+			else{
+				culler.AddSphere(bound.center,bound.radius);
+			}
+		}
+	};
+	VisibilityCuller culler;
+	fill(culler);
+	start = std::chrono::steady_clock::now();
+	for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+		fill(culler);
+	}
+	double fillMs = ElapsedMs(start) / kFrameCount;
+
+	// 積むのは同じなので、判定だけを測る
+	auto measure = [&](VisibilityCuller::Path path,std::vector<uint8_t>& result){
+		double totalMs = 0.0;
+		for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+			fill(culler);
+			auto cullStart = std::chrono::steady_clock::now();
+			culler.Cull(path);
+			totalMs += ElapsedMs(cullStart);
+		}
+		result.assign(kBoundCount,0);
+		for(uint32_t index : culler.GetVisible()){
+			result[index] = 1;
+		}
+		return totalMs / kFrameCount;
+	};
+	std::vector<uint8_t> scalar;
+	std::vector<uint8_t> simd;
+	double scalarMs = measure(VisibilityCuller::Path::kScalar,scalar);
+	double simdMs = measure(VisibilityCuller::Path::kSimd,simd);
+	uint32_t tested = culler.GetTestedCount();
+	uint32_t visible = culler.GetVisibleCount();
+	uint32_t culled = culler.GetCulledCount();
+
+	// 種類ごとに Cull を分けても、まとめて判定した時と同じになるか
+	culler.Begin(frustum);
+	for(uint32_t i = 0; i < kBoundCount; ++i){
+		const Bound& bound = bounds[i];
+		if(bound.isBox){
+			culler.AddBox(bound.center,bound.extent);
+		}
+		else{
+			culler.AddSphere(bound.center,bound.radius);
+		}
+		if(i % 1000 == 999){
+			culler.Cull();
+		}
+	}
+	culler.Cull();
+	uint32_t splitMismatchCount = 0;
+	for(uint32_t i = 0; i < kBoundCount; ++i){
+		splitMismatchCount += culler.IsVisible(i) != (expected[i] != 0) ? 1 : 0;
+	}
+
+	uint32_t scalarMismatchCount = 0;
+	uint32_t simdMismatchCount = 0;
+	uint32_t visibleSpheres = 0;
+	uint32_t visibleBoxes = 0;
+	for(uint32_t i = 0; i < kBoundCount; ++i){
+		scalarMismatchCount += scalar[i] != expected[i] ? 1 : 0;
+		simdMismatchCount += simd[i] != expected[i] ? 1 : 0;
+		(bounds[i].isBox ? visibleBoxes : visibleSpheres) += expected[i];
+	}
+	bool isMatched = scalarMismatchCount == 0 && simdMismatchCount == 0 && splitMismatchCount == 0;
+
+	std::printf("%u bounds (%u spheres, %u boxes): visible %u (%u spheres, %u boxes), culled %u (%.1f%%)\n",tested,kBoundCount - kBoundCount / 2,kBoundCount / 2,
+	            visible,visibleSpheres,visibleBoxes,culled,100.0 * culled / tested);
+	std::printf("  per object (Frustum) %7.3f ms/frame\n",perObjectMs);
+	std::printf("  scalar Cull          %7.3f ms/frame (%.2fx)%s\n",scalarMs,perObjectMs / scalarMs,scalarMismatchCount == 0 ? "" : " MISMATCH");
+	std::printf("  SIMD Cull            %7.3f ms/frame (%.2fx)%s\n",simdMs,perObjectMs / simdMs,simdMismatchCount == 0 ? "" : " MISMATCH");
+	std::printf("  Begin + Add          %7.3f ms/frame\n",fillMs);
+	std::printf("%s\n",isMatched ? "SIMD, scalar and per-object results match" : "MISMATCH");
+	return isMatched ? 0 : 1;
+}
+
+namespace{
+
+// 定数バッファへの転送を CPU だけで記録する出し先
+// 送り先 (定数バッファ) ごとに最後に送った値を覚え、描く時にそれが描きたい値と同じかを確かめる
+class RecordingUploadBackend{
+public:
+	struct Value{
+		Vector3 scale;
+		Vector3 rotation;
+		Vector3 translation;
+	};
+
+	// 送り先 (定数バッファ) を1つ作って番号を返す
+	uint32_t CreateTarget(){
+		targets_.push_back({{}, false});
+		return static_cast<uint32_t>(targets_.size() - 1);
+	}
+
+	// 以前の書き方: 毎回送る (kind は数える時の分類)
+	void Upload(uint32_t target,const Value& value,uint32_t kind){
+		targets_[target].value = value;
+		targets_[target].isUploaded = true;
+		++uploadCounts_[kind];
+	}
+	// 変更の追跡を通す書き方 (WorldTransformUpdate(worldTransform, tracker) と同じ)
+	void Upload(uint32_t target,TransformChangeTracker& tracker,const Value& value,uint32_t kind){
+		if(tracker.Update(value.scale,value.rotation,value.translation)){
+			Upload(target,value,kind);
+		}
+	}
+
+	// 描く時: GPU にある値が描きたい値と同じでなければ数える
+	void Draw(uint32_t target,const Value& value,uint32_t kind){
+		const Target& t = targets_[target];
+		bool isSame = t.isUploaded && IsSame(t.value.scale,value.scale) && IsSame(t.value.rotation,value.rotation) && IsSame(t.value.translation,value.translation);
+		mismatchCounts_[kind] += isSame ? 0 : 1;
+	}
+
+	uint64_t GetUploadCount(uint32_t kind) const{ return uploadCounts_[kind]; }
+	uint64_t GetMismatchCount(uint32_t kind) const{ return mismatchCounts_[kind]; }
+
+private:
+	struct Target{
+		Value value;
+		bool isUploaded;
+	};
+	static bool IsSame(const Vector3& a,const Vector3& b){ return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+	std::vector<Target> targets_;
+	std::array<uint64_t,8> uploadCounts_ = {};
+	std::array<uint64_t,8> mismatchCounts_ = {};
+};
+
+// RenderResourcePool の中身 (RenderResourcePoolBase) を記録用の出し先で動かすための Traits
+// 定数バッファを作るたびに出し先に送り先を1つ作り、Transfer で送った値を記録する
+struct RecordingTraits{
+	struct Transform{
+		Vector3 scale_ = {1.0f, 1.0f, 1.0f};
+		Vector3 rotation_ = {};
+		Vector3 translation_ = {};
+		uint32_t target = 0;
+	};
+	struct Color{};
+
+	// 記録先と、次に借りるものの分類 (借りる前に設定する)
+	static inline RecordingUploadBackend* backend = nullptr;
+	static inline uint32_t kind = 0;
+
+	static void Initialize(Transform& transform){ transform.target = backend->CreateTarget(); }
+	static void Initialize(Color&){}
+	static void Transfer(Transform& transform){ backend->Upload(transform.target,{transform.scale_, transform.rotation_, transform.translation_},kind); }
+};
+
+} // namespace
+
+// GameScene の1プレイ分 (60Hz のティック、144Hz の描画で 10 秒) のトランスフォームの転送を数える
+// 空・ブロック層・プレイヤー (補間)・攻撃エフェクト・敵 40 体 (止まっている。1体は途中で倒れる)・ビーム・ヒットエフェクト
+int Uploads(){
+	enum Kind : uint32_t{
+		kSkydome,
+		kBlockLayer,
+		kPlayer,
+		kAttack,
+		kEnemy,
+		kBeam,
+		kHitEffect,
+		kKindCount,
+	};
+	const char* kKindNames[kKindCount] = {"skydome", "block layer", "player", "attack effect", "enemies", "beams", "hit effects"};
+	const float kTickTime = 1.0f / 60.0f;
+	const float kFrameTime = 1.0f / 144.0f;
+	const uint32_t kFrameCount = 1440;
+	const uint32_t kEnemyCount = 40;
+	const float kDefeatStart = 5.0f; // 1体目が倒れる時刻
+	const float kDefeatedTime = 0.6f;
+
+	// math.cpp の Lerp と同じ (同じ値同士はそのまま返す)
+	auto lerp = [](const Vector3& a,const Vector3& b,float t){
+		auto lerp1 = [](float x1,float x2,float t){ return x1 == x2 ? x1 : (1.0f - t) * x1 + t * x2; };
+		return Vector3{lerp1(a.x,b.x,t), lerp1(a.y,b.y,t), lerp1(a.z,b.z,t)};
+	};
+
+	bool isAllMatched = true;
+	// [0] は以前の書き方 (毎回送る)、[1] は変更の追跡を通す
+	RecordingUploadBackend results[2];
+	for(int useTracker = 0; useTracker < 2; ++useTracker){
+		RecordingUploadBackend& backend = results[useTracker];
+		auto upload = [&](uint32_t target,TransformChangeTracker& tracker,const RecordingUploadBackend::Value& value,uint32_t kind){
+			if(useTracker){
+				backend.Upload(target,tracker,value,kind);
+			}
+			else{
+				backend.Upload(target,value,kind);
+			}
+		};
+
+		// 持ち続けるトランスフォーム
+		uint32_t skydome = backend.CreateTarget();
+		uint32_t blockLayer = backend.CreateTarget();
+		uint32_t player = backend.CreateTarget();
+		uint32_t attack = backend.CreateTarget();
+		TransformChangeTracker skydomeTracker;
+		TransformChangeTracker blockLayerTracker;
+		TransformChangeTracker playerTracker; // TransformInterpolator の分
+		TransformChangeTracker attackTracker;
+		// 以前の書き方は借りた順に送り先を使い回して毎回送る
+		// 変更の追跡を通す方は GameScene と同じ RenderResourcePool の中身で借りる
+		std::vector<uint32_t> poolTargets;
+		size_t poolCursor = 0;
+		RenderResourcePoolBase<RecordingTraits> pool;
+		RecordingTraits::backend = &backend;
+		auto acquire = [&](uint32_t kind,const RecordingUploadBackend::Value& value){
+			if(useTracker){
+				RecordingTraits::kind = kind;
+				const RecordingTraits::Transform& transform = pool.AcquireTransform(value.scale,value.rotation,value.translation);
+				backend.Draw(transform.target,value,kind);
+				return;
+			}
+			if(poolCursor == poolTargets.size()){
+				poolTargets.push_back(backend.CreateTarget());
+			}
+			size_t slot = poolCursor++;
+			backend.Upload(poolTargets[slot],value,kind);
+			backend.Draw(poolTargets[slot],value,kind);
+		};
+
+		// シミュレーションの状態 (ゲームの敵エンティティと同じコンポーネント)
+		struct EnemyEntity{
+			EnemyState state;
+			TransformComponent transform;
+			PrevTransformComponent prevTransform;
+		};
+		std::vector<EnemyEntity> enemies(kEnemyCount);
+		for(uint32_t i = 0; i < kEnemyCount; ++i){
+			enemies[i].transform = {{2.0f, 2.0f, 2.0f}, {0.0f, 4.712389f, 0.0f}, {10.0f + 4.0f * i, 2.0f, 0.0f}};
+			enemies[i].prevTransform = {enemies[i].transform.rotation, enemies[i].transform.translation};
+		}
+		bool hasDefeated = false;
+		Vector3 playerTranslation = {2.0f, 2.0f, 0.0f};
+		Vector3 prevPlayerTranslation = playerTranslation;
+		const Vector3 playerScale = {1.0f, 1.0f, 1.0f};
+		const Vector3 playerRotation = {0.0f, 1.5707964f, 0.0f};
+		const Vector3 one = {1.0f, 1.0f, 1.0f};
+		const Vector3 zero = {0.0f, 0.0f, 0.0f};
+
+		// 初期化 (Skydome::Initialize・GenerateBlocks・Player::Reset の後の最初の更新と同じ)
+		upload(skydome,skydomeTracker,{one, zero, zero},kSkydome);
+		upload(blockLayer,blockLayerTracker,{one, zero, zero},kBlockLayer);
+		upload(attack,attackTracker,{one, playerRotation, playerTranslation},kAttack);
+
+		double accumulator = 0.0;
+		float time = 0.0f;
+		for(uint32_t frame = 0; frame < kFrameCount; ++frame){
+			accumulator += kFrameTime;
+			while(accumulator >= kTickTime){
+				accumulator -= kTickTime;
+				time += kTickTime;
+				// SaveState
+				prevPlayerTranslation = playerTranslation;
+				for(EnemyEntity& enemy : enemies){
+					enemy.prevTransform.rotation = enemy.transform.rotation;
+				}
+
+				// UpdateGameObjects
+				upload(skydome,skydomeTracker,{one, zero, zero},kSkydome);
+				// プレイヤーは最初の 3 秒だけ歩く (以前は本体も毎ティック送っていた)
+				if(time < 3.0f){
+					playerTranslation.x += 0.1f;
+				}
+				if(!useTracker){
+					backend.Upload(player,{playerScale, playerRotation, playerTranslation},kPlayer);
+				}
+				upload(attack,attackTracker,{one, playerRotation, playerTranslation},kAttack);
+				// 1体目は kDefeatStart に倒れ、回りながら消える
+				if(time >= kDefeatStart && !hasDefeated){
+					enemies[0].state.behavior = EnemyBehavior::kDefeated;
+					hasDefeated = true;
+				}
+				for(size_t i = 0; i < enemies.size(); ++i){
+					EnemyEntity& enemy = enemies[i];
+					if(enemy.state.behavior == EnemyBehavior::kDefeated){
+						enemy.state.counter += kTickTime;
+						enemy.transform.rotation.y += 0.3f;
+						enemy.transform.rotation.x = -1.0471976f * std::min(enemy.state.counter / kDefeatedTime,1.0f);
+					}
+				}
+				if(!enemies.empty() && enemies[0].state.behavior == EnemyBehavior::kDefeated && enemies[0].state.counter >= kDefeatedTime){
+					enemies.erase(enemies.begin());
+				}
+				upload(blockLayer,blockLayerTracker,{one, zero, zero},kBlockLayer);
+			}
+			float alpha = static_cast<float>(accumulator / kTickTime);
+
+			// Interpolate (プレイヤー)
+			RecordingUploadBackend::Value playerValue = {playerScale, playerRotation, lerp(prevPlayerTranslation,playerTranslation,alpha)};
+			upload(player,playerTracker,playerValue,kPlayer);
+
+			// Draw
+			poolCursor = 0;
+			pool.Reset();
+			backend.Draw(skydome,{one, zero, zero},kSkydome);
+			backend.Draw(blockLayer,{one, zero, zero},kBlockLayer);
+			backend.Draw(player,playerValue,kPlayer);
+			backend.Draw(attack,{one, playerRotation, playerTranslation},kAttack);
+			for(const EnemyEntity& enemy : enemies){
+				acquire(kEnemy,{enemy.transform.scale, lerp(enemy.prevTransform.rotation,enemy.transform.rotation,alpha), enemy.transform.translation});
+			}
+			// ビームは 4〜8 秒に 3 本飛ぶ
+			if(time >= 4.0f && time < 8.0f){
+				for(int i = 0; i < 3; ++i){
+					acquire(kBeam,{{0.5f, 0.5f, 0.5f}, zero, {2.0f + (time - 4.0f) * 30.0f, 2.0f + i, 0.0f}});
+				}
+			}
+			// ヒットエフェクトは倒れた時に 0.5 秒 (楕円 3 つ + 円)
+			if(time >= kDefeatStart && time < kDefeatStart + 0.5f){
+				float scale = (time - kDefeatStart) * 4.0f;
+				for(float rotation : {0.0f, 1.0f, 2.0f}){
+					acquire(kHitEffect,{{0.1f, scale * 2.0f, 1.0f}, {0.0f, 0.0f, rotation}, {10.0f, 2.0f, 0.0f}});
+				}
+				acquire(kHitEffect,{{scale, scale, 1.0f}, zero, {10.0f, 2.0f, 0.0f}});
+			}
+		}
+		for(uint32_t kind = 0; kind < kKindCount; ++kind){
+			isAllMatched = isAllMatched && backend.GetMismatchCount(kind) == 0;
+		}
+	}
+
+	std::printf("%u frames (%.0f s, %u ticks at 60 Hz)\n",kFrameCount,kFrameCount * kFrameTime,static_cast<uint32_t>(kFrameCount * kFrameTime * 60.0f + 0.5f));
+	uint64_t oldTotal = 0;
+	uint64_t newTotal = 0;
+	for(uint32_t kind = 0; kind < kKindCount; ++kind){
+		uint64_t oldCount = results[0].GetUploadCount(kind);
+		uint64_t newCount = results[1].GetUploadCount(kind);
+		oldTotal += oldCount;
+		newTotal += newCount;
+		uint64_t mismatchCount = results[0].GetMismatchCount(kind) + results[1].GetMismatchCount(kind);
+		std::printf("  %-14s %6llu -> %6llu uploads (%.2f -> %.2f per frame)%s\n",kKindNames[kind],static_cast<unsigned long long>(oldCount),
+		            static_cast<unsigned long long>(newCount),static_cast<double>(oldCount) / kFrameCount,static_cast<double>(newCount) / kFrameCount,
+		            mismatchCount == 0 ? "" : " MISMATCH");
+	}
+	std::printf("  %-14s %6llu -> %6llu uploads (%.2f -> %.2f per frame)\n","total",static_cast<unsigned long long>(oldTotal),static_cast<unsigned long long>(newTotal),
+	            static_cast<double>(oldTotal) / kFrameCount,static_cast<double>(newTotal) / kFrameCount);
+	std::printf("%s\n",isAllMatched ? "every drawn transform matches the last upload to its constant buffer" : "MISMATCH");
+	return isAllMatched ? 0 : 1;
+}
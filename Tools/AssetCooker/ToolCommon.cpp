@@ -0,0 +1,75 @@
+#include "ToolCommon.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+namespace{
+
+std::atomic<uint64_t> allocationCount{0};
+
+} // namespace
+
+// 確保の数を数えるだけで、中身は malloc / free に任せる (new[] と delete[] もここを通る)
+void* operator new(std::size_t size){
+	allocationCount.fetch_add(1,std::memory_order_relaxed);
+	if(void* memory = std::malloc(size == 0 ? 1 : size)){
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept{
+	std::free(memory);
+}
+
+void operator delete(void* memory,std::size_t) noexcept{
+	std::free(memory);
+}
+
+std::vector<std::string> FindModels(){
+	std::vector<std::string> names;
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("Resources")){
+		if(!entry.is_directory()){
+			continue;
+		}
+		std::string name = entry.path().filename().string();
+		if(std::filesystem::exists(entry.path() / (name + ".obj"))){
+			names.push_back(name);
+		}
+	}
+	std::sort(names.begin(),names.end());
+	return names;
+}
+
+std::vector<std::string> FindTextures(){
+	std::vector<std::string> names;
+	for(const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator("Resources")){
+		std::string extension = entry.path().extension().string();
+		if(entry.is_regular_file() && (extension == ".png" || extension == ".jpg")){
+			names.push_back(std::filesystem::relative(entry.path(),"Resources").generic_string());
+		}
+	}
+	std::sort(names.begin(),names.end());
+	return names;
+}
+
+std::vector<std::string> FindLevels(){
+	std::vector<std::string> names;
+	for(const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator("Resources")){
+		if(entry.is_regular_file() && entry.path().extension() == ".csv"){
+			names.push_back(std::filesystem::relative(entry.path(),"Resources").generic_string());
+		}
+	}
+	std::sort(names.begin(),names.end());
+	return names;
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start){
+	return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint64_t GetAllocationCount(){
+	return allocationCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ==========================================
+// AssetCooker のコマンドで共有する小さな関数
+// パスは作業フォルダ (DirectXGame) からの相対
+// ==========================================
+
+// Resources/<name>/<name>.obj があるフォルダ名の一覧
+std::vector<std::string> FindModels();
+// Resources/ 以下の画像 (Resources/ からの相対パス。クック済みは除く)
+std::vector<std::string> FindTextures();
+// Resources/ 以下の CSV (マップチップ。Resources/ からの相対パス)
+std::vector<std::string> FindLevels();
+
+// start からの経過時間 (ms)
+double ElapsedMs(std::chrono::steady_clock::time_point start);
+
+// ツールを起動してからの operator new の回数 (ヒープ確保の数を測る用。ToolCommon.cpp で置き換えている)
+uint64_t GetAllocationCount();
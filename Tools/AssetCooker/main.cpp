@@ -0,0 +1,460 @@
+// ==========================================
+// アセットのクックツール
+//   AssetCooker build [DirectXGame フォルダ]  … Resources/ の全 OBJ を .kmesh に、全 PNG を .cooked.dds に、全 CSV を .kmap にし、モデルの小さいテクスチャをアトラスにまとめる
+//                                              入力の中身が前回から変わったものだけを作り直す (状態は .cookcache/ に置く)
+//   AssetCooker cook  [DirectXGame フォルダ]  … build と同じだが、全て作り直す
+//   AssetCooker pack  [DirectXGame フォルダ]  … build の後、モデルとマップを Resources.kpak にまとめ、全て元と同じに読めるかを確かめる
+// 確かめ・計測 (AssetChecks.cpp)
+//   AssetCooker bench [DirectXGame フォルダ]  … OBJ と .kmesh の読み込み時間を比べる
+//   AssetCooker parse [DirectXGame フォルダ]  … ObjParser の結果を ObjLoader と突き合わせ、速度 (MB/s) を測る
+//   AssetCooker optimize [DirectXGame フォルダ] … MeshOptimizer の前後の ACMR/ATVR を出し、形が変わっていないか確かめる
+//   AssetCooker lod   [DirectXGame フォルダ]  … MeshSimplifier の LOD の段 (三角形数と誤差) と、CameraController の距離で描く三角形数 (エフェクトはゲーム中の大きさ) の見積もりを出す
+//   AssetCooker texture [DirectXGame フォルダ] … ミップの作り方を確かめ、全 PNG を BC1 / BC3 / BC7 に圧縮した時の PSNR・時間・VRAM を出す
+//   AssetCooker atlas [DirectXGame フォルダ]  … アトラスを作り直し、使用率と、UV を変換して読んだ画素が元と合うかを出す
+//   AssetCooker dedup [DirectXGame フォルダ]  … 中身が同じテクスチャ・値が同じマテリアルをまとめると読み込みがいくつ減るかを出す
+// 確かめ・計測 (RenderBenchmarks.cpp)
+//   AssetCooker instancing [DirectXGame フォルダ] … マップのブロックをインスタンス描画にすると描画コマンドがいくつ減るかを出し、タイルの位置を確かめる
+//   AssetCooker tilewindow [DirectXGame フォルダ] … カメラに映る列だけを描く時の1フレームの手間を、横に伸ばしたマップ (最大 4096 列) で測る
+//   AssetCooker culling  … 10 万個の球・箱の視錐台カリングを SIMD・スカラー・1個ずつ (Frustum) で比べ、結果が同じか確かめて時間と省いた数を出す
+//   AssetCooker uploads  … GameScene と同じ並びのトランスフォームを 10 秒動かし、変更の追跡で定数バッファへの転送がいくつ減るかを記録して出す
+// 確かめ・計測 (MathBenchmarks.cpp)
+//   AssetCooker hierarchy … 10 万個のトランスフォームの木を、1個ずつ MakeAffineMatrix する書き方と TransformHierarchy (スカラー・SIMD) で作り比べ、結果が合うか確かめる
+//   AssetCooker matrix   … SimdMath の関数ごとに、math.cpp のこれまでの書き方との差 (ULP) と 1 個あたりの時間を出す
+//   AssetCooker kernels  … MathKernels の近似 (sin / cos・2^x・pow・角度の折り返し) の誤差と時間を std の関数や以前の書き方と比べる
+//   AssetCooker tables   … ConstexprMath のコンパイル時の表 (パーティクルの方向) を毎回計算する以前の書き方と比べ、EaseInOut の書き方を比べる
+// 確かめ・計測 (GameplayBenchmarks.cpp)
+//   AssetCooker beams    … 連射し続けた時の1ティックのヒープ確保の数と時間を、new Beam + std::list と EntityWorld で比べる
+//   AssetCooker retry    … 死んだ後のリトライにかかる CPU の時間 (モデル・テクスチャはキャッシュから取る) を、シーンを作り直す場合と GameScene::Reset (初期配置に戻すだけ) で比べる
+//   AssetCooker entities … 敵・ビーム・ヒットエフェクトの数を 1〜10 倍にして、1ティックの時間を以前の std::list<T*> と EntityWorld (総当たり / CollisionGrid) で比べる
+// ゲーム本体と同じ ObjParser / CookedMesh などを使う (GPU には触らない)
+// ==========================================
+#include "Commands.h"
+#include "CookPipeline.h"
+#include "CookedLevel.h"
+#include "CookedMesh.h"
+#include "CookedTexture.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "PackFile.h"
+#include "PngLoader.h"
+#include "TextureAtlas.h"
+#include "ToolCommon.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace{
+
+// 1行ずつ見て、key の後ろの名前をファイルのあるフォルダからのパスにして返す
+// ObjParser と同じく、mtllib は書かれたまま、map_Kd はファイル名だけを使う
+std::vector<std::string> ScanReferences(const std::string& path,std::string_view key,bool isFileNameOnly){
+	std::vector<std::string> paths;
+	std::string directoryPath = std::filesystem::path(path).parent_path().generic_string() + "/";
+	MappedFile file;
+	if(!file.Open(path)){
+		return paths;
+	}
+	std::string_view text(reinterpret_cast<const char*>(file.GetData()),file.GetSize());
+	while(!text.empty()){
+		size_t lineEnd = text.find('\n');
+		std::string_view line = text.substr(0,lineEnd);
+		text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+
+		size_t begin = line.find_first_not_of(" \t");
+		if(begin == std::string_view::npos || line.substr(begin,key.size()) != key){
+			continue;
+		}
+		line = line.substr(begin + key.size());
+		if(line.empty() || (line.front() != ' ' && line.front() != '\t')){
+			continue;
+		}
+		// オプション (-s など) は付けない前提で、最後の語をファイル名とする
+		size_t end = line.find_last_not_of(" \t\r");
+		if(end == std::string_view::npos){
+			continue;
+		}
+		line = line.substr(0,end + 1);
+		size_t nameBegin = line.find_last_of(isFileNameOnly ? " \t/\\" : " \t");
+		std::string name(nameBegin == std::string_view::npos ? line : line.substr(nameBegin + 1));
+		std::string reference = directoryPath + name;
+		if(std::find(paths.begin(),paths.end(),reference) == paths.end()){
+			paths.push_back(reference);
+		}
+	}
+	return paths;
+}
+
+// クックの仕方を変えたら上げる (形式の版はそれぞれのクラスの kVersion を使う)
+const uint32_t kModelCookVersion = 1;
+const uint32_t kTextureCookVersion = 1;
+const uint32_t kLevelCookVersion = 1;
+const uint32_t kAtlasCookVersion = 1;
+const uint32_t kPackCookVersion = 1;
+
+// OBJ → MTL → テクスチャの依存をたどり、ジョブを作る
+// ジョブの中では並列にしない (ジョブどうしで並列に走らせる。アトラスだけは1つなので中でも分ける)
+std::vector<CookPipeline::Job> MakeJobs(CookPipeline& pipeline){
+	std::vector<CookPipeline::Job> jobs;
+	std::vector<std::string> atlasInputs;
+	std::vector<std::string> models = FindModels();
+	for(const std::string& name : models){
+		std::string objPath = "Resources/" + name + "/" + name + ".obj";
+		std::vector<std::string> mtlPaths = pipeline.GetDependencies(objPath,[](const std::string& path){ return ScanReferences(path,"mtllib",false); });
+
+		CookPipeline::Job& job = jobs.emplace_back();
+		job.id = "model:" + name;
+		job.version = kModelCookVersion << 16 | CookedMesh::kVersion;
+		job.inputs.push_back(objPath);
+		job.inputs.insert(job.inputs.end(),mtlPaths.begin(),mtlPaths.end());
+		job.cook = [name](std::vector<std::string>& outputs){
+			// どちらで読まれても良いように平滑化あり・なしの両方を作る
+			for(bool smoothing : {false, true}){
+				MeshData meshData;
+				std::string path = CookedMesh::GetPath(name,smoothing);
+				if(!ObjParser::Load(name,smoothing,meshData,1) || !CookedMesh::Write(meshData,path)){
+					return false;
+				}
+				outputs.push_back(path);
+			}
+			return true;
+		};
+
+		// アトラスは全モデルの MTL とテクスチャを見る
+		atlasInputs.insert(atlasInputs.end(),job.inputs.begin(),job.inputs.end());
+		for(const std::string& mtlPath : mtlPaths){
+			std::vector<std::string> textures = pipeline.GetDependencies(mtlPath,[](const std::string& path){ return ScanReferences(path,"map_Kd",true); });
+			atlasInputs.insert(atlasInputs.end(),textures.begin(),textures.end());
+		}
+	}
+
+	for(const std::string& name : FindTextures()){
+		if(!name.ends_with(".png")){
+			continue;
+		}
+		CookPipeline::Job& job = jobs.emplace_back();
+		job.id = "texture:" + name;
+		job.version = kTextureCookVersion;
+		job.inputs.push_back("Resources/" + name);
+		job.cook = [name](std::vector<std::string>& outputs){
+			ImageData image;
+			if(!PngLoader::Load("Resources/" + name,image)){
+				return false;
+			}
+			std::string path = "Resources/" + CookedTexture::GetCookedName(name);
+			if(!CookedTexture::Write(image,CookedTexture::ChooseFormat(image),path,1)){
+				return false;
+			}
+			outputs.push_back(path);
+			return true;
+		};
+	}
+
+	for(const std::string& name : FindLevels()){
+		CookPipeline::Job& job = jobs.emplace_back();
+		job.id = "level:" + name;
+		job.version = kLevelCookVersion << 16 | CookedLevel::kVersion;
+		job.inputs.push_back("Resources/" + name);
+		job.cook = [name](std::vector<std::string>& outputs){
+			CookedLevel::Level level;
+			std::string csvPath = "Resources/" + name;
+			std::string path = CookedLevel::GetPath(csvPath);
+			if(!CookedLevel::ParseCsv(csvPath,level) || !CookedLevel::Write(level,path)){
+				return false;
+			}
+			outputs.push_back(path);
+			return true;
+		};
+	}
+
+	// モデルの小さいテクスチャをまとめる
+	std::sort(atlasInputs.begin(),atlasInputs.end());
+	atlasInputs.erase(std::unique(atlasInputs.begin(),atlasInputs.end()),atlasInputs.end());
+	CookPipeline::Job& atlasJob = jobs.emplace_back();
+	atlasJob.id = "atlas";
+	atlasJob.version = kAtlasCookVersion;
+	atlasJob.inputs = std::move(atlasInputs);
+	atlasJob.cook = [models](std::vector<std::string>& outputs){
+		std::vector<TextureAtlas::Source> sources;
+		for(const std::string& name : models){
+			MeshData meshData;
+			if(ObjParser::Load(name,false,meshData,1)){
+				TextureAtlas::AddSources(meshData,sources);
+			}
+		}
+		TextureAtlas::Result result;
+		if(!TextureAtlas::Build(sources,result)){
+			return false;
+		}
+		outputs.push_back(TextureAtlas::GetManifestPath());
+		for(const TextureAtlas::Page& page : result.pages){
+			outputs.push_back("Resources/" + page.fileName);
+		}
+		return true;
+	};
+	return jobs;
+}
+
+const char* const kPackPath = "Resources.kpak";
+const char* const kTracePath = "Resources/load_trace.txt";
+
+// パックに入れるもの (ゲームが VirtualFileSystem を通して読むもの)
+// テクスチャと音声はエンジンがパスで読むので入れない
+// 読み込みの記録に載っているものを記録順に先頭へ、残りはパス順 (フォルダごとにまとまる)
+std::vector<PackFile::Source> FindPackSources(){
+	std::vector<std::string> paths;
+	for(const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator("Resources")){
+		std::string extension = entry.path().extension().string();
+		if(entry.is_regular_file() && (extension == ".obj" || extension == ".mtl" || extension == ".kmesh" || extension == ".csv" || extension == ".kmap")){
+			paths.push_back(entry.path().generic_string());
+		}
+	}
+	std::sort(paths.begin(),paths.end());
+
+	std::unordered_map<std::string,size_t> traceOrder;
+	std::ifstream traceFile(kTracePath);
+	std::string line;
+	while(std::getline(traceFile,line)){
+		if(!line.empty() && line.back() == '\r'){
+			line.pop_back();
+		}
+		traceOrder.emplace(PackFile::NormalizePath(line),traceOrder.size());
+	}
+
+	std::vector<PackFile::Source> sources;
+	for(const std::string& path : paths){
+		PackFile::Source& source = sources.emplace_back();
+		source.path = path;
+		// クック済みメッシュは頂点をパックの中から直接使うので、圧縮しない
+		source.isCompressible = !path.ends_with(".kmesh");
+		source.isTraced = traceOrder.contains(PackFile::NormalizePath(path));
+	}
+	std::stable_sort(sources.begin(),sources.end(),[&](const PackFile::Source& a,const PackFile::Source& b){
+		if(a.isTraced != b.isTraced){
+			return a.isTraced;
+		}
+		return a.isTraced && traceOrder[PackFile::NormalizePath(a.path)] < traceOrder[PackFile::NormalizePath(b.path)];
+	});
+	return sources;
+}
+
+// 他のジョブの出力を入れるので、それらが終わってから作る
+CookPipeline::Job MakePackJob(){
+	std::vector<PackFile::Source> sources = FindPackSources();
+	CookPipeline::Job job;
+	job.id = "pack";
+	job.version = kPackCookVersion << 16 | PackFile::kVersion;
+	for(const PackFile::Source& source : sources){
+		job.inputs.push_back(source.path);
+	}
+	job.inputs.push_back(kTracePath);
+	job.cook = [sources](std::vector<std::string>& outputs){
+		PackFile::WriteStats stats;
+		if(!PackFile::Write(sources,kPackPath,stats)){
+			return false;
+		}
+		outputs.push_back(kPackPath);
+		return true;
+	};
+	return job;
+}
+
+// force でなければ、入力が前回から変わったジョブだけをクックする
+int Build(bool force,bool isPacking){
+	auto start = std::chrono::steady_clock::now();
+	CookPipeline pipeline(".cookcache");
+	pipeline.Load();
+	std::vector<CookPipeline::Job> jobs = MakeJobs(pipeline);
+	double scanMs = ElapsedMs(start);
+
+	auto report = [](const CookPipeline::Job& job,CookPipeline::Result result,double ms){
+		switch(result){
+		case CookPipeline::Result::kCooked:
+			std::printf("cooked   %-40s %8.1f ms\n",job.id.c_str(),ms);
+			break;
+		case CookPipeline::Result::kRestored:
+			std::printf("restored %-40s %8.1f ms\n",job.id.c_str(),ms);
+			break;
+		case CookPipeline::Result::kFailed:
+			std::printf("FAILED   %s\n",job.id.c_str());
+			break;
+		default:
+			break;
+		}
+	};
+	CookPipeline::Stats stats = pipeline.Run(jobs,force,0,report);
+	size_t jobCount = jobs.size();
+	if(isPacking){
+		CookPipeline::Stats packStats = pipeline.Run({MakePackJob()},force,1,report);
+		stats.cooked += packStats.cooked;
+		stats.restored += packStats.restored;
+		stats.upToDate += packStats.upToDate;
+		stats.failed += packStats.failed;
+		stats.hashedFiles += packStats.hashedFiles;
+		++jobCount;
+	}
+	if(!pipeline.Save()){
+		std::printf("FAILED   .cookcache (save)\n");
+		++stats.failed;
+	}
+
+	std::printf("%zu jobs: %u cooked, %u restored, %u up to date, %u failed (%u files hashed), scan %.1f ms, total %.1f ms\n",jobCount,stats.cooked,
+	            stats.restored,stats.upToDate,stats.failed,stats.hashedFiles,scanMs,ElapsedMs(start));
+	return stats.failed == 0 ? 0 : 1;
+}
+
+// パックを作り、全エントリが元のファイルと同じに読めるかと、引く速さを確かめる
+int Pack(){
+	if(Build(false,true) != 0){
+		return 1;
+	}
+
+	VirtualFileSystem* fileSystem = VirtualFileSystem::GetInstance();
+	if(!fileSystem->Mount(kPackPath)){
+		std::printf("FAILED   %s (mount)\n",kPackPath);
+		return 1;
+	}
+	std::vector<PackFile::Source> sources = FindPackSources();
+	int failed = 0;
+	uint64_t originalBytes = 0;
+	uint64_t tracedBytes = 0;
+	uint32_t tracedCount = 0;
+	for(const PackFile::Source& source : sources){
+		FileView view;
+		MappedFile original;
+		bool isOpen = fileSystem->Open(source.path,view);
+		bool isSame = isOpen && original.Open(source.path) && view.GetSize() == original.GetSize() &&
+		              std::memcmp(view.GetData(),original.GetData(),view.GetSize()) == 0;
+		if(!isSame){
+			std::printf("FAILED   %s (contents differ)\n",source.path.c_str());
+			++failed;
+		}
+		// 大文字小文字や区切りが違っても引ける
+		std::string otherPath = source.path;
+		std::transform(otherPath.begin(),otherPath.end(),otherPath.begin(),[](char c){ return c == '/' ? '\\' : static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+		if(!fileSystem->IsPacked(otherPath)){
+			std::printf("FAILED   %s (case-insensitive lookup)\n",otherPath.c_str());
+			++failed;
+		}
+		originalBytes += original.GetSize();
+		if(source.isTraced){
+			tracedBytes += original.GetSize();
+			++tracedCount;
+		}
+	}
+	if(fileSystem->IsPacked("Resources/missing/missing.obj")){
+		std::printf("FAILED   lookup of a missing file succeeded\n");
+		++failed;
+	}
+
+	// 引く速さ (1回ハッシュして1つのスロットを見るだけ)
+	const int kLookupRuns = 2000;
+	auto start = std::chrono::steady_clock::now();
+	uint32_t found = 0;
+	for(int run = 0; run < kLookupRuns; ++run){
+		for(const PackFile::Source& source : sources){
+			found += fileSystem->IsPacked(source.path) ? 1 : 0;
+		}
+	}
+	double lookupNs = ElapsedMs(start) * 1e6 / (static_cast<double>(kLookupRuns) * static_cast<double>(sources.size()));
+	(void)found;
+
+	std::printf("pack    %s: %zu files, %.1f KB -> %.1f KB on disk, zero-copy %u, decompressed %u, lookup %.0f ns\n",kPackPath,sources.size(),
+	            originalBytes / 1024.0,std::filesystem::file_size(kPackPath) / 1024.0,fileSystem->GetPackedOpenCount(),fileSystem->GetUnpackedOpenCount(),
+	            lookupNs);
+	if(tracedCount > 0){
+		std::printf("pack    %u files (%.1f KB) from %s are first, read ahead in one range at mount\n",tracedCount,tracedBytes / 1024.0,kTracePath);
+	}
+	else{
+		std::printf("pack    (no %s yet: run a Debug build once to record the load order)\n",kTracePath);
+	}
+	fileSystem->Unmount();
+	return failed == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc,char** argv){
+	if(argc < 2){
+		std::printf("usage: AssetCooker build|cook|pack|bench|parse|optimize|lod|texture|atlas|dedup|instancing|tilewindow|culling|uploads|hierarchy|matrix|kernels|tables|beams|entities|retry [DirectXGame directory]\n");
+		return 1;
+	}
+	if(argc >= 3){
+		std::filesystem::current_path(argv[2]);
+	}
+
+	std::string command = argv[1];
+	if(command == "build"){
+		return Build(false,false);
+	}
+	if(command == "cook"){
+		return Build(true,false);
+	}
+	if(command == "pack"){
+		return Pack();
+	}
+	if(command == "bench"){
+		return Bench();
+	}
+	if(command == "parse"){
+		return Parse();
+	}
+	if(command == "optimize"){
+		return Optimize();
+	}
+	if(command == "lod"){
+		return Lod();
+	}
+	if(command == "texture"){
+		return Texture();
+	}
+	if(command == "atlas"){
+		return Atlas();
+	}
+	if(command == "dedup"){
+		return Dedup();
+	}
+	if(command == "instancing"){
+		return Instancing();
+	}
+	if(command == "tilewindow"){
+		return TileWindow();
+	}
+	if(command == "culling"){
+		return Culling();
+	}
+	if(command == "uploads"){
+		return Uploads();
+	}
+	if(command == "hierarchy"){
+		return Hierarchy();
+	}
+	if(command == "matrix"){
+		return MatrixMath();
+	}
+	if(command == "kernels"){
+		return Kernels();
+	}
+	if(command == "tables"){
+		return Tables();
+	}
+	if(command == "beams"){
+		return Beams();
+	}
+	if(command == "entities"){
+		return Entities();
+	}
+	if(command == "retry"){
+		return Retry();
+	}
+	std::printf("unknown command: %s\n",command.c_str());
+	return 1;
+}